@@ -61,7 +61,7 @@ class FixedChunkPQTable
 
     void populate_chunk_inner_products(const float *query_vec, float *dist_vec);
 
-    void load_pq_centroid_bin(std::stringstream &pq_table, size_t num_chunks);
+    void load_pq_centroid_bin(std::istream &pq_table, size_t num_chunks);
 
     int64_t get_memory_usage();
 
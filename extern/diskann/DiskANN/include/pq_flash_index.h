@@ -45,10 +45,10 @@ template <typename T, typename LabelT = uint32_t> class PQFlashIndex
 
     DISKANN_DLLEXPORT int load_from_separate_paths(uint32_t num_threads, const char *index_filepath,
                                                    std::stringstream &pivots_stream, std::stringstream &compressed_stream);
-    DISKANN_DLLEXPORT int load_from_separate_paths(std::stringstream &pivots_stream, std::stringstream &compressed_stream,
-                                                   std::stringstream &tag_stream);
+    DISKANN_DLLEXPORT int load_from_separate_paths(std::istream &pivots_stream, std::istream &compressed_stream,
+                                                   std::istream &tag_stream);
 
-    DISKANN_DLLEXPORT size_t load_graph(std::stringstream &in);
+    DISKANN_DLLEXPORT size_t load_graph(std::istream &in);
 
 
     DISKANN_DLLEXPORT void load_cache_list(std::vector<uint32_t> &node_list);
@@ -343,7 +343,7 @@ inline void get_bin_metadata(const std::string &bin_file, size_t &nrows, size_t
     get_bin_metadata_impl(reader, nrows, ncols, offset);
 }
 
-inline void get_bin_metadata(std::stringstream &in, size_t &nrows, size_t &ncols, size_t offset = 0)
+inline void get_bin_metadata(std::istream &in, size_t &nrows, size_t &ncols, size_t offset = 0)
 {
     get_bin_metadata_impl(in, nrows, ncols, offset);
 }
@@ -460,7 +460,7 @@ inline void load_bin(const std::string &bin_file, T *&data, size_t &npts, size_t
 }
 
 template <typename T>
-inline void load_bin(std::stringstream &reader, T *&data, size_t &npts, size_t &dim, size_t offset = 0)
+inline void load_bin(std::istream &reader, T *&data, size_t &npts, size_t &dim, size_t offset = 0)
 {
     try
     {
@@ -168,7 +168,7 @@ void FixedChunkPQTable::load_pq_centroid_bin(const char *pq_table_file, size_t n
 }
 
 
-void FixedChunkPQTable::load_pq_centroid_bin(std::stringstream &pq_table, size_t num_chunks)
+void FixedChunkPQTable::load_pq_centroid_bin(std::istream &pq_table, size_t num_chunks)
 {
 
     uint64_t nr, nc;
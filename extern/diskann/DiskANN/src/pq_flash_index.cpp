@@ -1301,8 +1301,8 @@ int PQFlashIndex<T, LabelT>::load_from_separate_paths(uint32_t num_threads, cons
 }
 
 template <typename T, typename LabelT>
-int PQFlashIndex<T, LabelT>::load_from_separate_paths(std::stringstream &pivots_stream,
-                                                      std::stringstream &compressed_stream, std::stringstream& tag_stream)
+int PQFlashIndex<T, LabelT>::load_from_separate_paths(std::istream &pivots_stream,
+                                                      std::istream &compressed_stream, std::istream &tag_stream)
 {
 
     size_t num_pts_in_label_file = 0;
@@ -1697,7 +1697,7 @@ int64_t PQFlashIndex<T, LabelT>::cached_beam_search(const T *query1, const uint6
 }
 
 template <typename T, typename LabelT>
-size_t PQFlashIndex<T, LabelT>::load_graph(std::stringstream &in)
+size_t PQFlashIndex<T, LabelT>::load_graph(std::istream &in)
 {
     size_t expected_file_size;
     size_t file_frozen_pts;
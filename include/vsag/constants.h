@@ -117,6 +117,7 @@ extern const char* const PYRAMID_PRECISE_IO_TYPE;
 extern const char* const PYRAMID_PRECISE_FILE_PATH;
 extern const char* const PYRAMID_PARAMETER_EF_SEARCH;
 extern const char* const PYRAMID_NO_BUILD_LEVELS;
+extern const char* const PYRAMID_INDEX_MIN_SIZE;
 
 extern const char PART_SLASH;
 extern const char PART_BAR;
@@ -146,6 +147,7 @@ extern const char* const SERIALIZE_VERSION;
 extern const char* const SQ4_UNIFORM_TRUNC_RATE;
 extern const char* const RABITQ_PCA_DIM;
 extern const char* const RABITQ_BITS_PER_DIM_QUERY;
+extern const char* const RABITQ_BITS_PER_DIM_BASE;
 extern const char* const RABITQ_USE_FHT;
 extern const char* const INDEX_TQ_CHAIN;
 
@@ -157,6 +159,7 @@ extern const char* const HGRAPH_USE_REORDER;
 extern const char* const HGRAPH_USE_ELP_OPTIMIZER;
 extern const char* const HGRAPH_IGNORE_REORDER;
 extern const char* const HGRAPH_BUILD_BY_BASE_QUANTIZATION;
+extern const char* const HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION;
 extern const char* const HGRAPH_BASE_QUANTIZATION_TYPE;
 extern const char* const HGRAPH_GRAPH_MAX_DEGREE;
 extern const char* const HGRAPH_BUILD_EF_CONSTRUCTION;
@@ -177,6 +180,10 @@ extern const char* const HGRAPH_PARAMETER_EF_RUNTIME;
 extern const char* const HGRAPH_EXTRA_INFO_SIZE;
 extern const char* const HGRAPH_SUPPORT_DUPLICATE;
 extern const char* const HGRAPH_SUPPORT_TOMBSTONE;
+extern const char* const HGRAPH_CONSOLIDATE_REMOVE_RATIO;
+extern const char* const HGRAPH_GRAPH_LAYOUT_ORDER;
+extern const char* const HGRAPH_FUSE_CODES_WITH_GRAPH;
+extern const char* const HGRAPH_BUILD_PARTITION_COUNT;
 extern const char* const HGRAPH_USE_EXTRA_INFO_FILTER;
 extern const char* const STORE_RAW_VECTOR;
 extern const char* const RAW_VECTOR_IO_TYPE;
@@ -195,10 +202,12 @@ extern const char* const BRUTE_FORCE_USE_RESIDUAL;
 extern const char* const IVF_USE_RESIDUAL;
 extern const char* const IVF_USE_REORDER;
 extern const char* const IVF_TRAIN_TYPE;
+extern const char* const IVF_TRAIN_BALANCE_FACTOR;
 extern const char* const IVF_BUCKETS_COUNT;
 extern const char* const IVF_BASE_QUANTIZATION_TYPE;
 extern const char* const IVF_BASE_IO_TYPE;
 extern const char* const IVF_BASE_PQ_DIM;
+extern const char* const IVF_BASE_SQ4_UNIFORM_FASTSCAN;
 extern const char* const IVF_BASE_FILE_PATH;
 extern const char* const IVF_PRECISE_QUANTIZATION_TYPE;
 extern const char* const IVF_PRECISE_IO_TYPE;
@@ -208,6 +217,8 @@ extern const char* const IVF_THREAD_COUNT;
 
 extern const char* const GNO_IMI_FIRST_ORDER_BUCKETS_COUNT;
 extern const char* const GNO_IMI_SECOND_ORDER_BUCKETS_COUNT;
+extern const char* const HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT;
+extern const char* const HIERARCHICAL_MAX_BUCKET_SIZE_RATIO;
 
 // serialization
 extern const char* const SERIAL_MAGIC_BEGIN;
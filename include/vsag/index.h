@@ -128,6 +128,32 @@ public:
         throw std::runtime_error("Index not support delete vector");
     }
 
+    /**
+     * @brief Repair the graph around removed vectors so that no edge points to them anymore
+     *
+     * In-neighbors of every removed vector are reconnected through its out-neighbors, and
+     * the removed vectors can no longer be recovered by adding their ids again.
+     *
+     * @return result is the number of removed vectors consolidated by this call.
+     */
+    virtual tl::expected<uint64_t, Error>
+    ConsolidateRemoved() {
+        throw std::runtime_error("Index not support consolidate removed");
+    }
+
+    /**
+     * @brief Reclaim the storage of removed vectors by renumbering the remaining ones densely
+     *
+     * The index is rebuilt into freshly sized storage and swapped in under the writer lock,
+     * so Add/Remove/Update must not run concurrently. Removed ids cannot be recovered after.
+     *
+     * @return result is the number of removed slots reclaimed by this call.
+     */
+    virtual tl::expected<uint64_t, Error>
+    Compact() {
+        throw std::runtime_error("Index not support compact");
+    }
+
     /**
      * @brief Update the id of a base point from the index
      *
@@ -20,6 +20,7 @@
 
 #include <atomic>
 #include <memory>
+#include <numeric>
 #include <stdexcept>
 
 #include "algorithm/inner_index_interface.h"
@@ -27,15 +28,19 @@
 #include "common.h"
 #include "datacell/sparse_graph_datacell.h"
 #include "dataset_impl.h"
+#include "impl/cluster/kmeans_cluster.h"
 #include "impl/heap/standard_heap.h"
 #include "impl/odescent/odescent_graph_builder.h"
 #include "impl/pruning_strategy.h"
 #include "index/index_impl.h"
 #include "index/iterator_filter.h"
 #include "io/reader_io_parameter.h"
+#include "simd/fp32_simd.h"
 #include "storage/serialization.h"
 #include "storage/stream_reader.h"
+#include "storage/stream_writer.h"
 #include "typing.h"
+#include "utils/slow_task_timer.h"
 #include "utils/util_functions.h"
 #include "utils/visited_list.h"
 #include "vsag/options.h"
@@ -45,17 +50,25 @@ namespace vsag {
 HGraph::HGraph(const HGraphParameterPtr& hgraph_param, const vsag::IndexCommonParam& common_param)
     : InnerIndexInterface(hgraph_param, common_param),
       route_graphs_(common_param.allocator_.get()),
+      layout_order_cache_(common_param.allocator_.get()),
       use_elp_optimizer_(hgraph_param->use_elp_optimizer),
       ignore_reorder_(hgraph_param->ignore_reorder),
       build_by_base_(hgraph_param->build_by_base),
       ef_construct_(hgraph_param->ef_construction),
       alpha_(hgraph_param->alpha),
+      consolidate_remove_ratio_(hgraph_param->consolidate_remove_ratio),
       odescent_param_(hgraph_param->odescent_param),
       graph_type_(hgraph_param->graph_type),
       hierarchical_datacell_param_(hgraph_param->hierarchical_graph_param),
-      use_old_serial_format_(common_param.use_old_serial_format_) {
+      use_old_serial_format_(common_param.use_old_serial_format_),
+      common_param_(common_param) {
     this->label_table_->compress_duplicate_data_ = hgraph_param->support_duplicate;
     this->label_table_->support_tombstone_ = hgraph_param->support_tombstone;
+    this->graph_layout_order_ = get_graph_layout_order(hgraph_param->graph_layout_order);
+    this->build_partition_count_ = hgraph_param->build_partition_count;
+    // only meaningful when the build codes are the precise ones
+    this->build_search_by_base_ =
+        hgraph_param->build_search_by_base and use_reorder_ and not build_by_base_;
     neighbors_mutex_ = std::make_shared<PointsMutex>(0, common_param.allocator_.get());
     this->basic_flatten_codes_ =
         FlattenInterface::MakeInstance(hgraph_param->base_codes_param, common_param);
@@ -65,9 +78,17 @@ HGraph::HGraph(const HGraphParameterPtr& hgraph_param, const vsag::IndexCommonPa
     }
     this->searcher_ = std::make_shared<BasicSearcher>(common_param, neighbors_mutex_);
 
-    this->bottom_graph_ =
-        GraphInterface::MakeInstance(hgraph_param->bottom_graph_param, common_param);
+    // the fused codes hold the bottom graph in their own records
+    this->bottom_graph_ = this->basic_flatten_codes_->GetFusedGraph();
+    if (this->bottom_graph_ == nullptr) {
+        this->bottom_graph_ =
+            GraphInterface::MakeInstance(hgraph_param->bottom_graph_param, common_param);
+    }
     mult_ = 1 / log(1.0 * static_cast<double>(this->bottom_graph_->MaximumDegree()));
+    if (graph_type_ == GRAPH_TYPE_VALUE_VAMANA) {
+        // a vamana graph is flat, its medoid is the only entry point
+        mult_ = 0.0;
+    }
 
     auto step_block_size = Options::Instance().block_size_limit();
     auto block_size_per_vector = this->basic_flatten_codes_->code_size_;
@@ -116,8 +137,12 @@ HGraph::Build(const DatasetPtr& data) {
     CHECK_ARGUMENT(GetNumElements() == 0, "index is not empty");
     this->Train(data);
     std::vector<int64_t> ret;
-    if (graph_type_ == GRAPH_TYPE_VALUE_NSW) {
+    if (build_partition_count_ > 1) {
+        ret = this->build_by_partition(data);
+    } else if (graph_type_ == GRAPH_TYPE_VALUE_NSW) {
         ret = this->Add(data);
+    } else if (graph_type_ == GRAPH_TYPE_VALUE_VAMANA) {
+        ret = this->build_by_vamana(data);
     } else {
         ret = this->build_by_odescent(data);
     }
@@ -127,30 +152,228 @@ HGraph::Build(const DatasetPtr& data) {
     return ret;
 }
 
+void
+HGraph::parallel_run(int64_t count, const std::function<void(int64_t, int64_t)>& func) {
+    constexpr int64_t chunk_size = 4096;
+    if (this->build_pool_ == nullptr) {
+        func(0, count);
+        return;
+    }
+    std::vector<std::future<void>> futures;
+    for (int64_t begin = 0; begin < count; begin += chunk_size) {
+        auto end = std::min(begin + chunk_size, count);
+        futures.emplace_back(this->build_pool_->GeneralEnqueue(func, begin, end));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+}
+
 std::vector<int64_t>
 HGraph::build_by_odescent(const DatasetPtr& data) {
     std::vector<int64_t> failed_ids;
+    Vector<InnerIdType> inner_ids(allocator_);
+    Vector<Vector<InnerIdType>> route_graph_ids(allocator_);
+    this->insert_without_graph(data, failed_ids, inner_ids, route_graph_ids);
+
+    auto build_data = (use_reorder_ and not build_by_base_) ? this->high_precise_codes_
+                                                            : this->basic_flatten_codes_;
+    {
+        odescent_param_->max_degree = bottom_graph_->MaximumDegree();
+        ODescent odescent_builder(odescent_param_,
+                                  this->build_search_codes(build_data),
+                                  allocator_,
+                                  this->build_pool_.get());
+        odescent_builder.SetPruneFlatten(build_data);
+        odescent_builder.Build();
+        odescent_builder.SaveGraph(bottom_graph_);
+    }
+    this->build_route_graphs_by_odescent(route_graph_ids, build_data);
+    return failed_ids;
+}
+
+std::vector<int64_t>
+HGraph::build_by_vamana(const DatasetPtr& data) {
+    std::vector<int64_t> failed_ids;
+    Vector<InnerIdType> inner_ids(allocator_);
+    Vector<Vector<InnerIdType>> route_graph_ids(allocator_);
+    auto positions = this->insert_without_graph(data, failed_ids, inner_ids, route_graph_ids);
+    auto count = static_cast<int64_t>(positions.size());
+    if (count == 0) {
+        return failed_ids;
+    }
+    const auto* vectors = data->GetFloat32Vectors();
+    auto build_data = (use_reorder_ and not build_by_base_) ? this->high_precise_codes_
+                                                            : this->basic_flatten_codes_;
+
+    // 1. the medoid is approximated by the point nearest to the mean of a sample
+    constexpr int64_t max_sample_count = 65536;
+    auto sample_count = std::min(count, max_sample_count);
+    Vector<float> mean(dim_, 0.0F, allocator_);
+    for (int64_t i = 0; i < sample_count; ++i) {
+        const auto* vector = vectors + dim_ * positions[i * count / sample_count];
+        for (int64_t d = 0; d < dim_; ++d) {
+            mean[d] += vector[d] / static_cast<float>(sample_count);
+        }
+    }
+    std::mutex medoid_mutex;
+    auto medoid = std::make_pair(std::numeric_limits<float>::max(), inner_ids[0]);
+    parallel_run(count, [&](int64_t begin, int64_t end) {
+        auto local = std::make_pair(std::numeric_limits<float>::max(), inner_ids[0]);
+        for (int64_t i = begin; i < end; ++i) {
+            auto dist = FP32ComputeL2Sqr(mean.data(), vectors + dim_ * positions[i], dim_);
+            local = std::min(local, std::make_pair(dist, inner_ids[i]));
+        }
+        std::lock_guard lock(medoid_mutex);
+        medoid = std::min(medoid, local);
+    });
+    this->entry_point_id_ = medoid.second;
+
+    // 2. two passes of greedy search and robust prune in a random order, the first one with
+    // alpha 1 gives a sparse graph, the second one with alpha_ adds the long range edges.
+    // Only one node lock is held at a time, the back edges are added one node after another
+    const auto& search_data = this->build_search_codes(build_data);
+    Vector<InnerIdType> order(inner_ids.begin(), inner_ids.end(), allocator_);
+    std::shuffle(order.begin(), order.end(), std::default_random_engine(2021));
+    auto max_degree = bottom_graph_->MaximumDegree();
+    for (auto alpha : {1.0F, this->alpha_}) {
+        parallel_run(count, [&](int64_t begin, int64_t end) {
+            Vector<InnerIdType> neighbors(allocator_);
+            Vector<std::pair<InnerIdType, float>> candidates(allocator_);
+            for (int64_t i = begin; i < end; ++i) {
+                auto id = order[i];
+                auto results = search_by_pair_distance(
+                    id, bottom_graph_, entry_point_id_, ef_construct_, search_data);
+                this->refine_build_candidates(id, results, build_data);
+                candidates.clear();
+                while (not results->Empty()) {
+                    candidates.emplace_back(results->Top().second, results->Top().first);
+                    results->Pop();
+                }
+                {
+                    SharedLock lock(neighbors_mutex_, id);
+                    bottom_graph_->GetNeighbors(id, neighbors);
+                }
+                for (const auto& neighbor : neighbors) {
+                    candidates.emplace_back(neighbor, build_data->ComputePairVectors(id, neighbor));
+                }
+                std::sort(candidates.begin(), candidates.end());
+                candidates.erase(
+                    std::unique(candidates.begin(),
+                                candidates.end(),
+                                [](const auto& a, const auto& b) { return a.first == b.first; }),
+                    candidates.end());
+
+                auto edges = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+                for (const auto& [candidate, dist] : candidates) {
+                    if (candidate != id) {
+                        edges->Push(dist, candidate);
+                    }
+                }
+                select_edges_by_heuristic(edges, max_degree, build_data, allocator_, alpha);
+                neighbors.clear();
+                while (not edges->Empty()) {
+                    neighbors.emplace_back(edges->Top().second);
+                    edges->Pop();
+                }
+                {
+                    LockGuard lock(neighbors_mutex_, id);
+                    bottom_graph_->InsertNeighborsById(id, neighbors);
+                }
+                for (const auto& neighbor : neighbors) {
+                    this->add_back_edge(neighbor, id, build_data, alpha);
+                }
+            }
+        });
+    }
+    return failed_ids;
+}
+
+void
+HGraph::add_back_edge(InnerIdType from,
+                      InnerIdType to,
+                      const FlattenInterfacePtr& flatten,
+                      float alpha) {
+    LockGuard lock(neighbors_mutex_, from);
+    Vector<InnerIdType> neighbors(allocator_);
+    bottom_graph_->GetNeighbors(from, neighbors);
+    if (std::find(neighbors.begin(), neighbors.end(), to) != neighbors.end()) {
+        return;
+    }
+    if (neighbors.size() < bottom_graph_->MaximumDegree()) {
+        neighbors.emplace_back(to);
+        bottom_graph_->InsertNeighborsById(from, neighbors);
+        return;
+    }
+    auto edges = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+    edges->Push(flatten->ComputePairVectors(from, to), to);
+    for (const auto& neighbor : neighbors) {
+        edges->Push(flatten->ComputePairVectors(from, neighbor), neighbor);
+    }
+    select_edges_by_heuristic(edges, bottom_graph_->MaximumDegree(), flatten, allocator_, alpha);
+    neighbors.clear();
+    while (not edges->Empty()) {
+        neighbors.emplace_back(edges->Top().second);
+        edges->Pop();
+    }
+    bottom_graph_->InsertNeighborsById(from, neighbors);
+}
 
+Vector<int64_t>
+HGraph::insert_without_graph(const DatasetPtr& data,
+                             std::vector<int64_t>& failed_ids,
+                             Vector<InnerIdType>& inner_ids,
+                             Vector<Vector<InnerIdType>>& route_graph_ids) {
     auto total = data->GetNumElements();
     const auto* labels = data->GetIds();
     const auto* vectors = data->GetFloat32Vectors();
-    const auto* extra_infos = data->GetExtraInfos();
-    auto inner_ids = this->get_unique_inner_ids(total);
-    Vector<Vector<InnerIdType>> route_graph_ids(allocator_);
-    InnerIdType cur_size = 0;
-    for (int64_t i = 0; i < total; ++i) {
-        auto label = labels[i];
-        if (this->label_table_->CheckLabel(label)) {
-            failed_ids.emplace_back(label);
-            continue;
+
+    // 1. dedup the labels on the build pool, the first occurrence of a label wins
+    constexpr uint64_t label_stripe_count = 256;
+    std::vector<std::mutex> stripe_mutexes(label_stripe_count);
+    std::vector<UnorderedMap<LabelType, int64_t>> first_positions(
+        label_stripe_count, UnorderedMap<LabelType, int64_t>(allocator_));
+    Vector<uint8_t> accepted(total, 0, allocator_);
+    parallel_run(total, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            auto label = labels[i];
+            if (this->label_table_->CheckLabel(label)) {
+                continue;
+            }
+            accepted[i] = 1;
+            auto stripe = std::hash<LabelType>()(label) % label_stripe_count;
+            std::lock_guard lock(stripe_mutexes[stripe]);
+            auto [iter, inserted] = first_positions[stripe].emplace(label, i);
+            if (not inserted and i < iter->second) {
+                iter.value() = i;
+            }
         }
-        InnerIdType inner_id = inner_ids.at(cur_size);
-        cur_size++;
-        this->label_table_->Insert(inner_id, label);
-        this->basic_flatten_codes_->InsertVector(vectors + dim_ * i, inner_id);
-        if (use_reorder_) {
-            this->high_precise_codes_->InsertVector(vectors + dim_ * i, inner_id);
+    });
+    parallel_run(total, [&](int64_t begin, int64_t end) {
+        for (int64_t i = begin; i < end; ++i) {
+            if (accepted[i] != 0) {
+                auto stripe = std::hash<LabelType>()(labels[i]) % label_stripe_count;
+                accepted[i] = first_positions[stripe].at(labels[i]) == i ? 1 : 0;
+            }
+        }
+    });
+    first_positions.clear();
+
+    // 2. assign the inner ids and sample the levels in input order
+    Vector<int64_t> positions(allocator_);
+    positions.reserve(total);
+    for (int64_t i = 0; i < total; ++i) {
+        if (accepted[i] != 0) {
+            positions.emplace_back(i);
+        } else {
+            failed_ids.emplace_back(labels[i]);
         }
+    }
+    auto accepted_count = static_cast<InnerIdType>(positions.size());
+    inner_ids = this->get_unique_inner_ids(accepted_count);
+    for (InnerIdType i = 0; i < accepted_count; ++i) {
+        auto inner_id = inner_ids[i];
+        this->label_table_->Insert(inner_id, labels[positions[i]]);
         auto level = this->get_random_level() - 1;
         if (level >= 0) {
             if (level >= static_cast<int>(route_graph_ids.size()) || route_graph_ids.empty()) {
@@ -165,23 +388,171 @@ HGraph::build_by_odescent(const DatasetPtr& data) {
         }
     }
     this->resize(total_count_);
-    auto build_data = (use_reorder_ and not build_by_base_) ? this->high_precise_codes_
-                                                            : this->basic_flatten_codes_;
-    {
-        odescent_param_->max_degree = bottom_graph_->MaximumDegree();
-        ODescent odescent_builder(odescent_param_, build_data, allocator_, this->build_pool_.get());
-        odescent_builder.Build();
-        odescent_builder.SaveGraph(bottom_graph_);
+
+    // 3. encode the accepted vectors chunk by chunk, the inner ids of a chunk are consecutive
+    parallel_run(accepted_count, [&](int64_t begin, int64_t end) {
+        auto count = static_cast<InnerIdType>(end - begin);
+        const float* chunk_vectors = vectors + dim_ * positions[begin];
+        Vector<float> gathered(allocator_);
+        if (positions[end - 1] - positions[begin] != end - begin - 1) {
+            // duplicated labels left holes in this chunk
+            gathered.resize(static_cast<uint64_t>(count) * dim_);
+            for (int64_t i = begin; i < end; ++i) {
+                std::memcpy(gathered.data() + (i - begin) * dim_,
+                            vectors + dim_ * positions[i],
+                            dim_ * sizeof(float));
+            }
+            chunk_vectors = gathered.data();
+        }
+        this->basic_flatten_codes_->BatchInsertVector(chunk_vectors, count, &inner_ids[begin]);
+        if (use_reorder_) {
+            this->high_precise_codes_->BatchInsertVector(chunk_vectors, count, &inner_ids[begin]);
+        }
+    });
+    return positions;
+}
+
+void
+HGraph::build_route_graphs_by_odescent(const Vector<Vector<InnerIdType>>& route_graph_ids,
+                                       const FlattenInterfacePtr& build_data) {
+    if (this->odescent_param_ == nullptr) {
+        odescent_param_ = std::make_shared<ODescentParameter>();
     }
-    for (auto& route_graph_id : route_graph_ids) {
+    for (const auto& route_graph_id : route_graph_ids) {
         odescent_param_->max_degree = bottom_graph_->MaximumDegree() / 2;
-        ODescent sparse_odescent_builder(
-            odescent_param_, build_data, allocator_, this->build_pool_.get());
+        ODescent sparse_odescent_builder(odescent_param_,
+                                         this->build_search_codes(build_data),
+                                         allocator_,
+                                         this->build_pool_.get());
+        sparse_odescent_builder.SetPruneFlatten(build_data);
         auto graph = this->generate_one_route_graph();
         sparse_odescent_builder.Build(route_graph_id);
         sparse_odescent_builder.SaveGraph(graph);
         this->route_graphs_.emplace_back(graph);
     }
+}
+
+std::vector<int64_t>
+HGraph::build_by_partition(const DatasetPtr& data) {
+    std::vector<int64_t> failed_ids;
+    Vector<InnerIdType> inner_ids(allocator_);
+    Vector<Vector<InnerIdType>> route_graph_ids(allocator_);
+    auto positions = this->insert_without_graph(data, failed_ids, inner_ids, route_graph_ids);
+    const auto* vectors = data->GetFloat32Vectors();
+    auto count = static_cast<int64_t>(positions.size());
+    auto build_data = (use_reorder_ and not build_by_base_) ? this->high_precise_codes_
+                                                            : this->basic_flatten_codes_;
+
+    // 1. cluster a sample of the points, every point joins its nearest two clusters so that
+    // the shards overlap and the stitched graph stays connected
+    constexpr int64_t sample_count_per_shard = 1024;
+    constexpr uint64_t shard_overlap = 2;
+    auto shard_count = std::min(this->build_partition_count_, static_cast<uint64_t>(count));
+    auto sample_count =
+        std::min(count, static_cast<int64_t>(shard_count) * sample_count_per_shard);
+    Vector<float> samples(sample_count * dim_, allocator_);
+    for (int64_t i = 0; i < sample_count; ++i) {
+        std::memcpy(samples.data() + i * dim_,
+                    vectors + dim_ * positions[i * count / sample_count],
+                    dim_ * sizeof(float));
+    }
+    KMeansCluster cluster(static_cast<int32_t>(dim_), allocator_, this->build_pool_);
+    cluster.Run(static_cast<uint32_t>(shard_count), samples.data(), sample_count);
+    auto overlap = std::min(shard_overlap, shard_count);
+    Vector<uint32_t> assignments(count * overlap, 0, allocator_);
+    parallel_run(count, [&](int64_t begin, int64_t end) {
+        Vector<std::pair<float, uint32_t>> dists(shard_count, allocator_);
+        for (int64_t i = begin; i < end; ++i) {
+            for (uint32_t k = 0; k < shard_count; ++k) {
+                dists[k] = {FP32ComputeL2Sqr(vectors + dim_ * positions[i],
+                                             cluster.k_centroids_ + k * dim_,
+                                             dim_),
+                            k};
+            }
+            std::partial_sort(dists.begin(), dists.begin() + overlap, dists.end());
+            for (uint64_t j = 0; j < overlap; ++j) {
+                assignments[i * overlap + j] = dists[j].second;
+            }
+        }
+    });
+    Vector<Vector<int64_t>> shard_members(shard_count, Vector<int64_t>(allocator_), allocator_);
+    for (int64_t i = 0; i < count; ++i) {
+        for (uint64_t j = 0; j < overlap; ++j) {
+            shard_members[assignments[i * overlap + j]].emplace_back(i);
+        }
+    }
+    assignments.clear();
+    assignments.shrink_to_fit();
+
+    // 2. build every shard as an index of its own on the exported model, only one shard is
+    // alive at a time, then stitch it in: the first shard of a point gives its neighbors, the
+    // second one is united with them and pruned again
+    Vector<uint8_t> stitched(this->total_count_, 0, allocator_);
+    for (auto& members : shard_members) {
+        if (members.empty()) {
+            continue;
+        }
+        auto member_count = static_cast<int64_t>(members.size());
+        Vector<float> shard_vectors(member_count * dim_, allocator_);
+        Vector<int64_t> shard_labels(member_count, allocator_);
+        for (int64_t j = 0; j < member_count; ++j) {
+            std::memcpy(shard_vectors.data() + j * dim_,
+                        vectors + dim_ * positions[members[j]],
+                        dim_ * sizeof(float));
+            shard_labels[j] = inner_ids[members[j]];
+        }
+        auto shard_data = Dataset::Make();
+        shard_data->NumElements(member_count)
+            ->Dim(dim_)
+            ->Ids(shard_labels.data())
+            ->Float32Vectors(shard_vectors.data())
+            ->Owner(false);
+        auto shard = std::static_pointer_cast<HGraph>(this->ExportModel(this->common_param_));
+        if (graph_type_ == GRAPH_TYPE_VALUE_NSW) {
+            shard->Add(shard_data);
+        } else if (graph_type_ == GRAPH_TYPE_VALUE_VAMANA) {
+            shard->build_by_vamana(shard_data);
+        } else {
+            shard->build_by_odescent(shard_data);
+        }
+
+        const auto& shard_labels_table = shard->label_table_;
+        parallel_run(shard->total_count_, [&](int64_t begin, int64_t end) {
+            Vector<InnerIdType> neighbors(allocator_);
+            Vector<InnerIdType> existing(allocator_);
+            for (auto local_id = begin; local_id < end; ++local_id) {
+                auto id = static_cast<InnerIdType>(
+                    shard_labels_table->GetLabelById(static_cast<InnerIdType>(local_id)));
+                shard->bottom_graph_->GetNeighbors(local_id, neighbors);
+                for (auto& neighbor : neighbors) {
+                    neighbor = static_cast<InnerIdType>(shard_labels_table->GetLabelById(neighbor));
+                }
+                if (stitched[id] == 0) {
+                    stitched[id] = 1;
+                    bottom_graph_->InsertNeighborsById(id, neighbors);
+                    continue;
+                }
+                bottom_graph_->GetNeighbors(id, existing);
+                existing.insert(existing.end(), neighbors.begin(), neighbors.end());
+                std::sort(existing.begin(), existing.end());
+                existing.erase(std::unique(existing.begin(), existing.end()), existing.end());
+                auto edges = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+                for (const auto& neighbor : existing) {
+                    edges->Push(build_data->ComputePairVectors(id, neighbor), neighbor);
+                }
+                select_edges_by_heuristic(
+                    edges, bottom_graph_->MaximumDegree(), build_data, allocator_, alpha_);
+                neighbors.clear();
+                while (not edges->Empty()) {
+                    neighbors.emplace_back(edges->Top().second);
+                    edges->Pop();
+                }
+                bottom_graph_->InsertNeighborsById(id, neighbors);
+            }
+        });
+        logger::debug("partitioned build: stitched a shard of {} points", member_count);
+    }
+    this->build_route_graphs_by_odescent(route_graph_ids, build_data);
     return failed_ids;
 }
 
@@ -200,20 +571,32 @@ HGraph::Add(const DatasetPtr& data) {
         if (this->total_count_ == 0) {
             this->Train(data);
         }
+        this->layout_ordered_ = false;
     }
 
     auto add_func = [&](const void* data,
                         int level,
                         InnerIdType inner_id,
                         const char* extra_info,
-                        const AttributeSet* attrs) -> void {
+                        const AttributeSet* attrs,
+                        bool is_reused) -> void {
         if (this->extra_infos_ != nullptr) {
             this->extra_infos_->InsertExtraInfo(extra_info, inner_id);
         }
-        if (attrs != nullptr and this->use_attribute_filter_) {
+        if (is_reused and this->use_attribute_filter_) {
+            // drop the attributes left behind by the previous owner of the slot
+            AttributeSet origin_attrs;
+            AttributeSet empty_attrs;
+            const auto& new_attrs = attrs != nullptr ? *attrs : empty_attrs;
+            this->attr_filter_index_->GetAttribute(0, inner_id, &origin_attrs);
+            this->attr_filter_index_->UpdateBitsetsByAttr(new_attrs, inner_id, 0, origin_attrs);
+            for (auto* attr : origin_attrs.attrs_) {
+                delete attr;
+            }
+        } else if (attrs != nullptr and this->use_attribute_filter_) {
             this->attr_filter_index_->Insert(*attrs, inner_id);
         }
-        this->add_one_point(data, level, inner_id);
+        this->add_one_point(data, level, inner_id, is_reused);
     };
 
     std::vector<std::future<void>> futures;
@@ -222,6 +605,7 @@ HGraph::Add(const DatasetPtr& data) {
     const auto* extra_infos = data->GetExtraInfos();
     const auto* attr_sets = data->GetAttributeSets();
     Vector<std::pair<InnerIdType, LabelType>> inner_ids(allocator_);
+    UnorderedSet<InnerIdType> reused_ids(allocator_);
     for (int64_t j = 0; j < total; ++j) {
         InnerIdType inner_id;
 
@@ -232,6 +616,14 @@ HGraph::Add(const DatasetPtr& data) {
             if (is_process_finished) {
                 continue;
             }
+
+            // try reuse a slot released by ConsolidateRemoved
+            inner_id = this->reuse_released_inner_id(labels[j]);
+            if (inner_id != std::numeric_limits<InnerIdType>::max()) {
+                reused_ids.insert(inner_id);
+                inner_ids.emplace_back(inner_id, j);
+                continue;
+            }
         }
 
         {
@@ -253,17 +645,34 @@ HGraph::Add(const DatasetPtr& data) {
             std::scoped_lock label_lock(this->label_lookup_mutex_);
             level = this->get_random_level() - 1;
         }
+        bool is_reused = not reused_ids.empty() and reused_ids.count(inner_id) != 0;
+        if (is_reused) {
+            // the stale lists of a reused slot must be rewritten on every route graph it is in
+            std::shared_lock rlock(this->global_mutex_);
+            for (auto j = static_cast<int>(this->route_graphs_.size()) - 1; j > level; --j) {
+                if (this->route_graphs_[j]->GetNeighborSize(inner_id) != 0) {
+                    level = j;
+                    break;
+                }
+            }
+        }
         const auto* extra_info = extra_infos + local_idx * extra_info_size_;
         const AttributeSet* cur_attr_set = nullptr;
         if (attr_sets != nullptr) {
             cur_attr_set = attr_sets + local_idx;
         }
         if (this->build_pool_ != nullptr) {
-            auto future = this->build_pool_->GeneralEnqueue(
-                add_func, get_data(data, local_idx), level, inner_id, extra_info, cur_attr_set);
+            auto future = this->build_pool_->GeneralEnqueue(add_func,
+                                                            get_data(data, local_idx),
+                                                            level,
+                                                            inner_id,
+                                                            extra_info,
+                                                            cur_attr_set,
+                                                            is_reused);
             futures.emplace_back(std::move(future));
         } else {
-            add_func(get_data(data, local_idx), level, inner_id, extra_info, cur_attr_set);
+            add_func(
+                get_data(data, local_idx), level, inner_id, extra_info, cur_attr_set, is_reused);
         }
     }
     if (this->build_pool_ != nullptr) {
@@ -687,6 +1096,16 @@ HGraph::serialize_basic_info() const {
     jsonify_basic_info["max_capacity"].SetInt(this->max_capacity_.load());
     jsonify_basic_info["max_level"].SetInt(this->route_graphs_.size());
     jsonify_basic_info[INDEX_PARAM].SetString(this->create_param_ptr_->ToString());
+    if (not this->label_table_->released_ids_.empty()) {
+        const auto& released_ids = this->label_table_->released_ids_;
+        std::vector<InnerIdType> ids(released_ids.begin(), released_ids.end());
+        std::string released_str(reinterpret_cast<const char*>(ids.data()),
+                                 ids.size() * sizeof(InnerIdType));
+        jsonify_basic_info["released_ids"].SetString(base64_encode(released_str));
+    }
+    if (this->layout_ordered_) {
+        jsonify_basic_info["layout_ordered"].SetBool(true);
+    }
 
     return jsonify_basic_info;
 }
@@ -723,6 +1142,13 @@ HGraph::deserialize_basic_info(const JsonType& jsonify_basic_info) {
     for (int64_t i = 0; i < max_level; ++i) {
         this->route_graphs_.emplace_back(this->generate_one_route_graph());
     }
+    if (jsonify_basic_info.Contains("released_ids")) {
+        auto released_str = base64_decode(jsonify_basic_info["released_ids"].GetString());
+        const auto* ids = reinterpret_cast<const InnerIdType*>(released_str.data());
+        auto count = released_str.size() / sizeof(InnerIdType);
+        this->label_table_->released_ids_.insert(ids, ids + count);
+    }
+    FROM_JSON(jsonify_basic_info, layout_ordered, Bool);
     if (jsonify_basic_info.Contains(INDEX_PARAM)) {
         std::string index_param_string = jsonify_basic_info[INDEX_PARAM].GetString();
         HGraphParameterPtr index_param = std::make_shared<HGraphParameter>();
@@ -774,6 +1200,76 @@ HGraph::deserialize_label_info(StreamReader& reader) const {
 
 void
 HGraph::Serialize(StreamWriter& writer) const {
+    std::shared_lock rlock(this->global_mutex_);
+    if (this->need_layout_copy()) {
+        this->layout_copy()->serialize_impl(writer);
+        return;
+    }
+    this->serialize_impl(writer);
+}
+
+BinarySet
+HGraph::Serialize() const {
+    std::shared_lock rlock(this->global_mutex_);
+    if (this->need_layout_copy()) {
+        // one copy serves both the size pass and the write pass
+        return this->layout_copy()->Serialize();
+    }
+    SlowTaskTimer t(this->GetName() + " Serialize");
+    auto num_bytes = this->serialize_size_impl();
+    std::shared_ptr<int8_t[]> bin(new int8_t[num_bytes]);
+    BufferStreamWriter writer(reinterpret_cast<char*>(bin.get()));
+    this->serialize_impl(writer);
+    BinarySet bs;
+    bs.Set(this->GetName(), Binary{.data = bin, .size = num_bytes});
+    return bs;
+}
+
+uint64_t
+HGraph::CalSerializeSize() const {
+    std::shared_lock rlock(this->global_mutex_);
+    if (this->need_layout_copy()) {
+        return this->layout_copy()->serialize_size_impl();
+    }
+    return this->serialize_size_impl();
+}
+
+bool
+HGraph::need_layout_copy() const {
+    // a mutable index keeps its ids, only the serialized copy is laid out in graph order
+    return this->graph_layout_order_ != GraphLayoutOrder::NONE and not this->layout_ordered_ and
+           this->data_type_ != DataTypes::DATA_TYPE_SPARSE and this->delete_count_ == 0 and
+           this->total_count_ > 0;
+}
+
+std::shared_ptr<HGraph>
+HGraph::layout_copy() const {
+    Vector<InnerIdType> order(allocator_);
+    {
+        // the layout pass is as costly as the copy, reuse it until nodes are added
+        std::lock_guard lock(this->layout_order_cache_mutex_);
+        auto total_count = static_cast<int64_t>(this->total_count_.load());
+        if (this->layout_order_cache_count_ != total_count) {
+            this->layout_order_cache_ = this->compute_layout_order();
+            this->layout_order_cache_count_ = total_count;
+        }
+        order = this->layout_order_cache_;
+    }
+    auto relabeled = this->relabel_copy(order);
+    relabeled->layout_ordered_ = true;
+    return relabeled;
+}
+
+uint64_t
+HGraph::serialize_size_impl() const {
+    auto cal_size_func = [](uint64_t cursor, uint64_t size, void* buf) { return; };
+    WriteFuncStreamWriter writer(cal_size_func, 0);
+    this->serialize_impl(writer);
+    return writer.cursor_;
+}
+
+void
+HGraph::serialize_impl(StreamWriter& writer) const {
     if (this->ignore_reorder_) {
         this->use_reorder_ = false;
     }
@@ -926,7 +1422,7 @@ HGraph::GetMemoryUsageDetail() const {
     if (this->extra_info_size_ > 0 && this->extra_infos_ != nullptr) {
         memory_usage["extra_infos"].SetInt(this->extra_infos_->CalcSerializeSize());
     }
-    memory_usage["__total_size__"].SetInt(this->CalSerializeSize());
+    memory_usage["__total_size__"].SetInt(this->GetMemoryUsage());
     return memory_usage.Dump();
 }
 
@@ -996,14 +1492,43 @@ HGraph::GetMinAndMaxId() const {
     return {min_id, max_id};
 }
 
-void
-HGraph::add_one_point(const void* data, int level, InnerIdType inner_id) {
-    this->basic_flatten_codes_->InsertVector(data, inner_id);
-    if (use_reorder_) {
-        this->high_precise_codes_->InsertVector(data, inner_id);
+InnerIdType
+HGraph::reuse_released_inner_id(LabelType label) {
+    std::scoped_lock lock(this->add_mutex_, this->label_lookup_mutex_);
+    // duplicate records point at their first id, such a slot can't change hands
+    if (this->label_table_->released_ids_.empty() or this->label_table_->CompressDuplicateData()) {
+        return std::numeric_limits<InnerIdType>::max();
     }
-    if (create_new_raw_vector_) {
-        raw_vector_->InsertVector(data, inner_id);
+    for (const auto& id : this->label_table_->released_ids_) {
+        if (id == this->entry_point_id_) {
+            continue;
+        }
+        this->label_table_->ReuseReleasedId(id, label);
+        delete_count_--;
+        return id;
+    }
+    return std::numeric_limits<InnerIdType>::max();
+}
+
+void
+HGraph::add_one_point(const void* data, int level, InnerIdType inner_id, bool is_reused) {
+    if (is_reused) {
+        // a released slot is unreachable, so its codes can be overwritten in place
+        this->basic_flatten_codes_->UpdateVector(data, inner_id);
+        if (use_reorder_) {
+            this->high_precise_codes_->UpdateVector(data, inner_id);
+        }
+        if (create_new_raw_vector_) {
+            raw_vector_->UpdateVector(data, inner_id);
+        }
+    } else {
+        this->basic_flatten_codes_->InsertVector(data, inner_id);
+        if (use_reorder_) {
+            this->high_precise_codes_->InsertVector(data, inner_id);
+        }
+        if (create_new_raw_vector_) {
+            raw_vector_->InsertVector(data, inner_id);
+        }
     }
     std::unique_lock add_lock(add_mutex_);
     if (level >= static_cast<int>(this->route_graphs_.size()) || bottom_graph_->TotalCount() == 0) {
@@ -1041,9 +1566,10 @@ HGraph::graph_add_one(const void* data, int level, InnerIdType inner_id) {
     if (use_reorder_ and not build_by_base_) {
         flatten_codes = high_precise_codes_;
     }
+    const auto& search_codes = this->build_search_codes(flatten_codes);
     for (auto j = this->route_graphs_.size() - 1; j > level; --j) {
         result = search_one_graph(
-            data, route_graphs_[j], flatten_codes, param, (VisitedListPtr) nullptr, discard_stats);
+            data, route_graphs_[j], search_codes, param, (VisitedListPtr) nullptr, discard_stats);
         param.ep = result->Top().second;
     }
 
@@ -1053,7 +1579,7 @@ HGraph::graph_add_one(const void* data, int level, InnerIdType inner_id) {
     if (bottom_graph_->TotalCount() != 0) {
         result = search_one_graph(data,
                                   this->bottom_graph_,
-                                  flatten_codes,
+                                  search_codes,
                                   param,
                                   // to specify which overloaded function to call
                                   (VisitedListPtr) nullptr,
@@ -1063,6 +1589,7 @@ HGraph::graph_add_one(const void* data, int level, InnerIdType inner_id) {
             label_table_->SetDuplicateId(static_cast<InnerIdType>(param.duplicate_id), inner_id);
             return false;
         }
+        this->refine_build_candidates(inner_id, result, flatten_codes);
         mutually_connect_new_element(inner_id,
                                      result,
                                      this->bottom_graph_,
@@ -1078,11 +1605,12 @@ HGraph::graph_add_one(const void* data, int level, InnerIdType inner_id) {
         if (route_graphs_[j]->TotalCount() != 0) {
             result = search_one_graph(data,
                                       route_graphs_[j],
-                                      flatten_codes,
+                                      search_codes,
                                       param,
                                       // to specify which overloaded function to call
                                       (VisitedListPtr) nullptr,
                                       discard_stats);
+            this->refine_build_candidates(inner_id, result, flatten_codes);
             mutually_connect_new_element(inner_id,
                                          result,
                                          route_graphs_[j],
@@ -1252,6 +1780,7 @@ static const std::string HGRAPH_PARAMS_TEMPLATE =
         "{HGRAPH_USE_ENV_OPTIMIZER}": false,
         "{HGRAPH_IGNORE_REORDER_KEY}": false,
         "{HGRAPH_BUILD_BY_BASE_QUANTIZATION_KEY}": false,
+        "{HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION_KEY}": false,
         "{HGRAPH_USE_ATTRIBUTE_FILTER_KEY}": false,
         "{GRAPH_KEY}": {
             "{IO_PARAMS_KEY}": {
@@ -1281,6 +1810,7 @@ static const std::string HGRAPH_PARAMS_TEMPLATE =
                 "{SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE_KEY}": 0.05,
                 "{PCA_DIM_KEY}": 0,
                 "{RABITQ_QUANTIZATION_BITS_PER_DIM_QUERY_KEY}": 32,
+                "{RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY}": 1,
                 "{TQ_CHAIN_KEY}": "",
                 "nbits": 8,
                 "{PRODUCT_QUANTIZATION_DIM_KEY}": 1,
@@ -1325,6 +1855,10 @@ static const std::string HGRAPH_PARAMS_TEMPLATE =
         },
         "{HGRAPH_SUPPORT_DUPLICATE}": false,
         "{HGRAPH_SUPPORT_TOMBSTONE}": false,
+        "{CONSOLIDATE_REMOVE_RATIO_KEY}": 0.0,
+        "{GRAPH_LAYOUT_ORDER_KEY}": "{GRAPH_LAYOUT_ORDER_VALUE_NONE}",
+        "{HGRAPH_FUSE_CODES_WITH_GRAPH_KEY}": false,
+        "{HGRAPH_BUILD_PARTITION_COUNT_KEY}": 0,
         "{EF_CONSTRUCTION_KEY}": 400
     })";
 
@@ -1355,6 +1889,12 @@ HGraph::CheckAndMappingExternalParam(const JsonType& external_param,
                                                     HGRAPH_BUILD_BY_BASE_QUANTIZATION_KEY,
                                                 },
                                             },
+                                            {
+                                                HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION,
+                                                {
+                                                    HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION_KEY,
+                                                },
+                                            },
                                             {
                                                 USE_ATTRIBUTE_FILTER,
                                                 {
@@ -1576,6 +2116,14 @@ HGraph::CheckAndMappingExternalParam(const JsonType& external_param,
                                                     RABITQ_QUANTIZATION_BITS_PER_DIM_QUERY_KEY,
                                                 },
                                             },
+                                            {
+                                                RABITQ_BITS_PER_DIM_BASE,
+                                                {
+                                                    BASE_CODES_KEY,
+                                                    QUANTIZATION_PARAMS_KEY,
+                                                    RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY,
+                                                },
+                                            },
                                             {
                                                 HGRAPH_BASE_PQ_DIM,
                                                 {
@@ -1611,6 +2159,30 @@ HGraph::CheckAndMappingExternalParam(const JsonType& external_param,
                                                 {
                                                     SUPPORT_TOMBSTONE,
                                                 },
+                                            },
+                                            {
+                                                HGRAPH_CONSOLIDATE_REMOVE_RATIO,
+                                                {
+                                                    CONSOLIDATE_REMOVE_RATIO_KEY,
+                                                },
+                                            },
+                                            {
+                                                HGRAPH_GRAPH_LAYOUT_ORDER,
+                                                {
+                                                    GRAPH_LAYOUT_ORDER_KEY,
+                                                },
+                                            },
+                                            {
+                                                HGRAPH_FUSE_CODES_WITH_GRAPH,
+                                                {
+                                                    HGRAPH_FUSE_CODES_WITH_GRAPH_KEY,
+                                                },
+                                            },
+                                            {
+                                                HGRAPH_BUILD_PARTITION_COUNT,
+                                                {
+                                                    HGRAPH_BUILD_PARTITION_COUNT_KEY,
+                                                },
                                             }};
 
     std::string str = format_map(HGRAPH_PARAMS_TEMPLATE, DEFAULT_MAP);
@@ -1690,6 +2262,14 @@ HGraph::Remove(int64_t id) {
             }
             route_graphs_.pop_back();
         }
+        if (not find_new_ep) {
+            // flat graphs (e.g. vamana) hand the entry over to a bottom neighbor
+            Vector<InnerIdType> neighbors(allocator_);
+            bottom_graph_->GetNeighbors(this->entry_point_id_, neighbors);
+            if (not neighbors.empty()) {
+                this->entry_point_id_ = neighbors[0];
+            }
+        }
     }
     {
         {
@@ -1703,9 +2283,333 @@ HGraph::Remove(int64_t id) {
         this->label_table_->Remove(id);
         delete_count_++;
     }
+    if (this->consolidate_remove_ratio_ > 0.0F) {
+        uint64_t pending_count = 0;
+        uint64_t valid_count = 0;
+        {
+            std::shared_lock label_lock(this->label_lookup_mutex_);
+            auto released_count = this->label_table_->released_ids_.size();
+            pending_count = this->label_table_->deleted_ids_.size() - released_count;
+            valid_count = this->total_count_ - released_count;
+        }
+        if (static_cast<double>(pending_count) >=
+            this->consolidate_remove_ratio_ * static_cast<double>(valid_count)) {
+            this->ConsolidateRemoved();
+        }
+    }
     return true;
 }
 
+uint64_t
+HGraph::ConsolidateRemoved() {
+    std::scoped_lock consolidate_lock(this->consolidate_mutex_);
+    // removals bump node versions under the exclusive global lock, holding the shared one keeps
+    // the set of removed nodes stable while their in-edges are rewired
+    std::shared_lock rlock(this->global_mutex_);
+
+    UnorderedSet<InnerIdType> removed_ids(allocator_);
+    {
+        std::shared_lock label_lock(this->label_lookup_mutex_);
+        for (const auto& id : this->label_table_->deleted_ids_) {
+            if (not this->label_table_->IsReleased(id)) {
+                removed_ids.insert(id);
+            }
+        }
+    }
+    if (removed_ids.empty()) {
+        return 0;
+    }
+
+    auto flatten_codes = basic_flatten_codes_;
+    if (use_reorder_ and not build_by_base_) {
+        flatten_codes = high_precise_codes_;
+    }
+
+    Vector<InnerIdType> ids(this->total_count_, allocator_);
+    std::iota(ids.begin(), ids.end(), 0);
+    auto repaired_count =
+        this->repair_removed_neighbors(this->bottom_graph_, ids, removed_ids, flatten_codes);
+    for (auto& route_graph : this->route_graphs_) {
+        repaired_count += this->repair_removed_neighbors(
+            route_graph, route_graph->GetIds(), removed_ids, flatten_codes);
+    }
+
+    {
+        std::scoped_lock label_lock(this->label_lookup_mutex_);
+        for (const auto& id : removed_ids) {
+            this->label_table_->ReleaseRemovedId(id);
+        }
+    }
+    logger::debug("consolidate {} removed nodes, {} neighbor lists repaired",
+                  removed_ids.size(),
+                  repaired_count);
+    return removed_ids.size();
+}
+
+uint64_t
+HGraph::Compact() {
+    if (this->data_type_ == DataTypes::DATA_TYPE_SPARSE) {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                            "HGraph doesn't support Compact with sparse vectors");
+    }
+    // rewire the in-edges first, so that compaction only drops edges between removed nodes
+    this->ConsolidateRemoved();
+
+    std::scoped_lock add_lock(this->add_mutex_);
+    std::scoped_lock wlock(this->global_mutex_);
+    std::scoped_lock label_lock(this->label_lookup_mutex_);
+
+    auto total_count = static_cast<InnerIdType>(this->total_count_.load());
+    Vector<InnerIdType> new_to_old(allocator_);
+    new_to_old.reserve(total_count);
+    for (InnerIdType id = 0; id < total_count; ++id) {
+        if (not this->label_table_->IsRemoved(id)) {
+            new_to_old.emplace_back(id);
+        }
+    }
+    auto new_count = static_cast<InnerIdType>(new_to_old.size());
+    if (new_count == total_count) {
+        return 0;
+    }
+    this->take_relabeled(*this->relabel_copy(new_to_old));
+
+    logger::debug("compact hgraph from {} to {} nodes", total_count, new_count);
+    return total_count - new_count;
+}
+
+Vector<InnerIdType>
+HGraph::compute_layout_order() const {
+    auto total_count = static_cast<InnerIdType>(this->total_count_.load());
+    auto order = compute_graph_layout(
+        this->bottom_graph_, total_count, this->graph_layout_order_, allocator_);
+    // removed nodes are dropped, the layout of an index is always compact
+    if (this->delete_count_ > 0) {
+        auto valid_end = std::remove_if(order.begin(), order.end(), [&](InnerIdType id) {
+            return this->label_table_->IsRemoved(id);
+        });
+        order.erase(valid_end, order.end());
+    }
+    return order;
+}
+
+void
+HGraph::reorder_layout() {
+    if (this->delete_count_ > 0) {
+        this->ConsolidateRemoved();
+    }
+    std::scoped_lock add_lock(this->add_mutex_);
+    std::scoped_lock wlock(this->global_mutex_);
+    std::scoped_lock label_lock(this->label_lookup_mutex_);
+    if (this->total_count_ == 0) {
+        return;
+    }
+    this->take_relabeled(*this->relabel_copy(this->compute_layout_order()));
+    this->layout_ordered_ = true;
+    logger::debug("reorder hgraph layout of {} nodes", this->total_count_.load());
+}
+
+std::shared_ptr<HGraph>
+HGraph::relabel_copy(const Vector<InnerIdType>& new_to_old) const {
+    constexpr auto INVALID_ID = std::numeric_limits<InnerIdType>::max();
+    auto total_count = static_cast<InnerIdType>(this->total_count_.load());
+    auto new_count = static_cast<InnerIdType>(new_to_old.size());
+    Vector<InnerIdType> old_to_new(total_count, INVALID_ID, allocator_);
+    for (InnerIdType new_id = 0; new_id < new_count; ++new_id) {
+        old_to_new[new_to_old[new_id]] = new_id;
+    }
+
+    // copy the listed nodes into a freshly sized index sharing the trained models
+    auto common_param = this->common_param_;
+    common_param.thread_pool_ = this->build_pool_;
+    auto relabeled = std::make_shared<HGraph>(this->create_param_ptr_, common_param);
+    relabeled->SetBuildThreadsCount(this->build_thread_count_);
+    relabeled->resize(new_count);
+    relabeled->layout_ordered_ = this->layout_ordered_;
+
+    this->basic_flatten_codes_->ExportModel(relabeled->basic_flatten_codes_);
+    relabeled->basic_flatten_codes_->CopyOther(this->basic_flatten_codes_, new_to_old);
+    if (use_reorder_) {
+        this->high_precise_codes_->ExportModel(relabeled->high_precise_codes_);
+        relabeled->high_precise_codes_->CopyOther(this->high_precise_codes_, new_to_old);
+    }
+    if (create_new_raw_vector_) {
+        this->raw_vector_->ExportModel(relabeled->raw_vector_);
+        relabeled->raw_vector_->CopyOther(this->raw_vector_, new_to_old);
+    }
+
+    Vector<InnerIdType> neighbors(allocator_);
+    auto copy_neighbors = [&](const GraphInterfacePtr& from,
+                              const GraphInterfacePtr& to,
+                              InnerIdType old_id) -> void {
+        from->GetNeighbors(old_id, neighbors);
+        auto valid_end = std::remove_if(neighbors.begin(), neighbors.end(), [&](InnerIdType nb) {
+            return old_to_new[nb] == INVALID_ID;
+        });
+        neighbors.erase(valid_end, neighbors.end());
+        for (auto& nb : neighbors) {
+            nb = old_to_new[nb];
+        }
+        to->InsertNeighborsById(old_to_new[old_id], neighbors);
+    };
+    for (const auto& old_id : new_to_old) {
+        copy_neighbors(this->bottom_graph_, relabeled->bottom_graph_, old_id);
+    }
+    for (const auto& route_graph : this->route_graphs_) {
+        auto new_route_graph = relabeled->generate_one_route_graph();
+        for (const auto& old_id : route_graph->GetIds()) {
+            if (old_to_new[old_id] != INVALID_ID) {
+                copy_neighbors(route_graph, new_route_graph, old_id);
+            }
+        }
+        relabeled->route_graphs_.emplace_back(new_route_graph);
+    }
+
+    auto& new_label_table = relabeled->label_table_;
+    for (InnerIdType new_id = 0; new_id < new_count; ++new_id) {
+        new_label_table->Insert(new_id, this->label_table_->GetLabelById(new_to_old[new_id]));
+    }
+    if (this->label_table_->CompressDuplicateData()) {
+        for (InnerIdType new_id = 0; new_id < new_count; ++new_id) {
+            for (const auto& dup_id : this->label_table_->GetDuplicateId(new_to_old[new_id])) {
+                if (old_to_new[dup_id] != INVALID_ID) {
+                    new_label_table->SetDuplicateId(new_id, old_to_new[dup_id]);
+                }
+            }
+        }
+    }
+
+    if (this->extra_infos_ != nullptr) {
+        Vector<char> extra_info(this->extra_info_size_, allocator_);
+        for (InnerIdType new_id = 0; new_id < new_count; ++new_id) {
+            this->extra_infos_->GetExtraInfoById(new_to_old[new_id], extra_info.data());
+            relabeled->extra_infos_->InsertExtraInfo(extra_info.data(), new_id);
+        }
+    }
+    if (this->use_attribute_filter_ and this->attr_filter_index_ != nullptr) {
+        for (InnerIdType new_id = 0; new_id < new_count; ++new_id) {
+            AttributeSet attr_set;
+            this->attr_filter_index_->GetAttribute(0, new_to_old[new_id], &attr_set);
+            relabeled->attr_filter_index_->Insert(attr_set, new_id);
+            for (auto* attr : attr_set.attrs_) {
+                delete attr;
+            }
+        }
+    }
+
+    // the entry point is kept unless every route graph has been emptied by removals
+    auto entry_point_id = INVALID_ID;
+    if (this->entry_point_id_ < total_count) {
+        entry_point_id = old_to_new[this->entry_point_id_];
+    }
+    if (entry_point_id == INVALID_ID) {
+        relabeled->route_graphs_.clear();
+        entry_point_id = 0;
+    }
+    relabeled->entry_point_id_ = entry_point_id;
+    relabeled->total_count_ = new_count;
+    return relabeled;
+}
+
+void
+HGraph::take_relabeled(HGraph& other) {
+    this->basic_flatten_codes_ = other.basic_flatten_codes_;
+    this->high_precise_codes_ = other.high_precise_codes_;
+    this->raw_vector_ = other.raw_vector_;
+    this->reorder_ = other.reorder_;
+    this->bottom_graph_ = other.bottom_graph_;
+    this->route_graphs_ = other.route_graphs_;
+    this->label_table_ = other.label_table_;
+    this->extra_infos_ = other.extra_infos_;
+    this->attr_filter_index_ = other.attr_filter_index_;
+    this->pool_ = other.pool_;
+    this->max_capacity_.store(other.max_capacity_.load());
+    this->neighbors_mutex_->Resize(this->max_capacity_);
+    this->entry_point_id_ = other.entry_point_id_;
+    this->total_count_ = other.total_count_.load();
+    this->delete_count_ = 0;
+}
+
+uint64_t
+HGraph::repair_removed_neighbors(const GraphInterfacePtr& graph,
+                                 const Vector<InnerIdType>& ids,
+                                 const UnorderedSet<InnerIdType>& removed_ids,
+                                 const FlattenInterfacePtr& flatten_codes) {
+    std::atomic<uint64_t> repaired_count{0};
+    auto is_dead = [&](InnerIdType id) -> bool {
+        return removed_ids.count(id) != 0 or this->label_table_->IsReleased(id);
+    };
+
+    auto repair_func = [&](uint64_t start, uint64_t end) -> void {
+        Vector<InnerIdType> raw_neighbors(allocator_);
+        Vector<InnerIdType> neighbors(allocator_);
+        Vector<InnerIdType> candidates(allocator_);
+        for (uint64_t i = start; i < end; ++i) {
+            auto id = ids[i];
+            if (is_dead(id)) {
+                continue;
+            }
+            graph->GetNeighborsWithRemoved(id, raw_neighbors);
+            bool has_removed = std::any_of(raw_neighbors.begin(),
+                                           raw_neighbors.end(),
+                                           [&](InnerIdType nb) { return removed_ids.count(nb); });
+            if (not has_removed) {
+                continue;
+            }
+
+            // the candidates are the live neighbors plus the live out-neighbors of every removed
+            // neighbor, GetNeighbors() already drops nodes whose version has been bumped
+            candidates.clear();
+            graph->GetNeighbors(id, neighbors);
+            candidates.insert(candidates.end(), neighbors.begin(), neighbors.end());
+            for (const auto& nb : raw_neighbors) {
+                if (removed_ids.count(nb) == 0) {
+                    continue;
+                }
+                graph->GetNeighbors(nb, neighbors);
+                candidates.insert(candidates.end(), neighbors.begin(), neighbors.end());
+            }
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+            auto edges = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+            for (const auto& candidate : candidates) {
+                if (candidate == id or is_dead(candidate)) {
+                    continue;
+                }
+                edges->Push(flatten_codes->ComputePairVectors(id, candidate), candidate);
+            }
+            select_edges_by_heuristic(
+                edges, graph->MaximumDegree(), flatten_codes, allocator_, alpha_);
+
+            neighbors.clear();
+            while (not edges->Empty()) {
+                neighbors.emplace_back(edges->Top().second);
+                edges->Pop();
+            }
+            {
+                LockGuard lock(neighbors_mutex_, id);
+                graph->InsertNeighborsById(id, neighbors);
+            }
+            repaired_count++;
+        }
+    };
+
+    constexpr uint64_t block_size = 1024;
+    if (this->build_pool_ == nullptr) {
+        repair_func(0, ids.size());
+        return repaired_count;
+    }
+    std::vector<std::future<void>> futures;
+    for (uint64_t start = 0; start < ids.size(); start += block_size) {
+        auto end = std::min(start + block_size, static_cast<uint64_t>(ids.size()));
+        futures.emplace_back(this->build_pool_->GeneralEnqueue(repair_func, start, end));
+    }
+    for (auto& future : futures) {
+        future.get();
+    }
+    return repaired_count;
+}
+
 void
 HGraph::recover_remove(int64_t id) {
     // note:
@@ -1803,53 +2707,226 @@ HGraph::Merge(const std::vector<MergeUnit>& merge_units) {
     if (max_capacity_ < total_count) {
         this->resize(total_count);
     }
+    Vector<MergeShard> shards(allocator_);
+    if (total_count_ > 0) {
+        shards.push_back({0,
+                          static_cast<InnerIdType>(total_count_),
+                          this->entry_point_id_,
+                          this->route_graphs_.size()});
+    }
     for (const auto& merge_unit : merge_units) {
         const auto other_index = std::dynamic_pointer_cast<HGraph>(
             std::dynamic_pointer_cast<IndexImpl<HGraph>>(merge_unit.index)->GetInnerIndex());
-        if (total_count_ == 0) {
-            this->entry_point_id_ = other_index->entry_point_id_;
-        }
-        basic_flatten_codes_->MergeOther(other_index->basic_flatten_codes_, this->total_count_);
+        auto bias = static_cast<InnerIdType>(this->total_count_);
+        auto other_count = static_cast<InnerIdType>(other_index->GetNumElements());
+        if (other_count > 0) {
+            shards.push_back({bias,
+                              bias + other_count,
+                              other_index->entry_point_id_ + bias,
+                              other_index->route_graphs_.size()});
+        }
+        basic_flatten_codes_->MergeOther(other_index->basic_flatten_codes_, bias);
         label_table_->MergeOther(other_index->label_table_, merge_unit.id_map_func);
         if (use_reorder_) {
-            high_precise_codes_->MergeOther(other_index->high_precise_codes_, this->total_count_);
+            high_precise_codes_->MergeOther(other_index->high_precise_codes_, bias);
         }
-        bottom_graph_->MergeOther(other_index->bottom_graph_, this->total_count_);
-        if (route_graphs_.size() < other_index->route_graphs_.size()) {
+        bottom_graph_->MergeOther(other_index->bottom_graph_, bias);
+        while (route_graphs_.size() < other_index->route_graphs_.size()) {
             route_graphs_.push_back(this->generate_one_route_graph());
         }
         for (int j = 0; j < other_index->route_graphs_.size(); ++j) {
-            route_graphs_[j]->MergeOther(other_index->route_graphs_[j], this->total_count_);
+            route_graphs_[j]->MergeOther(other_index->route_graphs_[j], bias);
         }
-        this->total_count_ += other_index->GetNumElements();
+        this->total_count_ += other_count;
     }
-    if (this->odescent_param_ == nullptr) {
-        odescent_param_ = std::make_shared<ODescentParameter>();
+    if (shards.empty()) {
+        return;
     }
 
+    // every shard is still a disconnected component here: its own edges are kept as they are
+    // and only the cross-shard candidates of its boundary nodes are searched and pruned in
     auto build_data = (use_reorder_ and not build_by_base_) ? this->high_precise_codes_
                                                             : this->basic_flatten_codes_;
-    for (InnerIdType inner_id = 0; inner_id < this->total_count_; ++inner_id) {
-        Vector<InnerIdType> neighbors(this->allocator_);
-        this->bottom_graph_->GetNeighbors(inner_id, neighbors);
-        neighbors.resize(neighbors.size() / 2);
-        this->bottom_graph_->InsertNeighborsById(inner_id, neighbors);
+    if (shards.size() > 1) {
+        // the upper levels must stay disconnected while a lower level is linked, because the
+        // descent towards a shard walks through them
+        auto linked_count = this->link_merged_shards(-1, shards, build_data);
+        for (int64_t level = 0; level < static_cast<int64_t>(route_graphs_.size()); ++level) {
+            linked_count += this->link_merged_shards(level, shards, build_data);
+        }
+        logger::debug(
+            "merge {} shards, {} nodes linked across shards", shards.size(), linked_count);
     }
-    {
-        odescent_param_->max_degree = bottom_graph_->MaximumDegree();
-        ODescent odescent_builder(odescent_param_, build_data, allocator_, this->build_pool_.get());
-        odescent_builder.Build(bottom_graph_);
-        odescent_builder.SaveGraph(bottom_graph_);
+    for (const auto& shard : shards) {
+        if (shard.route_level_count == route_graphs_.size()) {
+            this->entry_point_id_ = shard.entry_point;
+            break;
+        }
     }
-    for (auto& graph : route_graphs_) {
-        odescent_param_->max_degree = bottom_graph_->MaximumDegree() / 2;
-        ODescent sparse_odescent_builder(
-            odescent_param_, build_data, allocator_, this->build_pool_.get());
-        auto ids = graph->GetIds();
-        sparse_odescent_builder.Build(ids, graph);
-        sparse_odescent_builder.SaveGraph(graph);
-        this->entry_point_id_ = ids.back();
+}
+
+DistHeapPtr
+HGraph::search_by_pair_distance(InnerIdType query_id,
+                                const GraphInterfacePtr& graph,
+                                InnerIdType ep,
+                                uint64_t ef,
+                                const FlattenInterfacePtr& flatten) const {
+    auto results = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+    auto candidates = std::make_shared<StandardHeap<false, false>>(allocator_, -1);
+    auto vt = this->pool_->TakeOne();
+    Vector<InnerIdType> neighbors(allocator_);
+
+    auto ep_dist = flatten->ComputePairVectors(query_id, ep);
+    vt->Set(ep);
+    results->Push(ep_dist, ep);
+    candidates->Push(ep_dist, ep);
+    while (not candidates->Empty()) {
+        auto [cur_dist, cur_id] = candidates->Top();
+        if (results->Size() >= ef and cur_dist > results->Top().first) {
+            break;
+        }
+        candidates->Pop();
+        {
+            SharedLock lock(neighbors_mutex_, cur_id);
+            graph->GetNeighbors(cur_id, neighbors);
+        }
+        for (const auto& neighbor : neighbors) {
+            if (vt->Get(neighbor)) {
+                continue;
+            }
+            vt->Set(neighbor);
+            auto dist = flatten->ComputePairVectors(query_id, neighbor);
+            if (results->Size() < ef or dist < results->Top().first) {
+                candidates->Push(dist, neighbor);
+                results->Push(dist, neighbor);
+                if (results->Size() > ef) {
+                    results->Pop();
+                }
+            }
+        }
     }
+    this->pool_->ReturnOne(vt);
+    return results;
+}
+
+void
+HGraph::refine_build_candidates(InnerIdType id,
+                                DistHeapPtr& candidates,
+                                const FlattenInterfacePtr& flatten) const {
+    if (not this->build_search_by_base_) {
+        return;
+    }
+    auto refined = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+    while (not candidates->Empty()) {
+        auto candidate = candidates->Top().second;
+        refined->Push(flatten->ComputePairVectors(id, candidate), candidate);
+        candidates->Pop();
+    }
+    candidates = refined;
+}
+
+uint64_t
+HGraph::link_merged_shards(int64_t level,
+                           const Vector<MergeShard>& shards,
+                           const FlattenInterfacePtr& flatten) {
+    const auto& graph = level < 0 ? this->bottom_graph_ : this->route_graphs_[level];
+    Vector<InnerIdType> ids(allocator_);
+    if (level < 0) {
+        ids.resize(this->total_count_);
+        std::iota(ids.begin(), ids.end(), 0);
+    } else {
+        ids = graph->GetIds();
+    }
+    auto shard_of = [&](InnerIdType id) -> uint64_t {
+        auto iter = std::upper_bound(
+            shards.begin(), shards.end(), id, [](InnerIdType value, const MergeShard& shard) {
+                return value < shard.begin;
+            });
+        return static_cast<uint64_t>(iter - shards.begin()) - 1;
+    };
+
+    // the new neighbor lists are written only after all of them are computed, so that every
+    // search below walks the shards as they were before the merge
+    Vector<Vector<InnerIdType>> linked(ids.size(), Vector<InnerIdType>(allocator_), allocator_);
+    std::atomic<uint64_t> linked_count{0};
+    const auto& search_flatten = this->build_search_codes(flatten);
+    auto link_func = [&](uint64_t start, uint64_t end) -> void {
+        Vector<InnerIdType> neighbors(allocator_);
+        for (uint64_t i = start; i < end; ++i) {
+            auto id = ids[i];
+            auto self_shard = shard_of(id);
+            graph->GetNeighbors(id, neighbors);
+            auto edges = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+            for (const auto& neighbor : neighbors) {
+                edges->Push(flatten->ComputePairVectors(id, neighbor), neighbor);
+            }
+            // a node is on the boundary of another shard when that shard holds a point closer
+            // than its farthest edge, the other nodes keep their edges untouched
+            auto threshold = edges->Empty() ? std::numeric_limits<float>::max()
+                                            : edges->Top().first;
+            bool is_boundary = false;
+            for (uint64_t k = 0; k < shards.size(); ++k) {
+                const auto& shard = shards[k];
+                if (k == self_shard or static_cast<int64_t>(shard.route_level_count) <= level) {
+                    continue;
+                }
+                auto ep = shard.entry_point;
+                for (auto j = static_cast<int64_t>(shard.route_level_count) - 1; j > level; --j) {
+                    auto route_result =
+                        search_by_pair_distance(id, route_graphs_[j], ep, 1, search_flatten);
+                    ep = route_result->Top().second;
+                }
+                auto nearest = search_by_pair_distance(id, graph, ep, 1, search_flatten);
+                this->refine_build_candidates(id, nearest, flatten);
+                if (nearest->Top().first >= threshold) {
+                    continue;
+                }
+                is_boundary = true;
+                // no more than a full neighbor list of candidates can survive the pruning
+                auto candidates = search_by_pair_distance(
+                    id, graph, nearest->Top().second, graph->MaximumDegree(), search_flatten);
+                this->refine_build_candidates(id, candidates, flatten);
+                while (not candidates->Empty()) {
+                    const auto& candidate = candidates->Top();
+                    edges->Push(candidate.first, candidate.second);
+                    candidates->Pop();
+                }
+            }
+            if (not is_boundary) {
+                continue;
+            }
+            select_edges_by_heuristic(edges, graph->MaximumDegree(), flatten, allocator_, alpha_);
+            while (edges->Size() > graph->MaximumDegree()) {
+                edges->Pop();
+            }
+            auto& result = linked[i];
+            while (not edges->Empty()) {
+                result.emplace_back(edges->Top().second);
+                edges->Pop();
+            }
+            linked_count++;
+        }
+    };
+
+    constexpr uint64_t block_size = 1024;
+    if (this->build_pool_ == nullptr) {
+        link_func(0, ids.size());
+    } else {
+        std::vector<std::future<void>> futures;
+        for (uint64_t start = 0; start < ids.size(); start += block_size) {
+            auto end = std::min(start + block_size, static_cast<uint64_t>(ids.size()));
+            futures.emplace_back(this->build_pool_->GeneralEnqueue(link_func, start, end));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
+    for (uint64_t i = 0; i < ids.size(); ++i) {
+        if (not linked[i].empty()) {
+            graph->InsertNeighborsById(ids[i], linked[i]);
+        }
+    }
+    return linked_count;
 }
 
 void
@@ -1865,6 +2942,10 @@ HGraph::SetImmutable() {
     if (this->immutable_) {
         return;
     }
+    if (this->graph_layout_order_ != GraphLayoutOrder::NONE and not this->layout_ordered_ and
+        this->data_type_ != DataTypes::DATA_TYPE_SPARSE) {
+        this->reorder_layout();
+    }
     std::scoped_lock<std::shared_mutex> wlock(this->global_mutex_);
     this->neighbors_mutex_.reset();
     this->neighbors_mutex_ = std::make_shared<EmptyMutex>();
@@ -26,6 +26,7 @@
 #include "datacell/sparse_graph_datacell_parameter.h"
 #include "hgraph_parameter.h"
 #include "impl/basic_optimizer.h"
+#include "impl/graph_layout.h"
 #include "impl/heap/distance_heap.h"
 #include "impl/reorder/flatten_reorder.h"
 #include "impl/searcher/basic_searcher.h"
@@ -74,6 +75,12 @@ public:
     DatasetPtr
     CalDistanceById(const float* query, const int64_t* ids, int64_t count) const override;
 
+    uint64_t
+    Compact() override;
+
+    uint64_t
+    ConsolidateRemoved() override;
+
     void
     Deserialize(StreamReader& reader) override;
 
@@ -91,7 +98,9 @@ public:
 
     int64_t
     GetMemoryUsage() const override {
-        return static_cast<int64_t>(this->CalSerializeSize());
+        // the live index, not the laid out copy that Serialize writes
+        std::shared_lock rlock(this->global_mutex_);
+        return static_cast<int64_t>(this->serialize_size_impl());
     }
 
     std::string
@@ -172,9 +181,17 @@ public:
     bool
     Remove(int64_t id) override;
 
+    using InnerIndexInterface::Serialize;
+
     void
     Serialize(StreamWriter& writer) const override;
 
+    [[nodiscard]] BinarySet
+    Serialize() const override;
+
+    uint64_t
+    CalSerializeSize() const override;
+
     void
     SetBuildThreadsCount(uint64_t count) {
         this->build_thread_count_ = count;
@@ -219,6 +236,9 @@ private:
 
     int
     get_random_level() {
+        if (mult_ == 0.0) {
+            return 0;
+        }
         std::uniform_real_distribution<double> distribution(0.0, 1.0);
         double r = -log(distribution(level_generator_)) * mult_;
         return static_cast<int>(r);
@@ -236,11 +256,42 @@ private:
         return ret;
     }
 
+    InnerIdType
+    reuse_released_inner_id(LabelType label);
+
+    void
+    parallel_run(int64_t count, const std::function<void(int64_t, int64_t)>& func);
+
     std::vector<int64_t>
     build_by_odescent(const DatasetPtr& data);
 
+    // inserts the labels and codes of the points with new labels without any edge, returns the
+    // input position of every inserted point, the i-th of them got inner_ids[i]
+    Vector<int64_t>
+    insert_without_graph(const DatasetPtr& data,
+                         std::vector<int64_t>& failed_ids,
+                         Vector<InnerIdType>& inner_ids,
+                         Vector<Vector<InnerIdType>>& route_graph_ids);
+
+    void
+    build_route_graphs_by_odescent(const Vector<Vector<InnerIdType>>& route_graph_ids,
+                                   const FlattenInterfacePtr& build_data);
+
+    std::vector<int64_t>
+    build_by_partition(const DatasetPtr& data);
+
+    std::vector<int64_t>
+    build_by_vamana(const DatasetPtr& data);
+
+    // links from -> to in the bottom graph, a full list is pruned again with alpha
+    void
+    add_back_edge(InnerIdType from,
+                  InnerIdType to,
+                  const FlattenInterfacePtr& flatten,
+                  float alpha);
+
     void
-    add_one_point(const void* data, int level, InnerIdType id);
+    add_one_point(const void* data, int level, InnerIdType id, bool is_reused);
 
     bool
     graph_add_one(const void* data, int level, InnerIdType inner_id);
@@ -303,6 +354,70 @@ private:
     void
     recover_remove(int64_t id);
 
+    uint64_t
+    repair_removed_neighbors(const GraphInterfacePtr& graph,
+                             const Vector<InnerIdType>& ids,
+                             const UnorderedSet<InnerIdType>& removed_ids,
+                             const FlattenInterfacePtr& flatten_codes);
+
+    // a contiguous id range [begin, end) that came from one index during Merge()
+    struct MergeShard {
+        InnerIdType begin;
+        InnerIdType end;
+        InnerIdType entry_point;
+        uint64_t route_level_count;
+    };
+
+    // the codes to generate the build candidates with, the pruning always uses build_data
+    const FlattenInterfacePtr&
+    build_search_codes(const FlattenInterfacePtr& build_data) const {
+        return this->build_search_by_base_ ? this->basic_flatten_codes_ : build_data;
+    }
+
+    // recomputes the distances of candidates found on the base codes with the build codes
+    void
+    refine_build_candidates(InnerIdType id,
+                            DistHeapPtr& candidates,
+                            const FlattenInterfacePtr& flatten) const;
+
+    DistHeapPtr
+    search_by_pair_distance(InnerIdType query_id,
+                            const GraphInterfacePtr& graph,
+                            InnerIdType ep,
+                            uint64_t ef,
+                            const FlattenInterfacePtr& flatten) const;
+
+    uint64_t
+    link_merged_shards(int64_t level,
+                       const Vector<MergeShard>& shards,
+                       const FlattenInterfacePtr& flatten);
+
+    Vector<InnerIdType>
+    compute_layout_order() const;
+
+    bool
+    need_layout_copy() const;
+
+    // a copy laid out in graph_layout_order_, the caller holds global_mutex_
+    std::shared_ptr<HGraph>
+    layout_copy() const;
+
+    void
+    serialize_impl(StreamWriter& writer) const;
+
+    uint64_t
+    serialize_size_impl() const;
+
+    void
+    reorder_layout();
+
+    // copies the nodes new_to_old[i] into a new index as node i, the edges to others are dropped
+    std::shared_ptr<HGraph>
+    relabel_copy(const Vector<InnerIdType>& new_to_old) const;
+
+    void
+    take_relabeled(HGraph& other);
+
     bool
     try_recover_tombstone(const DatasetPtr& data, std::vector<int64_t>& failed_ids);
 
@@ -335,6 +450,7 @@ private:
     bool use_elp_optimizer_{false};
     bool ignore_reorder_{false};
     bool build_by_base_{false};
+    bool build_search_by_base_{false};
 
     BasicSearcherPtr searcher_;
     ParallelSearcherPtr parallel_searcher_;
@@ -367,6 +483,17 @@ private:
 
     std::atomic<int64_t> delete_count_{0};
 
+    float consolidate_remove_ratio_{0.0F};
+    std::mutex consolidate_mutex_;
+
+    GraphLayoutOrder graph_layout_order_{GraphLayoutOrder::NONE};
+    uint64_t build_partition_count_{0};
+    bool layout_ordered_{false};
+    // layout order of the last serialized copy, valid while total_count_ is unchanged
+    mutable Vector<InnerIdType> layout_order_cache_;
+    mutable int64_t layout_order_cache_count_{-1};
+    mutable std::mutex layout_order_cache_mutex_;
+
     std::shared_ptr<Optimizer<BasicSearcher>> optimizer_;
 
     bool create_new_raw_vector_{false};
@@ -375,5 +502,7 @@ private:
     ReorderInterfacePtr reorder_{nullptr};
 
     bool use_old_serial_format_{false};
+
+    IndexCommonParam common_param_;
 };
 }  // namespace vsag
@@ -21,6 +21,7 @@
 #include "datacell/graph_interface_parameter.h"
 #include "datacell/sparse_graph_datacell_parameter.h"
 #include "datacell/sparse_vector_datacell_parameter.h"
+#include "impl/graph_layout.h"
 #include "impl/odescent/odescent_graph_parameter.h"
 #include "inner_string_params.h"
 #include "vsag/constants.h"
@@ -50,6 +51,11 @@ HGraphParameter::FromJson(const JsonType& json) {
         this->build_by_base = json[HGRAPH_BUILD_BY_BASE_QUANTIZATION_KEY].GetBool();
     }
 
+    if (json.Contains(HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION_KEY)) {
+        this->build_search_by_base =
+            json[HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION_KEY].GetBool();
+    }
+
     CHECK_ARGUMENT(json.Contains(BASE_CODES_KEY),
                    fmt::format("hgraph parameters must contains {}", BASE_CODES_KEY));
     const auto& base_codes_json = json[BASE_CODES_KEY];
@@ -112,6 +118,14 @@ HGraphParameter::FromJson(const JsonType& json) {
 
     if (graph_json.Contains(GRAPH_TYPE_KEY)) {
         graph_type = graph_json[GRAPH_TYPE_KEY].GetString();
+        CHECK_ARGUMENT(graph_type == GRAPH_TYPE_VALUE_NSW or
+                           graph_type == GRAPH_TYPE_VALUE_ODESCENT or
+                           graph_type == GRAPH_TYPE_VALUE_VAMANA,
+                       fmt::format("invalid graph_type: {}", graph_type));
+        CHECK_ARGUMENT(graph_type != GRAPH_TYPE_VALUE_VAMANA or
+                           this->data_type == DataTypes::DATA_TYPE_FLOAT,
+                       fmt::format("graph_type {} only supports float32 data",
+                                   GRAPH_TYPE_VALUE_VAMANA));
         if (graph_type == GRAPH_TYPE_VALUE_ODESCENT) {
             odescent_param = std::make_shared<ODescentParameter>();
             odescent_param->FromJson(graph_json);
@@ -124,6 +138,35 @@ HGraphParameter::FromJson(const JsonType& json) {
     if (json.Contains(SUPPORT_TOMBSTONE)) {
         this->support_tombstone = json[SUPPORT_TOMBSTONE].GetBool();
     }
+    if (json.Contains(CONSOLIDATE_REMOVE_RATIO_KEY)) {
+        this->consolidate_remove_ratio = json[CONSOLIDATE_REMOVE_RATIO_KEY].GetFloat();
+        CHECK_ARGUMENT(this->consolidate_remove_ratio >= 0.0F and
+                           this->consolidate_remove_ratio <= 1.0F,
+                       fmt::format("{} must be in [0, 1], got {}",
+                                   CONSOLIDATE_REMOVE_RATIO_KEY,
+                                   this->consolidate_remove_ratio));
+    }
+    if (json.Contains(GRAPH_LAYOUT_ORDER_KEY)) {
+        this->graph_layout_order = json[GRAPH_LAYOUT_ORDER_KEY].GetString();
+        get_graph_layout_order(this->graph_layout_order);
+    }
+    if (json.Contains(HGRAPH_FUSE_CODES_WITH_GRAPH_KEY)) {
+        this->fuse_codes_with_graph = json[HGRAPH_FUSE_CODES_WITH_GRAPH_KEY].GetBool();
+    }
+    if (this->fuse_codes_with_graph) {
+        CHECK_ARGUMENT(graph_storage_type == GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_FLAT and
+                           this->base_codes_param->name == FLATTEN_DATA_CELL,
+                       fmt::format("{} requires flat graph storage and flatten base codes",
+                                   HGRAPH_FUSE_CODES_WITH_GRAPH_KEY));
+        this->base_codes_param->fused_graph_param = this->bottom_graph_param;
+    }
+    if (json.Contains(HGRAPH_BUILD_PARTITION_COUNT_KEY)) {
+        this->build_partition_count = json[HGRAPH_BUILD_PARTITION_COUNT_KEY].GetInt();
+        CHECK_ARGUMENT(this->build_partition_count <= 1 or
+                           this->data_type == DataTypes::DATA_TYPE_FLOAT,
+                       fmt::format("{} only supports float32 data",
+                                   HGRAPH_BUILD_PARTITION_COUNT_KEY));
+    }
 }
 
 JsonType
@@ -137,6 +180,10 @@ HGraphParameter::ToJson() const {
     json[EF_CONSTRUCTION_KEY].SetInt(this->ef_construction);
     json[ALPHA_KEY].SetFloat(this->alpha);
     json[SUPPORT_DUPLICATE].SetBool(this->support_duplicate);
+    json[CONSOLIDATE_REMOVE_RATIO_KEY].SetFloat(this->consolidate_remove_ratio);
+    json[GRAPH_LAYOUT_ORDER_KEY].SetString(this->graph_layout_order);
+    json[HGRAPH_FUSE_CODES_WITH_GRAPH_KEY].SetBool(this->fuse_codes_with_graph);
+    json[HGRAPH_BUILD_PARTITION_COUNT_KEY].SetInt(this->build_partition_count);
     return json;
 }
 
@@ -178,6 +225,11 @@ HGraphParameter::CheckCompatibility(const ParamPtr& other) const {
         logger::error("HGraphParameter::CheckCompatibility: support_duplicate must be the same");
         return false;
     }
+    if (fuse_codes_with_graph != hgraph_param->fuse_codes_with_graph) {
+        logger::error(
+            "HGraphParameter::CheckCompatibility: fuse_codes_with_graph must be the same");
+        return false;
+    }
     return true;
 }
 
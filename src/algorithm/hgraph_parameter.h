@@ -56,6 +56,8 @@ public:
     bool use_elp_optimizer{false};
     bool ignore_reorder{false};
     bool build_by_base{false};
+    // generate the build candidates on the base codes, prune with the precise codes
+    bool build_search_by_base{false};
 
     uint64_t ef_construction{400};
     float alpha{1.0F};
@@ -63,6 +65,18 @@ public:
     bool support_duplicate{false};
     bool support_tombstone{false};
 
+    // consolidate removed nodes once they exceed this ratio of the index, 0 means manual only
+    float consolidate_remove_ratio{0.0F};
+
+    // relabel the nodes in this graph order on SetImmutable and on serialization
+    std::string graph_layout_order{GRAPH_LAYOUT_ORDER_VALUE_NONE};
+
+    // store the base codes and the bottom neighbor lists in one record per node
+    bool fuse_codes_with_graph{false};
+
+    // build from this many overlapping shards and stitch them together, 0 means a single build
+    uint64_t build_partition_count{0};
+
     DataTypes data_type{DataTypes::DATA_TYPE_FLOAT};
 
     std::string name;
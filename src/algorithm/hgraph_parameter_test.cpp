@@ -54,6 +54,10 @@ struct HGraphDefaultParam {
     bool use_attribute_filter = false;
     bool support_duplicate = false;
     bool use_reorder = true;
+    float consolidate_remove_ratio = 0.0F;
+    std::string graph_layout_order = "none";
+    bool fuse_codes_with_graph = false;
+    int build_partition_count = 0;
 };
 
 std::string
@@ -107,7 +111,11 @@ generate_hgraph_param(const HGraphDefaultParam& param) {
         "type": "hgraph",
         "use_attribute_filter": {},
         "use_reorder": {},
-        "support_duplicate": {}
+        "support_duplicate": {},
+        "consolidate_remove_ratio": {},
+        "graph_layout_order": "{}",
+        "fuse_codes_with_graph": {},
+        "build_partition_count": {}
     }})";
 
     return fmt::format(param_str,
@@ -122,7 +130,11 @@ generate_hgraph_param(const HGraphDefaultParam& param) {
                        param.precise_codes_quantization_type,
                        param.use_attribute_filter,
                        param.use_reorder,
-                       param.support_duplicate);
+                       param.support_duplicate,
+                       param.consolidate_remove_ratio,
+                       param.graph_layout_order,
+                       param.fuse_codes_with_graph,
+                       param.build_partition_count);
 }
 
 TEST_CASE("HGraph Parameters CheckCompatibility", "[ut][HGraphParameter][CheckCompatibility]") {
@@ -158,4 +170,25 @@ TEST_CASE("HGraph Parameters CheckCompatibility", "[ut][HGraphParameter][CheckCo
     TEST_COMPATIBILITY_CASE(
         "different use attribute filter", use_attribute_filter, true, false, false)
     TEST_COMPATIBILITY_CASE("different support duplicate", support_duplicate, true, false, false)
+    TEST_COMPATIBILITY_CASE(
+        "different consolidate remove ratio", consolidate_remove_ratio, 0.0F, 0.2F, true)
+    TEST_COMPATIBILITY_CASE(
+        "different graph layout order", graph_layout_order, "none", "gorder", true)
+    TEST_COMPATIBILITY_CASE(
+        "different fuse codes with graph", fuse_codes_with_graph, true, false, false)
+    TEST_COMPATIBILITY_CASE(
+        "different build partition count", build_partition_count, 0, 8, true)
+}
+
+TEST_CASE("HGraph Parameters Vamana Data Type", "[ut][HGraphParameter]") {
+    HGraphDefaultParam default_param;
+    auto json = vsag::JsonType::Parse(generate_hgraph_param(default_param));
+    json["graph"]["graph_type"].SetString("vamana");
+
+    auto float_param = std::make_shared<vsag::HGraphParameter>();
+    REQUIRE_NOTHROW(float_param->FromJson(json));
+
+    auto int8_param = std::make_shared<vsag::HGraphParameter>();
+    int8_param->data_type = vsag::DataTypes::DATA_TYPE_INT8;
+    REQUIRE_THROWS_AS(int8_param->FromJson(json), vsag::VsagException);
 }
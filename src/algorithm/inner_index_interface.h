@@ -115,6 +115,18 @@ public:
     virtual InnerIndexPtr
     Clone(const IndexCommonParam& param);
 
+    virtual uint64_t
+    Compact() {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                            "Index doesn't support Compact");
+    }
+
+    virtual uint64_t
+    ConsolidateRemoved() {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
+                            "Index doesn't support ConsolidateRemoved");
+    }
+
     virtual Index::Checkpoint
     ContinueBuild(const DatasetPtr& base, const BinarySet& binary_set) {
         throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION,
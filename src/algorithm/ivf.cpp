@@ -30,6 +30,7 @@
 #include "index_feature_list.h"
 #include "inner_string_params.h"
 #include "ivf_partition/gno_imi_partition.h"
+#include "ivf_partition/hierarchical_partition.h"
 #include "ivf_partition/ivf_nearest_partition.h"
 #include "storage/serialization.h"
 #include "storage/stream_reader.h"
@@ -53,8 +54,11 @@ static constexpr const char* IVF_PARAMS_TEMPLATE =
             "{QUANTIZATION_PARAMS_KEY}": {
                 "{TYPE_KEY}": "{QUANTIZATION_TYPE_VALUE_FP32}",
                 "{SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE_KEY}": 0.05,
+                "{SQ4_UNIFORM_QUANTIZATION_FASTSCAN_KEY}": false,
                 "{PCA_DIM_KEY}": 0,
                 "{RABITQ_QUANTIZATION_BITS_PER_DIM_QUERY_KEY}": 32,
+                "{RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY}": 1,
+                "{TQ_CHAIN_KEY}": "",
                 "{PRODUCT_QUANTIZATION_DIM_KEY}": 1
             },
             "{BUCKETS_COUNT_KEY}": 10,
@@ -63,9 +67,14 @@ static constexpr const char* IVF_PARAMS_TEMPLATE =
         "{IVF_PARTITION_STRATEGY_PARAMS_KEY}": {
             "{IVF_PARTITION_STRATEGY_TYPE_KEY}": "{IVF_PARTITION_STRATEGY_TYPE_NEAREST}",
             "{IVF_TRAIN_TYPE_KEY}": "{IVF_TRAIN_TYPE_KMEANS}",
+            "{IVF_TRAIN_BALANCE_FACTOR_KEY}": 0.0,
             "{IVF_PARTITION_STRATEGY_TYPE_GNO_IMI}": {
                 "{GNO_IMI_FIRST_ORDER_BUCKETS_COUNT_KEY}": 10,
                 "{GNO_IMI_SECOND_ORDER_BUCKETS_COUNT_KEY}": 10
+            },
+            "{IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL}": {
+                "{HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT_KEY}": 0,
+                "{HIERARCHICAL_MAX_BUCKET_SIZE_RATIO_KEY}": 2.0
             }
         },
         "{BUCKET_PER_DATA_KEY}": 1,
@@ -152,6 +161,13 @@ IVF::CheckAndMappingExternalParam(const JsonType& external_param,
                 IVF_TRAIN_TYPE_KEY,
             },
         },
+        {
+            IVF_TRAIN_BALANCE_FACTOR,
+            {
+                IVF_PARTITION_STRATEGY_PARAMS_KEY,
+                IVF_TRAIN_BALANCE_FACTOR_KEY,
+            },
+        },
         {
             IVF_PARTITION_STRATEGY_TYPE_KEY,
             {
@@ -175,6 +191,22 @@ IVF::CheckAndMappingExternalParam(const JsonType& external_param,
                 GNO_IMI_SECOND_ORDER_BUCKETS_COUNT_KEY,
             },
         },
+        {
+            HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT,
+            {
+                IVF_PARTITION_STRATEGY_PARAMS_KEY,
+                IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL,
+                HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT_KEY,
+            },
+        },
+        {
+            HIERARCHICAL_MAX_BUCKET_SIZE_RATIO,
+            {
+                IVF_PARTITION_STRATEGY_PARAMS_KEY,
+                IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL,
+                HIERARCHICAL_MAX_BUCKET_SIZE_RATIO_KEY,
+            },
+        },
         {
             BUCKET_PER_DATA_KEY,
             {
@@ -208,6 +240,22 @@ IVF::CheckAndMappingExternalParam(const JsonType& external_param,
                 PRODUCT_QUANTIZATION_DIM_KEY,
             },
         },
+        {
+            INDEX_TQ_CHAIN,
+            {
+                BUCKET_PARAMS_KEY,
+                QUANTIZATION_PARAMS_KEY,
+                TQ_CHAIN_KEY,
+            },
+        },
+        {
+            IVF_BASE_SQ4_UNIFORM_FASTSCAN,
+            {
+                BUCKET_PARAMS_KEY,
+                QUANTIZATION_PARAMS_KEY,
+                SQ4_UNIFORM_QUANTIZATION_FASTSCAN_KEY,
+            },
+        },
         {
             IVF_THREAD_COUNT,
             {
@@ -254,6 +302,10 @@ IVF::IVF(const IVFParameterPtr& param, const IndexCommonParam& common_param)
                IVFPartitionStrategyType::GNO_IMI) {
         this->partition_strategy_ = std::make_shared<GNOIMIPartition>(
             common_param, param->ivf_partition_strategy_parameter);
+    } else if (param->ivf_partition_strategy_parameter->partition_strategy_type ==
+               IVFPartitionStrategyType::HIERARCHICAL) {
+        this->partition_strategy_ = std::make_shared<HierarchicalPartition>(
+            bucket_->bucket_count_, common_param, param->ivf_partition_strategy_parameter);
     }
     if (this->use_reorder_) {
         this->reorder_codes_ =
@@ -337,7 +389,7 @@ IVF::InitFeatures() {
                                             IndexFeature::SUPPORT_EXPORT_MODEL,
                                             IndexFeature::SUPPORT_MERGE_INDEX});
 
-    if (this->bucket_->GetQuantizerName() == QUANTIZATION_TYPE_VALUE_PQFS) {
+    if (this->bucket_->UsePackage()) {
         this->index_feature_list_->SetFeature(IndexFeature::SUPPORT_ADD_AFTER_BUILD, false);
     }
 }
@@ -880,6 +932,7 @@ IVF::merge_one_unit(const MergeUnit& unit) {
     if (this->use_reorder_) {
         this->reorder_codes_->MergeOther(other_index->reorder_codes_, bias);
     }
+    this->partition_strategy_->MergeOther(other_index->partition_strategy_);
     this->total_elements_ += other_index->total_elements_;
 }
 
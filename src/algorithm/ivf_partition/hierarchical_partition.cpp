@@ -0,0 +1,414 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hierarchical_partition.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "impl/cluster/kmeans_cluster.h"
+#include "impl/logger/logger.h"
+#include "utils/util_functions.h"
+
+namespace vsag {
+
+HierarchicalPartition::HierarchicalPartition(BucketIdType bucket_count,
+                                             const IndexCommonParam& common_param,
+                                             IVFPartitionStrategyParametersPtr param)
+    : IVFPartitionStrategy(common_param, bucket_count),
+      ivf_partition_strategy_param_(std::move(param)),
+      first_order_centroids_(allocator_),
+      leaf_centroids_(allocator_),
+      leaf_offsets_(allocator_),
+      bucket_sizes_(allocator_) {
+    const auto& hierarchical_param = ivf_partition_strategy_param_->hierarchical_param;
+    first_order_buckets_count_ = hierarchical_param->first_order_buckets_count;
+    if (first_order_buckets_count_ <= 0) {
+        first_order_buckets_count_ = static_cast<BucketIdType>(
+            std::round(std::sqrt(static_cast<double>(this->bucket_count_))));
+    }
+    first_order_buckets_count_ = std::clamp(first_order_buckets_count_, 1, this->bucket_count_);
+    max_bucket_size_ratio_ = hierarchical_param->max_bucket_size_ratio;
+}
+
+void
+HierarchicalPartition::Train(const DatasetPtr dataset) {
+    const auto* vectors = dataset->GetFloat32Vectors();
+    auto num_element = dataset->GetNumElements();
+    if (num_element <= 0) {
+        // nothing to cluster, spread the leaves evenly over zero centroids
+        first_order_centroids_.assign(static_cast<uint64_t>(first_order_buckets_count_) * dim_,
+                                      0.0F);
+        leaf_centroids_.assign(static_cast<uint64_t>(this->bucket_count_) * dim_, 0.0F);
+        leaf_offsets_.assign(first_order_buckets_count_ + 1, 0);
+        for (BucketIdType i = 0; i < first_order_buckets_count_; ++i) {
+            leaf_offsets_[i + 1] = static_cast<BucketIdType>(
+                static_cast<int64_t>(this->bucket_count_) * (i + 1) / first_order_buckets_count_);
+        }
+        bucket_sizes_.assign(this->bucket_count_, 0);
+        this->is_trained_ = true;
+        return;
+    }
+    Vector<float> norm_vectors(allocator_);
+    if (metric_type_ == MetricType::METRIC_TYPE_COSINE) {
+        norm_vectors.resize(num_element * dim_);
+        for (int64_t i = 0; i < num_element; ++i) {
+            Normalize(vectors + i * dim_, norm_vectors.data() + i * dim_, dim_);
+        }
+        vectors = norm_vectors.data();
+    }
+
+    KMeansCluster cls(static_cast<int32_t>(dim_), this->allocator_, this->thread_pool_);
+    cls.SetBalanceFactor(max_bucket_size_ratio_);
+    auto labels = cls.Run(first_order_buckets_count_, vectors, num_element, KMEANS_ITER_COUNT);
+    first_order_centroids_.assign(cls.k_centroids_,
+                                  cls.k_centroids_ + first_order_buckets_count_ * dim_);
+
+    // give each coarse cluster a share of the leaves proportional to its size, at least one
+    // for a non-empty cluster, and the largest remainders take the rest
+    Vector<int64_t> sizes(first_order_buckets_count_, 0, allocator_);
+    for (auto label : labels) {
+        sizes[label]++;
+    }
+    Vector<BucketIdType> leaf_counts(first_order_buckets_count_, 0, allocator_);
+    Vector<std::pair<double, BucketIdType>> remainders(allocator_);
+    BucketIdType assigned = 0;
+    for (BucketIdType i = 0; i < first_order_buckets_count_; ++i) {
+        if (sizes[i] == 0) {
+            continue;
+        }
+        auto share = static_cast<double>(sizes[i]) * this->bucket_count_ / num_element;
+        leaf_counts[i] = std::max(static_cast<BucketIdType>(share), 1);
+        assigned += leaf_counts[i];
+        remainders.emplace_back(share - leaf_counts[i], i);
+    }
+    std::sort(remainders.begin(), remainders.end(), std::greater<>());
+    for (uint64_t i = 0; assigned < this->bucket_count_; i = (i + 1) % remainders.size()) {
+        leaf_counts[remainders[i].second]++;
+        assigned++;
+    }
+    while (assigned > this->bucket_count_) {
+        auto max_count = std::max_element(leaf_counts.begin(), leaf_counts.end());
+        (*max_count)--;
+        assigned--;
+    }
+
+    leaf_offsets_.assign(first_order_buckets_count_ + 1, 0);
+    for (BucketIdType i = 0; i < first_order_buckets_count_; ++i) {
+        leaf_offsets_[i + 1] = leaf_offsets_[i] + leaf_counts[i];
+    }
+    this->train_leaves(vectors, num_element, labels, leaf_counts);
+    if (metric_type_ == MetricType::METRIC_TYPE_COSINE) {
+        for (BucketIdType i = 0; i < first_order_buckets_count_; ++i) {
+            auto* centroid = first_order_centroids_.data() + static_cast<uint64_t>(i) * dim_;
+            Normalize(centroid, centroid, dim_);
+        }
+        for (BucketIdType i = 0; i < this->bucket_count_; ++i) {
+            auto* centroid = leaf_centroids_.data() + static_cast<uint64_t>(i) * dim_;
+            Normalize(centroid, centroid, dim_);
+        }
+    }
+    bucket_sizes_.assign(this->bucket_count_, 0);
+    this->is_trained_ = true;
+}
+
+void
+HierarchicalPartition::train_leaves(const float* vectors,
+                                    int64_t num_element,
+                                    const Vector<int32_t>& labels,
+                                    const Vector<BucketIdType>& leaf_counts) {
+    leaf_centroids_.resize(static_cast<uint64_t>(this->bucket_count_) * dim_);
+    Vector<int64_t> order(num_element, 0, allocator_);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(
+        order.begin(), order.end(), [&](int64_t a, int64_t b) { return labels[a] < labels[b]; });
+
+    Vector<float> cluster_datas(allocator_);
+    KMeansCluster cls(static_cast<int32_t>(dim_), this->allocator_, this->thread_pool_);
+    cls.SetBalanceFactor(max_bucket_size_ratio_);
+    int64_t begin = 0;
+    for (BucketIdType i = 0; i < first_order_buckets_count_; ++i) {
+        int64_t end = begin;
+        while (end < num_element and labels[order[end]] == i) {
+            ++end;
+        }
+        auto cluster_size = end - begin;
+        auto leaf_count = leaf_counts[i];
+        auto* leaves = leaf_centroids_.data() + static_cast<uint64_t>(leaf_offsets_[i]) * dim_;
+        if (leaf_count == 0) {
+            begin = end;
+            continue;
+        }
+        cluster_datas.resize(cluster_size * dim_);
+        for (int64_t j = 0; j < cluster_size; ++j) {
+            memcpy(cluster_datas.data() + j * dim_,
+                   vectors + order[begin + j] * dim_,
+                   dim_ * sizeof(float));
+        }
+        if (cluster_size <= leaf_count) {
+            // too few datas to cluster, the datas themselves and the coarse centroid are leaves
+            memcpy(leaves, cluster_datas.data(), cluster_size * dim_ * sizeof(float));
+            for (auto j = cluster_size; j < leaf_count; ++j) {
+                memcpy(leaves + j * dim_,
+                       first_order_centroids_.data() + i * dim_,
+                       dim_ * sizeof(float));
+            }
+        } else {
+            cls.Run(leaf_count, cluster_datas.data(), cluster_size, KMEANS_ITER_COUNT);
+            memcpy(leaves, cls.k_centroids_, leaf_count * dim_ * sizeof(float));
+        }
+        begin = end;
+    }
+}
+
+float
+HierarchicalPartition::compute_dist(const float* query, const float* centroid) const {
+    if (metric_type_ == MetricType::METRIC_TYPE_L2SQR) {
+        return FP32ComputeL2Sqr(query, centroid, dim_);
+    }
+    // the query and the centroids are normalized for cosine
+    return 1.0F - FP32ComputeIP(query, centroid, dim_);
+}
+
+uint32_t
+HierarchicalPartition::route(const float* query,
+                             BucketIdType topk,
+                             BucketIdType leaf_count_to_scan,
+                             BucketIdType* result_ids,
+                             float* result_dists) const {
+    Vector<std::pair<float, BucketIdType>> first_order_dists(first_order_buckets_count_,
+                                                             allocator_);
+    for (BucketIdType i = 0; i < first_order_buckets_count_; ++i) {
+        first_order_dists[i].first =
+            this->compute_dist(query, first_order_centroids_.data() + i * dim_);
+        first_order_dists[i].second = i;
+    }
+    std::sort(first_order_dists.begin(), first_order_dists.end());
+    auto dist_cmp = static_cast<uint32_t>(first_order_buckets_count_);
+
+    MaxHeap heap(this->allocator_);
+    BucketIdType scanned = 0;
+    for (BucketIdType i = 0; i < first_order_buckets_count_ and scanned < leaf_count_to_scan;
+         ++i) {
+        auto first_order_id = first_order_dists[i].second;
+        for (auto j = leaf_offsets_[first_order_id]; j < leaf_offsets_[first_order_id + 1]; ++j) {
+            auto dist = this->compute_dist(query, leaf_centroids_.data() + j * dim_);
+            if (heap.size() < topk or dist < heap.top().first) {
+                heap.emplace(dist, j);
+            }
+            if (heap.size() > topk) {
+                heap.pop();
+            }
+        }
+        scanned += leaf_offsets_[first_order_id + 1] - leaf_offsets_[first_order_id];
+    }
+    dist_cmp += static_cast<uint32_t>(scanned);
+
+    auto size = static_cast<BucketIdType>(heap.size());
+    for (auto j = size - 1; j >= 0; --j) {
+        result_ids[j] = static_cast<BucketIdType>(heap.top().second);
+        if (result_dists != nullptr) {
+            result_dists[j] = heap.top().first;
+        }
+        heap.pop();
+    }
+    for (auto j = size; j < topk; ++j) {
+        result_ids[j] = -1;
+    }
+    return dist_cmp;
+}
+
+Vector<BucketIdType>
+HierarchicalPartition::ClassifyDatas(const void* datas,
+                                     int64_t count,
+                                     BucketIdType buckets_per_data,
+                                     Statistics& stats) const {
+    const auto* vectors = reinterpret_cast<const float*>(datas);
+    Vector<float> norm_vectors(allocator_);
+    if (metric_type_ == MetricType::METRIC_TYPE_COSINE) {
+        norm_vectors.resize(count * dim_);
+        for (int64_t i = 0; i < count; ++i) {
+            Normalize(vectors + i * dim_, norm_vectors.data() + i * dim_, dim_);
+        }
+        vectors = norm_vectors.data();
+    }
+
+    auto candidate_count = std::min(buckets_per_data + SPILL_CANDIDATES, this->bucket_count_);
+    Vector<BucketIdType> candidate_ids(count * candidate_count, allocator_);
+    Vector<float> candidate_dists(count * candidate_count, allocator_);
+    std::atomic<uint32_t> dist_cmp{0};
+    auto task = [&](int64_t start, int64_t end) {
+        uint32_t local_dist_cmp = 0;
+        for (int64_t i = start; i < end; ++i) {
+            local_dist_cmp += this->route(vectors + i * dim_,
+                                          candidate_count,
+                                          LEAF_SCAN_FACTOR * candidate_count,
+                                          candidate_ids.data() + i * candidate_count,
+                                          candidate_dists.data() + i * candidate_count);
+        }
+        dist_cmp.fetch_add(local_dist_cmp, std::memory_order_relaxed);
+    };
+    constexpr int64_t block_size = 256;
+    if (thread_pool_ == nullptr) {
+        task(0, count);
+    } else {
+        Vector<std::future<void>> futures(allocator_);
+        for (int64_t i = 0; i < count; i += block_size) {
+            futures.push_back(
+                thread_pool_->GeneralEnqueue(task, i, std::min(i + block_size, count)));
+        }
+        for (auto& item : futures) {
+            item.get();
+        }
+    }
+    stats.dist_cmp.fetch_add(dist_cmp.load(), std::memory_order_relaxed);
+
+    // datas close to their nearest bucket choose first, the others spill when it is full
+    Vector<int64_t> order(count, 0, allocator_);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+        return candidate_dists[a * candidate_count] < candidate_dists[b * candidate_count];
+    });
+    Vector<BucketIdType> result(buckets_per_data * count, -1, this->allocator_);
+    std::lock_guard lock(bucket_sizes_mutex_);
+    auto total_size = std::accumulate(bucket_sizes_.begin(), bucket_sizes_.end(), 0L) +
+                      count * buckets_per_data;
+    auto capacity = static_cast<int64_t>(
+        std::ceil(max_bucket_size_ratio_ * static_cast<double>(total_size) / this->bucket_count_));
+    for (auto i : order) {
+        const auto* candidates = candidate_ids.data() + i * candidate_count;
+        auto* cur_result = result.data() + i * buckets_per_data;
+        BucketIdType chosen = 0;
+        for (BucketIdType j = 0; j < candidate_count and chosen < buckets_per_data; ++j) {
+            if (candidates[j] >= 0 and bucket_sizes_[candidates[j]] < capacity) {
+                cur_result[chosen++] = candidates[j];
+            }
+        }
+        if (chosen < buckets_per_data) {
+            // all candidates are full, spill to the nearest leaves that still have room
+            Vector<std::pair<float, BucketIdType>> leaf_dists(allocator_);
+            for (BucketIdType j = 0; j < this->bucket_count_; ++j) {
+                if (bucket_sizes_[j] < capacity and
+                    std::find(cur_result, cur_result + chosen, j) == cur_result + chosen) {
+                    leaf_dists.emplace_back(
+                        this->compute_dist(vectors + i * dim_, leaf_centroids_.data() + j * dim_),
+                        j);
+                }
+            }
+            stats.dist_cmp.fetch_add(leaf_dists.size(), std::memory_order_relaxed);
+            auto spill_count = std::min<uint64_t>(buckets_per_data - chosen, leaf_dists.size());
+            std::partial_sort(
+                leaf_dists.begin(), leaf_dists.begin() + spill_count, leaf_dists.end());
+            for (uint64_t j = 0; j < spill_count; ++j) {
+                cur_result[chosen++] = leaf_dists[j].second;
+            }
+        }
+        // capacity * bucket_count covers every copy, so this is only reached when fewer
+        // buckets than buckets_per_data still have room
+        for (BucketIdType j = 0; j < candidate_count and chosen < buckets_per_data; ++j) {
+            if (candidates[j] >= 0 and
+                std::find(cur_result, cur_result + chosen, candidates[j]) ==
+                    cur_result + chosen) {
+                cur_result[chosen++] = candidates[j];
+            }
+        }
+        for (BucketIdType j = 0; j < chosen; ++j) {
+            bucket_sizes_[cur_result[j]]++;
+        }
+    }
+    return result;
+}
+
+Vector<BucketIdType>
+HierarchicalPartition::ClassifyDatasForSearch(const void* datas,
+                                              int64_t count,
+                                              const InnerSearchParam& param,
+                                              Statistics& stats) {
+    const auto* vectors = reinterpret_cast<const float*>(datas);
+    Vector<float> norm_vector(allocator_);
+    auto buckets_per_data = param.scan_bucket_size;
+    Vector<BucketIdType> result(buckets_per_data * count, -1, this->allocator_);
+    uint32_t dist_cmp = 0;
+    for (int64_t i = 0; i < count; ++i) {
+        const auto* query = vectors + i * dim_;
+        if (metric_type_ == MetricType::METRIC_TYPE_COSINE) {
+            norm_vector.resize(dim_);
+            Normalize(query, norm_vector.data(), dim_);
+            query = norm_vector.data();
+        }
+        dist_cmp += this->route(query,
+                                buckets_per_data,
+                                LEAF_SCAN_FACTOR * buckets_per_data,
+                                result.data() + i * buckets_per_data,
+                                nullptr);
+    }
+    stats.dist_cmp.fetch_add(dist_cmp, std::memory_order_relaxed);
+    return result;
+}
+
+void
+HierarchicalPartition::GetCentroid(BucketIdType bucket_id, Vector<float>& centroid) {
+    if (!is_trained_ || bucket_id >= bucket_count_) {
+        throw VsagException(
+            ErrorType::INTERNAL_ERROR,
+            fmt::format("invalid bucket id {} or partition not trained", bucket_id));
+    }
+    memcpy(centroid.data(), leaf_centroids_.data() + bucket_id * dim_, dim_ * sizeof(float));
+}
+
+void
+HierarchicalPartition::MergeOther(const IVFPartitionStrategyPtr& other) {
+    auto other_partition = std::dynamic_pointer_cast<HierarchicalPartition>(other);
+    if (other_partition == nullptr or other_partition.get() == this) {
+        return;
+    }
+    std::scoped_lock lock(bucket_sizes_mutex_, other_partition->bucket_sizes_mutex_);
+    const auto& other_sizes = other_partition->bucket_sizes_;
+    if (bucket_sizes_.size() < other_sizes.size()) {
+        bucket_sizes_.resize(other_sizes.size(), 0);
+    }
+    for (uint64_t i = 0; i < other_sizes.size(); ++i) {
+        bucket_sizes_[i] += other_sizes[i];
+    }
+}
+
+void
+HierarchicalPartition::Serialize(StreamWriter& writer) {
+    IVFPartitionStrategy::Serialize(writer);
+    StreamWriter::WriteObj(writer, this->first_order_buckets_count_);
+    StreamWriter::WriteObj(writer, this->max_bucket_size_ratio_);
+    StreamWriter::WriteVector(writer, this->first_order_centroids_);
+    StreamWriter::WriteVector(writer, this->leaf_centroids_);
+    StreamWriter::WriteVector(writer, this->leaf_offsets_);
+    std::lock_guard lock(bucket_sizes_mutex_);
+    StreamWriter::WriteVector(writer, this->bucket_sizes_);
+}
+
+void
+HierarchicalPartition::Deserialize(lvalue_or_rvalue<StreamReader> reader) {
+    IVFPartitionStrategy::Deserialize(reader);
+    StreamReader::ReadObj(reader, this->first_order_buckets_count_);
+    StreamReader::ReadObj(reader, this->max_bucket_size_ratio_);
+    StreamReader::ReadVector(reader, this->first_order_centroids_);
+    StreamReader::ReadVector(reader, this->leaf_centroids_);
+    StreamReader::ReadVector(reader, this->leaf_offsets_);
+    std::lock_guard lock(bucket_sizes_mutex_);
+    StreamReader::ReadVector(reader, this->bucket_sizes_);
+}
+
+}  // namespace vsag
@@ -0,0 +1,115 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <mutex>
+
+#include "algorithm/inner_index_interface.h"
+#include "index_common_param.h"
+#include "ivf_partition_strategy.h"
+#include "ivf_partition_strategy_parameter.h"
+#include "vsag/index.h"
+namespace vsag {
+
+/**
+ * @brief Two level partition for large bucket counts.
+ *
+ * The datas are first clustered into first_order_buckets_count coarse clusters, then every
+ * coarse cluster is split into leaf buckets, the number of leaves is proportional to its size.
+ * Both levels are trained with a size-capped kmeans, and insertion spills a data to the next
+ * nearest leaf once its bucket grows beyond max_bucket_size_ratio times the average, so the
+ * bucket sizes stay within a bounded ratio. Routing only compares against the coarse centroids
+ * and the leaves of the nearest coarse clusters, about 2 * sqrt(buckets_count) distances
+ * instead of buckets_count.
+ */
+class HierarchicalPartition : public IVFPartitionStrategy {
+public:
+    explicit HierarchicalPartition(BucketIdType bucket_count,
+                                   const IndexCommonParam& common_param,
+                                   IVFPartitionStrategyParametersPtr param);
+
+    void
+    Train(const DatasetPtr dataset) override;
+
+    Vector<BucketIdType>
+    ClassifyDatas(const void* datas,
+                  int64_t count,
+                  BucketIdType buckets_per_data,
+                  Statistics& stats) const override;
+
+    Vector<BucketIdType>
+    ClassifyDatasForSearch(const void* datas,
+                           int64_t count,
+                           const InnerSearchParam& param,
+                           Statistics& stats) override;
+
+    void
+    GetCentroid(BucketIdType bucket_id, Vector<float>& centroid) override;
+
+    void
+    MergeOther(const IVFPartitionStrategyPtr& other) override;
+
+    void
+    Serialize(StreamWriter& writer) override;
+
+    void
+    Deserialize(lvalue_or_rvalue<StreamReader> reader) override;
+
+public:
+    IVFPartitionStrategyParametersPtr ivf_partition_strategy_param_{nullptr};
+
+    BucketIdType first_order_buckets_count_{0};
+    float max_bucket_size_ratio_{2.0F};
+
+    Vector<float> first_order_centroids_;
+    // leaves of coarse cluster i are [leaf_offsets_[i], leaf_offsets_[i + 1])
+    Vector<float> leaf_centroids_;
+    Vector<BucketIdType> leaf_offsets_;
+
+    // count of datas assigned to each bucket, used to cap the bucket size on insertion
+    mutable Vector<int64_t> bucket_sizes_;
+
+private:
+    // the distance of the index metric between a data and a centroid
+    float
+    compute_dist(const float* query, const float* centroid) const;
+
+    uint32_t
+    route(const float* query,
+          BucketIdType topk,
+          BucketIdType leaf_count_to_scan,
+          BucketIdType* result_ids,
+          float* result_dists) const;
+
+    void
+    train_leaves(const float* vectors,
+                 int64_t num_element,
+                 const Vector<int32_t>& labels,
+                 const Vector<BucketIdType>& leaf_counts);
+
+private:
+    mutable std::mutex bucket_sizes_mutex_;
+
+    // extra nearest buckets kept for each data, a full bucket spills to them
+    static constexpr BucketIdType SPILL_CANDIDATES = 8;
+
+    // the nearest coarse clusters are scanned until they hold this many times of the wanted leaves
+    static constexpr BucketIdType LEAF_SCAN_FACTOR = 2;
+
+    static constexpr int32_t KMEANS_ITER_COUNT = 25;
+};
+
+}  // namespace vsag
@@ -0,0 +1,73 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hierarchical_partition_parameter.h"
+
+#include <fmt/format.h>
+
+#include "impl/logger/logger.h"
+#include "inner_string_params.h"
+
+namespace vsag {
+
+HierarchicalPartitionParameter::HierarchicalPartitionParameter() = default;
+
+void
+HierarchicalPartitionParameter::FromJson(const JsonType& json) {
+    if (json.Contains(HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT_KEY)) {
+        this->first_order_buckets_count =
+            static_cast<BucketIdType>(json[HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT_KEY].GetInt());
+        CHECK_ARGUMENT(this->first_order_buckets_count >= 0,
+                       fmt::format("{} must be non-negative, got {}",
+                                   HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT_KEY,
+                                   this->first_order_buckets_count));
+    }
+    if (json.Contains(HIERARCHICAL_MAX_BUCKET_SIZE_RATIO_KEY)) {
+        this->max_bucket_size_ratio = json[HIERARCHICAL_MAX_BUCKET_SIZE_RATIO_KEY].GetFloat();
+        CHECK_ARGUMENT(this->max_bucket_size_ratio >= 1.0F,
+                       fmt::format("{} must be at least 1.0, got {}",
+                                   HIERARCHICAL_MAX_BUCKET_SIZE_RATIO_KEY,
+                                   this->max_bucket_size_ratio));
+    }
+}
+
+JsonType
+HierarchicalPartitionParameter::ToJson() const {
+    JsonType json;
+    json[HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT_KEY].SetInt(this->first_order_buckets_count);
+    json[HIERARCHICAL_MAX_BUCKET_SIZE_RATIO_KEY].SetFloat(this->max_bucket_size_ratio);
+    return json;
+}
+
+bool
+HierarchicalPartitionParameter::CheckCompatibility(const ParamPtr& other) const {
+    auto hierarchical_param = std::dynamic_pointer_cast<HierarchicalPartitionParameter>(other);
+    if (!hierarchical_param) {
+        logger::error(
+            "HierarchicalPartitionParameter::CheckCompatibility: "
+            "other parameter is not HierarchicalPartitionParameter");
+        return false;
+    }
+    if (this->first_order_buckets_count != hierarchical_param->first_order_buckets_count) {
+        logger::error(
+            "HierarchicalPartitionParameter::CheckCompatibility: "
+            "first_order_buckets_count mismatch: {} != {}",
+            this->first_order_buckets_count,
+            hierarchical_param->first_order_buckets_count);
+        return false;
+    }
+    return true;
+}
+}  // namespace vsag
@@ -0,0 +1,46 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include <fmt/format.h>
+
+#include "inner_string_params.h"
+#include "parameter.h"
+#include "typing.h"
+
+namespace vsag {
+class HierarchicalPartitionParameter : public Parameter {
+public:
+    explicit HierarchicalPartitionParameter();
+
+    void
+    FromJson(const JsonType& json) override;
+
+    JsonType
+    ToJson() const override;
+
+    bool
+    CheckCompatibility(const vsag::ParamPtr& other) const override;
+
+public:
+    // count of the coarse clusters, 0 means sqrt(buckets_count)
+    BucketIdType first_order_buckets_count{0};
+    // max bucket size in units of the average bucket size
+    float max_bucket_size_ratio{2.0F};
+};
+
+using HierarchicalPartitionParameterPtr = std::shared_ptr<HierarchicalPartitionParameter>;
+
+}  // namespace vsag
@@ -0,0 +1,52 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hierarchical_partition_parameter.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "parameter_test.h"
+
+TEST_CASE("Hierarchical Partition Parameters Test", "[ut][HierarchicalPartitionParameter]") {
+    auto param_str = R"({
+        "first_order_buckets_count": 32,
+        "max_bucket_size_ratio": 1.5
+    })";
+    vsag::JsonType param_json = vsag::JsonType::Parse(param_str);
+    auto param = std::make_shared<vsag::HierarchicalPartitionParameter>();
+    param->FromJson(param_json);
+    REQUIRE(param->first_order_buckets_count == 32);
+    REQUIRE(param->max_bucket_size_ratio == 1.5F);
+    vsag::ParameterTest::TestToJson(param);
+
+    param_str = R"({
+        "max_bucket_size_ratio": 0.5
+    })";
+    param_json = vsag::JsonType::Parse(param_str);
+    REQUIRE_THROWS(param->FromJson(param_json));
+}
+
+TEST_CASE("Hierarchical Partition CheckCompatibility", "[ut][HierarchicalPartitionParameter]") {
+    auto param = std::make_shared<vsag::HierarchicalPartitionParameter>();
+    param->first_order_buckets_count = 32;
+    REQUIRE(param->CheckCompatibility(param));
+
+    auto other_param = std::make_shared<vsag::HierarchicalPartitionParameter>();
+    other_param->first_order_buckets_count = 64;
+    REQUIRE_FALSE(param->CheckCompatibility(other_param));
+
+    auto other_type_param = std::make_shared<vsag::EmptyParameter>();
+    REQUIRE_FALSE(param->CheckCompatibility(other_type_param));
+}
@@ -0,0 +1,244 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hierarchical_partition.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "algorithm/ivf_parameter.h"
+#include "fixtures.h"
+#include "impl/allocator/safe_allocator.h"
+#include "impl/inner_search_param.h"
+#include "simd/fp32_simd.h"
+#include "storage/serialization_template_test.h"
+
+using namespace vsag;
+
+static IVFPartitionStrategyParametersPtr
+make_hierarchical_param(float max_bucket_size_ratio) {
+    auto param_str = fmt::format(R"({{
+        "partition_strategy_type": "hierarchical",
+        "ivf_train_type": "kmeans",
+        "hierarchical": {{
+            "first_order_buckets_count": 10,
+            "max_bucket_size_ratio": {}
+        }}
+    }})",
+                                 max_bucket_size_ratio);
+    auto strategy_param = std::make_shared<IVFPartitionStrategyParameters>();
+    strategy_param->FromJson(JsonType::Parse(param_str));
+    return strategy_param;
+}
+
+static uint64_t
+count_search_match(HierarchicalPartition& partition,
+                   const std::vector<float>& vec,
+                   const Vector<BucketIdType>& class_result,
+                   int64_t dim,
+                   BucketIdType scan_bucket_size) {
+    InnerSearchParam inner_search_param;
+    inner_search_param.scan_bucket_size = scan_bucket_size;
+    Statistics stats;
+    uint64_t match_count = 0;
+    for (int64_t i = 0; i < static_cast<int64_t>(class_result.size()); ++i) {
+        auto result =
+            partition.ClassifyDatasForSearch(vec.data() + i * dim, 1, inner_search_param, stats);
+        if (std::find(result.begin(), result.end(), class_result[i]) != result.end()) {
+            match_count++;
+        }
+    }
+    return match_count;
+}
+
+TEST_CASE("Hierarchical Partition Basic Test", "[ut][HierarchicalPartition]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 32;
+    BucketIdType bucket_count = 100;
+    IndexCommonParam param;
+    param.dim_ = dim;
+    param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    param.allocator_ = allocator;
+    float max_bucket_size_ratio = 1.5F;
+    auto partition = std::make_unique<HierarchicalPartition>(
+        bucket_count, param, make_hierarchical_param(max_bucket_size_ratio));
+    REQUIRE(partition->first_order_buckets_count_ == 10);
+
+    auto dataset = Dataset::Make();
+    int64_t data_count = 10000L;
+    auto vec = fixtures::generate_vectors(data_count, dim, true, 95);
+    dataset->Float32Vectors(vec.data())->Dim(dim)->NumElements(data_count)->Owner(false);
+    partition->Train(dataset);
+    REQUIRE(partition->leaf_offsets_.back() == bucket_count);
+
+    Statistics stats;
+    auto class_result = partition->ClassifyDatas(vec.data(), data_count, 1, stats);
+    REQUIRE(class_result.size() == data_count);
+    std::vector<int64_t> bucket_sizes(bucket_count, 0);
+    for (auto bucket_id : class_result) {
+        REQUIRE(bucket_id >= 0);
+        REQUIRE(bucket_id < bucket_count);
+        bucket_sizes[bucket_id]++;
+    }
+    auto max_size = *std::max_element(bucket_sizes.begin(), bucket_sizes.end());
+    REQUIRE(max_size <= static_cast<int64_t>(
+                            std::ceil(max_bucket_size_ratio * data_count / bucket_count)));
+
+    // routing only scans the nearest coarse clusters
+    auto dist_cmp = stats.dist_cmp.load();
+    REQUIRE(dist_cmp < data_count * bucket_count / 2);
+
+    auto match_count = count_search_match(*partition, vec, class_result, dim, 10);
+    std::cout << "match count(scan_buckets_count=10): " << match_count << std::endl;
+    REQUIRE(match_count > data_count * 9 / 10);
+}
+
+TEST_CASE("Hierarchical Partition IP Test", "[ut][HierarchicalPartition]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 32;
+    BucketIdType bucket_count = 100;
+    IndexCommonParam param;
+    param.dim_ = dim;
+    param.metric_ = MetricType::METRIC_TYPE_IP;
+    param.allocator_ = allocator;
+    // a loose cap, so that the datas stay in their nearest buckets
+    auto partition =
+        std::make_unique<HierarchicalPartition>(bucket_count, param, make_hierarchical_param(50));
+
+    // the norms vary, so the nearest bucket by inner product is not the nearest by l2
+    int64_t data_count = 5000L;
+    auto vec = fixtures::generate_vectors(data_count, dim, true, 95);
+    for (int64_t i = 0; i < data_count * dim; ++i) {
+        vec[i] *= static_cast<float>(1 + (i / dim) % 4);
+    }
+    auto dataset = Dataset::Make();
+    dataset->Float32Vectors(vec.data())->Dim(dim)->NumElements(data_count)->Owner(false);
+    partition->Train(dataset);
+
+    Statistics stats;
+    auto class_result = partition->ClassifyDatas(vec.data(), data_count, 1, stats);
+    uint64_t match_count = 0;
+    for (int64_t i = 0; i < data_count; ++i) {
+        BucketIdType best_id = 0;
+        float best_ip = std::numeric_limits<float>::lowest();
+        for (BucketIdType j = 0; j < bucket_count; ++j) {
+            auto ip = FP32ComputeIP(
+                vec.data() + i * dim, partition->leaf_centroids_.data() + j * dim, dim);
+            if (ip > best_ip) {
+                best_ip = ip;
+                best_id = j;
+            }
+        }
+        match_count += static_cast<uint64_t>(class_result[i] == best_id);
+    }
+    std::cout << "ip match count: " << match_count << std::endl;
+    REQUIRE(match_count > data_count * 8 / 10);
+    REQUIRE(count_search_match(*partition, vec, class_result, dim, 10) > data_count * 9 / 10);
+}
+
+TEST_CASE("Hierarchical Partition Serialize Test", "[ut][HierarchicalPartition]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 32;
+    BucketIdType bucket_count = 100;
+    IndexCommonParam param;
+    param.dim_ = dim;
+    param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    param.allocator_ = allocator;
+    auto strategy_param = make_hierarchical_param(2.0F);
+    auto partition = std::make_unique<HierarchicalPartition>(bucket_count, param, strategy_param);
+
+    auto dataset = Dataset::Make();
+    int64_t data_count = 5000L;
+    auto vec = fixtures::generate_vectors(data_count, dim, true, 95);
+    dataset->Float32Vectors(vec.data())->Dim(dim)->NumElements(data_count)->Owner(false);
+    partition->Train(dataset);
+    Statistics stats;
+    auto class_result = partition->ClassifyDatas(vec.data(), data_count, 1, stats);
+
+    auto partition2 = std::make_unique<HierarchicalPartition>(bucket_count, param, strategy_param);
+    test_serializion(*partition, *partition2);
+    REQUIRE(partition2->bucket_sizes_ == partition->bucket_sizes_);
+    REQUIRE(count_search_match(*partition, vec, class_result, dim, 10) ==
+            count_search_match(*partition2, vec, class_result, dim, 10));
+}
+
+TEST_CASE("Hierarchical Partition Strict Cap Test", "[ut][HierarchicalPartition]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t dim = 16;
+    BucketIdType bucket_count = 50;
+    IndexCommonParam param;
+    param.dim_ = dim;
+    param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    param.allocator_ = allocator;
+    float max_bucket_size_ratio = 1.2F;
+    auto strategy_param = make_hierarchical_param(max_bucket_size_ratio);
+
+    SECTION("skewed inserts spill beyond the nearest candidates") {
+        auto partition =
+            std::make_shared<HierarchicalPartition>(bucket_count, param, strategy_param);
+        int64_t data_count = 4000L;
+        auto vec = fixtures::generate_vectors(data_count, dim, true, 97);
+        auto dataset = Dataset::Make();
+        dataset->Float32Vectors(vec.data())->Dim(dim)->NumElements(data_count)->Owner(false);
+        partition->Train(dataset);
+
+        // all inserted datas are packed around a single point
+        auto skewed = fixtures::generate_vectors(data_count, dim, true, 98);
+        for (int64_t i = 0; i < data_count * dim; ++i) {
+            skewed[i] = skewed[i] * 0.01F + vec[i % dim];
+        }
+        Statistics stats;
+        BucketIdType buckets_per_data = 2;
+        auto class_result =
+            partition->ClassifyDatas(skewed.data(), data_count, buckets_per_data, stats);
+        std::vector<int64_t> bucket_sizes(bucket_count, 0);
+        for (int64_t i = 0; i < data_count; ++i) {
+            auto first = class_result[i * buckets_per_data];
+            auto second = class_result[i * buckets_per_data + 1];
+            REQUIRE(first != second);
+            bucket_sizes[first]++;
+            bucket_sizes[second]++;
+        }
+        auto capacity = static_cast<int64_t>(
+            std::ceil(max_bucket_size_ratio * static_cast<double>(data_count * buckets_per_data) /
+                      bucket_count));
+        REQUIRE(*std::max_element(bucket_sizes.begin(), bucket_sizes.end()) <= capacity);
+
+        // merging another partition of the same model adds up the bucket sizes
+        auto other = std::make_shared<HierarchicalPartition>(bucket_count, param, strategy_param);
+        HierarchicalPartition::Clone(partition, other);
+        partition->MergeOther(other);
+        for (BucketIdType i = 0; i < bucket_count; ++i) {
+            REQUIRE(partition->bucket_sizes_[i] == 2 * bucket_sizes[i]);
+        }
+    }
+
+    SECTION("train without datas") {
+        auto partition =
+            std::make_unique<HierarchicalPartition>(bucket_count, param, strategy_param);
+        auto dataset = Dataset::Make();
+        dataset->Dim(dim)->NumElements(0)->Owner(false);
+        partition->Train(dataset);
+        REQUIRE(partition->is_trained_);
+        REQUIRE(partition->leaf_offsets_.back() == bucket_count);
+
+        auto vec = fixtures::generate_vectors(10, dim, true, 99);
+        Statistics stats;
+        auto class_result = partition->ClassifyDatas(vec.data(), 10, 1, stats);
+        for (auto bucket_id : class_result) {
+            REQUIRE(bucket_id >= 0);
+            REQUIRE(bucket_id < bucket_count);
+        }
+    }
+}
@@ -61,7 +61,8 @@ IVFNearestPartition::Train(const DatasetPtr dataset) {
     if (ivf_partition_strategy_param_->partition_train_type ==
         IVFNearestPartitionTrainerType::KMeansTrainer) {
         constexpr int32_t kmeans_iter_count = 25;
-        KMeansCluster cls(static_cast<int32_t>(dim), this->allocator_);
+        KMeansCluster cls(static_cast<int32_t>(dim), this->allocator_, this->thread_pool_);
+        cls.SetBalanceFactor(ivf_partition_strategy_param_->balance_factor);
         cls.Run(this->bucket_count_,
                 dataset->GetFloat32Vectors(),
                 dataset->GetNumElements(),
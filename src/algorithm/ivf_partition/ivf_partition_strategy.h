@@ -72,6 +72,11 @@ public:
     virtual void
     GetCentroid(BucketIdType bucket_id, Vector<float>& centroid) = 0;
 
+    // fold in the per-bucket state of another partition with the same model on index merge
+    virtual void
+    MergeOther(const IVFPartitionStrategyPtr& other) {
+    }
+
     virtual void
     Serialize(StreamWriter& writer) {
         StreamWriter::WriteObj(writer, this->is_trained_);
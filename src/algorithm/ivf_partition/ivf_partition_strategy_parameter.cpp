@@ -34,12 +34,22 @@ IVFPartitionStrategyParameters::FromJson(const JsonType& json) {
     } else if (json[IVF_TRAIN_TYPE_KEY].GetString() == IVF_TRAIN_TYPE_RANDOM) {
         this->partition_train_type = IVFNearestPartitionTrainerType::RandomTrainer;
     }
+    if (json.Contains(IVF_TRAIN_BALANCE_FACTOR_KEY)) {
+        this->balance_factor = json[IVF_TRAIN_BALANCE_FACTOR_KEY].GetFloat();
+        CHECK_ARGUMENT(this->balance_factor >= 0.0F,
+                       fmt::format("{} must be non-negative, got {}",
+                                   IVF_TRAIN_BALANCE_FACTOR_KEY,
+                                   this->balance_factor));
+    }
 
     if (json[IVF_PARTITION_STRATEGY_TYPE_KEY].GetString() == IVF_PARTITION_STRATEGY_TYPE_NEAREST) {
         this->partition_strategy_type = IVFPartitionStrategyType::IVF;
     } else if (json[IVF_PARTITION_STRATEGY_TYPE_KEY].GetString() ==
                IVF_PARTITION_STRATEGY_TYPE_GNO_IMI) {
         this->partition_strategy_type = IVFPartitionStrategyType::GNO_IMI;
+    } else if (json[IVF_PARTITION_STRATEGY_TYPE_KEY].GetString() ==
+               IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL) {
+        this->partition_strategy_type = IVFPartitionStrategyType::HIERARCHICAL;
     }
 
     this->gnoimi_param = std::make_shared<GNOIMIParameter>();
@@ -51,6 +61,12 @@ IVFPartitionStrategyParameters::FromJson(const JsonType& json) {
                         IVF_PARTITION_STRATEGY_TYPE_GNO_IMI));
         this->gnoimi_param->FromJson(json[IVF_PARTITION_STRATEGY_TYPE_GNO_IMI]);
     }
+
+    this->hierarchical_param = std::make_shared<HierarchicalPartitionParameter>();
+    if (this->partition_strategy_type == IVFPartitionStrategyType::HIERARCHICAL and
+        json.Contains(IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL)) {
+        this->hierarchical_param->FromJson(json[IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL]);
+    }
 }
 
 JsonType
@@ -61,15 +77,21 @@ IVFPartitionStrategyParameters::ToJson() const {
     } else if (this->partition_train_type == IVFNearestPartitionTrainerType::RandomTrainer) {
         json[IVF_TRAIN_TYPE_KEY].SetString(IVF_TRAIN_TYPE_RANDOM);
     }
+    json[IVF_TRAIN_BALANCE_FACTOR_KEY].SetFloat(this->balance_factor);
 
     if (this->partition_strategy_type == IVFPartitionStrategyType::IVF) {
         json[IVF_PARTITION_STRATEGY_TYPE_KEY].SetString(IVF_PARTITION_STRATEGY_TYPE_NEAREST);
     } else if (this->partition_strategy_type == IVFPartitionStrategyType::GNO_IMI) {
         json[IVF_PARTITION_STRATEGY_TYPE_KEY].SetString(IVF_PARTITION_STRATEGY_TYPE_GNO_IMI);
+    } else if (this->partition_strategy_type == IVFPartitionStrategyType::HIERARCHICAL) {
+        json[IVF_PARTITION_STRATEGY_TYPE_KEY].SetString(IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL);
     }
     if (this->partition_strategy_type == IVFPartitionStrategyType::GNO_IMI) {
         json[IVF_PARTITION_STRATEGY_TYPE_GNO_IMI].SetJson(this->gnoimi_param->ToJson());
     }
+    if (this->partition_strategy_type == IVFPartitionStrategyType::HIERARCHICAL) {
+        json[IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL].SetJson(this->hierarchical_param->ToJson());
+    }
     return json;
 }
 
@@ -91,6 +113,10 @@ IVFPartitionStrategyParameters::CheckCompatibility(const ParamPtr& other) const
         logger::error(message);
         return false;
     }
+    if (partition_strategy_type == IVFPartitionStrategyType::HIERARCHICAL) {
+        return this->hierarchical_param->CheckCompatibility(
+            ivf_partition_param->hierarchical_param);
+    }
     return this->gnoimi_param->CheckCompatibility(ivf_partition_param->gnoimi_param);
 }
 
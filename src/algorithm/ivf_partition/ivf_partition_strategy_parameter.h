@@ -18,6 +18,7 @@
 
 #include "datacell/bucket_datacell_parameter.h"
 #include "gno_imi_parameter.h"
+#include "hierarchical_partition_parameter.h"
 #include "inner_string_params.h"
 #include "parameter.h"
 #include "typing.h"
@@ -32,6 +33,7 @@ enum class IVFNearestPartitionTrainerType {
 enum class IVFPartitionStrategyType {
     IVF = 0,
     GNO_IMI = 1,
+    HIERARCHICAL = 2,
 };
 
 class IVFPartitionStrategyParameters : public Parameter {
@@ -51,7 +53,10 @@ public:
     IVFNearestPartitionTrainerType partition_train_type{
         IVFNearestPartitionTrainerType::KMeansTrainer};
     IVFPartitionStrategyType partition_strategy_type{IVFPartitionStrategyType::IVF};
+    // max bucket size of kmeans training, in units of the average size, 0 means unbounded
+    float balance_factor{0.0F};
     GNOIMIParameterPtr gnoimi_param{nullptr};
+    HierarchicalPartitionParameterPtr hierarchical_param{nullptr};
 };
 
 using IVFPartitionStrategyParametersPtr = std::shared_ptr<IVFPartitionStrategyParameters>;
@@ -23,6 +23,7 @@ TEST_CASE("IVF Partition Strategy Parameters Test", "[ut][IVFPartitionStrategyPa
     auto param_str = R"({
         "partition_strategy_type": "gno_imi",
         "ivf_train_type": "random", 
+        "ivf_train_balance_factor": 1.5,
         "gno_imi": {
             "first_order_buckets_count": 200,
             "second_order_buckets_count": 50
@@ -33,6 +34,7 @@ TEST_CASE("IVF Partition Strategy Parameters Test", "[ut][IVFPartitionStrategyPa
     param->FromJson(param_json);
     REQUIRE(param->partition_strategy_type == vsag::IVFPartitionStrategyType::GNO_IMI);
     REQUIRE(param->partition_train_type == vsag::IVFNearestPartitionTrainerType::RandomTrainer);
+    REQUIRE(param->balance_factor == 1.5F);
     REQUIRE(param->gnoimi_param->first_order_buckets_count == 200);
     REQUIRE(param->gnoimi_param->second_order_buckets_count == 50);
 
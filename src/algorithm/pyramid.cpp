@@ -44,18 +44,23 @@ IndexNode::IndexNode(IndexCommonParam* common_param, GraphInterfaceParamPtr grap
 }
 
 void
-IndexNode::BuildGraph(ODescent& odescent) {
+IndexNode::BuildGraph(ODescent& odescent, uint64_t index_min_size) {
     std::unique_lock lock(mutex_);
-    // Build an index when the level corresponding to the current node requires indexing
+    // Build an index when the level corresponding to the current node requires indexing,
+    // nodes smaller than index_min_size keep their points as a flat list
     if (has_index_ && not ids_.empty()) {
-        InitGraph();
-        entry_point_ = ids_[0];
-        odescent.Build(ids_);
-        odescent.SaveGraph(graph_);
+        if (ids_.size() >= index_min_size) {
+            InitGraph();
+            entry_point_ = ids_[0];
+            odescent.Build(ids_);
+            odescent.SaveGraph(graph_);
+            Vector<InnerIdType>(common_param_->allocator_.get()).swap(ids_);
+        }
+    } else {
         Vector<InnerIdType>(common_param_->allocator_.get()).swap(ids_);
     }
     for (const auto& item : children_) {
-        item.second->BuildGraph(odescent);
+        item.second->BuildGraph(odescent, index_min_size);
     }
 }
 
@@ -81,7 +86,7 @@ IndexNode::GetChild(const std::string& key, bool need_init) {
 }
 
 void
-IndexNode::Deserialize(StreamReader& reader) {
+IndexNode::Deserialize(StreamReader& reader, bool with_flat_ids) {
     // deserialize `entry_point_`
     StreamReader::ReadObj(reader, entry_point_);
     // deserialize `level_`
@@ -94,13 +99,17 @@ IndexNode::Deserialize(StreamReader& reader) {
         InitGraph();
         graph_->Deserialize(reader);
     }
+    // deserialize `ids_` (introduced together with flat nodes)
+    if (with_flat_ids) {
+        StreamReader::ReadVector(reader, ids_);
+    }
     // deserialize `children`
     size_t children_size = 0;
     StreamReader::ReadObj(reader, children_size);
     for (int i = 0; i < children_size; ++i) {
         std::string key = StreamReader::ReadString(reader);
         AddChild(key);
-        children_[key]->Deserialize(reader);
+        children_[key]->Deserialize(reader, with_flat_ids);
     }
 }
 
@@ -117,6 +126,8 @@ IndexNode::Serialize(StreamWriter& writer) const {
     if (has_index) {
         graph_->Serialize(writer);
     }
+    // serialize `ids_`
+    StreamWriter::WriteVector(writer, ids_);
     // serialize `children`
     size_t children_size = children_.size();
     StreamWriter::WriteObj(writer, children_size);
@@ -137,21 +148,29 @@ IndexNode::SearchGraph(const SearchFunc& search_func,
                        const VisitedListPtr& vl,
                        const DistHeapPtr& search_result,
                        int64_t ef_search) const {
-    if (graph_ != nullptr && graph_->TotalCount() > 0) {
-        auto self_search_result = search_func(this, vl);
-        while (not self_search_result->Empty()) {
-            auto result = self_search_result->Top();
-            self_search_result->Pop();
-            search_result->Push(result.first, result.second);
-            if (search_result->Size() > ef_search) {
-                search_result->Pop();
-            }
+    auto self_search_result = search_func(this, vl);
+    while (not self_search_result->Empty()) {
+        auto result = self_search_result->Top();
+        self_search_result->Pop();
+        search_result->Push(result.first, result.second);
+        if (search_result->Size() > ef_search) {
+            search_result->Pop();
         }
+    }
+}
+
+void
+IndexNode::CollectSearchNodes(Vector<const IndexNode*>& nodes) const {
+    // a node with a built graph or a flat list covers its whole subtree,
+    // otherwise descend into the children
+    std::shared_lock lock(mutex_);
+    if ((graph_ != nullptr && graph_->TotalCount() > 0) || not ids_.empty()) {
+        nodes.push_back(this);
         return;
     }
 
     for (const auto& [key, node] : children_) {
-        node->SearchGraph(search_func, vl, search_result, ef_search);
+        node->CollectSearchNodes(nodes);
     }
 }
 
@@ -187,7 +206,7 @@ Pyramid::build_by_odescent(const DatasetPtr& base) {
                 no_build_levels.end();
         }
     }
-    root_->BuildGraph(graph_builder);
+    root_->BuildGraph(graph_builder, index_min_size_);
     cur_element_count_ = data_num;
     max_capacity_ = data_num;
     return {};
@@ -214,21 +233,15 @@ Pyramid::KnnSearch(const DatasetPtr& query,
             std::make_shared<InnerIdWrapperFilter>(filter, *label_table_);
     }
     Statistics stats;
-    auto codes = use_reorder_ ? precise_codes_ : base_codes_;
     SearchFunc search_func = [&](const IndexNode* node, const VisitedListPtr& vl) {
-        std::shared_lock lock(node->mutex_);
-        search_param.ep = node->entry_point_;
-        auto results = searcher_->Search(node->graph_,
-                                         codes,
-                                         vl,
-                                         query->GetFloat32Vectors(),
-                                         search_param,
-                                         (LabelTablePtr) nullptr,
-                                         stats);
-        return results;
+        return this->search_node(node, vl, query->GetFloat32Vectors(), search_param, stats);
     };
 
-    auto result = this->search_impl(query, k, search_func, parsed_param.ef_search);
+    auto result = this->search_impl(query,
+                                    k,
+                                    search_func,
+                                    parsed_param.ef_search,
+                                    parsed_param.parallel_search_thread_count);
     result->Statistics(stats.Dump());
     return result;
 }
@@ -255,22 +268,16 @@ Pyramid::RangeSearch(const DatasetPtr& query,
             std::make_shared<InnerIdWrapperFilter>(filter, *label_table_);
     }
     Statistics stats;
-    auto codes = use_reorder_ ? precise_codes_ : base_codes_;
     SearchFunc search_func = [&](const IndexNode* node, const VisitedListPtr& vl) {
-        std::shared_lock lock(node->mutex_);
-        search_param.ep = node->entry_point_;
-        auto results = searcher_->Search(node->graph_,
-                                         codes,
-                                         vl,
-                                         query->GetFloat32Vectors(),
-                                         search_param,
-                                         (LabelTablePtr) nullptr,
-                                         stats);
-        return results;
+        return this->search_node(node, vl, query->GetFloat32Vectors(), search_param, stats);
     };
     int64_t final_limit = limited_size == -1 ? std::numeric_limits<int64_t>::max() : limited_size;
 
-    auto result = this->search_impl(query, final_limit, search_func, parsed_param.ef_search);
+    auto result = this->search_impl(query,
+                                    final_limit,
+                                    search_func,
+                                    parsed_param.ef_search,
+                                    parsed_param.parallel_search_thread_count);
     result->Statistics(stats.Dump());
     return result;
 }
@@ -279,15 +286,19 @@ DatasetPtr
 Pyramid::search_impl(const DatasetPtr& query,
                      int64_t limit,
                      const SearchFunc& search_func,
-                     int64_t ef_search) const {
+                     int64_t ef_search,
+                     int64_t parallelism) const {
     const auto* query_path = query->GetPaths();
-    CHECK_ARGUMENT(query_path != nullptr || root_->graph_ != nullptr,  // NOLINT
-                   "query_path is required when level0 is not built");
+    if (query_path == nullptr) {
+        // a root kept as a flat list by index_min_size is searchable as well
+        std::shared_lock lock(root_->mutex_);
+        CHECK_ARGUMENT(root_->graph_ != nullptr || not root_->ids_.empty(),  // NOLINT
+                       "query_path is required when level0 is not built");
+    }
     CHECK_ARGUMENT(query->GetFloat32Vectors() != nullptr, "query vectors is required");
 
-    auto search_result = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
-
-    auto vl = pool_->TakeOne();
+    // resolve every matched path into the subgraphs that have to be searched
+    Vector<const IndexNode*> search_nodes(allocator_);
     if (query_path != nullptr) {
         const std::string& current_path = query_path[0];
         auto parsed_path = parse_path(current_path);
@@ -302,13 +313,54 @@ Pyramid::search_impl(const DatasetPtr& query,
                 }
             }
             if (valid) {
-                node->SearchGraph(search_func, vl, search_result, ef_search);
+                node->CollectSearchNodes(search_nodes);
             }
         }
+        // overlapping paths (e.g. "a|a/b") must not search the same subgraph twice
+        std::sort(search_nodes.begin(), search_nodes.end());
+        search_nodes.erase(std::unique(search_nodes.begin(), search_nodes.end()),
+                           search_nodes.end());
     } else {
-        root_->SearchGraph(search_func, vl, search_result, ef_search);
+        root_->CollectSearchNodes(search_nodes);
+    }
+
+    auto node_count = static_cast<int64_t>(search_nodes.size());
+    auto task_count = std::max(std::min(parallelism, node_count), static_cast<int64_t>(1));
+    Vector<DistHeapPtr> heaps(task_count, allocator_);
+    for (auto& heap : heaps) {
+        heap = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+    }
+    // each task checks out one visited list and searches an interleaved share of the subgraphs
+    auto search_task = [&](int64_t task_id) {
+        auto vl = pool_->TakeOne();
+        for (auto i = task_id; i < node_count; i += task_count) {
+            search_nodes[i]->SearchGraph(search_func, vl, heaps[task_id], ef_search);
+        }
+        pool_->ReturnOne(vl);
+    };
+
+    if (task_count == 1 or this->build_pool_ == nullptr) {
+        for (int64_t i = 0; i < task_count; ++i) {
+            search_task(i);
+        }
+    } else {
+        Vector<std::future<void>> futures(allocator_);
+        for (int64_t i = 1; i < task_count; ++i) {
+            futures.push_back(this->build_pool_->GeneralEnqueue(search_task, i));
+        }
+        search_task(0);
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
+
+    auto search_result = heaps[0];
+    for (int64_t i = 1; i < task_count; ++i) {
+        search_result->Merge(*heaps[i]);
+    }
+    while (search_result->Size() > ef_search) {
+        search_result->Pop();
     }
-    pool_->ReturnOne(vl);
 
     if (search_result->Empty()) {
         return DatasetImpl::MakeEmptyDataset();
@@ -340,6 +392,55 @@ Pyramid::search_impl(const DatasetPtr& query,
     return result;
 }
 
+DistHeapPtr
+Pyramid::search_node(const IndexNode* node,
+                     const VisitedListPtr& vl,
+                     const float* query_vector,
+                     const InnerSearchParam& search_param,
+                     Statistics& stats) const {
+    std::shared_lock lock(node->mutex_);
+    auto codes = use_reorder_ ? precise_codes_ : base_codes_;
+    DistHeapPtr results = nullptr;
+    if (node->graph_ != nullptr && node->graph_->TotalCount() > 0) {
+        // subgraphs may be searched concurrently, so each call works on its own copy
+        InnerSearchParam node_search_param = search_param;
+        node_search_param.ep = node->entry_point_;
+        results = searcher_->Search(node->graph_,
+                                    codes,
+                                    vl,
+                                    query_vector,
+                                    node_search_param,
+                                    (LabelTablePtr) nullptr,
+                                    stats);
+    } else {
+        results = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+    }
+    if (node->ids_.empty()) {
+        return results;
+    }
+
+    // brute-force scan of the points that are not (yet) in a graph
+    const auto& ids = node->ids_;
+    auto computer = codes->FactoryComputer(query_vector);
+    Vector<float> dists(ids.size(), allocator_);
+    codes->Query(dists.data(), computer, ids.data(), ids.size());
+    stats.dist_cmp.fetch_add(ids.size(), std::memory_order_relaxed);
+    const auto& filter = search_param.is_inner_id_allowed;
+    for (uint64_t i = 0; i < ids.size(); ++i) {
+        if (filter != nullptr && not filter->CheckValid(ids[i])) {
+            continue;
+        }
+        if (search_param.search_mode == RANGE_SEARCH && dists[i] > search_param.radius) {
+            continue;
+        }
+        results->Push(dists[i], ids[i]);
+        if (search_param.search_mode == KNN_SEARCH && results->Size() > search_param.ef) {
+            results->Pop();
+        }
+    }
+    return results;
+}
+
 int64_t
 Pyramid::GetNumElements() const {
     return base_codes_->TotalCount();
@@ -357,6 +458,7 @@ Pyramid::Serialize(StreamWriter& writer) const {
     // serialize footer (introduced since v0.15)
     JsonType basic_info;
     basic_info["max_capacity"].SetInt(max_capacity_);
+    basic_info["flat_nodes"].SetBool(true);
     auto metadata = std::make_shared<Metadata>();
     metadata->Set(BASIC_INFO, basic_info);
     auto footer = std::make_shared<Footer>(metadata);
@@ -370,6 +472,8 @@ Pyramid::Deserialize(StreamReader& reader) {
     auto metadata = footer->GetMetadata();
     auto basic_info = metadata->Get(BASIC_INFO);
     auto max_capacity = basic_info["max_capacity"].GetInt();
+    // indexes written before flat nodes were introduced do not serialize the ids of a node
+    bool with_flat_ids = basic_info.Contains("flat_nodes") && basic_info["flat_nodes"].GetBool();
 
     BufferStreamReader buffer_reader(
         &reader, std::numeric_limits<uint64_t>::max(), this->allocator_);
@@ -380,7 +484,7 @@ Pyramid::Deserialize(StreamReader& reader) {
         precise_codes_->Deserialize(buffer_reader);
     }
     cur_element_count_ = base_codes_->TotalCount();
-    root_->Deserialize(buffer_reader);
+    root_->Deserialize(buffer_reader, with_flat_ids);
     resize(max_capacity);
 }
 
@@ -564,7 +668,8 @@ static const std::string HGRAPH_PARAMS_TEMPLATE =
         },
         "{BUILD_THREAD_COUNT_KEY}": 16,
         "{EF_CONSTRUCTION_KEY}": 400,
-        "{NO_BUILD_LEVELS}":[]
+        "{NO_BUILD_LEVELS}":[],
+        "{INDEX_MIN_SIZE}": 0
     })";
 
 ParamPtr
@@ -583,6 +688,7 @@ Pyramid::CheckAndMappingExternalParam(const JsonType& external_param,
         {PYRAMID_PRECISE_IO_TYPE, {PRECISE_CODES_KEY, IO_PARAMS_KEY, TYPE_KEY}},
         {PYRAMID_BUILD_THREAD_COUNT, {BUILD_THREAD_COUNT_KEY}},
         {PYRAMID_NO_BUILD_LEVELS, {NO_BUILD_LEVELS}},
+        {PYRAMID_INDEX_MIN_SIZE, {INDEX_MIN_SIZE}},
         {PYRAMID_BASE_PQ_DIM,
          {BASE_CODES_KEY, QUANTIZATION_PARAMS_KEY, PRODUCT_QUANTIZATION_DIM_KEY}},
         {PYRAMID_BASE_FILE_PATH, {BASE_CODES_KEY, IO_PARAMS_KEY, IO_FILE_PATH_KEY}},
@@ -626,6 +732,19 @@ Pyramid::add_one_point(const std::shared_ptr<IndexNode>& node,
                        InnerIdType inner_id,
                        const float* vector) {
     std::unique_lock graph_lock(node->mutex_);
+    if (index_min_size_ > 0 && node->graph_ == nullptr) {
+        // small nodes stay a flat list, the insert that reaches index_min_size builds the graph
+        node->ids_.push_back(inner_id);
+        if (node->building_graph_ || node->ids_.size() < index_min_size_) {
+            return;
+        }
+        node->building_graph_ = true;
+        auto build_count = node->ids_.size();
+        graph_lock.unlock();
+        build_node_graph(node, build_count);
+        return;
+    }
+
     InnerSearchParam search_param;
     search_param.ef = pyramid_param_->ef_construction;
     search_param.topk = pyramid_param_->max_degree;
@@ -663,6 +782,60 @@ Pyramid::add_one_point(const std::shared_ptr<IndexNode>& node,
     }
 }
 
+void
+Pyramid::build_node_graph(const std::shared_ptr<IndexNode>& node, uint64_t build_count) {
+    Vector<InnerIdType> build_ids(allocator_);
+    {
+        std::shared_lock lock(node->mutex_);
+        build_ids.assign(node->ids_.begin(),
+                         node->ids_.begin() + static_cast<int64_t>(build_count));
+    }
+
+    // searches and inserts keep using the flat list while the graph is built outside the lock
+    auto codes = use_reorder_ ? precise_codes_ : base_codes_;
+    auto graph = GraphInterface::MakeInstance(pyramid_param_->graph_param, common_param_);
+    ODescent graph_builder(lazy_build_param_, codes, allocator_, nullptr);
+    graph_builder.Build(build_ids);
+    graph_builder.SaveGraph(graph);
+
+    {
+        std::unique_lock lock(node->mutex_);
+        node->graph_ = graph;
+        node->entry_point_ = build_ids[0];
+        // points added during the build stay in the flat list until they are inserted below
+        Vector<InnerIdType> rest_ids(node->ids_.begin() + static_cast<int64_t>(build_ids.size()),
+                                     node->ids_.end(),
+                                     allocator_);
+        node->ids_.swap(rest_ids);
+        node->building_graph_ = false;
+    }
+
+    // new points go into the graph now, so the flat list only shrinks; each point leaves it right
+    // before its insertion, like any point that is being inserted. A point whose codes cannot be
+    // decoded stays in the flat list
+    Vector<uint8_t> buffer(codes->code_size_, allocator_);
+    Vector<float> vector(dim_, allocator_);
+    while (true) {
+        InnerIdType inner_id = 0;
+        {
+            std::shared_lock lock(node->mutex_);
+            if (node->ids_.empty()) {
+                break;
+            }
+            inner_id = node->ids_.back();
+        }
+        codes->GetCodesById(inner_id, buffer.data());
+        if (not codes->Decode(buffer.data(), vector.data())) {
+            break;
+        }
+        {
+            std::unique_lock lock(node->mutex_);
+            node->ids_.pop_back();
+        }
+        add_one_point(node, inner_id, vector.data());
+    }
+}
+
 std::vector<std::vector<std::string>>
 Pyramid::parse_path(const std::string& path) {
     auto multi_paths = split(path, PART_BAR);
@@ -34,6 +34,7 @@
 namespace vsag {
 
 class IndexNode;
+class PyramidTest;
 using SearchFunc = std::function<DistHeapPtr(const IndexNode* node, const VisitedListPtr& vl)>;
 
 std::vector<std::string>
@@ -44,7 +45,7 @@ public:
     IndexNode(IndexCommonParam* common_param, GraphInterfaceParamPtr graph_param);
 
     void
-    BuildGraph(ODescent& odescent);
+    BuildGraph(ODescent& odescent, uint64_t index_min_size);
 
     void
     InitGraph();
@@ -55,6 +56,9 @@ public:
                 const DistHeapPtr& search_result,
                 int64_t ef_search) const;
 
+    void
+    CollectSearchNodes(Vector<const IndexNode*>& nodes) const;
+
     void
     AddChild(const std::string& key);
 
@@ -65,7 +69,7 @@ public:
     Serialize(StreamWriter& writer) const;
 
     void
-    Deserialize(StreamReader& reader);
+    Deserialize(StreamReader& reader, bool with_flat_ids);
 
 public:
     GraphInterfacePtr graph_{nullptr};
@@ -73,8 +77,11 @@ public:
     uint32_t level_{0};
     mutable std::shared_mutex mutex_;
 
+    // points of a node without graph are scanned as a flat list; after a lazy build it holds the
+    // points added while the graph was being built until they are inserted into the graph
     Vector<InnerIdType> ids_;
     bool has_index_{false};
+    bool building_graph_{false};
 
 private:
     UnorderedMap<std::string, std::shared_ptr<IndexNode>> children_;
@@ -94,7 +101,8 @@ public:
         : InnerIndexInterface(pyramid_param, common_param),
           pyramid_param_(pyramid_param),
           common_param_(common_param),
-          alpha_(pyramid_param->alpha) {
+          alpha_(pyramid_param->alpha),
+          index_min_size_(pyramid_param->index_min_size) {
         base_codes_ =
             FlattenInterface::MakeInstance(pyramid_param_->base_codes_param, common_param_);
         root_ = std::make_shared<IndexNode>(&common_param_, pyramid_param_->graph_param);
@@ -105,6 +113,12 @@ public:
                 FlattenInterface::MakeInstance(pyramid_param_->precise_codes_param, common_param_);
             reorder_ = std::make_shared<FlattenReorder>(precise_codes_, allocator_);
         }
+        lazy_build_param_ = pyramid_param_->odescent_param;
+        if (lazy_build_param_ == nullptr) {
+            lazy_build_param_ = std::make_shared<ODescentParameter>();
+            lazy_build_param_->max_degree = pyramid_param_->max_degree;
+            lazy_build_param_->alpha = alpha_;
+        }
     }
 
     explicit Pyramid(const ParamPtr& param, const IndexCommonParam& common_param)
@@ -169,7 +183,8 @@ private:
     search_impl(const DatasetPtr& query,
                 int64_t limit,
                 const SearchFunc& search_func,
-                int64_t ef_search) const;
+                int64_t ef_search,
+                int64_t parallelism) const;
 
     bool
     is_update_entry_point(uint64_t total_count) {
@@ -181,6 +196,17 @@ private:
     std::vector<int64_t>
     build_by_odescent(const DatasetPtr& base);
 
+    DistHeapPtr
+    search_node(const IndexNode* node,
+                const VisitedListPtr& vl,
+                const float* query_vector,
+                const InnerSearchParam& search_param,
+                Statistics& stats) const;
+
+    // builds the graph of node over its first build_count flat points, then inserts the rest
+    void
+    build_node_graph(const std::shared_ptr<IndexNode>& node, uint64_t build_count);
+
     void
     add_one_point(const std::shared_ptr<IndexNode>& node,
                   InnerIdType inner_id,
@@ -190,6 +216,8 @@ private:
     parse_path(const std::string& path);
 
 private:
+    friend class PyramidTest;
+
     IndexCommonParam common_param_;
     PyramidParamPtr pyramid_param_{nullptr};
     std::shared_ptr<IndexNode> root_{nullptr};
@@ -202,6 +230,8 @@ private:
     int64_t max_capacity_{0};
     int64_t cur_element_count_{0};
     float alpha_{1.0F};
+    uint64_t index_min_size_{0};
+    ODescentParameterPtr lazy_build_param_{nullptr};
 
     std::shared_mutex resize_mutex_;
     std::mutex cur_element_count_mutex_;
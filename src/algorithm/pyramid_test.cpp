@@ -17,6 +17,125 @@
 
 #include <catch2/catch_test_macros.hpp>
 
+#include "fixtures.h"
+
+namespace vsag {
+class PyramidTest {
+public:
+    static std::shared_ptr<IndexNode>
+    GetRoot(const Pyramid& index) {
+        return index.root_;
+    }
+
+    static void
+    BuildNodeGraph(Pyramid& index, const std::shared_ptr<IndexNode>& node, uint64_t build_count) {
+        index.build_node_graph(node, build_count);
+    }
+};
+}  // namespace vsag
+
+using namespace vsag;
+
+static std::shared_ptr<Pyramid>
+make_pyramid(const IndexCommonParam& common_param, uint64_t index_min_size) {
+    auto external_param = JsonType::Parse(fmt::format(
+        R"({{"no_build_levels": [], "index_min_size": {}}})", index_min_size));
+    auto param = Pyramid::CheckAndMappingExternalParam(external_param, common_param);
+    return std::make_shared<Pyramid>(param, common_param);
+}
+
+TEST_CASE("Pyramid Lazy Build Test", "[ut][pyramid]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    IndexCommonParam common_param;
+    common_param.dim_ = 16;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    common_param.allocator_ = allocator;
+    uint64_t index_min_size = 100;
+    auto index = make_pyramid(common_param, index_min_size);
+
+    // the root looks like a lazy build is running, so all the inserts stay in its flat list
+    auto root = PyramidTest::GetRoot(*index);
+    root->building_graph_ = true;
+    int64_t count = 300;
+    auto vectors = fixtures::generate_vectors(count, common_param.dim_);
+    std::vector<int64_t> ids(count);
+    std::vector<std::string> paths(count, "a");
+    for (int64_t i = 0; i < count; ++i) {
+        ids[i] = i;
+    }
+    auto base = Dataset::Make();
+    base->NumElements(count)
+        ->Dim(common_param.dim_)
+        ->Ids(ids.data())
+        ->Paths(paths.data())
+        ->Float32Vectors(vectors.data())
+        ->Owner(false);
+    index->Build(base);
+    REQUIRE(root->graph_ == nullptr);
+    REQUIRE(root->ids_.size() == count);
+
+    // the build covers the points that reached index_min_size, the points added while it ran
+    // are inserted into the graph afterwards instead of staying in the flat list
+    PyramidTest::BuildNodeGraph(*index, root, index_min_size);
+    REQUIRE(root->ids_.empty());
+    REQUIRE_FALSE(root->building_graph_);
+    REQUIRE(root->graph_->TotalCount() == count);
+    auto child = root->GetChild("a");
+    REQUIRE(child->ids_.empty());
+    REQUIRE(child->graph_->TotalCount() == count);
+
+    // a query without path is served by the root graph
+    auto search_param = R"({"pyramid": {"ef_search": 100}})";
+    auto query = Dataset::Make();
+    query->NumElements(1)
+        ->Dim(common_param.dim_)
+        ->Float32Vectors(vectors.data() + (count - 1) * common_param.dim_)
+        ->Owner(false);
+    auto result = index->KnnSearch(query, 1, search_param, nullptr);
+    REQUIRE(result->GetIds()[0] == count - 1);
+}
+
+TEST_CASE("Pyramid Flat Root Search Test", "[ut][pyramid]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    IndexCommonParam common_param;
+    common_param.dim_ = 16;
+    common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+    common_param.allocator_ = allocator;
+    // every node stays a flat list
+    auto index = make_pyramid(common_param, 10000);
+
+    int64_t count = 500;
+    auto vectors = fixtures::generate_vectors(count, common_param.dim_);
+    std::vector<int64_t> ids(count);
+    std::vector<std::string> paths(count, "a");
+    for (int64_t i = 0; i < count; ++i) {
+        ids[i] = i;
+    }
+    auto base = Dataset::Make();
+    base->NumElements(count)
+        ->Dim(common_param.dim_)
+        ->Ids(ids.data())
+        ->Paths(paths.data())
+        ->Float32Vectors(vectors.data())
+        ->Owner(false);
+    index->Build(base);
+    REQUIRE(PyramidTest::GetRoot(*index)->graph_ == nullptr);
+
+    // a query without path scans the flat root
+    int64_t k = 10;
+    auto search_param = R"({"pyramid": {"ef_search": 100}})";
+    for (int64_t i = 0; i < 10; ++i) {
+        auto query = Dataset::Make();
+        query->NumElements(1)
+            ->Dim(common_param.dim_)
+            ->Float32Vectors(vectors.data() + i * common_param.dim_)
+            ->Owner(false);
+        auto result = index->KnnSearch(query, k, search_param, nullptr);
+        REQUIRE(result->GetDim() == k);
+        REQUIRE(result->GetIds()[0] == i);
+    }
+}
+
 TEST_CASE("Split function tests", "[ut][pyramid]") {
     SECTION("Empty input string") {
         auto result = vsag::split("", ',');
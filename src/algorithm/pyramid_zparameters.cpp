@@ -55,6 +55,14 @@ PyramidParameters::FromJson(const JsonType& json) {
         std::sort(this->no_build_levels.begin(), this->no_build_levels.end());
     }
 
+    if (json.Contains(INDEX_MIN_SIZE)) {
+        auto index_min_size_value = json[INDEX_MIN_SIZE].GetInt();
+        CHECK_ARGUMENT(
+            index_min_size_value >= 0,
+            fmt::format("index_min_size({}) must not be negative", index_min_size_value));
+        this->index_min_size = index_min_size_value;
+    }
+
     this->use_reorder = json[USE_REORDER_KEY].GetBool();
     if (this->use_reorder) {
         this->precise_codes_param = CreateFlattenParam(json[PRECISE_CODES_KEY]);
@@ -64,6 +72,7 @@ JsonType
 PyramidParameters::ToJson() const {
     JsonType json = InnerIndexParameter::ToJson();
     json[NO_BUILD_LEVELS].SetVector(no_build_levels);
+    json[INDEX_MIN_SIZE].SetInt(this->index_min_size);
     json[BASE_CODES_KEY].SetJson(base_codes_param->ToJson());
 
     auto graph_json = graph_param->ToJson();
@@ -49,6 +49,8 @@ public:
     ODescentParameterPtr odescent_param{nullptr};
 
     std::vector<int32_t> no_build_levels;
+    // nodes holding fewer points than this are kept as a flat list instead of a graph
+    uint64_t index_min_size{0};
     uint64_t ef_construction{400};
     int64_t max_degree{64};
     std::string graph_type{GRAPH_TYPE_VALUE_NSW};
@@ -26,6 +26,7 @@ struct PyramidDefaultParam {
     bool use_reorder = true;
     std::string base_quantization_type = "fp32";
     std::vector<int> no_build_levels = {0, 1, 2};
+    int index_min_size = 100;
     std::string base_io_type = "memory_io";
     std::string graph_type = "odescent";
     std::string graph_storage_type = "compressed";
@@ -77,6 +78,7 @@ generate_pyramid(const PyramidDefaultParam& param) {
                 "remove_flag_bit": 8,
                 "support_remove": false
             }},
+            "index_min_size": {},
             "no_build_levels": [{}],
             "precise_codes": {{
                 "codes_type": "flatten",
@@ -107,6 +109,7 @@ generate_pyramid(const PyramidDefaultParam& param) {
                        param.graph_storage_type,
                        param.graph_type,
                        param.max_degree,
+                       param.index_min_size,
                        fmt::join(param.no_build_levels, ","),
                        param.precise_file_path,
                        param.precise_io_type,
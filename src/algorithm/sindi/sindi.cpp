@@ -15,12 +15,25 @@
 
 #include "sindi.h"
 
+#include "attr/argparse.h"
+#include "attr/executor/executor.h"
+#include "impl/filter/filter_headers.h"
 #include "impl/heap/standard_heap.h"
 #include "index_feature_list.h"
 #include "storage/serialization.h"
 #include "utils/util_functions.h"
 
 namespace vsag {
+
+// the dense codes are scanned in blocks of ids that pass the filter
+static constexpr InnerIdType DENSE_SCAN_BLOCK_SIZE = 1024;
+
+// the rerank is only split when every task gets at least this many candidates
+static constexpr uint64_t MIN_RERANK_COUNT_PER_TASK = 256;
+
+// a filter that lets less than this ratio of the ids through is evaluated into window masks
+static constexpr float WINDOW_MASK_VALID_RATIO = 0.7F;
+
 ParamPtr
 SINDI::CheckAndMappingExternalParam(const JsonType& external_param,
                                     const IndexCommonParam& common_param) {
@@ -32,16 +45,22 @@ SINDI::CheckAndMappingExternalParam(const JsonType& external_param,
 SINDI::SINDI(const SINDIParameterPtr& param, const IndexCommonParam& common_param)
     : InnerIndexInterface(param, common_param),
       use_reorder_(param->use_reorder),
+      use_compression_(param->use_compression),
       term_id_limit_(param->term_id_limit),
       window_size_(param->window_size),
       doc_retain_ratio_(1.0F - param->doc_prune_ratio),
       window_term_list_(common_param.allocator_.get()),
-      deserialize_without_footer_(param->deserialize_without_footer) {
+      deserialize_without_footer_(param->deserialize_without_footer),
+      thread_pool_(common_param.thread_pool_) {
     if (use_reorder_) {
         SparseIndexParameterPtr rerank_param = std::make_shared<SparseIndexParameters>();
         rerank_param->need_sort = true;
         rerank_flat_index_ = std::make_shared<SparseIndex>(rerank_param, common_param);
     }
+    if (param->dense_codes_param != nullptr) {
+        CHECK_ARGUMENT(dim_ > 0, "dim must be set for the dense codes of a hybrid index");
+        dense_codes_ = FlattenInterface::MakeInstance(param->dense_codes_param, common_param);
+    }
 }
 
 std::vector<int64_t>
@@ -56,18 +75,20 @@ SINDI::Add(const DatasetPtr& base) {
     const auto* ids = base->GetIds();
     const auto* extra_info = base->GetExtraInfos();
     const auto extra_info_size = base->GetExtraInfoSize();
-
-    // adjust window
-    int64_t final_add_window = ceil_int(cur_element_count_ + data_num, window_size_) / window_size_;
-    while (window_term_list_.size() < final_add_window) {
-        window_term_list_.emplace_back(
-            std::make_shared<SparseTermDataCell>(doc_retain_ratio_, term_id_limit_, allocator_));
+    const auto* attrs = base->GetAttributeSets();
+    const auto* dense_vectors = base->GetFloat32Vectors();
+    if (dense_codes_ != nullptr) {
+        CHECK_ARGUMENT(dense_vectors != nullptr, "base.float_vector is nullptr");
+        CHECK_ARGUMENT(
+            base->GetDim() == dim_,
+            fmt::format("base.dim({}) must be equal to index.dim({})", base->GetDim(), dim_));
     }
 
-    // add process
-    for (uint32_t i = 0; i < data_num; ++i) {
-        auto cur_window = cur_element_count_ / window_size_;
-        auto window_start_id = cur_window * window_size_;
+    // check the vectors first, the valid ones get consecutive inner ids
+    Vector<SparseVector> valid_vectors(allocator_);
+    Vector<int64_t> valid_ids(allocator_);
+    Vector<int64_t> valid_offsets(allocator_);
+    for (int64_t i = 0; i < data_num; ++i) {
         const auto& sparse_vector = sparse_vectors[i];
         if (sparse_vector.len_ <= 0) {
             failed_ids.push_back(ids[i]);
@@ -75,39 +96,98 @@ SINDI::Add(const DatasetPtr& base) {
                 "sparse_vector.len_ ({}) is invalid for id ({})", sparse_vector.len_, ids[i]);
             continue;
         }
-
-        uint32_t inner_id = cur_element_count_ - window_start_id;
-
-        try {
-            window_term_list_[cur_window]->InsertVector(sparse_vector, inner_id);
-        } catch (const std::runtime_error& e) {
+        auto max_term_id =
+            *std::max_element(sparse_vector.ids_, sparse_vector.ids_ + sparse_vector.len_);
+        if (max_term_id > term_id_limit_) {
             failed_ids.push_back(ids[i]);
-            logger::warn("runtime error: {}", e.what());
-            continue;
-        } catch (const std::bad_alloc& e) {
-            failed_ids.push_back(ids[i]);
-            logger::warn("memory allocation failed: {}", e.what());
+            logger::warn("max term id ({}) is greater than term id limit ({}) for id ({})",
+                         max_term_id,
+                         term_id_limit_,
+                         ids[i]);
             continue;
         }
+        valid_vectors.push_back(sparse_vector);
+        valid_ids.push_back(ids[i]);
+        valid_offsets.push_back(i);
+    }
+    auto valid_num = static_cast<int64_t>(valid_vectors.size());
+    if (valid_num == 0) {
+        return failed_ids;
+    }
 
-        label_table_->Insert(cur_element_count_, ids[i]);  // todo(zxy): check id exists
+    // adjust window
+    int64_t final_add_window =
+        ceil_int(cur_element_count_ + valid_num, window_size_) / window_size_;
+    while (window_term_list_.size() < final_add_window) {
+        window_term_list_.emplace_back(std::make_shared<SparseTermDataCell>(
+            doc_retain_ratio_, term_id_limit_, allocator_, use_compression_));
+    }
 
-        if (extra_info_size > 0) {
-            extra_infos_->InsertExtraInfo(extra_info + i * extra_info_size, cur_element_count_);
+    // the batch covers a range of windows, each of them is filled by one task
+    auto first_window = cur_element_count_ / window_size_;
+    auto fill_window = [&](int64_t window_id) -> void {
+        auto window_start_id = window_id * window_size_;
+        auto begin = std::max(window_start_id, cur_element_count_);
+        auto end = std::min(window_start_id + window_size_, cur_element_count_ + valid_num);
+        const auto* window_vectors = valid_vectors.data() + (begin - cur_element_count_);
+        window_term_list_[window_id]->InsertVectors(
+            window_vectors, end - begin, begin - window_start_id);
+        // a full window takes no more vectors, so it can be compressed
+        if (use_compression_ and end == window_start_id + window_size_) {
+            window_term_list_[window_id]->Compress();
+        }
+    };
+    if (thread_pool_ == nullptr or final_add_window - first_window <= 1) {
+        for (auto window_id = first_window; window_id < final_add_window; ++window_id) {
+            fill_window(window_id);
+        }
+    } else {
+        std::vector<std::future<void>> futures;
+        for (auto window_id = first_window + 1; window_id < final_add_window; ++window_id) {
+            futures.emplace_back(thread_pool_->GeneralEnqueue(fill_window, window_id));
         }
+        fill_window(first_window);
+        for (auto& future : futures) {
+            future.get();
+        }
+    }
 
-        cur_element_count_++;
+    // the dense vectors follow the same inner ids as the sparse ones
+    if (dense_codes_ != nullptr) {
+        Vector<float> valid_dense_vectors(valid_num * dim_, allocator_);
+        for (int64_t i = 0; i < valid_num; ++i) {
+            memcpy(valid_dense_vectors.data() + i * dim_,
+                   dense_vectors + valid_offsets[i] * dim_,
+                   dim_ * sizeof(float));
+        }
+        if (cur_element_count_ == 0) {
+            dense_codes_->Train(valid_dense_vectors.data(), valid_num);
+        }
+        dense_codes_->Resize(cur_element_count_ + valid_num);
+        dense_codes_->BatchInsertVector(valid_dense_vectors.data(), valid_num);
+    }
 
-        // high precision part
-        if (use_reorder_) {
-            auto single_base = Dataset::Make();
-            single_base->NumElements(1)
-                ->SparseVectors(sparse_vectors + i)
-                ->Ids(ids + i)
-                ->Owner(false);
-            rerank_flat_index_->Add(single_base);
+    for (int64_t i = 0; i < valid_num; ++i) {
+        label_table_->Insert(cur_element_count_ + i, valid_ids[i]);  // todo(zxy): check id exists
+        if (extra_info_size > 0) {
+            extra_infos_->InsertExtraInfo(extra_info + valid_offsets[i] * extra_info_size,
+                                          cur_element_count_ + i);
+        }
+        if (use_attribute_filter_ and attrs != nullptr) {
+            attr_filter_index_->Insert(attrs[valid_offsets[i]], cur_element_count_ + i);
         }
     }
+    cur_element_count_ += valid_num;
+
+    // high precision part
+    if (use_reorder_) {
+        auto valid_base = Dataset::Make();
+        valid_base->NumElements(valid_num)
+            ->SparseVectors(valid_vectors.data())
+            ->Ids(valid_ids.data())
+            ->Owner(false);
+        rerank_flat_index_->Add(valid_base);
+    }
 
     return failed_ids;
 }
@@ -132,44 +212,111 @@ SINDI::KnnSearch(const DatasetPtr& query,
                  const std::string& parameters,
                  const FilterPtr& filter,
                  vsag::Allocator* allocator) const {
+    SearchRequest req;
+    req.query_ = query;
+    req.topk_ = k;
+    req.filter_ = filter;
+    req.params_str_ = parameters;
+    req.search_allocator_ = allocator;
+    return this->SearchWithRequest(req);
+}
+
+DatasetPtr
+SINDI::SearchWithRequest(const SearchRequest& request) const {
     std::shared_lock rlock(this->global_mutex_);
 
-    // Due to concerns about the performance of this index
-    // We have not yet implemented search with filtering capabilities
+    const auto& query = request.query_;
     const auto* sparse_vectors = query->GetSparseVectors();
     CHECK_ARGUMENT(query->GetNumElements() == 1, "num of query should be 1");
     auto sparse_query = sparse_vectors[0];
     CHECK_ARGUMENT(
         sparse_query.len_ > 0,
         fmt::format("query->GetSparseVectors()->len_ ({}) is invalid", sparse_query.len_));
+    Allocator* search_allocator = allocator_;
+    if (request.search_allocator_ != nullptr) {
+        search_allocator = request.search_allocator_;
+    }
 
     // search parameter
     SINDISearchParameter search_param;
-    search_param.FromJson(JsonType::Parse(parameters));
-    CHECK_ARGUMENT(search_param.n_candidate <= SPARSE_AMPLIFICATION_FACTOR * k,
-                   fmt::format("n_candidate ({}) should be less than {} * k ({})",
-                               search_param.n_candidate,
-                               AMPLIFICATION_FACTOR,
-                               k));
+    search_param.FromJson(JsonType::Parse(request.params_str_));
     InnerSearchParam inner_param;
-    inner_param.ef = std::max(static_cast<int64_t>(search_param.n_candidate), k);
-    inner_param.topk = k;
+    inner_param.parallel_search_thread_count = search_param.parallel_search_thread_count;
+    auto k = request.topk_;
+    if (request.mode_ == SearchMode::KNN_SEARCH) {
+        CHECK_ARGUMENT(search_param.n_candidate <= SPARSE_AMPLIFICATION_FACTOR * k,
+                       fmt::format("n_candidate ({}) should be less than {} * k ({})",
+                                   search_param.n_candidate,
+                                   AMPLIFICATION_FACTOR,
+                                   k));
+        inner_param.ef = std::max(static_cast<int64_t>(search_param.n_candidate), k);
+        inner_param.topk = k;
+    } else {
+        inner_param.range_search_limit_size = static_cast<int>(request.limited_size_);
+        inner_param.radius = request.radius_;
+    }
 
-    FilterPtr ft = nullptr;
-    if (filter != nullptr) {
-        ft = std::make_shared<InnerIdWrapperFilter>(filter, *this->label_table_);
+    // all the filters are gathered into one filter on inner ids
+    auto combined_filter =
+        std::make_shared<CombinedInnerIdFilter>(*this->label_table_, cur_element_count_);
+    if (request.filter_ != nullptr) {
+        combined_filter->SetLabelFilter(request.filter_);
+    }
+    if (request.enable_bitset_filter_ and request.bitset_filter_ != nullptr) {
+        combined_filter->SetLabelBlackList(request.bitset_filter_);
+    }
+    ExecutorPtr executor = nullptr;
+    if (request.enable_attribute_filter_ and this->attr_filter_index_ != nullptr) {
+        auto& schema = this->attr_filter_index_->field_type_map_;
+        auto expr = AstParse(request.attribute_filter_str_, &schema);
+        executor = Executor::MakeInstance(this->allocator_, expr, this->attr_filter_index_);
+        executor->Init();
+        executor->Clear();
+        const auto* attr_filter = executor->Run();
+        if (executor->only_bitset_) {
+            combined_filter->SetInnerIdWhiteList(executor->bitset_);
+        } else {
+            combined_filter->SetInnerIdFilter(attr_filter);
+        }
+    }
+
+    // a selective filter is evaluated once per window into a mask, so that fully filtered-out
+    // windows are skipped and filtered-out postings are not accumulated; a permissive filter is
+    // only checked for the candidates that reach the heap. The hybrid search checks every id in
+    // its dense scan anyway, so it always takes the masks
+    const auto* dense_query = query->GetFloat32Vectors();
+    bool hybrid = dense_codes_ != nullptr and dense_query != nullptr;
+    CombinedInnerIdFilterPtr window_filter = nullptr;
+    if (not combined_filter->Empty()) {
+        if (hybrid or combined_filter->ValidRatio() < WINDOW_MASK_VALID_RATIO) {
+            window_filter = combined_filter;
+        } else {
+            inner_param.is_inner_id_allowed = combined_filter;
+        }
     }
-    inner_param.is_inner_id_allowed = ft;
 
     auto computer = std::make_shared<SparseTermComputer>(sparse_query, search_param, allocator_);
-    return search_impl<KNN_SEARCH>(computer, inner_param, allocator);
+    if (hybrid) {
+        CHECK_ARGUMENT(request.mode_ == SearchMode::KNN_SEARCH,
+                       "hybrid search only supports knn search");
+        CHECK_ARGUMENT(
+            query->GetDim() == dim_,
+            fmt::format("query.dim({}) must be equal to index.dim({})", query->GetDim(), dim_));
+        return hybrid_search_impl(
+            computer, dense_query, search_param, inner_param, search_allocator, window_filter);
+    }
+    if (request.mode_ == SearchMode::RANGE_SEARCH) {
+        return search_impl<RANGE_SEARCH>(computer, inner_param, search_allocator, window_filter);
+    }
+    return search_impl<KNN_SEARCH>(computer, inner_param, search_allocator, window_filter);
 }
 
 template <InnerSearchMode mode>
 DatasetPtr
 SINDI::search_impl(const SparseTermComputerPtr& computer,
                    const InnerSearchParam& inner_param,
-                   Allocator* allocator) const {
+                   Allocator* allocator,
+                   const CombinedInnerIdFilterPtr& window_filter) const {
     // computer and heap
     MaxHeap heap(allocator);
     int64_t k = 0;
@@ -179,22 +326,63 @@ SINDI::search_impl(const SparseTermComputerPtr& computer,
     }
 
     // window iteration
-    Vector<float> dists(window_size_, 0.0, allocator);
-
-    for (auto cur = 0; cur < window_term_list_.size(); cur++) {
-        auto window_start_id = cur * window_size_;
-        auto term_list = this->window_term_list_[cur];
-
-        // compute
-        term_list->Query(dists.data(), computer);
+    int64_t window_count = static_cast<int64_t>(window_term_list_.size());
+    int64_t thread_count = std::min(inner_param.parallel_search_thread_count, window_count);
+    if (thread_pool_ == nullptr or thread_count <= 1) {
+        Vector<float> dists(window_size_, 0.0, allocator);
+        Vector<uint8_t> window_mask(window_filter == nullptr ? 0 : window_size_, 0, allocator);
+        for (auto cur = 0; cur < window_count; cur++) {
+            scan_window<mode>(computer,
+                              inner_param,
+                              window_filter,
+                              cur,
+                              dists.data(),
+                              window_mask.data(),
+                              heap);
+        }
+    } else {
+        // each task owns a computer (it carries the term iterator), an accumulator and a heap,
+        // windows are handed out by an atomic cursor and the heaps are merged at the end
+        std::atomic<int64_t> next_window(0);
+        Vector<SparseTermComputerPtr> computers(thread_count, nullptr, allocator_);
+        Vector<MaxHeap> heaps(thread_count, MaxHeap(allocator_), allocator_);
+        for (auto& local_computer : computers) {
+            local_computer = std::make_shared<SparseTermComputer>(*computer);
+        }
+        auto scan_func = [&](int64_t thread_id) -> void {
+            Vector<float> dists(window_size_, 0.0, allocator_);
+            Vector<uint8_t> window_mask(window_filter == nullptr ? 0 : window_size_, 0, allocator_);
+            for (auto cur = next_window.fetch_add(1); cur < window_count;
+                 cur = next_window.fetch_add(1)) {
+                scan_window<mode>(computers[thread_id],
+                                  inner_param,
+                                  window_filter,
+                                  cur,
+                                  dists.data(),
+                                  window_mask.data(),
+                                  heaps[thread_id]);
+            }
+        };
+        std::vector<std::future<void>> futures;
+        for (int64_t thread_id = 1; thread_id < thread_count; ++thread_id) {
+            futures.emplace_back(thread_pool_->GeneralEnqueue(scan_func, thread_id));
+        }
+        scan_func(0);
+        for (auto& future : futures) {
+            future.get();
+        }
 
-        // insert heap
-        if (inner_param.is_inner_id_allowed) {
-            term_list->InsertHeap<mode, WITH_FILTER>(
-                dists.data(), computer, heap, inner_param, window_start_id);
-        } else {
-            term_list->InsertHeap<mode, PURE>(
-                dists.data(), computer, heap, inner_param, window_start_id);
+        // the per-task heaps hold at most ef candidates each in knn mode
+        for (auto& local_heap : heaps) {
+            while (not local_heap.empty()) {
+                heap.push(local_heap.top());
+                local_heap.pop();
+                if constexpr (mode == KNN_SEARCH) {
+                    if (heap.size() > inner_param.ef) {
+                        heap.pop();
+                    }
+                }
+            }
         }
     }
 
@@ -206,13 +394,40 @@ SINDI::search_impl(const SparseTermComputerPtr& computer,
         auto high_precise_heap = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
         auto [sorted_ids, sorted_vals] =
             rerank_flat_index_->sort_sparse_vector(computer->raw_query_);
-        for (auto i = 0; i < candidate_size; i++) {
-            auto inner_id = heap.top().second;
-            auto high_precise_distance = rerank_flat_index_->CalDistanceByIdUnsafe(
-                sorted_ids,
-                sorted_vals,
-                inner_id);  // TODO(ZXY): use flat to replace rerank_flat_index_
-            auto label = label_table_->GetLabelById(inner_id);
+        Vector<InnerIdType> candidate_ids(candidate_size, allocator);
+        Vector<float> precise_dists(candidate_size, allocator);
+        for (uint64_t i = 0; i < candidate_size; i++) {
+            candidate_ids[i] = heap.top().second;
+            heap.pop();
+        }
+        // TODO(ZXY): use flat to replace rerank_flat_index_
+        auto rerank_func = [&](uint64_t start, uint64_t end) -> void {
+            for (auto i = start; i < end; ++i) {
+                precise_dists[i] = rerank_flat_index_->CalDistanceByIdUnsafe(
+                    sorted_ids, sorted_vals, candidate_ids[i]);
+            }
+        };
+        auto rerank_thread_count = std::min(
+            static_cast<uint64_t>(inner_param.parallel_search_thread_count),
+            candidate_size / MIN_RERANK_COUNT_PER_TASK);
+        if (thread_pool_ == nullptr or rerank_thread_count <= 1) {
+            rerank_func(0, candidate_size);
+        } else {
+            auto chunk_size = (candidate_size + rerank_thread_count - 1) / rerank_thread_count;
+            std::vector<std::future<void>> futures;
+            for (uint64_t start = chunk_size; start < candidate_size; start += chunk_size) {
+                auto end = std::min(start + chunk_size, candidate_size);
+                futures.emplace_back(thread_pool_->GeneralEnqueue(rerank_func, start, end));
+            }
+            rerank_func(0, chunk_size);
+            for (auto& future : futures) {
+                future.get();
+            }
+        }
+
+        for (uint64_t i = 0; i < candidate_size; i++) {
+            auto high_precise_distance = precise_dists[i];
+            auto label = label_table_->GetLabelById(candidate_ids[i]);
             if constexpr (mode == KNN_SEARCH) {
                 if (high_precise_distance < cur_heap_top or high_precise_heap->Size() < k) {
                     high_precise_heap->Push(high_precise_distance, label);
@@ -231,7 +446,6 @@ SINDI::search_impl(const SparseTermComputerPtr& computer,
                     high_precise_heap->Pop();
                 }
             }
-            heap.pop();
         }
 
         return rerank_flat_index_->collect_results(high_precise_heap);
@@ -265,39 +479,225 @@ SINDI::search_impl(const SparseTermComputerPtr& computer,
     return results;
 }
 
-DatasetPtr
-SINDI::RangeSearch(const DatasetPtr& query,
-                   float radius,
-                   const std::string& parameters,
-                   const FilterPtr& filter,
-                   int64_t limited_size) const {
-    std::shared_lock rlock(this->global_mutex_);
+template <InnerSearchMode mode>
+void
+SINDI::scan_window(const SparseTermComputerPtr& computer,
+                   const InnerSearchParam& inner_param,
+                   const CombinedInnerIdFilterPtr& window_filter,
+                   uint32_t window_id,
+                   float* dists,
+                   uint8_t* window_mask,
+                   MaxHeap& heap) const {
+    auto window_start_id = window_id * window_size_;
+    const auto& term_list = this->window_term_list_[window_id];
+
+    if (window_filter != nullptr) {
+        if (fill_window_mask(window_filter, window_id, window_mask) == 0) {
+            return;
+        }
+        // filtered-out documents are never accumulated, the mask keeps them out of the heap
+        term_list->Query(dists, computer, window_mask);
+        InnerSearchParam window_param = inner_param;
+        window_param.is_inner_id_allowed =
+            std::make_shared<WindowMaskFilter>(window_mask, window_start_id);
+        term_list->InsertHeap<mode, WITH_FILTER>(
+            dists, computer, heap, window_param, window_start_id);
+        return;
+    }
 
-    // Due to concerns about the performance of this index
-    // We have not yet implemented search with filtering capabilities
-    const auto* sparse_vectors = query->GetSparseVectors();
-    CHECK_ARGUMENT(query->GetNumElements() == 1, "num of query should be 1");
-    auto sparse_query = sparse_vectors[0];
-    CHECK_ARGUMENT(
-        sparse_query.len_ > 0,
-        fmt::format("query->GetSparseVectors()->len_ ({}) is invalid", sparse_query.len_));
+    // the pruning needs a threshold: the worst candidate of a full heap, or the radius
+    float threshold = std::numeric_limits<float>::max();
+    if (computer->use_term_pruning_) {
+        if constexpr (mode == KNN_SEARCH) {
+            if (heap.size() >= inner_param.ef) {
+                threshold = heap.top().first;
+            }
+        } else {
+            threshold = inner_param.radius - 1;  // dist in heap is 0 - ip
+        }
+    }
 
-    // search parameter
-    SINDISearchParameter search_param;
-    search_param.FromJson(JsonType::Parse(parameters));
-    InnerSearchParam inner_param;
+    // compute and insert heap
+    if (threshold != std::numeric_limits<float>::max() and
+        term_list->QueryWithPruning(dists, computer, threshold)) {
+        if (inner_param.is_inner_id_allowed) {
+            term_list->InsertCandidates<mode, WITH_FILTER>(
+                dists, computer, heap, inner_param, window_start_id);
+        } else {
+            term_list->InsertCandidates<mode, PURE>(
+                dists, computer, heap, inner_param, window_start_id);
+        }
+        return;
+    }
+    term_list->Query(dists, computer);
+    if (inner_param.is_inner_id_allowed) {
+        term_list->InsertHeap<mode, WITH_FILTER>(
+            dists, computer, heap, inner_param, window_start_id);
+    } else {
+        term_list->InsertHeap<mode, PURE>(dists, computer, heap, inner_param, window_start_id);
+    }
+}
 
-    inner_param.range_search_limit_size = static_cast<int>(limited_size);
-    inner_param.radius = radius;
+DatasetPtr
+SINDI::hybrid_search_impl(const SparseTermComputerPtr& computer,
+                          const float* dense_query,
+                          const SINDISearchParameter& search_param,
+                          const InnerSearchParam& inner_param,
+                          Allocator* allocator,
+                          const CombinedInnerIdFilterPtr& window_filter) const {
+    auto candidate_count = static_cast<uint64_t>(inner_param.ef);
+
+    // dense candidates
+    auto dense_computer = dense_codes_->FactoryComputer(dense_query);
+    MaxHeap dense_heap(allocator);
+    Vector<InnerIdType> block_ids(DENSE_SCAN_BLOCK_SIZE, allocator);
+    Vector<float> block_dists(DENSE_SCAN_BLOCK_SIZE, allocator);
+    Vector<uint8_t> block_mask(window_filter == nullptr ? 0 : DENSE_SCAN_BLOCK_SIZE, allocator);
+    auto total_count = static_cast<InnerIdType>(cur_element_count_);
+    for (InnerIdType start = 0; start < total_count; start += DENSE_SCAN_BLOCK_SIZE) {
+        auto end = std::min(start + DENSE_SCAN_BLOCK_SIZE, total_count);
+        InnerIdType count = 0;
+        if (window_filter != nullptr) {
+            window_filter->FillMask(start, end - start, block_mask.data());
+            for (auto id = start; id < end; ++id) {
+                block_ids[count] = id;
+                count += block_mask[id - start];
+            }
+        } else {
+            for (auto id = start; id < end; ++id) {
+                block_ids[count++] = id;
+            }
+        }
+        dense_codes_->Query(block_dists.data(), dense_computer, block_ids.data(), count, allocator);
+        for (InnerIdType i = 0; i < count; ++i) {
+            if (dense_heap.size() < candidate_count or block_dists[i] < dense_heap.top().first) {
+                dense_heap.emplace(block_dists[i], block_ids[i]);
+                if (dense_heap.size() > candidate_count) {
+                    dense_heap.pop();
+                }
+            }
+        }
+    }
 
-    FilterPtr ft = nullptr;
-    if (filter != nullptr) {
-        ft = std::make_shared<InnerIdWrapperFilter>(filter, *this->label_table_);
+    // (inner id, accumulated sparse distance), sorted so that each window picks up its own
+    Vector<std::pair<InnerIdType, float>> candidates(allocator);
+    while (not dense_heap.empty()) {
+        candidates.emplace_back(dense_heap.top().second, 0.0F);
+        dense_heap.pop();
     }
-    inner_param.is_inner_id_allowed = ft;
+    std::sort(candidates.begin(), candidates.end());
 
-    auto computer = std::make_shared<SparseTermComputer>(sparse_query, search_param, allocator_);
-    return search_impl<RANGE_SEARCH>(computer, inner_param, allocator_);
+    // sparse candidates, the accumulator of a window also scores the dense candidates in it
+    MaxHeap sparse_heap(allocator);
+    Vector<float> dists(window_size_, 0.0, allocator);
+    Vector<uint8_t> window_mask(window_filter == nullptr ? 0 : window_size_, 0, allocator);
+    uint64_t next_candidate = 0;
+    auto dense_candidate_count = candidates.size();
+    for (uint32_t window_id = 0; window_id < window_term_list_.size(); ++window_id) {
+        auto window_start_id = window_id * window_size_;
+        const auto& term_list = window_term_list_[window_id];
+        InnerSearchParam window_param = inner_param;
+        if (window_filter != nullptr) {
+            if (fill_window_mask(window_filter, window_id, window_mask.data()) == 0) {
+                continue;
+            }
+            term_list->Query(dists.data(), computer, window_mask.data());
+            window_param.is_inner_id_allowed =
+                std::make_shared<WindowMaskFilter>(window_mask.data(), window_start_id);
+        } else {
+            term_list->Query(dists.data(), computer);
+        }
+        for (; next_candidate < dense_candidate_count and
+               candidates[next_candidate].first < window_start_id + window_size_;
+             ++next_candidate) {
+            candidates[next_candidate].second =
+                dists[candidates[next_candidate].first - window_start_id];
+        }
+        if (window_param.is_inner_id_allowed) {
+            term_list->InsertHeap<KNN_SEARCH, WITH_FILTER>(
+                dists.data(), computer, sparse_heap, window_param, window_start_id);
+        } else {
+            term_list->InsertHeap<KNN_SEARCH, PURE>(
+                dists.data(), computer, sparse_heap, window_param, window_start_id);
+        }
+    }
+    while (not sparse_heap.empty()) {
+        candidates.emplace_back(sparse_heap.top().second, sparse_heap.top().first);
+        sparse_heap.pop();
+    }
+    std::sort(candidates.begin(), candidates.end());
+    auto last = std::unique(
+        candidates.begin(), candidates.end(), [](const auto& left, const auto& right) {
+            return left.first == right.first;
+        });
+    candidates.erase(last, candidates.end());
+
+    // fuse the distances of the union of candidates
+    Vector<InnerIdType> candidate_ids(candidates.size(), allocator);
+    Vector<float> dense_dists(candidates.size(), allocator);
+    for (uint64_t i = 0; i < candidates.size(); ++i) {
+        candidate_ids[i] = candidates[i].first;
+    }
+    dense_codes_->Query(dense_dists.data(),
+                        dense_computer,
+                        candidate_ids.data(),
+                        static_cast<InnerIdType>(candidate_ids.size()),
+                        allocator);
+    Vector<uint32_t> sorted_ids(allocator);
+    Vector<float> sorted_vals(allocator);
+    if (use_reorder_) {
+        std::tie(sorted_ids, sorted_vals) =
+            rerank_flat_index_->sort_sparse_vector(computer->raw_query_);
+    }
+    auto k = static_cast<uint64_t>(inner_param.topk);
+    MaxHeap heap(allocator);
+    for (uint64_t i = 0; i < candidates.size(); ++i) {
+        float sparse_dist = 1 + candidates[i].second;  // dist = -ip -> 1 + dist = 1 - ip
+        if (use_reorder_) {
+            sparse_dist = rerank_flat_index_->CalDistanceByIdUnsafe(
+                sorted_ids, sorted_vals, candidate_ids[i]);
+        }
+        auto dist =
+            search_param.dense_weight * dense_dists[i] + search_param.sparse_weight * sparse_dist;
+        heap.emplace(dist, candidate_ids[i]);
+        if (heap.size() > k) {
+            heap.pop();
+        }
+    }
+
+    auto cur_size = static_cast<int64_t>(heap.size());
+    auto [results, ret_dists, ret_ids] = create_fast_dataset(cur_size, allocator_);
+    for (auto j = cur_size - 1; j >= 0; j--) {
+        ret_dists[j] = heap.top().first;
+        ret_ids[j] = label_table_->GetLabelById(heap.top().second);
+        heap.pop();
+    }
+    return results;
+}
+
+uint32_t
+SINDI::fill_window_mask(const CombinedInnerIdFilterPtr& window_filter,
+                        uint32_t window_id,
+                        uint8_t* window_mask) const {
+    int64_t window_start_id = static_cast<int64_t>(window_id) * window_size_;
+    auto count = std::min(static_cast<int64_t>(window_size_), cur_element_count_ - window_start_id);
+    return window_filter->FillMask(window_start_id, count, window_mask);
+}
+
+DatasetPtr
+SINDI::RangeSearch(const DatasetPtr& query,
+                   float radius,
+                   const std::string& parameters,
+                   const FilterPtr& filter,
+                   int64_t limited_size) const {
+    SearchRequest req;
+    req.query_ = query;
+    req.mode_ = SearchMode::RANGE_SEARCH;
+    req.radius_ = radius;
+    req.limited_size_ = limited_size;
+    req.filter_ = filter;
+    req.params_str_ = parameters;
+    return this->SearchWithRequest(req);
 }
 
 void
@@ -318,6 +718,14 @@ SINDI::Serialize(StreamWriter& writer) const {
         rerank_flat_index_->Serialize(writer);
     }
 
+    if (use_attribute_filter_ and attr_filter_index_ != nullptr) {
+        attr_filter_index_->Serialize(writer);
+    }
+
+    if (dense_codes_ != nullptr) {
+        dense_codes_->Serialize(writer);
+    }
+
     JsonType jsonify_basic_info;
     auto metadata = std::make_shared<Metadata>();
     jsonify_basic_info[INDEX_PARAM].SetString(this->create_param_ptr_->ToString());
@@ -358,8 +766,8 @@ SINDI::Deserialize(StreamReader& reader) {
     StreamReader::ReadObj(buffer_reader, window_term_list_size);
     window_term_list_.resize(window_term_list_size);
     for (auto& window : window_term_list_) {
-        window =
-            std::make_shared<SparseTermDataCell>(doc_retain_ratio_, term_id_limit_, allocator_);
+        window = std::make_shared<SparseTermDataCell>(
+            doc_retain_ratio_, term_id_limit_, allocator_, use_compression_);
         window->Deserialize(buffer_reader);
     }
 
@@ -368,6 +776,14 @@ SINDI::Deserialize(StreamReader& reader) {
     if (use_reorder_) {
         rerank_flat_index_->Deserialize(buffer_reader);
     }
+
+    if (use_attribute_filter_ and attr_filter_index_ != nullptr) {
+        attr_filter_index_->Deserialize(buffer_reader);
+    }
+
+    if (dense_codes_ != nullptr) {
+        dense_codes_->Deserialize(buffer_reader);
+    }
 }
 
 bool
@@ -417,6 +833,11 @@ SINDI::EstimateMemory(uint64_t num_elements) const {
     // size of term list
     mem += sizeof(std::vector<float>) * 2 * term_id_limit_;
 
+    // size of dense codes
+    if (dense_codes_ != nullptr) {
+        mem += dense_codes_->code_size_ * num_elements;
+    }
+
     return mem;
 }
 
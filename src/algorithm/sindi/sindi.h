@@ -17,7 +17,9 @@
 
 #include "algorithm/inner_index_interface.h"
 #include "algorithm/sparse_index.h"
+#include "datacell/flatten_interface.h"
 #include "datacell/sparse_term_datacell.h"
+#include "impl/filter/combined_inner_id_filter.h"
 
 namespace vsag {
 
@@ -73,6 +75,9 @@ public:
                 const FilterPtr& filter,
                 int64_t limited_size = -1) const override;
 
+    DatasetPtr
+    SearchWithRequest(const SearchRequest& request) const override;
+
     InnerIndexPtr
     Fork(const IndexCommonParam& param) override {
         return nullptr;
@@ -120,7 +125,31 @@ private:
     DatasetPtr
     search_impl(const SparseTermComputerPtr& computer,
                 const InnerSearchParam& inner_param,
-                Allocator* allocator) const;
+                Allocator* allocator,
+                const CombinedInnerIdFilterPtr& window_filter = nullptr) const;
+
+    template <InnerSearchMode mode>
+    void
+    scan_window(const SparseTermComputerPtr& computer,
+                const InnerSearchParam& inner_param,
+                const CombinedInnerIdFilterPtr& window_filter,
+                uint32_t window_id,
+                float* dists,
+                uint8_t* window_mask,
+                MaxHeap& heap) const;
+
+    DatasetPtr
+    hybrid_search_impl(const SparseTermComputerPtr& computer,
+                       const float* dense_query,
+                       const SINDISearchParameter& search_param,
+                       const InnerSearchParam& inner_param,
+                       Allocator* allocator,
+                       const CombinedInnerIdFilterPtr& window_filter) const;
+
+    uint32_t
+    fill_window_mask(const CombinedInnerIdFilterPtr& window_filter,
+                     uint32_t window_id,
+                     uint8_t* window_mask) const;
 
 private:
     mutable std::shared_mutex global_mutex_;
@@ -135,10 +164,18 @@ private:
 
     bool use_reorder_{false};
 
+    bool use_compression_{false};
+
     float doc_retain_ratio_{0};
 
     std::shared_ptr<SparseIndex> rerank_flat_index_{nullptr};
+
+    // dense vectors of the documents, set when the index serves hybrid queries
+    FlattenInterfacePtr dense_codes_{nullptr};
+
     bool deserialize_without_footer_{false};
+
+    std::shared_ptr<SafeThreadPool> thread_pool_{nullptr};
 };
 
 }  // namespace vsag
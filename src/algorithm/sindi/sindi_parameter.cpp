@@ -15,6 +15,7 @@
 
 #include "sindi_parameter.h"
 
+#include "datacell/attribute_inverted_interface_parameter.h"
 #include "inner_string_params.h"
 
 namespace vsag {
@@ -54,6 +55,30 @@ SINDIParameter::FromJson(const JsonType& json) {
         window_size = DEFAULT_WINDOW_SIZE;
     }
 
+    if (json.Contains(USE_ATTRIBUTE_FILTER_KEY)) {
+        use_attribute_filter = json[USE_ATTRIBUTE_FILTER_KEY].GetBool();
+    }
+    if (use_attribute_filter) {
+        attr_inverted_interface_param = std::make_shared<AttributeInvertedInterfaceParameter>();
+        if (json.Contains(ATTR_PARAMS_KEY)) {
+            attr_inverted_interface_param->FromJson(json[ATTR_PARAMS_KEY]);
+        }
+    }
+
+    if (json.Contains(SPARSE_DENSE_CODES)) {
+        dense_codes_param = CreateFlattenParam(json[SPARSE_DENSE_CODES]);
+    }
+
+    if (json.Contains(SPARSE_USE_COMPRESSION)) {
+        use_compression = json[SPARSE_USE_COMPRESSION].GetBool();
+    } else {
+        use_compression = DEFAULT_USE_COMPRESSION;
+    }
+    // the scan on quantized weights only ranks the candidates, the exact distances and vectors
+    // come from the reorder
+    CHECK_ARGUMENT(not use_compression or use_reorder,
+                   "use_compression quantizes the posting weights, it requires use_reorder");
+
     if (json.Contains(SPARSE_DESERIALIZE_WITHOUT_FOOTER)) {
         deserialize_without_footer = json[SPARSE_DESERIALIZE_WITHOUT_FOOTER].GetBool();
     }
@@ -66,6 +91,14 @@ SINDIParameter::ToJson() const {
     json[SPARSE_DOC_PRUNE_RATIO].SetFloat(doc_prune_ratio);
     json[USE_REORDER_KEY].SetBool(use_reorder);
     json[SPARSE_WINDOW_SIZE].SetInt(window_size);
+    json[SPARSE_USE_COMPRESSION].SetBool(use_compression);
+    if (dense_codes_param != nullptr) {
+        json[SPARSE_DENSE_CODES].SetJson(dense_codes_param->ToJson());
+    }
+    json[USE_ATTRIBUTE_FILTER_KEY].SetBool(use_attribute_filter);
+    if (use_attribute_filter) {
+        json[ATTR_PARAMS_KEY].SetJson(attr_inverted_interface_param->ToJson());
+    }
     return json;
 }
 
@@ -87,6 +120,19 @@ SINDIParameter::CheckCompatibility(const vsag::ParamPtr& other) const {
     if (this->use_reorder != sindi_param->use_reorder) {
         return false;
     }
+    if (this->use_compression != sindi_param->use_compression) {
+        return false;
+    }
+    if (this->use_attribute_filter != sindi_param->use_attribute_filter) {
+        return false;
+    }
+    if ((this->dense_codes_param == nullptr) != (sindi_param->dense_codes_param == nullptr)) {
+        return false;
+    }
+    if (this->dense_codes_param != nullptr and
+        not this->dense_codes_param->CheckCompatibility(sindi_param->dense_codes_param)) {
+        return false;
+    }
     return true;
 }
 
@@ -94,6 +140,7 @@ void
 SINDISearchParameter::FromJson(const JsonType& json) {
     CHECK_ARGUMENT(json.Contains(INDEX_SINDI),
                    fmt::format("parameters must contains {}", INDEX_SINDI));
+    this->IndexSearchParameter::FromJson(json[INDEX_SINDI]);
     if (json[INDEX_SINDI].Contains(SPARSE_TERM_PRUNE_RATIO)) {
         term_prune_ratio = json[INDEX_SINDI][SPARSE_TERM_PRUNE_RATIO].GetFloat();
         CHECK_ARGUMENT((0.0F <= term_prune_ratio and term_prune_ratio <= 0.9F),
@@ -115,6 +162,25 @@ SINDISearchParameter::FromJson(const JsonType& json) {
     } else {
         n_candidate = DEFAULT_N_CANDIDATE;
     }
+    if (json[INDEX_SINDI].Contains(SPARSE_USE_TERM_PRUNING)) {
+        use_term_pruning = json[INDEX_SINDI][SPARSE_USE_TERM_PRUNING].GetBool();
+    } else {
+        use_term_pruning = DEFAULT_USE_TERM_PRUNING;
+    }
+    if (json[INDEX_SINDI].Contains(SPARSE_DENSE_WEIGHT)) {
+        dense_weight = json[INDEX_SINDI][SPARSE_DENSE_WEIGHT].GetFloat();
+        CHECK_ARGUMENT(dense_weight >= 0.0F,
+                       fmt::format("dense_weight must be non-negative, got {}", dense_weight));
+    } else {
+        dense_weight = DEFAULT_DENSE_WEIGHT;
+    }
+    if (json[INDEX_SINDI].Contains(SPARSE_SPARSE_WEIGHT)) {
+        sparse_weight = json[INDEX_SINDI][SPARSE_SPARSE_WEIGHT].GetFloat();
+        CHECK_ARGUMENT(sparse_weight >= 0.0F,
+                       fmt::format("sparse_weight must be non-negative, got {}", sparse_weight));
+    } else {
+        sparse_weight = DEFAULT_SPARSE_WEIGHT;
+    }
 }
 JsonType
 SINDISearchParameter::ToJson() const {
@@ -123,6 +189,10 @@ SINDISearchParameter::ToJson() const {
     json[INDEX_SINDI][SPARSE_QUERY_PRUNE_RATIO].SetFloat(query_prune_ratio);
     json[INDEX_SINDI][SPARSE_N_CANDIDATE].SetInt(n_candidate);
     json[INDEX_SINDI][SPARSE_TERM_PRUNE_RATIO].SetFloat(term_prune_ratio);
+    json[INDEX_SINDI][SEARCH_PARALLELISM].SetInt(parallel_search_thread_count);
+    json[INDEX_SINDI][SPARSE_USE_TERM_PRUNING].SetBool(use_term_pruning);
+    json[INDEX_SINDI][SPARSE_DENSE_WEIGHT].SetFloat(dense_weight);
+    json[INDEX_SINDI][SPARSE_SPARSE_WEIGHT].SetFloat(sparse_weight);
     return json;
 }
 
@@ -15,7 +15,9 @@
 
 #pragma once
 
+#include "algorithm/index_search_parameter.h"
 #include "algorithm/inner_index_parameter.h"
+#include "datacell/flatten_interface_parameter.h"
 #include "index_common_param.h"
 #include "utils/pointer_define.h"
 
@@ -44,11 +46,18 @@ public:
 
     float doc_prune_ratio{0};
 
+    // compress full windows: delta-encoded 16-bit ids and 8-bit quantized weights, requires
+    // use_reorder since the quantized weights give no exact distances nor vectors
+    bool use_compression{false};
+
+    // optional dense part, the index then serves hybrid dense and sparse queries
+    FlattenInterfaceParamPtr dense_codes_param{nullptr};
+
     // temporal parameter
     bool deserialize_without_footer{false};
 };
 
-class SINDISearchParameter : public Parameter {
+class SINDISearchParameter : public Parameter, public IndexSearchParameter {
 public:
     void
     FromJson(const JsonType& json) override;
@@ -65,6 +74,14 @@ public:
     // data cell
     float query_prune_ratio{0};
     float term_prune_ratio{0};
+
+    // skip postings that can no longer enter the candidates (maxscore on block maxima),
+    // pays off for short queries and small k where the low weight terms have long lists
+    bool use_term_pruning{false};
+
+    // hybrid search: distance = dense_weight * dense distance + sparse_weight * sparse distance
+    float dense_weight{0};
+    float sparse_weight{0};
 };
 
 }  // namespace vsag
@@ -46,6 +46,7 @@ struct SINDIDefaultParam {
     float doc_prune_ratio = 0.1F;
     int window_size = 66666;
     int term_id_limit = 10000;
+    bool use_compression = false;
 };
 
 std::string
@@ -55,6 +56,7 @@ generate_sindi_param(const SINDIDefaultParam& param) {
     json[SPARSE_DOC_PRUNE_RATIO].SetFloat(param.doc_prune_ratio);
     json[SPARSE_WINDOW_SIZE].SetInt(param.window_size);
     json[SPARSE_TERM_ID_LIMIT].SetInt(param.term_id_limit);
+    json[SPARSE_USE_COMPRESSION].SetBool(param.use_compression);
     return json.Dump();
 }
 
@@ -68,6 +70,7 @@ TEST_CASE("SINDI Index Parameters Test", "[ut][SINDIParameter]") {
     REQUIRE(std::abs(param->doc_prune_ratio - default_param.doc_prune_ratio) < 1e-3);
     REQUIRE(param->window_size == default_param.window_size);
     REQUIRE(param->term_id_limit == default_param.term_id_limit);
+    REQUIRE(param->use_compression == default_param.use_compression);
 
     vsag::ParameterTest::TestToJson(param);
 
@@ -89,4 +92,47 @@ TEST_CASE("SINDI Index Parameters Compatibility Test", "[ut][SINDIParameter]") {
     TEST_COMPATIBILITY_CASE("doc_prune_ratio compatibility", doc_prune_ratio, 0.2F, 0.3F, false);
     TEST_COMPATIBILITY_CASE("window_size compatibility", window_size, 66666, 77777, false);
     TEST_COMPATIBILITY_CASE("term_id_limit compatibility", term_id_limit, 10000, 10001, false);
+    TEST_COMPATIBILITY_CASE("use_compression compatibility", use_compression, true, false, false);
+}
+
+TEST_CASE("SINDI Hybrid Parameters Test", "[ut][SINDIParameter]") {
+    auto param_str = R"({
+        "dense_codes": {
+            "io_params": {
+                "type": "block_memory_io"
+            },
+            "quantization_params": {
+                "type": "sq8"
+            }
+        }
+    })";
+    auto param = std::make_shared<vsag::SINDIParameter>();
+    param->FromJson(vsag::JsonType::Parse(param_str));
+    REQUIRE(param->dense_codes_param != nullptr);
+    vsag::ParameterTest::TestToJson(param);
+
+    auto sparse_param = std::make_shared<vsag::SINDIParameter>();
+    sparse_param->FromJson(vsag::JsonType::Parse("{}"));
+    REQUIRE(sparse_param->dense_codes_param == nullptr);
+    REQUIRE_FALSE(param->CheckCompatibility(sparse_param));
+    REQUIRE(param->CheckCompatibility(param));
+
+    auto search_param_str = R"({
+        "sindi": {
+            "n_candidate": 20,
+            "dense_weight": 0.3,
+            "sparse_weight": 0.7
+        }
+    })";
+    vsag::SINDISearchParameter search_param;
+    search_param.FromJson(vsag::JsonType::Parse(search_param_str));
+    REQUIRE(std::abs(search_param.dense_weight - 0.3F) < 1e-6);
+    REQUIRE(std::abs(search_param.sparse_weight - 0.7F) < 1e-6);
+
+    auto invalid_str = R"({
+        "sindi": {
+            "dense_weight": -1.0
+        }
+    })";
+    REQUIRE_THROWS(search_param.FromJson(vsag::JsonType::Parse(invalid_str)));
 }
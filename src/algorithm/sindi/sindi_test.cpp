@@ -17,9 +17,11 @@
 
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <set>
 
 #include "fixtures.h"
 #include "impl/allocator/safe_allocator.h"
+#include "impl/filter/filter_headers.h"
 #include "storage/serialization_template_test.h"
 
 using namespace vsag;
@@ -33,6 +35,28 @@ public:
     }
 };
 
+class SelectiveMockFilter : public MockFilter {
+public:
+    [[nodiscard]] float
+    ValidRatio() const override {
+        return 0.5F;
+    }
+};
+
+class WindowMockFilter : public Filter {
+public:
+    [[nodiscard]] bool
+    CheckValid(int64_t id) const override {
+        // the first window is filtered out completely
+        return id >= 10000 and id % 3 == 0;
+    }
+
+    [[nodiscard]] float
+    ValidRatio() const override {
+        return 0.2F;
+    }
+};
+
 TEST_CASE("SINDI Basic Test", "[ut][SINDI]") {
     auto allocator = SafeAllocator::FactoryDefaultAllocator();
     IndexCommonParam common_param;
@@ -195,3 +219,480 @@ TEST_CASE("SINDI Basic Test", "[ut][SINDI]") {
         delete[] item.ids_;
     }
 }
+
+TEST_CASE("SINDI Parallel And Pruned Search Test", "[ut][SINDI]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.thread_pool_ = SafeThreadPool::FactoryDefaultThreadPool();
+
+    // several windows so that the scan can be split
+    uint32_t num_base = 35000;
+    uint32_t num_query = 20;
+    int64_t k = 10;
+    auto use_reorder = GENERATE("false", "true");
+
+    std::vector<int64_t> ids(num_base);
+    for (int64_t i = 0; i < num_base; ++i) {
+        ids[i] = i;
+    }
+    auto sv_base = fixtures::GenerateSparseVectors(num_base, 32, 1000, 0, 10, 114);
+    auto base = vsag::Dataset::Make();
+    base->NumElements(num_base)->SparseVectors(sv_base.data())->Ids(ids.data())->Owner(false);
+
+    constexpr static auto param_str = R"({{
+        "use_reorder": {},
+        "doc_prune_ratio": 0.0,
+        "window_size": 10000,
+        "term_id_limit": 1001
+    }})";
+    auto index_param = std::make_shared<vsag::SINDIParameter>();
+    index_param->FromJson(vsag::JsonType::Parse(fmt::format(param_str, use_reorder)));
+    auto index = std::make_unique<SINDI>(index_param, common_param);
+    REQUIRE(index->Build(base).empty());
+
+    constexpr static auto search_param_str = R"(
+    {{
+        "sindi": {{
+            "query_prune_ratio": 0.0,
+            "term_prune_ratio": 0.0,
+            "n_candidate": 600,
+            "parallelism": {},
+            "use_term_pruning": {}
+        }}
+    }}
+    )";
+    auto serial_param = fmt::format(search_param_str, 1, false);
+    auto mock_filter = std::make_shared<MockFilter>();
+
+    // parallel scan (and rerank), pruned scan and both give the same results as the plain scan
+    auto parallelism = GENERATE(1, 4);
+    auto use_term_pruning = GENERATE(false, true);
+    auto other_param = fmt::format(search_param_str, parallelism, use_term_pruning);
+
+    auto query = vsag::Dataset::Make();
+    for (int i = 0; i < num_query; ++i) {
+        query->NumElements(1)->SparseVectors(sv_base.data() + i * 1000)->Owner(false);
+        for (const auto& filter : {FilterPtr(nullptr), FilterPtr(mock_filter)}) {
+            auto serial_result = index->KnnSearch(query, k, serial_param, filter);
+            auto other_result = index->KnnSearch(query, k, other_param, filter);
+            REQUIRE(serial_result->GetDim() == other_result->GetDim());
+            for (int j = 0; j < serial_result->GetDim(); j++) {
+                REQUIRE(std::abs(serial_result->GetDistances()[j] -
+                                 other_result->GetDistances()[j]) < 1e-5);
+            }
+
+            auto radius = serial_result->GetDistances()[k / 2];
+            auto serial_range = index->RangeSearch(query, radius, serial_param, filter);
+            auto other_range = index->RangeSearch(query, radius, other_param, filter);
+            REQUIRE(serial_range->GetDim() == other_range->GetDim());
+        }
+    }
+
+    for (auto& item : sv_base) {
+        delete[] item.vals_;
+        delete[] item.ids_;
+    }
+}
+
+TEST_CASE("SINDI Compression Test", "[ut][SINDI]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+
+    // three full windows get compressed, the last one stays raw
+    uint32_t num_base = 35000;
+    uint32_t num_query = 20;
+    int64_t k = 10;
+
+    std::vector<int64_t> ids(num_base);
+    for (int64_t i = 0; i < num_base; ++i) {
+        ids[i] = i;
+    }
+    auto sv_base = fixtures::GenerateSparseVectors(num_base, 32, 1000, 0, 10, 114);
+    auto base = vsag::Dataset::Make();
+    base->NumElements(num_base)->SparseVectors(sv_base.data())->Ids(ids.data())->Owner(false);
+
+    constexpr static auto param_str = R"({{
+        "use_reorder": {},
+        "use_compression": {},
+        "doc_prune_ratio": 0.0,
+        "window_size": 10000,
+        "term_id_limit": 1001
+    }})";
+    auto raw_param = std::make_shared<vsag::SINDIParameter>();
+    raw_param->FromJson(vsag::JsonType::Parse(fmt::format(param_str, false, false)));
+    auto raw_index = std::make_unique<SINDI>(raw_param, common_param);
+    REQUIRE(raw_index->Build(base).empty());
+
+    // the quantized weights cannot give exact distances without the reorder
+    auto compressed_param = std::make_shared<vsag::SINDIParameter>();
+    REQUIRE_THROWS(
+        compressed_param->FromJson(vsag::JsonType::Parse(fmt::format(param_str, false, true))));
+    compressed_param->FromJson(vsag::JsonType::Parse(fmt::format(param_str, true, true)));
+    REQUIRE(compressed_param->use_compression);
+    auto index = std::make_unique<SINDI>(compressed_param, common_param);
+    REQUIRE(index->Build(base).empty());
+
+    auto another_index = std::make_unique<SINDI>(compressed_param, common_param);
+    test_serializion(*index, *another_index);
+    REQUIRE(another_index->GetNumElements() == num_base);
+
+    auto search_param = R"({
+        "sindi": {
+            "query_prune_ratio": 0.0,
+            "term_prune_ratio": 0.0,
+            "n_candidate": 20
+        }
+    })";
+    float correct = 0;
+    auto query = vsag::Dataset::Make();
+    for (int i = 0; i < num_query; ++i) {
+        query->NumElements(1)->SparseVectors(sv_base.data() + i * 1000)->Owner(false);
+        auto raw_result = raw_index->KnnSearch(query, k, search_param, nullptr);
+        auto result = index->KnnSearch(query, k, search_param, nullptr);
+        auto loaded_result = another_index->KnnSearch(query, k, search_param, nullptr);
+        REQUIRE(result->GetDim() == k);
+        REQUIRE(loaded_result->GetDim() == k);
+        std::set<int64_t> raw_ids(raw_result->GetIds(), raw_result->GetIds() + k);
+        for (int j = 0; j < k; j++) {
+            REQUIRE(result->GetIds()[j] == loaded_result->GetIds()[j]);
+            // exact distances from the reorder, up to the summation order
+            auto raw_dist = raw_index->CalcDistanceById(query, result->GetIds()[j]);
+            REQUIRE(std::abs(result->GetDistances()[j] - raw_dist) <= 1e-5 * std::abs(raw_dist));
+            correct += static_cast<float>(raw_ids.count(result->GetIds()[j]));
+        }
+    }
+    REQUIRE(correct / static_cast<float>(num_query * k) > 0.9);
+
+    for (auto& item : sv_base) {
+        delete[] item.vals_;
+        delete[] item.ids_;
+    }
+}
+
+TEST_CASE("SINDI Batch Add Test", "[ut][SINDI]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.thread_pool_ = SafeThreadPool::FactoryDefaultThreadPool();
+
+    uint32_t num_base = 25000;
+    uint32_t num_query = 10;
+    int64_t k = 10;
+    auto use_reorder = GENERATE("false", "true");
+
+    std::vector<int64_t> ids(num_base);
+    for (int64_t i = 0; i < num_base; ++i) {
+        ids[i] = i;
+    }
+    auto sv_base = fixtures::GenerateSparseVectors(num_base, 32, 1000, 0, 10, 514);
+    // an empty vector and a vector beyond term_id_limit are rejected without breaking the batch
+    std::vector<uint32_t> invalid_term = {1002};
+    std::vector<float> invalid_val = {1.0F};
+    auto empty_len = sv_base[100].len_;
+    auto* invalid_ids = sv_base[200].ids_;
+    auto invalid_len = sv_base[200].len_;
+    sv_base[100].len_ = 0;
+    sv_base[200].ids_ = invalid_term.data();
+    sv_base[200].len_ = 1;
+
+    constexpr static auto param_str = R"({{
+        "use_reorder": {},
+        "doc_prune_ratio": 0.0,
+        "window_size": 10000,
+        "term_id_limit": 1001
+    }})";
+    auto index_param = std::make_shared<vsag::SINDIParameter>();
+    index_param->FromJson(vsag::JsonType::Parse(fmt::format(param_str, use_reorder)));
+
+    // one batch filling three windows in parallel
+    auto base = vsag::Dataset::Make();
+    base->NumElements(num_base)->SparseVectors(sv_base.data())->Ids(ids.data())->Owner(false);
+    auto batch_index = std::make_unique<SINDI>(index_param, common_param);
+    auto failed_ids = batch_index->Build(base);
+    REQUIRE(failed_ids == std::vector<int64_t>{100, 200});
+    REQUIRE(batch_index->GetNumElements() == num_base - 2);
+
+    // small batches crossing the window borders
+    auto chunk_index = std::make_unique<SINDI>(index_param, common_param);
+    uint32_t chunk_size = 777;
+    for (uint32_t start = 0; start < num_base; start += chunk_size) {
+        auto chunk = vsag::Dataset::Make();
+        chunk->NumElements(std::min(chunk_size, num_base - start))
+            ->SparseVectors(sv_base.data() + start)
+            ->Ids(ids.data() + start)
+            ->Owner(false);
+        chunk_index->Add(chunk);
+    }
+    REQUIRE(chunk_index->GetNumElements() == num_base - 2);
+
+    auto search_param = R"({
+        "sindi": {
+            "query_prune_ratio": 0.0,
+            "term_prune_ratio": 0.0,
+            "n_candidate": 20
+        }
+    })";
+    auto query = vsag::Dataset::Make();
+    for (int i = 0; i < num_query; ++i) {
+        query->NumElements(1)->SparseVectors(sv_base.data() + i * 1000)->Owner(false);
+        auto batch_result = batch_index->KnnSearch(query, k, search_param, nullptr);
+        auto chunk_result = chunk_index->KnnSearch(query, k, search_param, nullptr);
+        REQUIRE(batch_result->GetDim() == chunk_result->GetDim());
+        for (int j = 0; j < batch_result->GetDim(); j++) {
+            REQUIRE(batch_result->GetIds()[j] == chunk_result->GetIds()[j]);
+            REQUIRE(batch_result->GetDistances()[j] == chunk_result->GetDistances()[j]);
+        }
+    }
+
+    sv_base[100].len_ = empty_len;
+    sv_base[200].ids_ = invalid_ids;
+    sv_base[200].len_ = invalid_len;
+    for (auto& item : sv_base) {
+        delete[] item.vals_;
+        delete[] item.ids_;
+    }
+}
+
+TEST_CASE("SINDI Filtered Search Test", "[ut][SINDI]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.thread_pool_ = SafeThreadPool::FactoryDefaultThreadPool();
+
+    uint32_t num_base = 25000;
+    uint32_t num_query = 10;
+    int64_t k = 10;
+    auto use_compression = GENERATE("false", "true");
+
+    std::vector<int64_t> ids(num_base);
+    for (int64_t i = 0; i < num_base; ++i) {
+        ids[i] = i;
+    }
+    auto sv_base = fixtures::GenerateSparseVectors(num_base, 32, 1000, 0, 10, 1919);
+    auto base = vsag::Dataset::Make();
+    base->NumElements(num_base)->SparseVectors(sv_base.data())->Ids(ids.data())->Owner(false);
+
+    constexpr static auto param_str = R"({{
+        "use_reorder": {0},
+        "use_compression": {0},
+        "doc_prune_ratio": 0.0,
+        "window_size": 10000,
+        "term_id_limit": 1001
+    }})";
+    auto index_param = std::make_shared<vsag::SINDIParameter>();
+    index_param->FromJson(vsag::JsonType::Parse(fmt::format(param_str, use_compression)));
+    auto index = std::make_unique<SINDI>(index_param, common_param);
+    REQUIRE(index->Build(base).empty());
+
+    auto parallelism = GENERATE(1, 4);
+    constexpr static auto search_param_str = R"(
+    {{
+        "sindi": {{
+            "query_prune_ratio": 0.0,
+            "term_prune_ratio": 0.0,
+            "n_candidate": 20,
+            "parallelism": {}
+        }}
+    }}
+    )";
+    auto search_param = fmt::format(search_param_str, parallelism);
+
+    // the masked scan gives the same results as checking the candidates one by one
+    auto mock_filter = std::make_shared<MockFilter>();
+    auto selective_filter = std::make_shared<SelectiveMockFilter>();
+    auto window_filter = std::make_shared<WindowMockFilter>();
+    // a selective bitset is evaluated into window masks, a permissive one per candidate
+    auto bitset = vsag::Bitset::Make();
+    for (int64_t i = 0; i < 10000; ++i) {
+        bitset->Set(i, true);
+    }
+    auto permissive_bitset = vsag::Bitset::Make();
+    for (int64_t i = 0; i < 100; ++i) {
+        permissive_bitset->Set(i * 7, true);
+    }
+
+    auto query = vsag::Dataset::Make();
+    for (int i = 0; i < num_query; ++i) {
+        query->NumElements(1)->SparseVectors(sv_base.data() + i * 1000)->Owner(false);
+        auto expected = index->KnnSearch(query, k, search_param, mock_filter);
+        auto result = index->KnnSearch(query, k, search_param, selective_filter);
+        REQUIRE(expected->GetDim() == result->GetDim());
+        for (int j = 0; j < expected->GetDim(); j++) {
+            REQUIRE(expected->GetIds()[j] == result->GetIds()[j]);
+            REQUIRE(std::abs(expected->GetDistances()[j] - result->GetDistances()[j]) < 1e-4);
+        }
+
+        auto radius = expected->GetDistances()[k / 2];
+        auto expected_range = index->RangeSearch(query, radius, search_param, mock_filter);
+        auto range = index->RangeSearch(query, radius, search_param, selective_filter);
+        REQUIRE(expected_range->GetDim() == range->GetDim());
+
+        result = index->KnnSearch(query, k, search_param, window_filter);
+        REQUIRE(result->GetDim() == k);
+        for (int j = 0; j < result->GetDim(); j++) {
+            REQUIRE(window_filter->CheckValid(result->GetIds()[j]));
+        }
+
+        SearchRequest request;
+        request.query_ = query;
+        request.topk_ = k;
+        request.params_str_ = search_param;
+        request.enable_bitset_filter_ = true;
+        request.bitset_filter_ = bitset;
+        result = index->SearchWithRequest(request);
+        REQUIRE(result->GetDim() == k);
+        for (int j = 0; j < result->GetDim(); j++) {
+            REQUIRE(result->GetIds()[j] >= 10000);
+        }
+
+        request.bitset_filter_ = permissive_bitset;
+        result = index->SearchWithRequest(request);
+        REQUIRE(result->GetDim() == k);
+        for (int j = 0; j < result->GetDim(); j++) {
+            REQUIRE_FALSE(permissive_bitset->Test(result->GetIds()[j]));
+        }
+    }
+
+    for (auto& item : sv_base) {
+        delete[] item.vals_;
+        delete[] item.ids_;
+    }
+}
+
+TEST_CASE("SINDI Hybrid Search Test", "[ut][SINDI]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    IndexCommonParam common_param;
+    common_param.allocator_ = allocator;
+    common_param.metric_ = MetricType::METRIC_TYPE_IP;
+    common_param.dim_ = 16;
+
+    uint32_t num_base = 15000;
+    uint32_t num_query = 10;
+    int64_t k = 10;
+    auto use_reorder = GENERATE("false", "true");
+
+    std::vector<int64_t> ids(num_base);
+    for (int64_t i = 0; i < num_base; ++i) {
+        ids[i] = i;
+    }
+    auto sv_base = fixtures::GenerateSparseVectors(num_base, 32, 1000, 0, 1, 810);
+    auto dense_base = fixtures::generate_vectors(num_base, common_param.dim_);
+    auto base = vsag::Dataset::Make();
+    base->NumElements(num_base)
+        ->Dim(common_param.dim_)
+        ->SparseVectors(sv_base.data())
+        ->Float32Vectors(dense_base.data())
+        ->Ids(ids.data())
+        ->Owner(false);
+
+    constexpr static auto param_str = R"({{
+        "use_reorder": {},
+        "doc_prune_ratio": 0.0,
+        "window_size": 10000,
+        "term_id_limit": 1001,
+        "dense_codes": {{
+            "io_params": {{
+                "type": "block_memory_io"
+            }},
+            "quantization_params": {{
+                "type": "fp32"
+            }}
+        }}
+    }})";
+    auto index_param = std::make_shared<vsag::SINDIParameter>();
+    index_param->FromJson(vsag::JsonType::Parse(fmt::format(param_str, use_reorder)));
+    REQUIRE(index_param->dense_codes_param != nullptr);
+    auto index = std::make_unique<SINDI>(index_param, common_param);
+    REQUIRE(index->Build(base).empty());
+
+    auto another_index = std::make_unique<SINDI>(index_param, common_param);
+    test_serializion(*index, *another_index);
+    REQUIRE(another_index->GetNumElements() == num_base);
+
+    constexpr static auto search_param_str = R"(
+    {{
+        "sindi": {{
+            "query_prune_ratio": 0.0,
+            "term_prune_ratio": 0.0,
+            "n_candidate": 20,
+            "dense_weight": {},
+            "sparse_weight": {}
+        }}
+    }}
+    )";
+    auto sparse_param = fmt::format(search_param_str, 0.0, 1.0);
+    auto dense_param = fmt::format(search_param_str, 1.0, 0.0);
+    auto hybrid_param = fmt::format(search_param_str, 0.3, 0.7);
+    auto mock_filter = std::make_shared<MockFilter>();
+
+    auto dense_dist = [&](const float* query, int64_t id) -> float {
+        float ip = 0;
+        for (int64_t d = 0; d < common_param.dim_; ++d) {
+            ip += query[d] * dense_base[id * common_param.dim_ + d];
+        }
+        return 1 - ip;
+    };
+
+    auto sparse_query = vsag::Dataset::Make();
+    auto hybrid_query = vsag::Dataset::Make();
+    for (int i = 0; i < num_query; ++i) {
+        const auto* dense_query = dense_base.data() + (i * 1000 + 1) * common_param.dim_;
+        sparse_query->NumElements(1)->SparseVectors(sv_base.data() + i * 1000)->Owner(false);
+        hybrid_query->NumElements(1)
+            ->Dim(common_param.dim_)
+            ->SparseVectors(sv_base.data() + i * 1000)
+            ->Float32Vectors(dense_query)
+            ->Owner(false);
+
+        // only the sparse part: same as the sparse search
+        auto expected = index->KnnSearch(sparse_query, k, sparse_param, nullptr);
+        auto result = index->KnnSearch(hybrid_query, k, sparse_param, nullptr);
+        REQUIRE(result->GetDim() == expected->GetDim());
+        for (int j = 0; j < k; j++) {
+            REQUIRE(std::abs(result->GetDistances()[j] - expected->GetDistances()[j]) < 1e-4);
+        }
+
+        // only the dense part: exact, the dense candidates come from a full scan
+        std::vector<float> dense_dists(num_base);
+        for (int64_t id = 0; id < num_base; ++id) {
+            dense_dists[id] = dense_dist(dense_query, id);
+        }
+        std::sort(dense_dists.begin(), dense_dists.end());
+        result = index->KnnSearch(hybrid_query, k, dense_param, nullptr);
+        REQUIRE(result->GetDim() == k);
+        for (int j = 0; j < k; j++) {
+            REQUIRE(std::abs(result->GetDistances()[j] - dense_dists[j]) < 1e-4);
+        }
+
+        // fused distances, with and without a filter, before and after serialization
+        for (const auto& filter : {FilterPtr(nullptr), FilterPtr(mock_filter)}) {
+            result = index->KnnSearch(hybrid_query, k, hybrid_param, filter);
+            auto loaded_result = another_index->KnnSearch(hybrid_query, k, hybrid_param, filter);
+            REQUIRE(result->GetDim() == k);
+            REQUIRE(loaded_result->GetDim() == k);
+            for (int j = 0; j < k; j++) {
+                auto id = result->GetIds()[j];
+                REQUIRE(id == loaded_result->GetIds()[j]);
+                if (filter != nullptr) {
+                    REQUIRE(filter->CheckValid(id));
+                }
+                if (j > 0) {
+                    REQUIRE(result->GetDistances()[j - 1] <= result->GetDistances()[j]);
+                }
+                auto fused = 0.3F * dense_dist(dense_query, id) +
+                             0.7F * index->CalcDistanceById(sparse_query, id);
+                REQUIRE(std::abs(result->GetDistances()[j] - fused) < 1e-3);
+            }
+        }
+
+        // range search is not supported with a dense query
+        REQUIRE_THROWS(index->RangeSearch(hybrid_query, 0.5, hybrid_param, nullptr));
+    }
+
+    for (auto& item : sv_base) {
+        delete[] item.vals_;
+        delete[] item.ids_;
+    }
+}
@@ -20,9 +20,13 @@
 #include "impl/heap/standard_heap.h"
 #include "impl/label_table.h"
 #include "index_feature_list.h"
+#include "simd/sparse_simd.h"
 #include "utils/util_functions.h"
 namespace vsag {
 
+// a brute force scan is only split when every task gets at least this many vectors
+static constexpr int64_t MIN_SCAN_COUNT_PER_TASK = 1024;
+
 static float
 get_distance(uint32_t len1,
              const uint32_t* ids1,
@@ -30,23 +34,7 @@ get_distance(uint32_t len1,
              uint32_t len2,
              const uint32_t* ids2,
              const float* vals2) {
-    float sum = 0.0F;
-    uint32_t i = 0;
-    uint32_t j = 0;
-
-    while (i < len1 && j < len2) {
-        if (ids1[i] < ids2[j]) {
-            i++;
-        } else if (ids1[i] > ids2[j]) {
-            j++;
-        } else {
-            sum += vals1[i] * vals2[j];
-            i++;
-            j++;
-        }
-    }
-
-    return 1 - sum;
+    return 1 - SparseComputeIP(ids1, vals1, len1, ids2, vals2, len2);
 }
 
 SparseIndex::SparseIndex(const SparseIndexParameterPtr& param, const IndexCommonParam& common_param)
@@ -159,19 +147,15 @@ SparseIndex::KnnSearch(const DatasetPtr& query,
                        const FilterPtr& filter) const {
     const auto* sparse_vectors = query->GetSparseVectors();
     CHECK_ARGUMENT(query->GetNumElements() == 1, "num of query should be 1");
-    auto results = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+    auto search_param = SparseIndexSearchParameters::FromJson(parameters);
 
     auto [sorted_ids, sorted_vals] = sort_sparse_vector(sparse_vectors[0]);
-    for (int j = 0; j < cur_element_count_; ++j) {
-        auto distance = CalDistanceByIdUnsafe(sorted_ids, sorted_vals, j);
-        auto label = label_table_->GetLabelById(j);
-        if (not filter || filter->CheckValid(label)) {
-            results->Push(distance, label);
-            if (results->Size() > k) {
-                results->Pop();
-            }
-        }
-    }
+    auto results = scan(sorted_ids,
+                        sorted_vals,
+                        filter,
+                        std::numeric_limits<float>::max(),
+                        k,
+                        search_param.parallel_search_thread_count);
     // return result
     return collect_results(results);
 }
@@ -184,19 +168,14 @@ SparseIndex::RangeSearch(const DatasetPtr& query,
                          int64_t limited_size) const {
     const auto* sparse_vectors = query->GetSparseVectors();
     CHECK_ARGUMENT(query->GetNumElements() == 1, "num of query should be 1");
-    auto results = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+    auto search_param = SparseIndexSearchParameters::FromJson(parameters);
     auto [sorted_ids, sorted_vals] = sort_sparse_vector(sparse_vectors[0]);
-    for (int j = 0; j < cur_element_count_; ++j) {
-        auto distance = CalDistanceByIdUnsafe(sorted_ids, sorted_vals, j);
-        auto label = label_table_->GetLabelById(j);
-        if ((not filter || filter->CheckValid(label)) && distance <= radius + 2e-6) {
-            results->Push(distance, label);
-        }
-    }
-
-    while (results->Size() > limited_size) {
-        results->Pop();
-    }
+    auto results = scan(sorted_ids,
+                        sorted_vals,
+                        filter,
+                        radius + 2e-6,
+                        limited_size,
+                        search_param.parallel_search_thread_count);
 
     // return result
     return collect_results(results);
@@ -219,9 +198,60 @@ SparseIndex::collect_results(const DistHeapPtr& results) const {
     return result;
 }
 
+DistHeapPtr
+SparseIndex::scan(const Vector<uint32_t>& sorted_ids,
+                  const Vector<float>& sorted_vals,
+                  const FilterPtr& filter,
+                  float radius,
+                  int64_t max_size,
+                  int64_t thread_count) const {
+    auto scan_func = [&](int64_t start, int64_t end, const DistHeapPtr& heap) -> void {
+        for (auto j = start; j < end; ++j) {
+            auto label = label_table_->GetLabelById(j);
+            if (filter != nullptr and not filter->CheckValid(label)) {
+                continue;
+            }
+            auto distance = CalDistanceByIdUnsafe(sorted_ids, sorted_vals, j);
+            if (distance > radius) {
+                continue;
+            }
+            heap->Push(distance, label);
+            if (max_size >= 0 and heap->Size() > static_cast<uint64_t>(max_size)) {
+                heap->Pop();
+            }
+        }
+    };
+
+    thread_count = std::min(thread_count, cur_element_count_ / MIN_SCAN_COUNT_PER_TASK);
+    auto results = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+    if (thread_count <= 1 or build_pool_ == nullptr) {
+        scan_func(0, cur_element_count_, results);
+        return results;
+    }
+
+    // each task scans a contiguous range into its own heap, the heaps are merged at the end
+    auto chunk_size = (cur_element_count_ + thread_count - 1) / thread_count;
+    std::vector<DistHeapPtr> heaps(thread_count);
+    std::vector<std::future<void>> futures;
+    for (int64_t i = 1; i < thread_count; ++i) {
+        heaps[i] = std::make_shared<StandardHeap<true, false>>(allocator_, -1);
+        auto end = std::min(cur_element_count_, (i + 1) * chunk_size);
+        futures.emplace_back(build_pool_->GeneralEnqueue(scan_func, i * chunk_size, end, heaps[i]));
+    }
+    scan_func(0, chunk_size, results);
+    for (int64_t i = 1; i < thread_count; ++i) {
+        futures[i - 1].get();
+        results->Merge(*heaps[i]);
+    }
+    while (max_size >= 0 and results->Size() > static_cast<uint64_t>(max_size)) {
+        results->Pop();
+    }
+    return results;
+}
+
 float
-SparseIndex::CalDistanceByIdUnsafe(Vector<uint32_t>& sorted_ids,
-                                   Vector<float>& sorted_vals,
+SparseIndex::CalDistanceByIdUnsafe(const Vector<uint32_t>& sorted_ids,
+                                   const Vector<float>& sorted_vals,
                                    uint32_t inner_id) const {
     return get_distance(sorted_ids.size(),
                         sorted_ids.data(),
@@ -90,8 +90,8 @@ public:
     InitFeatures() override;
 
     float
-    CalDistanceByIdUnsafe(Vector<uint32_t>& sorted_ids,
-                          Vector<float>& sorted_vals,
+    CalDistanceByIdUnsafe(const Vector<uint32_t>& sorted_ids,
+                          const Vector<float>& sorted_vals,
                           uint32_t inner_id) const;
 
     DatasetPtr
@@ -101,6 +101,16 @@ public:
     sort_sparse_vector(const SparseVector& vector) const;
 
 private:
+    // scans all the vectors, with thread_count tasks, keeps at most max_size (if not negative)
+    // results within radius
+    DistHeapPtr
+    scan(const Vector<uint32_t>& sorted_ids,
+         const Vector<float>& sorted_vals,
+         const FilterPtr& filter,
+         float radius,
+         int64_t max_size,
+         int64_t thread_count) const;
+
     void
     resize(int64_t new_capacity) {
         if (new_capacity <= max_capacity_) {
@@ -16,6 +16,7 @@
 #pragma once
 
 #include "index_common_param.h"
+#include "index_search_parameter.h"
 #include "inner_index_parameter.h"
 #include "utils/pointer_define.h"
 
@@ -35,4 +36,20 @@ public:
 public:
     bool need_sort{true};
 };
+
+class SparseIndexSearchParameters : public IndexSearchParameter {
+public:
+    static SparseIndexSearchParameters
+    FromJson(const std::string& json_string) {
+        SparseIndexSearchParameters obj;
+        if (json_string.empty()) {
+            return obj;
+        }
+        auto params = JsonType::Parse(json_string);
+        if (params.Contains(INDEX_SPARSE)) {
+            obj.IndexSearchParameter::FromJson(params[INDEX_SPARSE]);
+        }
+        return obj;
+    }
+};
 }  // namespace vsag
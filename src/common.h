@@ -66,3 +66,7 @@ constexpr static const float DEFAULT_QUERY_PRUNE_RATIO = 0.0F;
 constexpr static const float DEFAULT_DOC_PRUNE_RATIO = 0.0F;
 constexpr static const float DEFAULT_TERM_PRUNE_RATIO = 0.0F;
 constexpr static const uint32_t DEFAULT_N_CANDIDATE = 0;
+constexpr static const bool DEFAULT_USE_TERM_PRUNING = false;
+constexpr static const bool DEFAULT_USE_COMPRESSION = false;
+constexpr static const float DEFAULT_DENSE_WEIGHT = 0.5F;
+constexpr static const float DEFAULT_SPARSE_WEIGHT = 0.5F;
@@ -135,6 +135,7 @@ const char* const SERIALIZE_VERSION = "VERSION";
 const char* const SQ4_UNIFORM_TRUNC_RATE = "sq4_uniform_trunc_rate";
 const char* const RABITQ_PCA_DIM = "rabitq_pca_dim";
 const char* const RABITQ_BITS_PER_DIM_QUERY = "rabitq_bits_per_dim_query";
+const char* const RABITQ_BITS_PER_DIM_BASE = "rabitq_bits_per_dim_base";
 const char* const RABITQ_USE_FHT = "rabitq_use_fht";
 const char* const INDEX_TQ_CHAIN = "tq_chain";
 
@@ -144,6 +145,7 @@ const char* const HGRAPH_USE_REORDER = USE_REORDER_KEY;
 const char* const HGRAPH_USE_ELP_OPTIMIZER = HGRAPH_USE_ELP_OPTIMIZER_KEY;
 const char* const HGRAPH_IGNORE_REORDER = "ignore_reorder";
 const char* const HGRAPH_BUILD_BY_BASE_QUANTIZATION = "build_by_base";
+const char* const HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION = "build_search_by_base";
 const char* const HGRAPH_BASE_QUANTIZATION_TYPE = "base_quantization_type";
 const char* const HGRAPH_GRAPH_MAX_DEGREE = "max_degree";
 const char* const HGRAPH_BUILD_EF_CONSTRUCTION = "ef_construction";
@@ -164,6 +166,10 @@ const char* const HGRAPH_PARAMETER_EF_RUNTIME = "ef_search";
 const char* const HGRAPH_EXTRA_INFO_SIZE = "extra_info_size";
 const char* const HGRAPH_SUPPORT_DUPLICATE = "support_duplicate";
 const char* const HGRAPH_SUPPORT_TOMBSTONE = "support_tomb_stone";
+const char* const HGRAPH_CONSOLIDATE_REMOVE_RATIO = "consolidate_remove_ratio";
+const char* const HGRAPH_GRAPH_LAYOUT_ORDER = "graph_layout_order";
+const char* const HGRAPH_FUSE_CODES_WITH_GRAPH = HGRAPH_FUSE_CODES_WITH_GRAPH_KEY;
+const char* const HGRAPH_BUILD_PARTITION_COUNT = HGRAPH_BUILD_PARTITION_COUNT_KEY;
 const char* const HGRAPH_USE_EXTRA_INFO_FILTER = "use_extra_info_filter";
 const char* const STORE_RAW_VECTOR = "store_raw_vector";
 const char* const RAW_VECTOR_IO_TYPE = "raw_vector_io_type";
@@ -182,10 +188,12 @@ const char* const BRUTE_FORCE_USE_RESIDUAL = "use_residual";
 const char* const IVF_USE_RESIDUAL = "use_residual";
 const char* const IVF_USE_REORDER = "use_reorder";
 const char* const IVF_TRAIN_TYPE = "ivf_train_type";
+const char* const IVF_TRAIN_BALANCE_FACTOR = "ivf_train_balance_factor";
 const char* const IVF_BUCKETS_COUNT = "buckets_count";
 const char* const IVF_BASE_QUANTIZATION_TYPE = "base_quantization_type";
 const char* const IVF_BASE_IO_TYPE = "base_io_type";
 const char* const IVF_BASE_PQ_DIM = "base_pq_dim";
+const char* const IVF_BASE_SQ4_UNIFORM_FASTSCAN = "base_sq4_uniform_fastscan";
 const char* const IVF_BASE_FILE_PATH = "base_file_path";
 
 const char* const PYRAMID_EF_CONSTRUCTION = EF_CONSTRUCTION_KEY;
@@ -204,9 +212,12 @@ const char* const PYRAMID_PRECISE_IO_TYPE = "precise_io_type";
 const char* const PYRAMID_PRECISE_FILE_PATH = "precise_file_path";
 const char* const PYRAMID_PARAMETER_EF_SEARCH = "ef_search";
 const char* const PYRAMID_NO_BUILD_LEVELS = "no_build_levels";
+const char* const PYRAMID_INDEX_MIN_SIZE = "index_min_size";
 
 const char* const GNO_IMI_FIRST_ORDER_BUCKETS_COUNT = "first_order_buckets_count";
 const char* const GNO_IMI_SECOND_ORDER_BUCKETS_COUNT = "second_order_buckets_count";
+const char* const HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT = "hierarchical_first_order_buckets_count";
+const char* const HIERARCHICAL_MAX_BUCKET_SIZE_RATIO = "max_bucket_size_ratio";
 
 const char* const IVF_PRECISE_QUANTIZATION_TYPE = "precise_quantization_type";
 const char* const IVF_PRECISE_IO_TYPE = "precise_io_type";
@@ -75,18 +75,23 @@ public:
 
     void
     Package() override {
-        if (GetQuantizerName() == QUANTIZATION_TYPE_VALUE_PQFS) {
+        if (this->quantizer_->UsePackage32()) {
             this->package_fastscan();
         }
     }
 
     void
     Unpack() override {
-        if (GetQuantizerName() == QUANTIZATION_TYPE_VALUE_PQFS) {
+        if (this->quantizer_->UsePackage32()) {
             this->unpack_fastscan();
         }
     }
 
+    [[nodiscard]] bool
+    UsePackage() const override {
+        return this->quantizer_->UsePackage32();
+    }
+
     void
     ExportModel(const BucketInterfacePtr& other) const override;
 
@@ -192,3 +192,40 @@ TEST_CASE("BucketDataCell Basic Test", "[ut][BucketDataCell] ") {
         }
     }
 }
+
+TEST_CASE("BucketDataCell TQ Test", "[ut][BucketDataCell] ") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto dim = 128;
+    std::string tq_chain = GENERATE("rom, fp32", "opq, fp32");
+    auto bucket_count = 20;
+    MetricType metrics[2] = {MetricType::METRIC_TYPE_L2SQR, MetricType::METRIC_TYPE_IP};
+    constexpr const char* param_temp =
+        R"(
+        {{
+            "io_params": {{
+                "type": "memory_io"
+            }},
+            "quantization_params": {{
+                "type": "tq",
+                "tq_chain": "{}",
+                "pq_dim": 16
+            }},
+            "buckets_count": {}
+        }}
+        )";
+    for (auto& metric : metrics) {
+        auto param_json = JsonType::Parse(fmt::format(param_temp, tq_chain, bucket_count));
+        auto param1 = std::make_shared<BucketDataCellParameter>();
+        param1->FromJson(param_json);
+        auto param2 = std::make_shared<BucketDataCellParameter>();
+        param2->FromJson(param_json);
+
+        IndexCommonParam common_param;
+        common_param.allocator_ = allocator;
+        common_param.dim_ = dim;
+        common_param.metric_ = metric;
+
+        // orthogonal transformers keep fp32 distances
+        TestBucketDataCell(param1, param2, common_param, 1e-3);
+    }
+}
@@ -21,6 +21,7 @@
 #include "inner_string_params.h"
 #include "io/io_headers.h"
 #include "quantization/quantizer_headers.h"
+#include "quantization/transform_quantization/transform_quantizer_parameter.h"
 
 namespace vsag {
 template <typename QuantTemp, typename IOTemp>
@@ -37,36 +38,73 @@ make_instance(const BucketDataCellParamPtr& param, const IndexCommonParam& commo
         param->use_residual_);
 }
 
+template <typename QuantTemp, typename IOTemp, MetricType metric>
+static BucketInterfacePtr
+make_instance_with_tq(const BucketDataCellParamPtr& param,
+                      const IndexCommonParam& common_param,
+                      bool is_transform_quantizer) {
+    if (is_transform_quantizer) {
+        return make_instance<TransformQuantizer<QuantTemp, metric>, IOTemp>(param, common_param);
+    }
+    return make_instance<QuantTemp, IOTemp>(param, common_param);
+}
+
 template <MetricType metric, typename IOTemp>
 static BucketInterfacePtr
 make_instance(const BucketDataCellParamPtr& param, const IndexCommonParam& common_param) {
     std::string quantization_string = param->quantizer_parameter->GetTypeName();
-    if (quantization_string == QUANTIZATION_TYPE_VALUE_SQ8) {
-        return make_instance<SQ8Quantizer<metric>, IOTemp>(param, common_param);
-    }
-    if (quantization_string == QUANTIZATION_TYPE_VALUE_FP32) {
-        return make_instance<FP32Quantizer<metric>, IOTemp>(param, common_param);
-    }
-    if (quantization_string == QUANTIZATION_TYPE_VALUE_SQ4) {
-        return make_instance<SQ4Quantizer<metric>, IOTemp>(param, common_param);
-    }
-    if (quantization_string == QUANTIZATION_TYPE_VALUE_SQ4_UNIFORM) {
-        return make_instance<SQ4UniformQuantizer<metric>, IOTemp>(param, common_param);
-    }
-    if (quantization_string == QUANTIZATION_TYPE_VALUE_SQ8_UNIFORM) {
-        return make_instance<SQ8UniformQuantizer<metric>, IOTemp>(param, common_param);
-    }
-    if (quantization_string == QUANTIZATION_TYPE_VALUE_PQ) {
-        return make_instance<ProductQuantizer<metric>, IOTemp>(param, common_param);
+
+    auto actual_quant_type = quantization_string;
+    bool is_transform_quantizer = (quantization_string == QUANTIZATION_TYPE_VALUE_TQ);
+    if (is_transform_quantizer) {
+        auto tq_param =
+            std::dynamic_pointer_cast<TransformQuantizerParameter>(param->quantizer_parameter);
+        if (not tq_param) {
+            throw VsagException(ErrorType::INVALID_ARGUMENT,
+                                "Expected TransformQuantizerParameter for TQ quantization");
+        }
+        actual_quant_type = tq_param->GetBottomQuantizationName();
     }
-    if (quantization_string == QUANTIZATION_TYPE_VALUE_PQFS) {
+
+    if (actual_quant_type == QUANTIZATION_TYPE_VALUE_SQ8) {
+        return make_instance_with_tq<SQ8Quantizer<metric>, IOTemp, metric>(
+            param, common_param, is_transform_quantizer);
+    }
+    if (actual_quant_type == QUANTIZATION_TYPE_VALUE_FP32) {
+        return make_instance_with_tq<FP32Quantizer<metric>, IOTemp, metric>(
+            param, common_param, is_transform_quantizer);
+    }
+    if (actual_quant_type == QUANTIZATION_TYPE_VALUE_SQ4) {
+        return make_instance_with_tq<SQ4Quantizer<metric>, IOTemp, metric>(
+            param, common_param, is_transform_quantizer);
+    }
+    if (actual_quant_type == QUANTIZATION_TYPE_VALUE_SQ4_UNIFORM) {
+        return make_instance_with_tq<SQ4UniformQuantizer<metric>, IOTemp, metric>(
+            param, common_param, is_transform_quantizer);
+    }
+    if (actual_quant_type == QUANTIZATION_TYPE_VALUE_SQ8_UNIFORM) {
+        return make_instance_with_tq<SQ8UniformQuantizer<metric>, IOTemp, metric>(
+            param, common_param, is_transform_quantizer);
+    }
+    if (actual_quant_type == QUANTIZATION_TYPE_VALUE_PQ) {
+        return make_instance_with_tq<ProductQuantizer<metric>, IOTemp, metric>(
+            param, common_param, is_transform_quantizer);
+    }
+    if (actual_quant_type == QUANTIZATION_TYPE_VALUE_PQFS) {
+        if (is_transform_quantizer) {
+            // packaged codes are laid out by the inner quantizer, which tq does not expose
+            throw VsagException(ErrorType::INVALID_ARGUMENT,
+                                "pqfs is not supported as the bottom quantizer of tq in buckets");
+        }
         return make_instance<PQFastScanQuantizer<metric>, IOTemp>(param, common_param);
     }
-    if (quantization_string == QUANTIZATION_TYPE_VALUE_BF16) {
-        return make_instance<BF16Quantizer<metric>, IOTemp>(param, common_param);
+    if (actual_quant_type == QUANTIZATION_TYPE_VALUE_BF16) {
+        return make_instance_with_tq<BF16Quantizer<metric>, IOTemp, metric>(
+            param, common_param, is_transform_quantizer);
     }
-    if (quantization_string == QUANTIZATION_TYPE_VALUE_FP16) {
-        return make_instance<FP16Quantizer<metric>, IOTemp>(param, common_param);
+    if (actual_quant_type == QUANTIZATION_TYPE_VALUE_FP16) {
+        return make_instance_with_tq<FP16Quantizer<metric>, IOTemp, metric>(
+            param, common_param, is_transform_quantizer);
     }
     return nullptr;
 }
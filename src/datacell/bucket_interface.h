@@ -119,6 +119,11 @@ public:
     virtual void
     Unpack(){};
 
+    [[nodiscard]] virtual bool
+    UsePackage() const {
+        return false;
+    }
+
 public:
     BucketIdType bucket_count_{0};
     uint32_t code_size_{0};
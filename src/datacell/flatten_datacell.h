@@ -110,6 +110,9 @@ public:
     void
     MergeOther(const FlattenInterfacePtr& other, InnerIdType bias) override;
 
+    void
+    CopyOther(const FlattenInterfacePtr& other, const Vector<InnerIdType>& other_ids) override;
+
     [[nodiscard]] std::string
     GetQuantizerName() override;
 
@@ -245,6 +248,24 @@ FlattenDataCell<QuantTmpl, IOTmpl>::BatchInsertVector(const void* vectors,
         io_->Write(codes.data,
                    static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
                    cur_count * static_cast<uint64_t>(code_size_));
+        return;
+    }
+    bool consecutive = true;
+    for (InnerIdType i = 1; i < count and consecutive; ++i) {
+        consecutive = idx_vec[i] == idx_vec[0] + i;
+    }
+    if (count > 0 and consecutive) {
+        // consecutive ids, encode in one batch and write the codes at once
+        ByteBuffer codes(static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
+                         allocator_);
+        quantizer_->EncodeBatch((const float*)vectors, codes.data, count);
+        {
+            std::lock_guard lock(mutex_);
+            total_count_ = std::max(total_count_, idx_vec[count - 1] + 1);
+        }
+        io_->Write(codes.data,
+                   static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
+                   static_cast<uint64_t>(idx_vec[0]) * static_cast<uint64_t>(code_size_));
     } else {
         auto dim = quantizer_->GetDim();
         for (int64_t i = 0; i < count; ++i) {
@@ -421,4 +442,38 @@ FlattenDataCell<QuantTmpl, IOTmpl>::MergeOther(const FlattenInterfacePtr& other,
     }
     this->total_count_ += total_count;
 }
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FlattenDataCell<QuantTmpl, IOTmpl>::CopyOther(const FlattenInterfacePtr& other,
+                                              const Vector<InnerIdType>& other_ids) {
+    auto ptr = std::dynamic_pointer_cast<FlattenDataCell<QuantTmpl, IOTmpl>>(other);
+    if (ptr == nullptr) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            "Copy flatten datacell failed: not match type");
+    }
+    constexpr uint64_t BUFFER_SIZE = 1024 * 1024 * 10;
+    const uint64_t max_run = std::max(BUFFER_SIZE / this->code_size_, 1UL);
+    uint64_t offset = static_cast<uint64_t>(this->total_count_) * this->code_size_;
+    uint64_t i = 0;
+    while (i < other_ids.size()) {
+        // copy runs of consecutive ids with a single read
+        uint64_t count = 1;
+        while (i + count < other_ids.size() and count < max_run and
+               other_ids[i + count] == other_ids[i] + count) {
+            ++count;
+        }
+        bool need_release = false;
+        uint64_t size = count * this->code_size_;
+        const auto* buffer = ptr->io_->Read(
+            size, static_cast<uint64_t>(other_ids[i]) * this->code_size_, need_release);
+        this->io_->Write(buffer, size, offset);
+        if (need_release) {
+            ptr->io_->Release(buffer);
+        }
+        offset += size;
+        i += count;
+    }
+    this->total_count_ += static_cast<InnerIdType>(other_ids.size());
+}
 }  // namespace vsag
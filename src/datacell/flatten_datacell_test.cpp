@@ -36,6 +36,8 @@ TestFlattenDataCell(FlattenDataCellParamPtr& param,
 
     FlattenInterfaceTest test(flatten, common_param.metric_);
     test.BasicTest(common_param.dim_, count, error);
+    auto copied = FlattenInterface::MakeInstance(param, common_param);
+    test.TestCopyOther(copied);
     auto other = FlattenInterface::MakeInstance(param, common_param);
     test.TestSerializeAndDeserialize(common_param.dim_, other, error);
 }
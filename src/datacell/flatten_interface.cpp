@@ -15,11 +15,13 @@
 #include "flatten_interface.h"
 
 #include "flatten_datacell.h"
+#include "fused_graph_datacell.h"
 #include "inner_string_params.h"
 #include "io/io_headers.h"
 #include "quantization/int8_quantizer.h"
 #include "quantization/quantizer_adapter.h"
 #include "quantization/quantizer_headers.h"
+#include "quantization/scalar_quantization/sq4_uniform_quantizer_parameter.h"
 #include "quantization/sparse_quantization/sparse_quantizer.h"
 #include "quantization/transform_quantization/transform_quantizer_parameter.h"
 #include "sparse_vector_datacell.h"
@@ -30,6 +32,18 @@ static FlattenInterfacePtr
 make_instance_flatten(const FlattenInterfaceParamPtr& param, const IndexCommonParam& common_param) {
     auto& io_param = param->io_parameter;
     auto& quantizer_param = param->quantizer_parameter;
+    if (param->name == FLATTEN_DATA_CELL and param->fused_graph_param != nullptr) {
+        if constexpr (std::is_same_v<IOTemp, MemoryBlockIO> or std::is_same_v<IOTemp, MemoryIO> or
+                      std::is_same_v<IOTemp, MMapIO> or std::is_same_v<IOTemp, BufferIO>) {
+            return std::make_shared<FusedGraphDataCell<QuantTemp, IOTemp>>(
+                quantizer_param, io_param, param->fused_graph_param, common_param);
+        } else {
+            throw VsagException(
+                ErrorType::INVALID_ARGUMENT,
+                fmt::format("io type {} does not support fused graph codes",
+                            io_param->GetTypeName()));
+        }
+    }
     if (param->name == FLATTEN_DATA_CELL) {
         return std::make_shared<FlattenDataCell<QuantTemp, IOTemp>>(
             quantizer_param, io_param, common_param);
@@ -110,6 +124,12 @@ make_instance(const FlattenInterfaceParamPtr& param, const IndexCommonParam& com
             param, common_param, is_transform_quantizer);
     }
     if (actual_quant_type == QUANTIZATION_TYPE_VALUE_SQ4_UNIFORM) {
+        auto sq4_param =
+            std::dynamic_pointer_cast<SQ4UniformQuantizerParameter>(param->quantizer_parameter);
+        if (sq4_param != nullptr and sq4_param->use_fastscan_) {
+            throw VsagException(ErrorType::INVALID_ARGUMENT,
+                                "sq4_uniform fastscan layout is only supported by bucket datacell");
+        }
         return make_instance_with_tq<SQ4UniformQuantizer<metric>, IOTemp, metric>(
             param, common_param, is_transform_quantizer);
     }
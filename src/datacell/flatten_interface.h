@@ -32,6 +32,7 @@
 
 namespace vsag {
 DEFINE_POINTER(FlattenInterface);
+DEFINE_POINTER(GraphInterface);
 
 class FlattenInterface {
 public:
@@ -161,6 +162,18 @@ public:
         throw VsagException(ErrorType::INTERNAL_ERROR, "MergeOther not implemented");
     }
 
+    // appends the codes of other_ids in other, in the given order, used by compaction
+    virtual void
+    CopyOther(const FlattenInterfacePtr& other, const Vector<InnerIdType>& other_ids) {
+        throw VsagException(ErrorType::UNSUPPORTED_INDEX_OPERATION, "CopyOther not implemented");
+    }
+
+    // returns the graph stored in the same records as the codes, nullptr if there is none
+    [[nodiscard]] virtual GraphInterfacePtr
+    GetFusedGraph() const {
+        return nullptr;
+    }
+
 public:
     mutable std::shared_mutex mutex_;
 
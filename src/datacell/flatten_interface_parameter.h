@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include "graph_interface_parameter.h"
 #include "io/io_parameter.h"
 #include "parameter.h"
 #include "quantization/quantizer_parameter.h"
@@ -33,6 +34,9 @@ public:
     IOParamPtr io_parameter{nullptr};
 
     std::string name;
+
+    // not serialized, set by the index when the bottom graph is stored along with the codes
+    GraphInterfaceParamPtr fused_graph_param{nullptr};
 };
 
 FlattenInterfaceParamPtr
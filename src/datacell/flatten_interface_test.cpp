@@ -19,6 +19,7 @@
 #include <fstream>
 
 #include "fixtures.h"
+#include "impl/allocator/safe_allocator.h"
 #include "simd/simd.h"
 #include "storage/serialization_template_test.h"
 
@@ -32,7 +33,12 @@ FlattenInterfaceTest::BasicTest(int64_t dim, uint64_t base_count, float error) {
     auto old_count = flatten_->TotalCount();
     InnerIdType last_one = base_count + old_count - 1;
     flatten_->Train(vectors.data(), base_count);
-    flatten_->BatchInsertVector(vectors.data(), base_count - 1);
+    auto half = base_count / 2;
+    flatten_->BatchInsertVector(vectors.data(), half);
+    std::vector<InnerIdType> consecutive_ids(base_count - 1 - half);
+    std::iota(consecutive_ids.begin(), consecutive_ids.end(), old_count + half);
+    flatten_->BatchInsertVector(
+        vectors.data() + half * dim, consecutive_ids.size(), consecutive_ids.data());
     flatten_->BatchInsertVector(vectors.data() + (base_count - 1) * dim, 1, &last_one);
     REQUIRE(flatten_->TotalCount() == base_count + old_count);
 
@@ -71,6 +77,23 @@ FlattenInterfaceTest::BasicTest(int64_t dim, uint64_t base_count, float error) {
         REQUIRE(std::abs(gt - value) < error);
     }
 }
+void
+FlattenInterfaceTest::TestCopyOther(FlattenInterfacePtr other) {
+    auto total_count = this->flatten_->TotalCount();
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    Vector<InnerIdType> ids(allocator.get());
+    for (InnerIdType i = 1; i < total_count; i += 2) {
+        ids.emplace_back(i);
+    }
+    this->flatten_->ExportModel(other);
+    other->CopyOther(this->flatten_, ids);
+    REQUIRE(other->TotalCount() == ids.size());
+    for (InnerIdType i = 0; i < ids.size(); ++i) {
+        REQUIRE(other->ComputePairVectors(i, 0) ==
+                this->flatten_->ComputePairVectors(ids[i], ids[0]));
+    }
+}
+
 void
 FlattenInterfaceTest::TestSerializeAndDeserialize(int64_t dim,
                                                   FlattenInterfacePtr other,
@@ -32,6 +32,9 @@ public:
     void
     TestSerializeAndDeserialize(int64_t dim, FlattenInterfacePtr other, float error = 1e-5f);
 
+    void
+    TestCopyOther(FlattenInterfacePtr other);
+
 public:
     FlattenInterfacePtr flatten_{nullptr};
 
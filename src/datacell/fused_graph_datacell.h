@@ -0,0 +1,449 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "common.h"
+#include "flatten_interface.h"
+#include "graph_datacell.h"
+#include "io/basic_io.h"
+#include "quantization/quantizer.h"
+#include "utils/byte_buffer.h"
+
+namespace vsag {
+
+/**
+ * stores the codes and the bottom neighbor lists of a node in one record
+ *
+ * record layout: | codes | padding to 4 bytes | neighbor count | neighbor ids | padding |
+ * the records are padded to whole cache lines, so reading the codes of a node also brings
+ * its neighbor list in, and a node sits in a single page for the disk based io
+ *
+ * the neighbor lists are served by a GraphDataCell which shares the io of this datacell,
+ * this datacell owns the io: it resizes, serializes and deserializes all the records
+ */
+template <typename QuantTmpl, typename IOTmpl>
+class FusedGraphDataCell : public FlattenInterface {
+public:
+    explicit FusedGraphDataCell(const QuantizerParamPtr& quantization_param,
+                                const IOParamPtr& io_param,
+                                const GraphInterfaceParamPtr& graph_param,
+                                const IndexCommonParam& common_param);
+
+    void
+    Query(float* result_dists,
+          const ComputerInterfacePtr& computer,
+          const InnerIdType* idx,
+          InnerIdType id_count,
+          Allocator* allocator = nullptr) override {
+        auto comp = static_cast<Computer<QuantTmpl>*>(computer.get());
+        this->query(result_dists, comp, idx, id_count, allocator);
+    }
+
+    ComputerInterfacePtr
+    FactoryComputer(const void* query) override {
+        auto computer = this->quantizer_->FactoryComputer();
+        computer->SetQuery((const float*)query);
+        return computer;
+    }
+
+    float
+    ComputePairVectors(InnerIdType id1, InnerIdType id2) override;
+
+    void
+    Train(const void* data, uint64_t count) override {
+        this->quantizer_->Train((const float*)data, count);
+    }
+
+    void
+    InsertVector(const void* vector, InnerIdType idx) override;
+
+    bool
+    UpdateVector(const void* vector,
+                 InnerIdType idx = std::numeric_limits<InnerIdType>::max()) override;
+
+    void
+    BatchInsertVector(const void* vectors, InnerIdType count, InnerIdType* idx_vec) override;
+
+    bool
+    Decode(const uint8_t* codes, DataType* data) override {
+        return this->quantizer_->DecodeOne(codes, data);
+    }
+
+    void
+    Resize(InnerIdType new_capacity) override {
+        if (new_capacity <= this->max_capacity_) {
+            return;
+        }
+        this->max_capacity_ = new_capacity;
+        uint64_t io_size = static_cast<uint64_t>(new_capacity) * record_size_;
+        uint8_t end_flag =
+            127;  // the value is meaningless, only to occupy the position for io allocate
+        this->io_->Write(&end_flag, 1, io_size);
+    }
+
+    void
+    Prefetch(InnerIdType id) override {
+        io_->Prefetch(get_offset(id), record_size_);
+    };
+
+    void
+    ExportModel(const FlattenInterfacePtr& other) const override;
+
+    void
+    MergeOther(const FlattenInterfacePtr& other, InnerIdType bias) override;
+
+    void
+    CopyOther(const FlattenInterfacePtr& other, const Vector<InnerIdType>& other_ids) override;
+
+    [[nodiscard]] std::string
+    GetQuantizerName() override {
+        return this->quantizer_->Name();
+    }
+
+    [[nodiscard]] MetricType
+    GetMetricType() override {
+        return this->quantizer_->Metric();
+    }
+
+    [[nodiscard]] const uint8_t*
+    GetCodesById(InnerIdType id, bool& need_release) const override {
+        return io_->Read(code_size_, get_offset(id), need_release);
+    }
+
+    bool
+    GetCodesById(InnerIdType id, uint8_t* codes) const override {
+        return io_->Read(code_size_, get_offset(id), codes);
+    }
+
+    [[nodiscard]] bool
+    InMemory() const override {
+        return IOTmpl::InMemory;
+    }
+
+    [[nodiscard]] bool
+    HoldMolds() const override {
+        return this->quantizer_->HoldMolds();
+    }
+
+    [[nodiscard]] GraphInterfacePtr
+    GetFusedGraph() const override {
+        return this->graph_;
+    }
+
+    void
+    Serialize(StreamWriter& writer) override;
+
+    void
+    Deserialize(lvalue_or_rvalue<StreamReader> reader) override;
+
+    void
+    InitIO(const IOParamPtr& io_param) override {
+        this->io_->InitIO(io_param);
+    }
+
+    [[nodiscard]] uint64_t
+    RecordSize() const {
+        return this->record_size_;
+    }
+
+public:
+    std::shared_ptr<Quantizer<QuantTmpl>> quantizer_{nullptr};
+    std::shared_ptr<BasicIO<IOTmpl>> io_{nullptr};
+    std::shared_ptr<GraphDataCell<IOTmpl>> graph_{nullptr};
+
+    Allocator* const allocator_{nullptr};
+
+private:
+    inline uint64_t
+    get_offset(InnerIdType id) const {
+        return static_cast<uint64_t>(id) * record_size_;
+    }
+
+    inline void
+    query(float* result_dists,
+          Computer<QuantTmpl>* computer,
+          const InnerIdType* idx,
+          InnerIdType id_count,
+          Allocator* allocator);
+
+    void
+    copy_codes(const FusedGraphDataCell<QuantTmpl, IOTmpl>* other,
+               InnerIdType other_id,
+               InnerIdType id);
+
+private:
+    uint64_t record_size_{0};
+};
+
+template <typename QuantTmpl, typename IOTmpl>
+FusedGraphDataCell<QuantTmpl, IOTmpl>::FusedGraphDataCell(
+    const QuantizerParamPtr& quantization_param,
+    const IOParamPtr& io_param,
+    const GraphInterfaceParamPtr& graph_param,
+    const IndexCommonParam& common_param)
+    : allocator_(common_param.allocator_.get()) {
+    this->quantizer_ = std::make_shared<QuantTmpl>(quantization_param, common_param);
+    this->io_ = std::make_shared<IOTmpl>(io_param, common_param);
+    this->code_size_ = quantizer_->GetCodeSize();
+    this->graph_ = std::make_shared<GraphDataCell<IOTmpl>>(graph_param, common_param);
+
+    constexpr uint64_t cache_line = 64;
+    auto neighbor_offset = (static_cast<uint64_t>(code_size_) + sizeof(InnerIdType) - 1) /
+                           sizeof(InnerIdType) * sizeof(InnerIdType);
+    auto record_size = neighbor_offset + sizeof(uint32_t) +
+                       static_cast<uint64_t>(graph_->MaximumDegree()) * sizeof(InnerIdType);
+    this->record_size_ = (record_size + cache_line - 1) / cache_line * cache_line;
+    this->graph_->ShareIO(this->io_, this->record_size_, neighbor_offset);
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FusedGraphDataCell<QuantTmpl, IOTmpl>::InsertVector(const void* vector, InnerIdType idx) {
+    {
+        std::lock_guard lock(mutex_);
+        if (idx == std::numeric_limits<InnerIdType>::max()) {
+            idx = total_count_;
+            ++total_count_;
+        } else {
+            total_count_ = std::max(total_count_, idx + 1);
+        }
+    }
+    ByteBuffer codes(static_cast<uint64_t>(code_size_), allocator_);
+    quantizer_->EncodeOne((const float*)vector, codes.data);
+    io_->Write(codes.data, code_size_, get_offset(idx));
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+bool
+FusedGraphDataCell<QuantTmpl, IOTmpl>::UpdateVector(const void* vector, InnerIdType idx) {
+    if (idx >= total_count_) {
+        return false;
+    }
+    std::lock_guard lock(mutex_);
+    ByteBuffer codes(static_cast<uint64_t>(code_size_), allocator_);
+    quantizer_->EncodeOne((const float*)vector, codes.data);
+    io_->Write(codes.data, code_size_, get_offset(idx));
+    return true;
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FusedGraphDataCell<QuantTmpl, IOTmpl>::BatchInsertVector(const void* vectors,
+                                                         InnerIdType count,
+                                                         InnerIdType* idx_vec) {
+    auto dim = quantizer_->GetDim();
+    if (idx_vec == nullptr) {
+        // the records are strided, encode in one batch and write the codes one by one
+        ByteBuffer codes(static_cast<uint64_t>(count) * static_cast<uint64_t>(code_size_),
+                         allocator_);
+        quantizer_->EncodeBatch((const float*)vectors, codes.data, count);
+        InnerIdType cur_count;
+        {
+            std::lock_guard lock(mutex_);
+            cur_count = total_count_;
+            total_count_ += count;
+        }
+        for (InnerIdType i = 0; i < count; ++i) {
+            io_->Write(codes.data + static_cast<uint64_t>(i) * code_size_,
+                       code_size_,
+                       get_offset(cur_count + i));
+        }
+    } else {
+        for (int64_t i = 0; i < count; ++i) {
+            this->InsertVector((const float*)vectors + dim * i, idx_vec[i]);
+        }
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FusedGraphDataCell<QuantTmpl, IOTmpl>::query(float* result_dists,
+                                             Computer<QuantTmpl>* computer,
+                                             const InnerIdType* idx,
+                                             InnerIdType id_count,
+                                             Allocator* allocator) {
+    Allocator* search_alloc = allocator == nullptr ? allocator_ : allocator;
+    for (uint32_t i = 0; i < this->prefetch_stride_code_ and i < id_count; i++) {
+        this->io_->Prefetch(get_offset(idx[i]), this->prefetch_depth_code_ * 64);
+    }
+    if constexpr (not IOTmpl::InMemory) {
+        if (id_count > 1) {
+            ByteBuffer codes(static_cast<uint64_t>(id_count) * this->code_size_, search_alloc);
+            Vector<uint64_t> sizes(id_count, this->code_size_, search_alloc);
+            Vector<uint64_t> offsets(id_count, 0, search_alloc);
+            for (int64_t i = 0; i < id_count; ++i) {
+                offsets[i] = get_offset(idx[i]);
+            }
+            this->io_->MultiRead(codes.data, sizes.data(), offsets.data(), id_count);
+            computer->ScanBatchDists(id_count, codes.data, result_dists);
+            return;
+        }
+    }
+
+    memset(result_dists, 0, sizeof(float) * id_count);
+    int64_t i = 0;
+    for (; i + 3 < id_count; i += 4) {
+        for (int64_t j = 0; j < 4; ++j) {
+            if (i + j + this->prefetch_stride_code_ < id_count) {
+                this->io_->Prefetch(get_offset(idx[i + j + this->prefetch_stride_code_]),
+                                    this->prefetch_depth_code_ * 64);
+            }
+        }
+        bool release1 = false;
+        const auto* codes1 = this->GetCodesById(idx[i], release1);
+        bool release2 = false;
+        const auto* codes2 = this->GetCodesById(idx[i + 1], release2);
+        bool release3 = false;
+        const auto* codes3 = this->GetCodesById(idx[i + 2], release3);
+        bool release4 = false;
+        const auto* codes4 = this->GetCodesById(idx[i + 3], release4);
+        computer->ComputeDistsBatch4(codes1,
+                                     codes2,
+                                     codes3,
+                                     codes4,
+                                     result_dists[i],
+                                     result_dists[i + 1],
+                                     result_dists[i + 2],
+                                     result_dists[i + 3]);
+        if (release1) {
+            this->io_->Release(codes1);
+        }
+        if (release2) {
+            this->io_->Release(codes2);
+        }
+        if (release3) {
+            this->io_->Release(codes3);
+        }
+        if (release4) {
+            this->io_->Release(codes4);
+        }
+    }
+    for (; i < id_count; ++i) {
+        bool release = false;
+        const auto* codes = this->GetCodesById(idx[i], release);
+        computer->ComputeDist(codes, result_dists + i);
+        if (release) {
+            this->io_->Release(codes);
+        }
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+float
+FusedGraphDataCell<QuantTmpl, IOTmpl>::ComputePairVectors(InnerIdType id1, InnerIdType id2) {
+    bool release1, release2;
+    const auto* codes1 = this->GetCodesById(id1, release1);
+    const auto* codes2 = this->GetCodesById(id2, release2);
+    auto result = this->quantizer_->Compute(codes1, codes2);
+    if (release1) {
+        this->io_->Release(codes1);
+    }
+    if (release2) {
+        this->io_->Release(codes2);
+    }
+    return result;
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FusedGraphDataCell<QuantTmpl, IOTmpl>::ExportModel(const FlattenInterfacePtr& other) const {
+    auto ptr = std::dynamic_pointer_cast<FusedGraphDataCell<QuantTmpl, IOTmpl>>(other);
+    if (ptr == nullptr) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            "Export model's fused graph datacell failed");
+    }
+    std::stringstream ss;
+    IOStreamWriter writer(ss);
+    this->quantizer_->Serialize(writer);
+    ss.seekg(0, std::ios::beg);
+    IOStreamReader reader(ss);
+    ptr->quantizer_->Deserialize(reader);
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FusedGraphDataCell<QuantTmpl, IOTmpl>::copy_codes(
+    const FusedGraphDataCell<QuantTmpl, IOTmpl>* other, InnerIdType other_id, InnerIdType id) {
+    bool need_release = false;
+    const auto* codes = other->GetCodesById(other_id, need_release);
+    this->io_->Write(codes, code_size_, get_offset(id));
+    if (need_release) {
+        other->io_->Release(codes);
+    }
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FusedGraphDataCell<QuantTmpl, IOTmpl>::MergeOther(const FlattenInterfacePtr& other,
+                                                  InnerIdType bias) {
+    auto ptr = std::dynamic_pointer_cast<FusedGraphDataCell<QuantTmpl, IOTmpl>>(other);
+    if (ptr == nullptr) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            "Merge fused graph datacell failed: not match type");
+    }
+    // only the codes are copied, the neighbor lists are merged by the graph
+    InnerIdType total_count = ptr->total_count_;
+    for (InnerIdType i = 0; i < total_count; ++i) {
+        this->copy_codes(ptr.get(), i, i + bias);
+    }
+    this->total_count_ += total_count;
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FusedGraphDataCell<QuantTmpl, IOTmpl>::CopyOther(const FlattenInterfacePtr& other,
+                                                 const Vector<InnerIdType>& other_ids) {
+    auto ptr = std::dynamic_pointer_cast<FusedGraphDataCell<QuantTmpl, IOTmpl>>(other);
+    if (ptr == nullptr) {
+        throw VsagException(ErrorType::INTERNAL_ERROR,
+                            "Copy fused graph datacell failed: not match type");
+    }
+    InnerIdType id = this->total_count_;
+    for (const auto& other_id : other_ids) {
+        this->copy_codes(ptr.get(), other_id, id++);
+    }
+    this->total_count_ = id;
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FusedGraphDataCell<QuantTmpl, IOTmpl>::Serialize(StreamWriter& writer) {
+    FlattenInterface::Serialize(writer);
+    StreamWriter::WriteObj(writer, this->record_size_);
+    this->io_->Serialize(writer);
+    this->quantizer_->Serialize(writer);
+}
+
+template <typename QuantTmpl, typename IOTmpl>
+void
+FusedGraphDataCell<QuantTmpl, IOTmpl>::Deserialize(lvalue_or_rvalue<StreamReader> reader) {
+    FlattenInterface::Deserialize(reader);
+    uint64_t record_size = 0;
+    StreamReader::ReadObj(reader, record_size);
+    if (record_size != this->record_size_) {
+        throw VsagException(
+            ErrorType::INVALID_ARGUMENT,
+            fmt::format("fused graph record size mismatch: {} vs {}", record_size, record_size_));
+    }
+    this->io_->Deserialize(reader);
+    this->quantizer_->Deserialize(reader);
+}
+
+}  // namespace vsag
@@ -0,0 +1,127 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "fused_graph_datacell.h"
+
+#include <catch2/catch_template_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "flatten_datacell_parameter.h"
+#include "flatten_interface_test.h"
+#include "graph_interface_parameter.h"
+#include "impl/allocator/safe_allocator.h"
+
+using namespace vsag;
+
+static void
+TestFusedGraphDataCell(const FlattenInterfaceParamPtr& param,
+                       const IndexCommonParam& common_param,
+                       uint64_t max_degree,
+                       float error) {
+    auto count = 500;
+    auto flatten = FlattenInterface::MakeInstance(param, common_param);
+    auto graph = flatten->GetFusedGraph();
+    REQUIRE(graph != nullptr);
+    REQUIRE(graph->MaximumDegree() == max_degree);
+
+    FlattenInterfaceTest test(flatten, common_param.metric_);
+    test.BasicTest(common_param.dim_, count, error);
+    auto copied = FlattenInterface::MakeInstance(param, common_param);
+    test.TestCopyOther(copied);
+
+    // neighbor lists and codes share a record, writing one must not touch the other
+    auto total = flatten->TotalCount();
+    graph->Resize(total);
+    Vector<InnerIdType> neighbors(common_param.allocator_.get());
+    for (InnerIdType id = 0; id < total; ++id) {
+        neighbors.resize(id % (max_degree + 1));
+        for (InnerIdType j = 0; j < neighbors.size(); ++j) {
+            neighbors[j] = (id + j + 1) % total;
+        }
+        graph->InsertNeighborsById(id, neighbors);
+    }
+    Vector<uint8_t> codes(flatten->code_size_, common_param.allocator_.get());
+    Vector<uint8_t> other_codes(flatten->code_size_, common_param.allocator_.get());
+    auto check = [&](const FlattenInterfacePtr& other_flatten) {
+        auto other_graph = other_flatten->GetFusedGraph();
+        for (InnerIdType id = 0; id < total; ++id) {
+            other_graph->GetNeighbors(id, neighbors);
+            REQUIRE(neighbors.size() == id % (max_degree + 1));
+            for (InnerIdType j = 0; j < neighbors.size(); ++j) {
+                REQUIRE(neighbors[j] == (id + j + 1) % total);
+            }
+            flatten->GetCodesById(id, codes.data());
+            other_flatten->GetCodesById(id, other_codes.data());
+            REQUIRE(codes == other_codes);
+        }
+    };
+    check(flatten);
+
+    // the codes carry the records, the graph only its own header
+    std::stringstream ss;
+    IOStreamWriter writer(ss);
+    flatten->Serialize(writer);
+    graph->Serialize(writer);
+
+    auto other = FlattenInterface::MakeInstance(param, common_param);
+    ss.seekg(0, std::ios::beg);
+    IOStreamReader reader(ss);
+    other->Deserialize(reader);
+    other->GetFusedGraph()->Deserialize(reader);
+    REQUIRE(other->TotalCount() == total);
+    check(other);
+}
+
+TEST_CASE("FusedGraphDataCell Basic Test", "[ut][FusedGraphDataCell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto dim = GENERATE(32, 100);
+    auto max_degree = GENERATE(5, 32);
+    std::string io_type = GENERATE("memory_io", "block_memory_io");
+    std::vector<std::pair<std::string, float>> quantizer_errors = {{"sq8", 2e-2f}, {"fp32", 1e-5}};
+    constexpr const char* codes_param_temp =
+        R"(
+        {{
+            "io_params": {{
+                "type": "{}"
+            }},
+            "quantization_params": {{
+                "type": "{}"
+            }}
+        }}
+        )";
+    constexpr const char* graph_param_temp =
+        R"(
+        {{
+            "io_params": {{
+                "type": "{}"
+            }},
+            "max_degree": {},
+            "support_remove": true
+        }}
+        )";
+    for (auto& quantizer_error : quantizer_errors) {
+        auto param = std::make_shared<FlattenDataCellParameter>();
+        param->FromJson(
+            JsonType::Parse(fmt::format(codes_param_temp, io_type, quantizer_error.first)));
+        param->fused_graph_param = GraphInterfaceParameter::GetGraphParameterByJson(
+            GraphStorageTypes::GRAPH_STORAGE_TYPE_VALUE_FLAT,
+            JsonType::Parse(fmt::format(graph_param_temp, io_type, max_degree)));
+        IndexCommonParam common_param;
+        common_param.allocator_ = allocator;
+        common_param.dim_ = dim;
+        common_param.metric_ = MetricType::METRIC_TYPE_L2SQR;
+        TestFusedGraphDataCell(param, common_param, max_degree, quantizer_error.second);
+    }
+}
@@ -62,6 +62,9 @@ public:
     void
     GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const override;
 
+    void
+    GetNeighborsWithRemoved(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const override;
+
     void
     Resize(InnerIdType new_size) override;
 
@@ -70,9 +73,25 @@ public:
         this->io_ = io;
     }
 
+    /****
+     * store the neighbor lists inside the records of an io owned by another datacell
+     * @param io shared io, serialized and resized by its owner
+     * @param record_size bytes between the records of two adjacent ids
+     * @param record_offset offset of the neighbor list inside a record
+     */
+    inline void
+    ShareIO(std::shared_ptr<BasicIO<IOTmpl>> io, uint64_t record_size, uint64_t record_offset) {
+        this->io_ = io;
+        this->own_io_ = false;
+        this->record_size_ = record_size;
+        this->record_offset_ = record_offset;
+    }
+
     virtual void
     InitIO(const IOParamPtr& io_param) override {
-        this->io_->InitIO(io_param);
+        if (own_io_) {
+            this->io_->InitIO(io_param);
+        }
     }
 
     /****
@@ -82,8 +101,7 @@ public:
      */
     void
     Prefetch(InnerIdType id, uint32_t neighbor_i) override {
-        io_->Prefetch(static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_) +
-                      sizeof(uint32_t) + neighbor_i * sizeof(InnerIdType));
+        io_->Prefetch(get_offset(id) + sizeof(uint32_t) + neighbor_i * sizeof(InnerIdType));
     }
 
     void
@@ -100,6 +118,12 @@ public:
     void
     MergeOther(GraphInterfacePtr other, uint64_t bias) override;
 
+private:
+    inline uint64_t
+    get_offset(InnerIdType id) const {
+        return static_cast<uint64_t>(id) * record_size_ + record_offset_;
+    }
+
 private:
     std::shared_ptr<BasicIO<IOTmpl>> io_{nullptr};
 
@@ -111,6 +135,10 @@ private:
     uint32_t remove_flag_mask_{0x00ffffff};
 
     uint32_t code_line_size_{0};
+
+    uint64_t record_size_{0};
+    uint64_t record_offset_{0};
+    bool own_io_{true};
 };
 
 template <typename IOTmpl>
@@ -154,6 +182,7 @@ GraphDataCell<IOTmpl>::GraphDataCell(const GraphDataCellParamPtr& param,
     this->id_bit_ = sizeof(InnerIdType) * 8 - this->remove_flag_bit_;
     this->remove_flag_mask_ = (1 << this->id_bit_) - 1;
     this->code_line_size_ = this->maximum_degree_ * sizeof(InnerIdType) + sizeof(uint32_t);
+    this->record_size_ = this->code_line_size_;
     this->allocator_ = common_param.allocator_.get();
     if (this->is_support_delete_) {
         node_versions_.resize(max_capacity_);
@@ -178,7 +207,7 @@ GraphDataCell<IOTmpl>::InsertNeighborsById(InnerIdType id,
     InnerIdType current = total_count_.load();
     while (current < id + 1 && !total_count_.compare_exchange_weak(current, id + 1)) {
     }
-    auto start = static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_);
+    auto start = get_offset(id);
     if (is_support_delete_) {
         uint32_t neighbor_count = std::min((uint32_t)(neighbor_ids.size()), this->maximum_degree_);
         this->io_->Write((uint8_t*)(&neighbor_count), sizeof(neighbor_count), start);
@@ -204,7 +233,7 @@ GraphDataCell<IOTmpl>::InsertNeighborsById(InnerIdType id,
 template <typename IOTmpl>
 uint32_t
 GraphDataCell<IOTmpl>::GetNeighborSize(InnerIdType id) const {
-    auto start = static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_);
+    auto start = get_offset(id);
     uint32_t neighbor_count = 0;
     this->io_->Read(sizeof(neighbor_count), start, (uint8_t*)(&neighbor_count));
     return neighbor_count;
@@ -213,7 +242,7 @@ GraphDataCell<IOTmpl>::GetNeighborSize(InnerIdType id) const {
 template <typename IOTmpl>
 void
 GraphDataCell<IOTmpl>::GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const {
-    auto start = static_cast<uint64_t>(id) * static_cast<uint64_t>(this->code_line_size_);
+    auto start = get_offset(id);
     uint32_t neighbor_count = 0;
     this->io_->Read(sizeof(neighbor_count), start, (uint8_t*)(&neighbor_count));
     if (is_support_delete_) {
@@ -239,6 +268,27 @@ GraphDataCell<IOTmpl>::GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbo
     }
 }
 
+template <typename IOTmpl>
+void
+GraphDataCell<IOTmpl>::GetNeighborsWithRemoved(InnerIdType id,
+                                               Vector<InnerIdType>& neighbor_ids) const {
+    if (not is_support_delete_) {
+        this->GetNeighbors(id, neighbor_ids);
+        return;
+    }
+    auto start = get_offset(id);
+    uint32_t neighbor_count = 0;
+    this->io_->Read(sizeof(neighbor_count), start, (uint8_t*)(&neighbor_count));
+    neighbor_count &= remove_flag_mask_;
+    start += sizeof(neighbor_count);
+    neighbor_ids.resize(neighbor_count);
+    this->io_->Read(
+        neighbor_count * sizeof(InnerIdType), start, (uint8_t*)(neighbor_ids.data()));
+    for (auto& neighbor_id : neighbor_ids) {
+        neighbor_id &= remove_flag_mask_;
+    }
+}
+
 template <typename IOTmpl>
 void
 GraphDataCell<IOTmpl>::Resize(InnerIdType new_size) {
@@ -254,6 +304,9 @@ GraphDataCell<IOTmpl>::Resize(InnerIdType new_size) {
         node_versions_.resize(new_size);
     }
     this->max_capacity_ = new_size;
+    if (not own_io_) {
+        return;
+    }
     uint64_t io_size = static_cast<uint64_t>(new_size) * static_cast<uint64_t>(code_line_size_);
     uint8_t end_flag =
         127;  // the value is meaningless, only to occupy the position for io allocate
@@ -264,7 +317,9 @@ template <typename IOTmpl>
 void
 GraphDataCell<IOTmpl>::Serialize(StreamWriter& writer) {
     GraphInterface::Serialize(writer);
-    this->io_->Serialize(writer);
+    if (own_io_) {
+        this->io_->Serialize(writer);
+    }
     StreamWriter::WriteObj(writer, this->code_line_size_);
     if (is_support_delete_) {
         StreamWriter::WriteVector(writer, node_versions_);
@@ -275,8 +330,13 @@ template <typename IOTmpl>
 void
 GraphDataCell<IOTmpl>::Deserialize(StreamReader& reader) {
     GraphInterface::Deserialize(reader);
-    this->io_->Deserialize(reader);
+    if (own_io_) {
+        this->io_->Deserialize(reader);
+    }
     StreamReader::ReadObj(reader, this->code_line_size_);
+    if (own_io_) {
+        this->record_size_ = this->code_line_size_;
+    }
     if (is_support_delete_) {
         StreamReader::ReadVector(reader, node_versions_);
     }
@@ -62,6 +62,12 @@ public:
     virtual void
     GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const = 0;
 
+    // returns the stored neighbors without filtering out removed nodes, used by delete repair
+    virtual void
+    GetNeighborsWithRemoved(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const {
+        this->GetNeighbors(id, neighbor_ids);
+    }
+
     virtual void
     Resize(InnerIdType new_size) = 0;
 
@@ -125,6 +125,12 @@ GraphInterfaceTest::BasicTest(uint64_t max_id,
                     for (const auto& neighbor_id : neighbors) {
                         REQUIRE(keys_to_delete.count(neighbor_id) == 0);
                     }
+                    // removed neighbors are still stored and visible to delete repair
+                    this->graph_->GetNeighborsWithRemoved(item.first, neighbors);
+                    REQUIRE(neighbors.size() == item.second->size());
+                    REQUIRE(memcmp(neighbors.data(),
+                                   item.second->data(),
+                                   neighbors.size() * sizeof(InnerIdType)) == 0);
                 } else {
                     this->graph_->DeleteNeighborsById(item.first);
                     keys_to_delete.insert(item.first);
@@ -108,6 +108,21 @@ SparseGraphDataCell::GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_
         }
     }
 }
+void
+SparseGraphDataCell::GetNeighborsWithRemoved(InnerIdType id,
+                                             Vector<InnerIdType>& neighbor_ids) const {
+    std::shared_lock<std::shared_mutex> rlock(this->neighbors_map_mutex_);
+    neighbor_ids.clear();
+    auto iter = this->neighbors_.find(id);
+    if (iter != this->neighbors_.end()) {
+        neighbor_ids.reserve(iter->second->size());
+        for (const auto& neighbor_id : *(iter->second)) {
+            neighbor_ids.push_back(is_support_delete_ ? (neighbor_id & remove_flag_mask_)
+                                                      : neighbor_id);
+        }
+    }
+}
+
 void
 SparseGraphDataCell::Serialize(StreamWriter& writer) {
     GraphInterface::Serialize(writer);
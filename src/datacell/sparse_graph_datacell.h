@@ -48,6 +48,9 @@ public:
     void
     GetNeighbors(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const override;
 
+    void
+    GetNeighborsWithRemoved(InnerIdType id, Vector<InnerIdType>& neighbor_ids) const override;
+
     void
     Resize(InnerIdType new_size) override;
 
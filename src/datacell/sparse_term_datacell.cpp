@@ -15,6 +15,8 @@
 
 #include "sparse_term_datacell.h"
 
+#include <array>
+
 namespace vsag {
 
 void
@@ -26,23 +28,321 @@ SparseTermDataCell::Query(float* global_dists, const SparseTermComputerPtr& comp
             auto next_it = it + 1;
             auto next_term = computer->GetTerm(next_it);
             if (next_term < term_ids_.size()) {
-                __builtin_prefetch(term_ids_[next_term].data(), 0, 3);
-                __builtin_prefetch(term_datas_[next_term].data(), 0, 3);
+                prefetch_term(next_term);
             }
         }
         if (term >= term_ids_.size()) {
             continue;
         }
-        computer->ScanForAccumulate(it,
-                                    term_ids_[term].data(),
-                                    term_datas_[term].data(),
-                                    static_cast<uint32_t>(static_cast<float>(term_sizes_[term]) *
-                                                          computer->term_retain_ratio_),
-                                    global_dists);
+        scan_term(it,
+                  term,
+                  static_cast<uint32_t>(static_cast<float>(term_sizes_[term]) *
+                                        computer->term_retain_ratio_),
+                  computer,
+                  global_dists);
     }
     computer->ResetTerm();
 }
 
+void
+SparseTermDataCell::Query(float* global_dists,
+                          const SparseTermComputerPtr& computer,
+                          const uint8_t* window_mask) const {
+    while (computer->HasNextTerm()) {
+        auto it = computer->NextTermIter();
+        auto term = computer->GetTerm(it);
+        if (term >= term_ids_.size()) {
+            continue;
+        }
+        float query_val = computer->sorted_query_[it].second;
+        auto count = static_cast<uint32_t>(static_cast<float>(term_sizes_[term]) *
+                                           computer->term_retain_ratio_);
+        for_each_posting(term, count, [&](uint32_t id, float val) {
+            if (window_mask[id] != 0) {
+                global_dists[id] += query_val * val;
+            }
+        });
+    }
+    computer->ResetTerm();
+}
+
+void
+SparseTermDataCell::scan_term(uint32_t term_iterator,
+                              uint32_t term,
+                              uint32_t count,
+                              const SparseTermComputerPtr& computer,
+                              float* global_dists) const {
+    if (compressed_) {
+        computer->ScanForAccumulate(term_iterator,
+                                    term_id_stream(term),
+                                    term_codes(term),
+                                    term_mins_[term],
+                                    term_scales_[term],
+                                    count,
+                                    term_has_escape(term),
+                                    global_dists);
+    } else {
+        computer->ScanForAccumulate(
+            term_iterator, term_ids_[term].data(), term_datas_[term].data(), count, global_dists);
+    }
+}
+
+void
+SparseTermDataCell::prefetch_term(uint32_t term) const {
+    if (compressed_) {
+        __builtin_prefetch(term_codes(term), 0, 3);
+        __builtin_prefetch(term_id_stream(term), 0, 3);
+    } else {
+        __builtin_prefetch(term_ids_[term].data(), 0, 3);
+        __builtin_prefetch(term_datas_[term].data(), 0, 3);
+    }
+}
+
+bool
+SparseTermDataCell::QueryWithPruning(float* global_dists,
+                                     const SparseTermComputerPtr& computer,
+                                     float threshold) const {
+    auto query_len = computer->pruned_len_;
+    auto& order = computer->prune_order_;
+    auto& bounds = computer->prune_bounds_;
+    order.resize(query_len);
+    bounds.resize(query_len);
+    float total_bound = 0.0F;
+    for (uint32_t it = 0; it < query_len; ++it) {
+        auto term = computer->GetTerm(it);
+        order[it] = it;
+        bounds[it] = 0.0F;
+        if (term < term_ids_.size()) {
+            bounds[it] = std::abs(computer->sorted_query_[it].second) *
+                         term_bound(term, retained_count(term, computer));
+        }
+        total_bound += bounds[it];
+    }
+    // bounds the rounding of an accumulation in any term order, no true candidate is pruned
+    float slack =
+        2.0F * total_bound * static_cast<float>(query_len) * std::numeric_limits<float>::epsilon();
+
+    // non-essential terms: the smallest bounds, together they cannot lift a document enough
+    std::sort(order.begin(), order.end(), [&bounds](uint32_t left, uint32_t right) {
+        return bounds[left] < bounds[right];
+    });
+    uint32_t non_essential_count = 0;
+    float lift = 0.0F;
+    while (non_essential_count < query_len and
+           lift + bounds[order[non_essential_count]] + slack < -threshold) {
+        lift += bounds[order[non_essential_count++]];
+    }
+    if (non_essential_count == 0) {
+        return false;
+    }
+
+    // the essential terms are accumulated in query order, every touched document is recorded
+    std::sort(order.begin() + non_essential_count, order.end());
+    uint64_t posting_count = 0;
+    for (auto i = non_essential_count; i < query_len; ++i) {
+        auto term = computer->GetTerm(order[i]);
+        if (term < term_ids_.size()) {
+            posting_count += retained_count(term, computer);
+        }
+    }
+    auto& touched = computer->prune_touched_;
+    if (touched.size() < posting_count) {
+        touched.resize(posting_count);
+    }
+    uint32_t touched_count = 0;
+    for (auto i = non_essential_count; i < query_len; ++i) {
+        auto term = computer->GetTerm(order[i]);
+        if (term < term_ids_.size()) {
+            touched_count = scan_term_and_collect(order[i],
+                                                  term,
+                                                  retained_count(term, computer),
+                                                  computer,
+                                                  global_dists,
+                                                  touched.data(),
+                                                  touched_count);
+        }
+    }
+    computer->prune_touched_count_ = touched_count;
+
+    // candidates: the touched documents that the non-essential terms can still lift enough
+    auto& candidates = computer->prune_candidates_;
+    candidates.clear();
+    float reach = threshold + lift + slack;
+    for (uint32_t i = 0; i < touched_count; ++i) {
+        if (global_dists[touched[i]] <= reach) {
+            candidates.push_back(touched[i]);
+        }
+    }
+
+    // complete them from the largest non-essential bound on, dropping those falling short
+    bool sorted = false;
+    for (auto i = non_essential_count; i > 0 and not candidates.empty(); --i) {
+        auto it = order[i - 1];
+        lift = std::max(lift - bounds[it], 0.0F);
+        auto term = computer->GetTerm(it);
+        if (term >= term_ids_.size()) {
+            continue;
+        }
+        auto count = retained_count(term, computer);
+        if (candidates.size() * PROBE_RATIO < count) {
+            if (not sorted) {
+                sort_candidates(candidates);
+                sorted = true;
+            }
+            probe_term(
+                it, term, count, computer, candidates.data(), candidates.size(), global_dists);
+        } else {
+            // dense candidates: scan the list, only the touched documents are accumulated
+            gate_scan_term(it, term, count, computer, global_dists);
+        }
+        reach = threshold + lift + slack;
+        uint64_t kept = 0;
+        for (auto id : candidates) {
+            if (global_dists[id] <= reach) {
+                candidates[kept++] = id;
+            }
+        }
+        candidates.resize(kept);
+    }
+
+    // sum the survivors again in query order, the same rounding as Query
+    if (not sorted) {
+        sort_candidates(candidates);
+    }
+    for (auto id : candidates) {
+        global_dists[id] = 0.0F;
+    }
+    for (uint32_t it = 0; it < query_len and not candidates.empty(); ++it) {
+        auto term = computer->GetTerm(it);
+        if (term < term_ids_.size()) {
+            probe_term(it,
+                       term,
+                       retained_count(term, computer),
+                       computer,
+                       candidates.data(),
+                       candidates.size(),
+                       global_dists);
+        }
+    }
+    return true;
+}
+
+uint32_t
+SparseTermDataCell::scan_term_and_collect(uint32_t term_iterator,
+                                          uint32_t term,
+                                          uint32_t count,
+                                          const SparseTermComputerPtr& computer,
+                                          float* global_dists,
+                                          uint32_t* touched,
+                                          uint32_t touched_count) const {
+    float query_val = computer->sorted_query_[term_iterator].second;
+    if (not compressed_) {
+        const auto* ids = term_ids_[term].data();
+        const auto* datas = term_datas_[term].data();
+        for (uint32_t i = 0; i < count; ++i) {
+            auto& dist = global_dists[ids[i]];
+            touched[touched_count] = ids[i];
+            touched_count += static_cast<uint32_t>(dist == 0);
+            dist += query_val * datas[i];
+        }
+        return touched_count;
+    }
+    // the same products as the compressed ScanForAccumulate
+    float base = query_val * term_mins_[term];
+    float step = query_val * term_scales_[term];
+    const auto* codes = term_codes(term);
+    SparsePostingIdDecoder decoder(term_id_stream(term));
+    for (uint32_t i = 0; i < count; ++i) {
+        auto id = decoder.Next();
+        auto& dist = global_dists[id];
+        touched[touched_count] = id;
+        touched_count += static_cast<uint32_t>(dist == 0);
+        dist += base + step * static_cast<float>(codes[i]);
+    }
+    return touched_count;
+}
+
+void
+SparseTermDataCell::gate_scan_term(uint32_t term_iterator,
+                                   uint32_t term,
+                                   uint32_t count,
+                                   const SparseTermComputerPtr& computer,
+                                   float* global_dists) const {
+    float query_val = computer->sorted_query_[term_iterator].second;
+    for_each_posting(term, count, [&](uint32_t id, float val) {
+        auto& dist = global_dists[id];
+        if (dist != 0) {
+            dist += query_val * val;
+        }
+    });
+}
+
+void
+SparseTermDataCell::sort_candidates(Vector<uint32_t>& candidates) {
+    // a document whose sum returns to zero is recorded twice
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+}
+
+void
+SparseTermDataCell::probe_term(uint32_t term_iterator,
+                               uint32_t term,
+                               uint32_t count,
+                               const SparseTermComputerPtr& computer,
+                               const uint32_t* ids,
+                               uint64_t id_count,
+                               float* global_dists) const {
+    float query_val = computer->sorted_query_[term_iterator].second;
+    float base = compressed_ ? query_val * term_mins_[term] : 0.0F;
+    float step = compressed_ ? query_val * term_scales_[term] : 0.0F;
+    const auto* codes = compressed_ ? term_codes(term) : nullptr;
+    const auto* datas = compressed_ ? nullptr : term_datas_[term].data();
+
+    // ids of the entered block, decoded into block_ids when compressed
+    std::array<uint32_t, TERM_BLOCK_SIZE> block_ids{};
+    const uint32_t* entered_ids = nullptr;
+    auto block_count = (count + TERM_BLOCK_SIZE - 1) / TERM_BLOCK_SIZE;
+    uint32_t block = 0;
+    uint32_t entered_block = block_count;
+    uint32_t begin = 0;
+    uint32_t end = 0;
+    for (uint64_t i = 0; i < id_count; ++i) {
+        auto id = ids[i];
+        while (block + 1 < block_count and
+               (compressed_ ? term_block_skips_[term][2 * (block + 1)]
+                            : term_ids_[term][(block + 1) * TERM_BLOCK_SIZE - 1]) < id) {
+            ++block;
+        }
+        if (block != entered_block) {
+            entered_block = block;
+            begin = block * TERM_BLOCK_SIZE;
+            end = std::min(begin + TERM_BLOCK_SIZE, count);
+            if (compressed_) {
+                const auto& skips = term_block_skips_[term];
+                SparsePostingIdDecoder decoder(term_id_stream(term) + skips[2 * block + 1],
+                                               skips[2 * block]);
+                for (auto pos = begin; pos < end; ++pos) {
+                    block_ids[pos - begin] = decoder.Next();
+                }
+                entered_ids = block_ids.data();
+            } else {
+                entered_ids = term_ids_[term].data() + begin;
+            }
+        }
+        auto offset = static_cast<uint32_t>(
+            std::lower_bound(entered_ids, entered_ids + (end - begin), id) - entered_ids);
+        if (offset == end - begin or entered_ids[offset] != id) {
+            continue;
+        }
+        // the same products as scan_term
+        if (compressed_) {
+            global_dists[id] += base + step * static_cast<float>(codes[begin + offset]);
+        } else {
+            global_dists[id] += query_val * datas[begin + offset];
+        }
+    }
+}
+
 template <InnerSearchMode mode, InnerSearchType type>
 void
 SparseTermDataCell::InsertHeap(float* dists,
@@ -73,10 +373,12 @@ SparseTermDataCell::InsertHeap(float* dists,
         uint32_t i = 0;
         auto term_size = static_cast<uint32_t>(static_cast<float>(term_sizes_[term]) *
                                                computer->term_retain_ratio_);
+        const uint32_t* raw_ids = compressed_ ? nullptr : term_ids_[term].data();
+        SparsePostingIdDecoder decoder(compressed_ ? term_id_stream(term) : nullptr);
         if constexpr (mode == InnerSearchMode::KNN_SEARCH) {
             if (heap.size() < n_candidate) {
                 for (; i < term_size; i++) {
-                    id = term_ids_[term][i];
+                    id = raw_ids != nullptr ? raw_ids[i] : decoder.Next();
 
                     if constexpr (type == InnerSearchType::WITH_FILTER) {
                         if (not filter->CheckValid(id + offset_id)) {
@@ -92,6 +394,7 @@ SparseTermDataCell::InsertHeap(float* dists,
                     }
 
                     if (heap.size() == n_candidate) {
+                        i++;
                         break;
                     }
                 }
@@ -99,7 +402,7 @@ SparseTermDataCell::InsertHeap(float* dists,
         }
 
         for (; i < term_size; i++) {
-            id = term_ids_[term][i];
+            id = raw_ids != nullptr ? raw_ids[i] : decoder.Next();
 
             if constexpr (type == InnerSearchType::WITH_FILTER) {
 #if __cplusplus >= 202002L
@@ -135,6 +438,47 @@ SparseTermDataCell::InsertHeap(float* dists,
     computer->ResetTerm();
 }
 
+template <InnerSearchMode mode, InnerSearchType type>
+void
+SparseTermDataCell::InsertCandidates(float* dists,
+                                     const SparseTermComputerPtr& computer,
+                                     MaxHeap& heap,
+                                     const InnerSearchParam& param,
+                                     uint32_t offset_id) const {
+    float cur_heap_top = std::numeric_limits<float>::max();
+    if constexpr (mode == InnerSearchMode::RANGE_SEARCH) {
+        cur_heap_top = param.radius - 1;
+    } else if (heap.size() >= param.ef) {
+        cur_heap_top = heap.top().first;
+    }
+
+    for (auto id : computer->prune_candidates_) {
+        if (dists[id] > cur_heap_top) {
+            continue;
+        }
+        if constexpr (type == InnerSearchType::WITH_FILTER) {
+            if (not param.is_inner_id_allowed->CheckValid(id + offset_id)) {
+                continue;
+            }
+        }
+        heap.emplace(dists[id], id + offset_id);
+        if constexpr (mode == InnerSearchMode::KNN_SEARCH) {
+            if (heap.size() > param.ef) {
+                heap.pop();
+            }
+            if (heap.size() >= param.ef) {
+                cur_heap_top = heap.top().first;
+            }
+        }
+    }
+
+    const auto* touched = computer->prune_touched_.data();
+    for (uint32_t i = 0; i < computer->prune_touched_count_; ++i) {
+        dists[touched[i]] = 0;
+    }
+    computer->prune_touched_count_ = 0;
+}
+
 void
 SparseTermDataCell::DocPrune(Vector<std::pair<uint32_t, float>>& sorted_base) const {
     // use this function when inserting
@@ -159,6 +503,10 @@ SparseTermDataCell::DocPrune(Vector<std::pair<uint32_t, float>>& sorted_base) co
 
 void
 SparseTermDataCell::InsertVector(const SparseVector& sparse_base, uint32_t base_id) {
+    if (compressed_) {
+        throw std::runtime_error("can not insert a vector into a compressed term list");
+    }
+
     // resize term
     uint32_t max_term_id = 0;
     for (auto i = 0; i < sparse_base.len_; i++) {
@@ -186,9 +534,88 @@ SparseTermDataCell::InsertVector(const SparseVector& sparse_base, uint32_t base_
         term_ids_[term].push_back(base_id);
         term_datas_[term].push_back(val);
         term_sizes_[term] += 1;
+        update_block_max(term, val);
     }
 }
 
+void
+SparseTermDataCell::InsertVectors(const SparseVector* sparse_bases,
+                                  uint32_t count,
+                                  uint32_t first_base_id) {
+    if (compressed_) {
+        throw std::runtime_error("can not insert vectors into a compressed term list");
+    }
+
+    // sort and prune every vector first, nothing is inserted if one of them is invalid
+    Vector<std::pair<uint32_t, float>> postings(allocator_);
+    Vector<uint64_t> offsets(count + 1, 0, allocator_);
+    Vector<std::pair<uint32_t, float>> sorted_base(allocator_);
+    uint32_t max_term_id = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        sorted_base.clear();
+        sort_sparse_vector(sparse_bases[i], sorted_base);
+        DocPrune(sorted_base);
+        for (auto& item : sorted_base) {
+            max_term_id = std::max(max_term_id, item.first);
+        }
+        postings.insert(postings.end(), sorted_base.begin(), sorted_base.end());
+        offsets[i + 1] = postings.size();
+    }
+    if (max_term_id > term_id_limit_) {
+        throw std::runtime_error(
+            fmt::format("max term id of sparse vectors {} is greater than term id limit {}",
+                        max_term_id,
+                        term_id_limit_));
+    }
+    ResizeTermList(max_term_id + 1);
+
+    // counting sort: every posting list grows once to its final size
+    Vector<uint32_t> term_counts(term_capacity_, 0, allocator_);
+    for (const auto& item : postings) {
+        term_counts[item.first]++;
+    }
+    for (uint32_t term = 0; term < term_capacity_; ++term) {
+        if (term_counts[term] != 0) {
+            term_ids_[term].reserve(term_sizes_[term] + term_counts[term]);
+            term_datas_[term].reserve(term_sizes_[term] + term_counts[term]);
+        }
+    }
+
+    // append in base id order, so that every posting list stays sorted by id
+    for (uint32_t i = 0; i < count; ++i) {
+        for (auto pos = offsets[i]; pos < offsets[i + 1]; ++pos) {
+            auto term = postings[pos].first;
+            auto val = postings[pos].second;
+            term_ids_[term].push_back(first_base_id + i);
+            term_datas_[term].push_back(val);
+            term_sizes_[term] += 1;
+            update_block_max(term, val);
+        }
+    }
+}
+
+void
+SparseTermDataCell::update_block_max(uint32_t term, float val) {
+    auto& block_maxs = term_block_maxs_[term];
+    auto block_id = (term_sizes_[term] - 1) / TERM_BLOCK_SIZE;
+    if (block_id >= block_maxs.size()) {
+        block_maxs.push_back(std::abs(val));
+    } else {
+        block_maxs[block_id] = std::max(block_maxs[block_id], std::abs(val));
+    }
+}
+
+float
+SparseTermDataCell::term_bound(uint32_t term, uint32_t retained_count) const {
+    const auto& block_maxs = term_block_maxs_[term];
+    auto block_count = (retained_count + TERM_BLOCK_SIZE - 1) / TERM_BLOCK_SIZE;
+    float bound = 0.0F;
+    for (uint32_t i = 0; i < block_count; ++i) {
+        bound = std::max(bound, block_maxs[i]);
+    }
+    return bound;
+}
+
 void
 SparseTermDataCell::ResizeTermList(InnerIdType new_term_capacity) {
     if (new_term_capacity <= term_capacity_) {
@@ -198,17 +625,98 @@ SparseTermDataCell::ResizeTermList(InnerIdType new_term_capacity) {
     Vector<Vector<uint32_t>> new_ids(new_term_capacity, Vector<uint32_t>(allocator_), allocator_);
     Vector<Vector<float>> new_datas(new_term_capacity, Vector<float>(allocator_), allocator_);
     Vector<uint32_t> new_sizes(new_term_capacity, 0, allocator_);
+    Vector<Vector<float>> new_block_maxs(
+        new_term_capacity, Vector<float>(allocator_), allocator_);
 
     std::move(term_ids_.begin(), term_ids_.end(), new_ids.begin());
     std::move(term_datas_.begin(), term_datas_.end(), new_datas.begin());
     std::copy(term_sizes_.begin(), term_sizes_.end(), new_sizes.begin());
+    std::move(term_block_maxs_.begin(), term_block_maxs_.end(), new_block_maxs.begin());
 
     term_ids_.swap(new_ids);
     term_datas_.swap(new_datas);
     term_sizes_.swap(new_sizes);
+    term_block_maxs_.swap(new_block_maxs);
     term_capacity_ = new_term_capacity;
 }
 
+void
+SparseTermDataCell::rebuild_block_maxs() {
+    for (auto term = 0; term < term_capacity_; term++) {
+        auto& block_maxs = term_block_maxs_[term];
+        block_maxs.assign((term_sizes_[term] + TERM_BLOCK_SIZE - 1) / TERM_BLOCK_SIZE, 0.0F);
+        uint32_t i = 0;
+        for_each_posting(term, term_sizes_[term], [&](uint32_t /*id*/, float val) {
+            auto& block_max = block_maxs[i++ / TERM_BLOCK_SIZE];
+            block_max = std::max(block_max, std::abs(val));
+        });
+    }
+}
+
+void
+SparseTermDataCell::rebuild_block_skips() {
+    term_block_skips_.assign(term_capacity_, Vector<uint32_t>(allocator_));
+    for (uint32_t term = 0; term < term_capacity_; ++term) {
+        auto& skips = term_block_skips_[term];
+        skips.resize(2 * ((term_sizes_[term] + TERM_BLOCK_SIZE - 1) / TERM_BLOCK_SIZE));
+        const auto* stream = term_id_stream(term);
+        SparsePostingIdDecoder decoder(stream);
+        uint32_t id = 0;
+        for (uint32_t i = 0; i < term_sizes_[term]; ++i) {
+            if (i % TERM_BLOCK_SIZE == 0) {
+                skips[2 * (i / TERM_BLOCK_SIZE)] = id;
+                skips[2 * (i / TERM_BLOCK_SIZE) + 1] =
+                    static_cast<uint32_t>(decoder.Position() - stream);
+            }
+            id = decoder.Next();
+        }
+    }
+}
+
+void
+SparseTermDataCell::Compress() {
+    if (compressed_) {
+        return;
+    }
+
+    // layout of a term: codes padded to an even length, then the delta-encoded ids
+    term_offsets_.assign(term_capacity_ + 1, 0);
+    uint64_t arena_size = 0;
+    for (uint32_t term = 0; term < term_capacity_; ++term) {
+        term_offsets_[term] = arena_size;
+        arena_size += (term_sizes_[term] + 1) & ~1U;
+        arena_size += sizeof(uint16_t) *
+                      SparsePostingCodec::IdStreamLength(term_ids_[term].data(), term_sizes_[term]);
+    }
+    term_offsets_[term_capacity_] = arena_size;
+
+    posting_arena_.resize(arena_size);
+    term_mins_.assign(term_capacity_, 0.0F);
+    term_scales_.assign(term_capacity_, 0.0F);
+    for (uint32_t term = 0; term < term_capacity_; ++term) {
+        auto* codes = posting_arena_.data() + term_offsets_[term];
+        SparsePostingCodec::EncodeWeights(term_datas_[term].data(),
+                                          term_sizes_[term],
+                                          codes,
+                                          term_mins_[term],
+                                          term_scales_[term]);
+        SparsePostingCodec::EncodeIds(
+            term_ids_[term].data(),
+            term_sizes_[term],
+            reinterpret_cast<uint16_t*>(codes + ((term_sizes_[term] + 1) & ~1U)));
+    }
+
+    // keep one empty list per term so that the term capacity checks still hold
+    Vector<Vector<uint32_t>>(term_capacity_, Vector<uint32_t>(allocator_), allocator_)
+        .swap(term_ids_);
+    Vector<Vector<float>>(term_capacity_, Vector<float>(allocator_), allocator_).swap(term_datas_);
+    compressed_ = true;
+
+    // a quantized weight may round above the raw maximum of its block
+    rebuild_block_maxs();
+    rebuild_block_skips();
+}
+
 float
 SparseTermDataCell::CalcDistanceByInnerId(const SparseTermComputerPtr& computer, uint32_t base_id) {
     float ip = 0;
@@ -221,12 +729,20 @@ SparseTermDataCell::CalcDistanceByInnerId(const SparseTermComputerPtr& computer,
             if (next_term >= term_ids_.size()) {
                 continue;
             }
-            __builtin_prefetch(term_ids_[next_term].data(), 0, 3);
-            __builtin_prefetch(term_datas_[next_term].data(), 0, 3);
+            prefetch_term(next_term);
         }
         if (term >= term_ids_.size()) {
             continue;
         }
+        if (compressed_) {
+            float query_val = computer->sorted_query_[it].second;
+            for_each_posting(term, term_sizes_[term], [&](uint32_t id, float val) {
+                if (id == base_id) {
+                    ip += query_val * val;
+                }
+            });
+            continue;
+        }
         computer->ScanForCalculateDist(
             it, term_ids_[term].data(), term_datas_[term].data(), term_sizes_[term], base_id, &ip);
     }
@@ -240,12 +756,12 @@ SparseTermDataCell::GetSparseVector(uint32_t base_id, SparseVector* data) {
     Vector<float> vals(allocator_);
 
     for (auto term = 0; term < term_ids_.size(); term++) {
-        for (auto i = 0; i < term_sizes_[term]; i++) {
-            if (term_ids_[term][i] == base_id) {
+        for_each_posting(term, term_sizes_[term], [&](uint32_t id, float val) {
+            if (id == base_id) {
                 ids.push_back(term);
-                vals.push_back(term_datas_[term][i]);
+                vals.push_back(val);
             }
-        }
+        });
     }
 
     data->len_ = ids.size();
@@ -264,6 +780,16 @@ SparseTermDataCell::Serialize(StreamWriter& writer) const {
         StreamWriter::WriteVector(writer, term_datas_[i]);
     }
     StreamWriter::WriteVector(writer, term_sizes_);
+
+    if (use_compression_) {
+        StreamWriter::WriteObj(writer, compressed_);
+        if (compressed_) {
+            StreamWriter::WriteVector(writer, posting_arena_);
+            StreamWriter::WriteVector(writer, term_offsets_);
+            StreamWriter::WriteVector(writer, term_mins_);
+            StreamWriter::WriteVector(writer, term_scales_);
+        }
+    }
 }
 
 void
@@ -276,6 +802,22 @@ SparseTermDataCell::Deserialize(StreamReader& reader) {
         StreamReader::ReadVector(reader, term_datas_[i]);
     }
     StreamReader::ReadVector(reader, term_sizes_);
+
+    if (use_compression_) {
+        StreamReader::ReadObj(reader, compressed_);
+        if (compressed_) {
+            StreamReader::ReadVector(reader, posting_arena_);
+            StreamReader::ReadVector(reader, term_offsets_);
+            StreamReader::ReadVector(reader, term_mins_);
+            StreamReader::ReadVector(reader, term_scales_);
+        }
+    }
+
+    // the block maxima and skips are not serialized, they are cheap to derive from the lists
+    rebuild_block_maxs();
+    if (compressed_) {
+        rebuild_block_skips();
+    }
 }
 
 template void
@@ -310,4 +852,36 @@ SparseTermDataCell::InsertHeap<InnerSearchMode::RANGE_SEARCH, InnerSearchType::W
     const InnerSearchParam& param,
     uint32_t offset_id) const;
 
+template void
+SparseTermDataCell::InsertCandidates<InnerSearchMode::KNN_SEARCH, InnerSearchType::PURE>(
+    float* dists,
+    const SparseTermComputerPtr& computer,
+    MaxHeap& heap,
+    const InnerSearchParam& param,
+    uint32_t offset_id) const;
+
+template void
+SparseTermDataCell::InsertCandidates<InnerSearchMode::KNN_SEARCH, InnerSearchType::WITH_FILTER>(
+    float* dists,
+    const SparseTermComputerPtr& computer,
+    MaxHeap& heap,
+    const InnerSearchParam& param,
+    uint32_t offset_id) const;
+
+template void
+SparseTermDataCell::InsertCandidates<InnerSearchMode::RANGE_SEARCH, InnerSearchType::PURE>(
+    float* dists,
+    const SparseTermComputerPtr& computer,
+    MaxHeap& heap,
+    const InnerSearchParam& param,
+    uint32_t offset_id) const;
+
+template void
+SparseTermDataCell::InsertCandidates<InnerSearchMode::RANGE_SEARCH, InnerSearchType::WITH_FILTER>(
+    float* dists,
+    const SparseTermComputerPtr& computer,
+    MaxHeap& heap,
+    const InnerSearchParam& param,
+    uint32_t offset_id) const;
+
 }  // namespace vsag
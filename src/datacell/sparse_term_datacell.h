@@ -27,20 +27,62 @@ namespace vsag {
 DEFINE_POINTER(SparseTermDataCell);
 class SparseTermDataCell {
 public:
+    // postings per block whose max weight is kept for pruning
+    static constexpr uint32_t TERM_BLOCK_SIZE = 64;
+
+    // a posting list is probed for the pruning candidates when it is this many times longer
+    static constexpr uint64_t PROBE_RATIO = 8;
+
     SparseTermDataCell() = default;
 
-    SparseTermDataCell(float doc_retain_ratio, uint32_t term_id_limit, Allocator* allocator)
+    SparseTermDataCell(float doc_retain_ratio,
+                       uint32_t term_id_limit,
+                       Allocator* allocator,
+                       bool use_compression = false)
         : doc_retain_ratio_(doc_retain_ratio),
           term_id_limit_(term_id_limit),
           allocator_(allocator),
+          use_compression_(use_compression),
           term_ids_(0, Vector<uint32_t>(allocator), allocator),
           term_datas_(0, Vector<float>(allocator), allocator),
-          term_sizes_(allocator) {
+          term_sizes_(allocator),
+          term_block_maxs_(0, Vector<float>(allocator), allocator),
+          term_block_skips_(allocator),
+          posting_arena_(allocator),
+          term_offsets_(allocator),
+          term_mins_(allocator),
+          term_scales_(allocator) {
     }
 
     void
     Query(float* global_dists, const SparseTermComputerPtr& computer) const;
 
+    /**
+     * @brief Query that only accumulates the documents whose byte in window_mask is set.
+     */
+    void
+    Query(float* global_dists,
+          const SparseTermComputerPtr& computer,
+          const uint8_t* window_mask) const;
+
+    /**
+     * @brief Query with MaxScore pruning against the current candidate threshold.
+     *
+     * threshold is a distance (minus the inner product) that a document must not exceed to
+     * enter the heap. The query terms with the smallest block max bounds, which together
+     * cannot lift a document below threshold, are non-essential: their posting lists are
+     * only probed for the documents the essential terms accumulated and that can still make
+     * it. The documents left are summed again in query order, so they get exactly the
+     * distance of Query. The scratch of the computer holds the result for InsertCandidates.
+     *
+     * @param global_dists accumulator of the window, all zero on entry.
+     * @return false if no term can be pruned, nothing is accumulated then.
+     */
+    bool
+    QueryWithPruning(float* global_dists,
+                     const SparseTermComputerPtr& computer,
+                     float threshold) const;
+
     template <InnerSearchMode mode = InnerSearchMode::KNN_SEARCH,
               InnerSearchType type = InnerSearchType::PURE>
     void
@@ -50,15 +92,46 @@ public:
                const InnerSearchParam& param,
                uint32_t offset_id) const;
 
+    /**
+     * @brief InsertHeap for the candidates left by QueryWithPruning, clears the accumulator.
+     */
+    template <InnerSearchMode mode = InnerSearchMode::KNN_SEARCH,
+              InnerSearchType type = InnerSearchType::PURE>
+    void
+    InsertCandidates(float* dists,
+                     const SparseTermComputerPtr& computer,
+                     MaxHeap& heap,
+                     const InnerSearchParam& param,
+                     uint32_t offset_id) const;
+
     void
     DocPrune(Vector<std::pair<uint32_t, float>>& sorted_base) const;
 
     void
     InsertVector(const SparseVector& sparse_base, uint32_t base_id);
 
+    /**
+     * @brief Insert count vectors with the consecutive base ids from first_base_id on.
+     *
+     * The postings of the whole batch are bucketed by term before they are appended, so
+     * each posting list is reallocated at most once per batch.
+     */
+    void
+    InsertVectors(const SparseVector* sparse_bases, uint32_t count, uint32_t first_base_id);
+
     void
     ResizeTermList(InnerIdType new_term_capacity);
 
+    /**
+     * @brief Re-encode all posting lists into one arena and release the raw lists.
+     *
+     * Each posting list becomes 8-bit quantized weights followed by its delta-encoded ids,
+     * see SparsePostingCodec. Called once the window is full: no vector can be inserted
+     * afterwards.
+     */
+    void
+    Compress();
+
     void
     Serialize(StreamWriter& writer) const;
 
@@ -71,6 +144,107 @@ public:
     void
     GetSparseVector(uint32_t base_id, SparseVector* data);
 
+private:
+    void
+    update_block_max(uint32_t term, float val);
+
+    float
+    term_bound(uint32_t term, uint32_t retained_count) const;
+
+    void
+    rebuild_block_maxs();
+
+    void
+    rebuild_block_skips();
+
+    uint32_t
+    retained_count(uint32_t term, const SparseTermComputerPtr& computer) const {
+        return static_cast<uint32_t>(static_cast<float>(term_sizes_[term]) *
+                                     computer->term_retain_ratio_);
+    }
+
+    uint32_t
+    scan_term_and_collect(uint32_t term_iterator,
+                          uint32_t term,
+                          uint32_t count,
+                          const SparseTermComputerPtr& computer,
+                          float* global_dists,
+                          uint32_t* touched,
+                          uint32_t touched_count) const;
+
+    void
+    gate_scan_term(uint32_t term_iterator,
+                   uint32_t term,
+                   uint32_t count,
+                   const SparseTermComputerPtr& computer,
+                   float* global_dists) const;
+
+    static void
+    sort_candidates(Vector<uint32_t>& candidates);
+
+    /**
+     * @brief Add the products of the term to the sorted documents ids found in its postings.
+     *
+     * The blocks of postings that hold none of ids are skipped by their last id, a compressed
+     * block is only decoded once a document falls into it.
+     */
+    void
+    probe_term(uint32_t term_iterator,
+               uint32_t term,
+               uint32_t count,
+               const SparseTermComputerPtr& computer,
+               const uint32_t* ids,
+               uint64_t id_count,
+               float* global_dists) const;
+
+    void
+    scan_term(uint32_t term_iterator,
+              uint32_t term,
+              uint32_t count,
+              const SparseTermComputerPtr& computer,
+              float* global_dists) const;
+
+    void
+    prefetch_term(uint32_t term) const;
+
+    const uint8_t*
+    term_codes(uint32_t term) const {
+        return posting_arena_.data() + term_offsets_[term];
+    }
+
+    const uint16_t*
+    term_id_stream(uint32_t term) const {
+        // the codes are padded to an even length to keep the id stream aligned
+        return reinterpret_cast<const uint16_t*>(term_codes(term) +
+                                                 ((term_sizes_[term] + 1) & ~1U));
+    }
+
+    bool
+    term_has_escape(uint32_t term) const {
+        // every escaped delta takes two more slots in the id stream
+        auto codes_size = (term_sizes_[term] + 1) & ~1U;
+        auto stream_size = term_offsets_[term + 1] - term_offsets_[term] - codes_size;
+        return stream_size != sizeof(uint16_t) * term_sizes_[term];
+    }
+
+    template <typename Func>
+    void
+    for_each_posting(uint32_t term, uint32_t count, Func&& func) const {
+        if (not compressed_) {
+            for (uint32_t i = 0; i < count; ++i) {
+                func(term_ids_[term][i], term_datas_[term][i]);
+            }
+            return;
+        }
+        const auto* codes = term_codes(term);
+        float min = term_mins_[term];
+        float scale = term_scales_[term];
+        SparsePostingIdDecoder decoder(term_id_stream(term));
+        for (uint32_t i = 0; i < count; ++i) {
+            func(decoder.Next(), min + scale * static_cast<float>(codes[i]));
+        }
+    }
+
 public:
     uint32_t term_id_limit_{0};
 
@@ -84,6 +258,26 @@ public:
 
     Vector<uint32_t> term_sizes_;
 
+    // max |weight| of every TERM_BLOCK_SIZE postings, rebuilt on deserialize
+    Vector<Vector<float>> term_block_maxs_;
+
+    // per block of a compressed list: the id before the block and its offset in the id
+    // stream, rebuilt on deserialize
+    Vector<Vector<uint32_t>> term_block_skips_;
+
+    // compressed posting lists, only filled after Compress()
+    bool use_compression_{false};
+
+    bool compressed_{false};
+
+    Vector<uint8_t> posting_arena_;
+
+    Vector<uint64_t> term_offsets_;
+
+    Vector<float> term_mins_;
+
+    Vector<float> term_scales_;
+
     Allocator* const allocator_{nullptr};
 };
 }  // namespace vsag
@@ -17,6 +17,9 @@
 
 #include <catch2/catch_template_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
+#include <random>
+#include <sstream>
+#include <set>
 
 #include "impl/allocator/safe_allocator.h"
 
@@ -199,3 +202,266 @@ TEST_CASE("SparseTermDatacell Last Term Test", "[ut][SparseTermDatacell]") {
         REQUIRE(std::abs(dists[1] - (-0.1f)) < 1e-3f);
     }
 }
+
+TEST_CASE("SparseTermDatacell Query With Pruning Test", "[ut][SparseTermDatacell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint32_t doc_count = 5000;
+    uint32_t doc_len = 30;
+    uint32_t vocab_size = 500;
+    std::mt19937 rng(47);
+    std::uniform_int_distribution<uint32_t> term_dist(0, vocab_size - 1);
+    std::uniform_real_distribution<float> val_dist(0.1F, 1.0F);
+
+    auto make_sv = [&](uint32_t len, std::vector<uint32_t>& ids, std::vector<float>& vals) {
+        std::set<uint32_t> terms;
+        while (terms.size() < len) {
+            terms.insert(term_dist(rng));
+        }
+        ids.assign(terms.begin(), terms.end());
+        vals.resize(len);
+        for (auto& val : vals) {
+            val = val_dist(rng);
+        }
+        SparseVector sv;
+        sv.len_ = len;
+        sv.ids_ = ids.data();
+        sv.vals_ = vals.data();
+        return sv;
+    };
+
+    // a compressed list is probed through its block skips
+    auto use_compression = GENERATE(false, true);
+    auto data_cell = std::make_shared<SparseTermDataCell>(
+        1.0F, DEFAULT_TERM_ID_LIMIT, allocator.get(), use_compression);
+    std::vector<uint32_t> doc_ids;
+    std::vector<float> doc_vals;
+    for (uint32_t i = 0; i < doc_count; ++i) {
+        data_cell->InsertVector(make_sv(doc_len, doc_ids, doc_vals), i);
+    }
+    if (use_compression) {
+        data_cell->Compress();
+    }
+
+    std::vector<uint32_t> query_ids;
+    std::vector<float> query_vals;
+    auto query = make_sv(50, query_ids, query_vals);
+    SINDISearchParameter search_params;
+    search_params.use_term_pruning = true;
+    auto computer = std::make_shared<SparseTermComputer>(query, search_params, allocator.get());
+    REQUIRE(computer->use_term_pruning_);
+
+    // exact distances and the threshold of the best ef documents
+    InnerSearchParam inner_param;
+    inner_param.ef = 10;
+    std::vector<float> exact_dists(doc_count, 0);
+    data_cell->Query(exact_dists.data(), computer);
+    std::vector<float> sorted_dists(exact_dists);
+    std::sort(sorted_dists.begin(), sorted_dists.end());
+    float threshold = sorted_dists[inner_param.ef - 1];
+
+    // the candidates are exactly the documents within threshold, with the same distances
+    std::vector<float> dists(doc_count, 0);
+    REQUIRE(data_cell->QueryWithPruning(dists.data(), computer, threshold));
+    std::set<uint32_t> candidates(computer->prune_candidates_.begin(),
+                                  computer->prune_candidates_.end());
+    for (uint32_t i = 0; i < doc_count; ++i) {
+        if (exact_dists[i] <= threshold) {
+            REQUIRE(candidates.count(i) == 1);
+            REQUIRE(dists[i] == exact_dists[i]);
+        }
+    }
+
+    // the heap keeps the same candidates and the accumulator is cleared
+    MaxHeap heap(allocator.get());
+    for (uint32_t i = 0; i < doc_count and heap.size() < inner_param.ef; ++i) {
+        heap.emplace(std::numeric_limits<float>::max(), doc_count + i);
+    }
+    data_cell->InsertCandidates<KNN_SEARCH, PURE>(dists.data(), computer, heap, inner_param, 0);
+    REQUIRE(heap.size() == inner_param.ef);
+    while (not heap.empty()) {
+        REQUIRE(exact_dists[heap.top().second] <= threshold);
+        heap.pop();
+    }
+    for (auto dist : dists) {
+        REQUIRE(dist == 0);
+    }
+}
+
+TEST_CASE("SparseTermDatacell Compress Test", "[ut][SparseTermDatacell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint32_t doc_count = 3000;
+    uint32_t doc_len = 20;
+    uint32_t vocab_size = 300;
+    std::mt19937 rng(97);
+    std::uniform_int_distribution<uint32_t> term_dist(0, vocab_size - 1);
+    std::uniform_real_distribution<float> val_dist(0.1F, 1.0F);
+
+    auto make_sv = [&](uint32_t len, std::vector<uint32_t>& ids, std::vector<float>& vals) {
+        std::set<uint32_t> terms;
+        while (terms.size() < len) {
+            terms.insert(term_dist(rng));
+        }
+        ids.assign(terms.begin(), terms.end());
+        vals.resize(len);
+        for (auto& val : vals) {
+            val = val_dist(rng);
+        }
+        SparseVector sv;
+        sv.len_ = len;
+        sv.ids_ = ids.data();
+        sv.vals_ = vals.data();
+        return sv;
+    };
+
+    // the last id is far enough from the others to need an escaped delta
+    std::vector<uint32_t> base_ids;
+    for (uint32_t i = 0; i < doc_count - 1; ++i) {
+        base_ids.push_back(i * 3);
+    }
+    base_ids.push_back(base_ids.back() + 100000);
+    uint32_t window_size = base_ids.back() + 1;
+
+    auto raw_cell =
+        std::make_shared<SparseTermDataCell>(1.0F, DEFAULT_TERM_ID_LIMIT, allocator.get(), true);
+    auto compressed_cell =
+        std::make_shared<SparseTermDataCell>(1.0F, DEFAULT_TERM_ID_LIMIT, allocator.get(), true);
+    std::vector<uint32_t> doc_ids;
+    std::vector<float> doc_vals;
+    for (auto base_id : base_ids) {
+        auto sv = make_sv(doc_len, doc_ids, doc_vals);
+        raw_cell->InsertVector(sv, base_id);
+        compressed_cell->InsertVector(sv, base_id);
+    }
+    uint64_t raw_bytes = 0;
+    for (uint32_t term = 0; term < compressed_cell->term_capacity_; ++term) {
+        raw_bytes += compressed_cell->term_sizes_[term] * (sizeof(uint32_t) + sizeof(float));
+    }
+    compressed_cell->Compress();
+    REQUIRE(compressed_cell->compressed_);
+    REQUIRE(compressed_cell->posting_arena_.size() * 2 < raw_bytes);
+    auto sv = make_sv(doc_len, doc_ids, doc_vals);
+    REQUIRE_THROWS(compressed_cell->InsertVector(sv, window_size));
+
+    std::vector<uint32_t> query_ids;
+    std::vector<float> query_vals;
+    auto query = make_sv(30, query_ids, query_vals);
+    SINDISearchParameter search_params;
+    auto computer = std::make_shared<SparseTermComputer>(query, search_params, allocator.get());
+
+    // the quantized weights are close to the raw ones
+    std::vector<float> raw_dists(window_size, 0);
+    std::vector<float> dists(window_size, 0);
+    raw_cell->Query(raw_dists.data(), computer);
+    compressed_cell->Query(dists.data(), computer);
+    for (auto base_id : base_ids) {
+        REQUIRE(std::abs(dists[base_id] - raw_dists[base_id]) < 2e-2);
+        REQUIRE(std::abs(compressed_cell->CalcDistanceByInnerId(computer, base_id) - 1 -
+                         dists[base_id]) < 1e-4);
+    }
+
+    SparseVector raw_sv;
+    SparseVector compressed_sv;
+    raw_cell->GetSparseVector(base_ids.back(), &raw_sv);
+    compressed_cell->GetSparseVector(base_ids.back(), &compressed_sv);
+    REQUIRE(raw_sv.len_ == compressed_sv.len_);
+    for (uint32_t i = 0; i < raw_sv.len_; ++i) {
+        REQUIRE(raw_sv.ids_[i] == compressed_sv.ids_[i]);
+        REQUIRE(std::abs(raw_sv.vals_[i] - compressed_sv.vals_[i]) < 2e-3);
+    }
+    allocator->Deallocate(raw_sv.ids_);
+    allocator->Deallocate(raw_sv.vals_);
+    allocator->Deallocate(compressed_sv.ids_);
+    allocator->Deallocate(compressed_sv.vals_);
+
+    // the heap gets the accumulated distances and the accumulator is cleared
+    InnerSearchParam inner_param;
+    inner_param.ef = 10;
+    MaxHeap heap(allocator.get());
+    std::fill(dists.begin(), dists.end(), 0);
+    compressed_cell->Query(dists.data(), computer);
+    auto expected = dists;
+    compressed_cell->InsertHeap<KNN_SEARCH, PURE>(dists.data(), computer, heap, inner_param, 0);
+    REQUIRE(heap.size() == inner_param.ef);
+    std::vector<float> sorted_dists(expected);
+    std::sort(sorted_dists.begin(), sorted_dists.end());
+    while (not heap.empty()) {
+        REQUIRE(heap.top().first == expected[heap.top().second]);
+        REQUIRE(heap.top().first <= sorted_dists[inner_param.ef - 1]);
+        heap.pop();
+    }
+    for (auto dist : dists) {
+        REQUIRE(dist == 0);
+    }
+
+    // the compressed lists survive serialization
+    std::stringstream ss;
+    IOStreamWriter writer(ss);
+    compressed_cell->Serialize(writer);
+    auto loaded_cell =
+        std::make_shared<SparseTermDataCell>(1.0F, DEFAULT_TERM_ID_LIMIT, allocator.get(), true);
+    IOStreamReader reader(ss);
+    loaded_cell->Deserialize(reader);
+    REQUIRE(loaded_cell->compressed_);
+    std::vector<float> loaded_dists(window_size, 0);
+    loaded_cell->Query(loaded_dists.data(), computer);
+    REQUIRE(loaded_dists == expected);
+}
+
+TEST_CASE("SparseTermDatacell Insert Vectors Test", "[ut][SparseTermDatacell]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint32_t doc_count = 500;
+    uint32_t doc_len = 20;
+    uint32_t vocab_size = 200;
+    std::mt19937 rng(31);
+    std::uniform_int_distribution<uint32_t> term_dist(0, vocab_size - 1);
+    std::uniform_real_distribution<float> val_dist(0.1F, 1.0F);
+
+    std::vector<std::vector<uint32_t>> doc_ids(doc_count);
+    std::vector<std::vector<float>> doc_vals(doc_count);
+    std::vector<SparseVector> sparse_vectors(doc_count);
+    for (uint32_t i = 0; i < doc_count; ++i) {
+        std::set<uint32_t> terms;
+        while (terms.size() < doc_len) {
+            terms.insert(term_dist(rng));
+        }
+        doc_ids[i].assign(terms.begin(), terms.end());
+        for (uint32_t d = 0; d < doc_len; ++d) {
+            doc_vals[i].push_back(val_dist(rng));
+        }
+        sparse_vectors[i].len_ = doc_len;
+        sparse_vectors[i].ids_ = doc_ids[i].data();
+        sparse_vectors[i].vals_ = doc_vals[i].data();
+    }
+
+    // one by one and in two batches give the same posting lists
+    float doc_retain_ratio = 0.8F;
+    auto single_cell = std::make_shared<SparseTermDataCell>(
+        doc_retain_ratio, DEFAULT_TERM_ID_LIMIT, allocator.get());
+    auto batch_cell = std::make_shared<SparseTermDataCell>(
+        doc_retain_ratio, DEFAULT_TERM_ID_LIMIT, allocator.get());
+    for (uint32_t i = 0; i < doc_count; ++i) {
+        single_cell->InsertVector(sparse_vectors[i], i);
+    }
+    uint32_t half = doc_count / 2;
+    batch_cell->InsertVectors(sparse_vectors.data(), half, 0);
+    batch_cell->InsertVectors(sparse_vectors.data() + half, doc_count - half, half);
+
+    REQUIRE(batch_cell->term_capacity_ == single_cell->term_capacity_);
+    for (uint32_t term = 0; term < single_cell->term_capacity_; ++term) {
+        REQUIRE(batch_cell->term_sizes_[term] == single_cell->term_sizes_[term]);
+        REQUIRE(batch_cell->term_ids_[term] == single_cell->term_ids_[term]);
+        REQUIRE(batch_cell->term_datas_[term] == single_cell->term_datas_[term]);
+        REQUIRE(batch_cell->term_block_maxs_[term] == single_cell->term_block_maxs_[term]);
+    }
+
+    // an invalid vector rejects the whole batch
+    std::vector<uint32_t> invalid_ids = {DEFAULT_TERM_ID_LIMIT + 1};
+    std::vector<float> invalid_vals = {1.0F};
+    SparseVector invalid_sv;
+    invalid_sv.len_ = 1;
+    invalid_sv.ids_ = invalid_ids.data();
+    invalid_sv.vals_ = invalid_vals.data();
+    std::vector<SparseVector> invalid_batch = {sparse_vectors[0], invalid_sv};
+    REQUIRE_THROWS(batch_cell->InsertVectors(invalid_batch.data(), 2, doc_count));
+    REQUIRE(batch_cell->term_sizes_ == single_cell->term_sizes_);
+}
@@ -18,18 +18,36 @@
 #include <cblas.h>
 #include <omp.h>
 
+#include <numeric>
 #include <random>
 
 #include "algorithm/inner_index_interface.h"
 #include "diskann_logger.h"
 #include "impl/allocator/safe_allocator.h"
+#include "impl/logger/logger.h"
 #include "simd/fp32_simd.h"
-#include "utils/byte_buffer.h"
+#include "utils/timer.h"
 #include "utils/util_functions.h"
 
 namespace vsag {
+
+template <typename Func>
+static void
+parallel_for_blocks(const SafeThreadPoolPtr& thread_pool, uint64_t total, Func&& func) {
+    constexpr uint64_t bs = 1024;
+    std::vector<std::future<void>> futures;
+    for (uint64_t i = 0; i < total; i += bs) {
+        futures.emplace_back(thread_pool->GeneralEnqueue(func, i, std::min(i + bs, total)));
+    }
+    for (auto& future : futures) {
+        future.wait();
+    }
+}
+
 KMeansCluster::KMeansCluster(int32_t dim, Allocator* allocator, SafeThreadPoolPtr thread_pool)
-    : dim_(dim), allocator_(allocator), thread_pool_(std::move(thread_pool)) {
+    : dim_(dim),
+      allocator_(allocator),
+      thread_pool_(std::move(thread_pool)) {
     if (thread_pool_ == nullptr) {
         this->thread_pool_ = SafeThreadPool::FactoryDefaultThreadPool();
     }
@@ -50,6 +68,8 @@ KMeansCluster::Run(uint32_t k,
                    double* err,
                    bool use_mse_for_convergence,
                    float threshold) {
+    statistics_ = KMeansStatistics();
+    Timer total_timer(statistics_.total_time_ms);
     if (k_centroids_ != nullptr) {
         allocator_->Deallocate(k_centroids_);
         k_centroids_ = nullptr;
@@ -59,108 +79,355 @@ KMeansCluster::Run(uint32_t k,
 
     std::random_device rd;
     std::mt19937 gen(rd());
-    std::uniform_int_distribution<uint64_t> dis(0, count - 1);
-    for (int i = 0; i < k; ++i) {
-        auto index = dis(gen);
-        for (int j = 0; j < dim_; ++j) {
-            k_centroids_[i * dim_ + j] = datas[index * dim_ + j];
-        }
+    {
+        Timer timer(statistics_.init_time_ms);
+        this->init_centroids(k, datas, count, gen);
     }
 
-    double total_err = std::numeric_limits<double>::max();
-    double last_err = std::numeric_limits<double>::max();
-    Vector<int32_t> labels(count, -1, this->allocator_);
-    std::vector<std::mutex> mutexes(k);
-    std::vector<std::future<void>> futures;
-    ByteBuffer y_sqr_buffer(static_cast<uint64_t>(k) * sizeof(float), allocator_);
-    ByteBuffer distances_buffer(static_cast<uint64_t>(k) * QUERY_BS * sizeof(float), allocator_);
-    auto* y_sqr = reinterpret_cast<float*>(y_sqr_buffer.data);
-    auto* distances = reinterpret_cast<float*>(distances_buffer.data);
-
-    logger::trace("KMeansCluster::Run k: {}, count: {}, iter: {}", k, count, iter);
+    logger::trace("KMeansCluster::Run k: {}, count: {}, iter: {}, mini batch: {}",
+                  k,
+                  count,
+                  iter,
+                  mini_batch_size_);
     if (k < THRESHOLD_FOR_HGRAPH) {
         logger::trace("KMeansCluster::Run use blas");
     } else {
         logger::trace("KMeansCluster::Run use hgraph");
     }
 
+    Vector<int32_t> labels(count, -1, this->allocator_);
+    double total_err = 0.0;
+    if (mini_batch_size_ > 0 and mini_batch_size_ < count) {
+        total_err = this->run_mini_batch(
+            k, datas, count, iter, use_mse_for_convergence, threshold, labels, gen);
+    } else {
+        total_err = this->run_lloyd(
+            k, datas, count, iter, use_mse_for_convergence, threshold, labels, gen);
+    }
+
+    Vector<uint64_t> sizes(k, 0, allocator_);
+    for (uint64_t i = 0; i < count; ++i) {
+        sizes[labels[i]]++;
+    }
+    auto [min_size, max_size] = std::minmax_element(sizes.begin(), sizes.end());
+    statistics_.min_cluster_size = *min_size;
+    statistics_.max_cluster_size = *max_size;
+    statistics_.final_error = total_err;
+    statistics_.total_time_ms = total_timer.Record();
+    logger::debug(
+        "KMeansCluster::Run k: {}, count: {}, iterations: {}, converged: {}, error: {}, "
+        "cluster size: [{}, {}], time(ms): init {:.1f}, assign {:.1f}, update {:.1f}, total {:.1f}",
+        k,
+        count,
+        statistics_.iterations,
+        statistics_.converged,
+        statistics_.final_error,
+        statistics_.min_cluster_size,
+        statistics_.max_cluster_size,
+        statistics_.init_time_ms,
+        statistics_.assign_time_ms,
+        statistics_.update_time_ms,
+        statistics_.total_time_ms);
+
+    if (err != nullptr) {
+        *err = total_err;
+    }
+    return labels;
+}
+
+double
+KMeansCluster::run_lloyd(uint32_t k,
+                         const float* datas,
+                         uint64_t count,
+                         int iter,
+                         bool use_mse_for_convergence,
+                         float threshold,
+                         Vector<int32_t>& labels,
+                         std::mt19937& gen) {
+    double total_err = std::numeric_limits<double>::max();
+    double last_err = std::numeric_limits<double>::max();
+    Vector<uint64_t> sizes(k, 0, allocator_);
     for (int it = 0; it < iter; ++it) {
-        if (k < THRESHOLD_FOR_HGRAPH) {
-            total_err = this->find_nearest_one_with_blas(datas, count, k, y_sqr, distances, labels);
-        } else {
-            total_err = this->find_nearest_one_with_hgraph(datas, count, k, labels);
+        double cost = 0.0;
+        {
+            Timer timer(cost);
+            total_err = this->assign(datas, count, k, labels);
         }
-        constexpr uint64_t bs = 1024;
+        statistics_.assign_time_ms += cost;
+        {
+            Timer timer(cost);
+            this->update_centroids(datas, count, k, labels, sizes, gen);
+        }
+        statistics_.update_time_ms += cost;
+        statistics_.iterations = it + 1;
 
-        Vector<int> counts(k, 0, allocator_);
-        Vector<float> new_centroids(static_cast<uint64_t>(k) * dim_, 0.0F, allocator_);
+        logger::trace("[{}] KMeansCluster::Run iter: {}/{} finished, cur loss is {}",
+                      get_current_time(),
+                      static_cast<int>(it),
+                      static_cast<int>(iter),
+                      static_cast<double>(total_err));
+        if (it > 0 && use_mse_for_convergence &&
+            std::fabs(last_err - total_err) / static_cast<double>(count) < threshold) {
+            statistics_.converged = true;
+            break;
+        }
+        last_err = total_err;
+    }
+    return total_err;
+}
 
-        auto update_centroids_func = [&](uint64_t start, uint64_t end) {
-            omp_set_num_threads(1);
-            for (uint64_t i = start; i < end; ++i) {
-                uint32_t label = labels[i];
-                {
-                    std::lock_guard<std::mutex> lock(mutexes[label]);
-                    counts[label]++;
-                    cblas_saxpy(dim_,
-                                1.0F,
-                                datas + i * dim_,
-                                1,
-                                new_centroids.data() + label * static_cast<uint64_t>(dim_),
-                                1);
-                }
-            }
-        };
-        for (uint64_t i = 0; i < count; i += bs) {
-            futures.emplace_back(
-                thread_pool_->GeneralEnqueue(update_centroids_func, i, std::min(i + bs, count)));
+double
+KMeansCluster::run_mini_batch(uint32_t k,
+                              const float* datas,
+                              uint64_t count,
+                              int iter,
+                              bool use_mse_for_convergence,
+                              float threshold,
+                              Vector<int32_t>& labels,
+                              std::mt19937& gen) {
+    auto batch_size = mini_batch_size_;
+    auto dim = static_cast<uint64_t>(dim_);
+    Vector<float> batch(batch_size * dim, 0.0F, allocator_);
+    Vector<int32_t> batch_labels(batch_size, -1, allocator_);
+    // number of samples each centroid has absorbed so far, the learning rate is 1 / sizes[c]
+    Vector<uint64_t> sizes(k, 0, allocator_);
+    Vector<uint64_t> batch_sizes(k, 0, allocator_);
+    Vector<uint64_t> offsets(k + 1, 0, allocator_);
+    Vector<uint64_t> order(batch_size, 0, allocator_);
+    std::uniform_int_distribution<uint64_t> dis(0, count - 1);
+
+    double last_err = std::numeric_limits<double>::max();
+    for (int it = 0; it < iter; ++it) {
+        for (uint64_t i = 0; i < batch_size; ++i) {
+            memcpy(batch.data() + i * dim, datas + dis(gen) * dim, dim * sizeof(float));
         }
-        for (auto& future : futures) {
-            future.wait();
+        double cost = 0.0;
+        double batch_err = 0.0;
+        {
+            Timer timer(cost);
+            batch_err = this->assign(batch.data(), batch_size, k, batch_labels);
         }
-        futures.clear();
+        statistics_.assign_time_ms += cost;
 
-        for (int j = 0; j < k; ++j) {
-            if (counts[j] > 0) {
-                cblas_sscal(dim_,
-                            1.0F / static_cast<float>(counts[j]),
-                            new_centroids.data() + j * static_cast<uint64_t>(dim_),
-                            1);
-                std::copy(new_centroids.data() + j * static_cast<uint64_t>(dim_),
-                          new_centroids.data() + (j + 1) * static_cast<uint64_t>(dim_),
-                          k_centroids_ + j * static_cast<uint64_t>(dim_));
-            } else {
-                auto index = dis(gen);
-                for (int s = 0; s < dim_; ++s) {
-                    k_centroids_[j * dim_ + s] = datas[index * dim_ + s];
-                }
+        {
+            Timer timer(cost);
+            // group the batch by label, then each centroid absorbs its samples one by one
+            std::fill(batch_sizes.begin(), batch_sizes.end(), 0);
+            for (uint64_t i = 0; i < batch_size; ++i) {
+                batch_sizes[batch_labels[i]]++;
+            }
+            offsets[0] = 0;
+            for (uint64_t j = 0; j < k; ++j) {
+                offsets[j + 1] = offsets[j] + batch_sizes[j];
+            }
+            std::fill(batch_sizes.begin(), batch_sizes.end(), 0);
+            for (uint64_t i = 0; i < batch_size; ++i) {
+                auto label = batch_labels[i];
+                order[offsets[label] + batch_sizes[label]++] = i;
             }
+            auto update_func = [&](uint64_t start, uint64_t end) {
+                for (uint64_t j = start; j < end; ++j) {
+                    auto* centroid = k_centroids_ + j * dim;
+                    for (uint64_t p = offsets[j]; p < offsets[j + 1]; ++p) {
+                        sizes[j]++;
+                        auto eta = 1.0F / static_cast<float>(sizes[j]);
+                        cblas_sscal(static_cast<blasint>(dim), 1.0F - eta, centroid, 1);
+                        cblas_saxpy(static_cast<blasint>(dim),
+                                    eta,
+                                    batch.data() + order[p] * dim,
+                                    1,
+                                    centroid,
+                                    1);
+                    }
+                }
+            };
+            parallel_for_blocks(thread_pool_, k, update_func);
         }
+        statistics_.update_time_ms += cost;
+        statistics_.iterations = it + 1;
 
-        logger::trace("[{}] KMeansCluster::Run iter: {}/{} finished, cur loss is {}",
+        logger::trace("[{}] KMeansCluster::Run mini batch iter: {}/{} finished, batch loss is {}",
                       get_current_time(),
                       static_cast<int>(it),
                       static_cast<int>(iter),
-                      static_cast<double>(total_err));
+                      batch_err);
         if (it > 0 && use_mse_for_convergence &&
-            std::fabs(last_err - total_err) / static_cast<double>(count) < threshold) {
+            std::fabs(last_err - batch_err) / static_cast<double>(batch_size) < threshold) {
+            statistics_.converged = true;
             break;
         }
+        last_err = batch_err;
+    }
 
-        last_err = total_err;
+    // centroids are final, one full assignment gives the labels of all datas
+    double cost = 0.0;
+    double total_err = 0.0;
+    {
+        Timer timer(cost);
+        total_err = this->assign(datas, count, k, labels);
     }
-    if (err != nullptr) {
-        *err = total_err;
+    statistics_.assign_time_ms += cost;
+    return total_err;
+}
+
+void
+KMeansCluster::init_centroids(uint32_t k, const float* datas, uint64_t count, std::mt19937& gen) {
+    if (init_type_ == KMeansInitType::KMEANS_PLUS_PLUS and k < THRESHOLD_FOR_HGRAPH and
+        k < count) {
+        this->init_centroids_kmeans_plus_plus(k, datas, count, gen);
+        return;
+    }
+    std::uniform_int_distribution<uint64_t> dis(0, count - 1);
+    for (uint64_t i = 0; i < k; ++i) {
+        auto index = dis(gen);
+        memcpy(k_centroids_ + i * dim_, datas + index * dim_, dim_ * sizeof(float));
+    }
+}
+
+void
+KMeansCluster::init_centroids_kmeans_plus_plus(uint32_t k,
+                                               const float* datas,
+                                               uint64_t count,
+                                               std::mt19937& gen) {
+    auto dim = static_cast<uint64_t>(dim_);
+    // 1. seed on a subset, the cost is O(seed_count * k * dim)
+    auto seed_count = std::min(count, SEED_SAMPLES_PER_CENTROID * k);
+    Vector<float> samples(allocator_);
+    const float* seeds = datas;
+    if (seed_count < count) {
+        std::uniform_int_distribution<uint64_t> dis(0, count - 1);
+        samples.resize(seed_count * dim);
+        for (uint64_t i = 0; i < seed_count; ++i) {
+            memcpy(samples.data() + i * dim, datas + dis(gen) * dim, dim * sizeof(float));
+        }
+        seeds = samples.data();
+    }
+
+    // 2. each next centroid is drawn with probability proportional to the squared distance to
+    //    the nearest chosen one
+    Vector<float> min_dists(seed_count, std::numeric_limits<float>::max(), allocator_);
+    std::uniform_int_distribution<uint64_t> first_dis(0, seed_count - 1);
+    uint64_t chosen = first_dis(gen);
+    constexpr uint64_t block_size = 4096;
+    auto block_count = (seed_count + block_size - 1) / block_size;
+    Vector<double> block_sums(block_count, 0.0, allocator_);
+    std::vector<std::future<void>> futures;
+    for (uint64_t c = 0; c < k; ++c) {
+        auto* centroid = k_centroids_ + c * dim;
+        memcpy(centroid, seeds + chosen * dim, dim * sizeof(float));
+        if (c + 1 == k) {
+            break;
+        }
+
+        auto update_func = [&](uint64_t block_id) {
+            auto start = block_id * block_size;
+            auto end = std::min(start + block_size, seed_count);
+            double sum = 0.0;
+            for (uint64_t i = start; i < end; ++i) {
+                auto dist = FP32ComputeL2Sqr(seeds + i * dim, centroid, dim);
+                min_dists[i] = std::min(min_dists[i], dist);
+                sum += min_dists[i];
+            }
+            block_sums[block_id] = sum;
+        };
+        for (uint64_t b = 0; b < block_count; ++b) {
+            futures.emplace_back(thread_pool_->GeneralEnqueue(update_func, b));
+        }
+        for (auto& future : futures) {
+            future.wait();
+        }
+        futures.clear();
+
+        double total = std::accumulate(block_sums.begin(), block_sums.end(), 0.0);
+        if (total <= 0.0) {
+            // all samples coincide with chosen centroids
+            chosen = first_dis(gen);
+            continue;
+        }
+        std::uniform_real_distribution<double> real_dis(0.0, total);
+        auto target = real_dis(gen);
+        uint64_t b = 0;
+        while (b + 1 < block_count and target >= block_sums[b]) {
+            target -= block_sums[b];
+            ++b;
+        }
+        chosen = std::min(b * block_size + block_size, seed_count) - 1;
+        for (uint64_t i = b * block_size; i < std::min(b * block_size + block_size, seed_count);
+             ++i) {
+            target -= min_dists[i];
+            if (target < 0.0) {
+                chosen = i;
+                break;
+            }
+        }
+    }
+}
+
+double
+KMeansCluster::assign(const float* query,
+                      uint64_t query_count,
+                      uint64_t k,
+                      Vector<int32_t>& labels) {
+    if (k < THRESHOLD_FOR_HGRAPH) {
+        return this->find_nearest_one_with_blas(query, query_count, k, labels);
+    }
+    return this->find_nearest_one_with_hgraph(query, query_count, k, labels);
+}
+
+void
+KMeansCluster::update_centroids(const float* datas,
+                                uint64_t count,
+                                uint64_t k,
+                                const Vector<int32_t>& labels,
+                                Vector<uint64_t>& sizes,
+                                std::mt19937& gen) {
+    auto dim = static_cast<uint64_t>(dim_);
+    // group datas by label, so that each centroid is summed by exactly one task without locks
+    std::fill(sizes.begin(), sizes.end(), 0);
+    for (uint64_t i = 0; i < count; ++i) {
+        sizes[labels[i]]++;
+    }
+    Vector<uint64_t> offsets(k + 1, 0, allocator_);
+    for (uint64_t j = 0; j < k; ++j) {
+        offsets[j + 1] = offsets[j] + sizes[j];
+    }
+    Vector<uint64_t> order(count, 0, allocator_);
+    {
+        Vector<uint64_t> cursor(offsets.begin(), offsets.end() - 1, allocator_);
+        for (uint64_t i = 0; i < count; ++i) {
+            order[cursor[labels[i]]++] = i;
+        }
+    }
+
+    auto update_centroids_func = [&](uint64_t start, uint64_t end) {
+        omp_set_num_threads(1);
+        for (uint64_t j = start; j < end; ++j) {
+            if (sizes[j] == 0) {
+                continue;
+            }
+            auto* centroid = k_centroids_ + j * dim;
+            std::fill(centroid, centroid + dim, 0.0F);
+            for (uint64_t p = offsets[j]; p < offsets[j + 1]; ++p) {
+                cblas_saxpy(static_cast<blasint>(dim), 1.0F, datas + order[p] * dim, 1, centroid, 1);
+            }
+            cblas_sscal(static_cast<blasint>(dim), 1.0F / static_cast<float>(sizes[j]), centroid, 1);
+        }
+    };
+    parallel_for_blocks(thread_pool_, k, update_centroids_func);
+
+    std::uniform_int_distribution<uint64_t> dis(0, count - 1);
+    for (uint64_t j = 0; j < k; ++j) {
+        if (sizes[j] == 0) {
+            auto index = dis(gen);
+            memcpy(k_centroids_ + j * dim, datas + index * dim, dim * sizeof(float));
+        }
     }
-    return labels;
 }
 
 double
 KMeansCluster::find_nearest_one_with_blas(const float* query,
                                           const uint64_t query_count,
                                           const uint64_t k,
-                                          float* y_sqr,
-                                          float* distances,
                                           Vector<int32_t>& labels) {
     double error = 0.0;
     std::mutex error_mutex;
@@ -168,75 +435,158 @@ KMeansCluster::find_nearest_one_with_blas(const float* query,
         throw VsagException(ErrorType::INTERNAL_ERROR, "k_centroids_ is nullptr");
     }
 
-    auto& thread_pool = this->thread_pool_;
-    auto bs = 1024;
-    std::vector<std::future<void>> futures;
-
-    auto wait_futures_and_clear = [&]() {
-        for (auto& future : futures) {
-            future.wait();
-        }
-        futures.clear();
-    };
-
+    auto dim = static_cast<uint64_t>(dim_);
+    Vector<float> y_sqr(k, 0.0F, allocator_);
     auto compute_ip_func = [&](uint64_t start, uint64_t end) -> void {
         for (uint64_t i = start; i < end; ++i) {
-            y_sqr[i] = FP32ComputeIP(k_centroids_ + i * dim_, k_centroids_ + i * dim_, dim_);
+            y_sqr[i] = FP32ComputeIP(k_centroids_ + i * dim, k_centroids_ + i * dim, dim);
         }
     };
-    for (uint64_t i = 0; i < static_cast<uint64_t>(k); i += bs) {
-        futures.emplace_back(thread_pool->GeneralEnqueue(
-            compute_ip_func, i, std::min(i + bs, static_cast<uint64_t>(k))));
-    }
-    wait_futures_and_clear();
+    parallel_for_blocks(thread_pool_, k, compute_ip_func);
 
-    for (uint64_t i = 0; i < query_count; i += QUERY_BS) {
-        auto end = std::min(i + QUERY_BS, query_count);
-        auto cur_query_count = end - i;
-        auto* cur_label = labels.data() + i;
-
-        cblas_sgemm(CblasColMajor,
-                    CblasTrans,
-                    CblasNoTrans,
-                    static_cast<blasint>(k),
-                    static_cast<blasint>(cur_query_count),
-                    dim_,
-                    -2.0F,
-                    k_centroids_,
-                    dim_,
-                    query + i * dim_,
-                    dim_,
-                    0.0F,
-                    distances,
-                    static_cast<blasint>(k));
-
-        auto assign_labels_func = [&](uint64_t start, uint64_t end) -> void {
-            omp_set_num_threads(1);
-            double thread_local_error = 0.0;
-            for (uint64_t i = start; i < end; ++i) {
-                cblas_saxpy(static_cast<blasint>(k), 1.0, y_sqr, 1, distances + i * k, 1);
-                auto* min_elem = std::min_element(distances + i * k, distances + i * k + k);
-                auto x_sqr = FP32ComputeIP(query + i * dim_, query + i * dim_, dim_);
-                auto min_index = std::distance(distances + i * k, min_elem);
-                thread_local_error += static_cast<double>(*min_elem + x_sqr);
-                if (min_index != cur_label[i]) {
-                    cur_label[i] = static_cast<int>(min_index);
+    // keep the nearest candidate_count centroids of each query, sorted by distance
+    bool use_balance = balance_factor_ > 0.0F and k > 1;
+    uint64_t candidate_count = use_balance ? std::min(k, BALANCE_CANDIDATES) : 1;
+    Vector<float> candidate_dists(
+        query_count * candidate_count, std::numeric_limits<float>::max(), allocator_);
+    Vector<int32_t> candidate_labels(query_count * candidate_count, 0, allocator_);
+
+    // each task assigns one query block, looping over centroid blocks with single thread blas
+    auto assign_labels_func = [&](uint64_t start, uint64_t end) -> void {
+        omp_set_num_threads(1);
+        auto cur_query_count = end - start;
+        auto centroid_block = std::min(k, ASSIGN_CENTROID_BLOCK);
+        Vector<float> distances(cur_query_count * centroid_block, 0.0F, allocator_);
+        for (uint64_t c = 0; c < k; c += centroid_block) {
+            auto cur_centroid_count = std::min(centroid_block, k - c);
+            cblas_sgemm(CblasColMajor,
+                        CblasTrans,
+                        CblasNoTrans,
+                        static_cast<blasint>(cur_centroid_count),
+                        static_cast<blasint>(cur_query_count),
+                        static_cast<blasint>(dim),
+                        -2.0F,
+                        k_centroids_ + c * dim,
+                        static_cast<blasint>(dim),
+                        query + start * dim,
+                        static_cast<blasint>(dim),
+                        0.0F,
+                        distances.data(),
+                        static_cast<blasint>(cur_centroid_count));
+            for (uint64_t i = 0; i < cur_query_count; ++i) {
+                auto* dist = distances.data() + i * cur_centroid_count;
+                cblas_saxpy(
+                    static_cast<blasint>(cur_centroid_count), 1.0F, y_sqr.data() + c, 1, dist, 1);
+                auto* best_dists = candidate_dists.data() + (start + i) * candidate_count;
+                auto* best_labels = candidate_labels.data() + (start + i) * candidate_count;
+                if (candidate_count == 1) {
+                    auto* min_elem = std::min_element(dist, dist + cur_centroid_count);
+                    if (*min_elem < best_dists[0]) {
+                        best_dists[0] = *min_elem;
+                        best_labels[0] = static_cast<int32_t>(c + (min_elem - dist));
+                    }
+                    continue;
+                }
+                for (uint64_t j = 0; j < cur_centroid_count; ++j) {
+                    if (dist[j] >= best_dists[candidate_count - 1]) {
+                        continue;
+                    }
+                    auto pos = candidate_count - 1;
+                    while (pos > 0 and best_dists[pos - 1] > dist[j]) {
+                        best_dists[pos] = best_dists[pos - 1];
+                        best_labels[pos] = best_labels[pos - 1];
+                        --pos;
+                    }
+                    best_dists[pos] = dist[j];
+                    best_labels[pos] = static_cast<int32_t>(c + j);
                 }
             }
-            {
-                std::lock_guard<std::mutex> lock(error_mutex);
-                error += thread_local_error;
+        }
+        double thread_local_error = 0.0;
+        for (uint64_t i = 0; i < cur_query_count; ++i) {
+            auto* cur_query = query + (start + i) * dim;
+            auto x_sqr = FP32ComputeIP(cur_query, cur_query, dim);
+            // from now on the candidate distances are full l2 distances
+            for (uint64_t j = 0; j < candidate_count; ++j) {
+                candidate_dists[(start + i) * candidate_count + j] += x_sqr;
             }
-        };
-        for (uint64_t j = 0; j < cur_query_count; j += bs) {
-            futures.emplace_back(thread_pool->GeneralEnqueue(
-                assign_labels_func, j, std::min(j + bs, cur_query_count)));
+            thread_local_error +=
+                static_cast<double>(candidate_dists[(start + i) * candidate_count]);
+            labels[start + i] = candidate_labels[(start + i) * candidate_count];
         }
-        wait_futures_and_clear();
+        {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            error += thread_local_error;
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+    for (uint64_t i = 0; i < query_count; i += ASSIGN_QUERY_BLOCK) {
+        futures.emplace_back(thread_pool_->GeneralEnqueue(
+            assign_labels_func, i, std::min(i + ASSIGN_QUERY_BLOCK, query_count)));
+    }
+    for (auto& future : futures) {
+        future.wait();
+    }
+    if (use_balance) {
+        error = this->balanced_assign(
+            query, query_count, k, candidate_dists, candidate_labels, labels);
     }
     return error / static_cast<float>(query_count);
 }
 
+double
+KMeansCluster::balanced_assign(const float* query,
+                               uint64_t query_count,
+                               uint64_t k,
+                               const Vector<float>& candidate_dists,
+                               const Vector<int32_t>& candidate_labels,
+                               Vector<int32_t>& labels) const {
+    auto candidate_count = candidate_dists.size() / query_count;
+    auto capacity = static_cast<uint64_t>(std::ceil(std::max(balance_factor_, 1.0F) *
+                                                    static_cast<float>(query_count) /
+                                                    static_cast<float>(k)));
+    // datas close to their nearest centroid choose first
+    Vector<uint64_t> order(query_count, 0, allocator_);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint64_t a, uint64_t b) {
+        return candidate_dists[a * candidate_count] < candidate_dists[b * candidate_count];
+    });
+    Vector<uint64_t> sizes(k, 0, allocator_);
+    double error = 0.0;
+    auto dim = static_cast<uint64_t>(dim_);
+    for (auto i : order) {
+        int32_t label = -1;
+        float dist = 0.0F;
+        for (uint64_t j = 0; j < candidate_count; ++j) {
+            if (sizes[candidate_labels[i * candidate_count + j]] < capacity) {
+                label = candidate_labels[i * candidate_count + j];
+                dist = candidate_dists[i * candidate_count + j];
+                break;
+            }
+        }
+        if (label < 0) {
+            // all candidates are full, scan every centroid for the nearest one with room,
+            // capacity * k >= query_count guarantees there is one
+            dist = std::numeric_limits<float>::max();
+            for (uint64_t c = 0; c < k; ++c) {
+                if (sizes[c] >= capacity) {
+                    continue;
+                }
+                auto cur_dist = FP32ComputeL2Sqr(query + i * dim, k_centroids_ + c * dim, dim);
+                if (cur_dist < dist) {
+                    dist = cur_dist;
+                    label = static_cast<int32_t>(c);
+                }
+            }
+        }
+        sizes[label]++;
+        labels[i] = label;
+        error += static_cast<double>(dist);
+    }
+    return error;
+}
+
 double
 KMeansCluster::find_nearest_one_with_hgraph(const float* query,
                                             const uint64_t query_count,
@@ -15,11 +15,31 @@
 
 #pragma once
 
+#include <random>
+
 #include "impl/thread_pool/safe_thread_pool.h"
 #include "typing.h"
 
 namespace vsag {
 class Allocator;
+
+enum class KMeansInitType {
+    RANDOM = 0,
+    KMEANS_PLUS_PLUS = 1,
+};
+
+struct KMeansStatistics {
+    int32_t iterations{0};
+    bool converged{false};
+    double final_error{0.0};
+    uint64_t min_cluster_size{0};
+    uint64_t max_cluster_size{0};
+    double init_time_ms{0.0};
+    double assign_time_ms{0.0};
+    double update_time_ms{0.0};
+    double total_time_ms{0.0};
+};
+
 class KMeansCluster {
 public:
     explicit KMeansCluster(int32_t dim,
@@ -37,16 +57,97 @@ public:
         bool use_mse_for_convergence = false,
         float threshold = 1e-6F);
 
+    /**
+     * @brief Seeding of the centroids, k-means++ by default. Large k (assigned with hgraph)
+     * always uses random seeding since k-means++ is O(count * k * dim).
+     */
+    void
+    SetInitType(KMeansInitType init_type) {
+        init_type_ = init_type;
+    }
+
+    /**
+     * @brief Number of samples per iteration, 0 means full batch Lloyd iterations. With
+     * mini-batch, centroids are updated with per-centroid learning rates (Sculley, 2010) and
+     * a full assignment is only done once at the end to produce the labels.
+     */
+    void
+    SetMiniBatchSize(uint64_t mini_batch_size) {
+        mini_batch_size_ = mini_batch_size;
+    }
+
+    /**
+     * @brief Maximum cluster size during assignment, in units of the average size (count / k),
+     * 0 disables it. Datas in full clusters go to the nearest centroid that still has room,
+     * which pulls more centroids into dense regions. The cap is strict for every assignment,
+     * but only effective when k is small enough to be assigned with blas.
+     */
+    void
+    SetBalanceFactor(float balance_factor) {
+        balance_factor_ = balance_factor;
+    }
+
+    [[nodiscard]] const KMeansStatistics&
+    GetStatistics() const {
+        return statistics_;
+    }
+
 public:
     float* k_centroids_{nullptr};
 
 private:
+    void
+    init_centroids(uint32_t k, const float* datas, uint64_t count, std::mt19937& gen);
+
+    void
+    init_centroids_kmeans_plus_plus(uint32_t k,
+                                    const float* datas,
+                                    uint64_t count,
+                                    std::mt19937& gen);
+
+    double
+    assign(const float* query, uint64_t query_count, uint64_t k, Vector<int32_t>& labels);
+
+    void
+    update_centroids(const float* datas,
+                     uint64_t count,
+                     uint64_t k,
+                     const Vector<int32_t>& labels,
+                     Vector<uint64_t>& sizes,
+                     std::mt19937& gen);
+
+    double
+    run_lloyd(uint32_t k,
+              const float* datas,
+              uint64_t count,
+              int iter,
+              bool use_mse_for_convergence,
+              float threshold,
+              Vector<int32_t>& labels,
+              std::mt19937& gen);
+
+    double
+    run_mini_batch(uint32_t k,
+                   const float* datas,
+                   uint64_t count,
+                   int iter,
+                   bool use_mse_for_convergence,
+                   float threshold,
+                   Vector<int32_t>& labels,
+                   std::mt19937& gen);
+
+    double
+    balanced_assign(const float* query,
+                    uint64_t query_count,
+                    uint64_t k,
+                    const Vector<float>& candidate_dists,
+                    const Vector<int32_t>& candidate_labels,
+                    Vector<int32_t>& labels) const;
+
     double
     find_nearest_one_with_blas(const float* query,
                                const uint64_t query_count,
                                const uint64_t k,
-                               float* y_sqr,
-                               float* distances,
                                Vector<int32_t>& labels);
 
     double
@@ -62,9 +163,29 @@ private:
 
     const int32_t dim_{0};
 
+    KMeansInitType init_type_{KMeansInitType::KMEANS_PLUS_PLUS};
+
+    uint64_t mini_batch_size_{0};
+
+    float balance_factor_{0.0F};
+
+    KMeansStatistics statistics_;
+
     static constexpr uint64_t THRESHOLD_FOR_HGRAPH = 10000ULL;
 
     static constexpr uint64_t QUERY_BS = 65536ULL;
+
+    // the blas assignment is tiled into query blocks x centroid blocks, each query block is one
+    // task of the thread pool, so the distance buffer stays small even for a large k
+    static constexpr uint64_t ASSIGN_QUERY_BLOCK = 256ULL;
+
+    static constexpr uint64_t ASSIGN_CENTROID_BLOCK = 4096ULL;
+
+    // number of nearest centroids kept per data for the balanced assignment
+    static constexpr uint64_t BALANCE_CANDIDATES = 8ULL;
+
+    // k-means++ seeding runs on at most this many samples per centroid
+    static constexpr uint64_t SEED_SAMPLES_PER_CENTROID = 64ULL;
 };
 
 }  // namespace vsag
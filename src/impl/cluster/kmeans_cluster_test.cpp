@@ -16,6 +16,7 @@
 #include "kmeans_cluster.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 
 #include "fixtures.h"
 #include "impl/allocator/safe_allocator.h"
@@ -67,3 +68,104 @@ TEST_CASE("Kmeans Basic Test", "[ut][KMeansCluster]") {
         }
     }
 }
+
+static double
+ComputeMeanError(const std::vector<float>& datas,
+                 const float* centroids,
+                 const vsag::Vector<int>& labels,
+                 int32_t dim) {
+    double error = 0.0;
+    for (uint64_t i = 0; i < labels.size(); ++i) {
+        for (int32_t j = 0; j < dim; ++j) {
+            double diff = datas[i * dim + j] - centroids[labels[i] * dim + j];
+            error += diff * diff;
+        }
+    }
+    return error / static_cast<double>(labels.size());
+}
+
+TEST_CASE("Kmeans Init And Statistics Test", "[ut][KMeansCluster]") {
+    std::vector<int> labels;
+    int32_t k = 16;
+    int32_t dim = 8;
+    uint64_t count = 4000;
+    auto datas = GenerateDataset(k, dim, count, labels);
+    auto allocator = vsag::SafeAllocator::FactoryDefaultAllocator();
+
+    auto init_type = GENERATE(vsag::KMeansInitType::RANDOM, vsag::KMeansInitType::KMEANS_PLUS_PLUS);
+    vsag::KMeansCluster cluster(dim, allocator.get());
+    cluster.SetInitType(init_type);
+    double err = 0.0;
+    int iter = 10;
+    auto result = cluster.Run(k, datas.data(), count, iter, &err);
+    REQUIRE(result.size() == count);
+
+    const auto& stats = cluster.GetStatistics();
+    REQUIRE(stats.iterations == iter);
+    REQUIRE_FALSE(stats.converged);
+    REQUIRE(stats.final_error == err);
+    REQUIRE(stats.min_cluster_size <= stats.max_cluster_size);
+    REQUIRE(stats.max_cluster_size <= count);
+    REQUIRE(stats.total_time_ms >= stats.assign_time_ms);
+    REQUIRE(std::abs(ComputeMeanError(datas, cluster.k_centroids_, result, dim) - err) <
+            1e-3 + 1e-3 * err);
+
+    // k-means++ seeds one centroid per well separated cluster with high probability
+    if (init_type == vsag::KMeansInitType::KMEANS_PLUS_PLUS) {
+        REQUIRE(err < 1e-3);
+    }
+
+    // with convergence check, identical errors of two iterations stop the loop
+    cluster.Run(k, datas.data(), count, 100, nullptr, true, 1e-6F);
+    REQUIRE(cluster.GetStatistics().iterations < 100);
+    REQUIRE(cluster.GetStatistics().converged);
+}
+
+TEST_CASE("Kmeans Mini Batch Test", "[ut][KMeansCluster]") {
+    int32_t dim = 16;
+    uint64_t count = 20000;
+    uint32_t k = 32;
+    auto datas = fixtures::generate_vectors(count, dim, false, 47);
+    auto allocator = vsag::SafeAllocator::FactoryDefaultAllocator();
+
+    vsag::KMeansCluster full_cluster(dim, allocator.get());
+    double full_err = 0.0;
+    full_cluster.Run(k, datas.data(), count, 25, &full_err);
+
+    vsag::KMeansCluster batch_cluster(dim, allocator.get());
+    batch_cluster.SetMiniBatchSize(1024);
+    double batch_err = 0.0;
+    auto result = batch_cluster.Run(k, datas.data(), count, 100, &batch_err);
+    REQUIRE(result.size() == count);
+    REQUIRE(batch_cluster.GetStatistics().iterations == 100);
+    REQUIRE(std::abs(ComputeMeanError(datas, batch_cluster.k_centroids_, result, dim) -
+                     batch_err) < 1e-3 * batch_err);
+    // mini-batch only sees a fraction of the datas, but should stay close to full batch
+    REQUIRE(batch_err < full_err * 1.1);
+}
+
+TEST_CASE("Kmeans Balance Test", "[ut][KMeansCluster]") {
+    int32_t dim = 8;
+    uint64_t count = 8000;
+    uint32_t k = 16;
+    // skewed datas: most vectors are packed in a small region
+    auto datas = fixtures::generate_vectors(count, dim, false, 97);
+    for (uint64_t i = 0; i < count * 3 / 4; ++i) {
+        for (int32_t j = 0; j < dim; ++j) {
+            datas[i * dim + j] = datas[i * dim + j] * 0.05F + 1.0F;
+        }
+    }
+    auto allocator = vsag::SafeAllocator::FactoryDefaultAllocator();
+
+    vsag::KMeansCluster cluster(dim, allocator.get());
+    cluster.Run(k, datas.data(), count, 25);
+    auto unbalanced_max = cluster.GetStatistics().max_cluster_size;
+
+    vsag::KMeansCluster balanced_cluster(dim, allocator.get());
+    float balance_factor = 1.2F;
+    balanced_cluster.SetBalanceFactor(balance_factor);
+    balanced_cluster.Run(k, datas.data(), count, 25);
+    auto balanced_max = balanced_cluster.GetStatistics().max_cluster_size;
+    REQUIRE(balanced_max < unbalanced_max);
+    REQUIRE(balanced_max <= static_cast<uint64_t>(std::ceil(balance_factor * count / k)));
+}
@@ -0,0 +1,100 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "combined_inner_id_filter.h"
+
+#include <algorithm>
+
+#include "common.h"
+
+namespace vsag {
+
+bool
+CombinedInnerIdFilter::check_label(LabelType label) const {
+    if (label_black_list_ != nullptr and label_black_list_->Test(label & ROW_ID_MASK)) {
+        return false;
+    }
+    return label_filter_ == nullptr or label_filter_->CheckValid(label);
+}
+
+bool
+CombinedInnerIdFilter::CheckValid(int64_t inner_id) const {
+    if (inner_id_white_list_ != nullptr and not inner_id_white_list_->Test(inner_id)) {
+        return false;
+    }
+    if (inner_id_filter_ != nullptr and not inner_id_filter_->CheckValid(inner_id)) {
+        return false;
+    }
+    if (label_black_list_ == nullptr and label_filter_ == nullptr) {
+        return true;
+    }
+    return check_label(label_table_.GetLabelById(inner_id));
+}
+
+float
+CombinedInnerIdFilter::ValidRatio() const {
+    float ratio = 1.0F;
+    if (label_filter_ != nullptr) {
+        ratio *= label_filter_->ValidRatio();
+    }
+    if (inner_id_filter_ != nullptr) {
+        ratio *= inner_id_filter_->ValidRatio();
+    }
+    if (total_count_ == 0) {
+        return ratio;
+    }
+    auto total_count = static_cast<float>(total_count_);
+    if (label_black_list_ != nullptr) {
+        auto black_count = static_cast<float>(label_black_list_->Count());
+        ratio *= 1.0F - std::min(black_count / total_count, 1.0F);
+    }
+    if (inner_id_white_list_ != nullptr) {
+        ratio *= std::min(static_cast<float>(inner_id_white_list_->Count()) / total_count, 1.0F);
+    }
+    return ratio;
+}
+
+uint32_t
+CombinedInnerIdFilter::FillMask(int64_t start_id, int64_t count, uint8_t* mask) const {
+    if (inner_id_white_list_ != nullptr) {
+        for (int64_t i = 0; i < count; ++i) {
+            mask[i] = static_cast<uint8_t>(inner_id_white_list_->Test(start_id + i));
+        }
+    } else {
+        std::fill(mask, mask + count, 1);
+    }
+    if (inner_id_filter_ != nullptr) {
+        for (int64_t i = 0; i < count; ++i) {
+            if (mask[i] != 0) {
+                mask[i] = static_cast<uint8_t>(inner_id_filter_->CheckValid(start_id + i));
+            }
+        }
+    }
+    // the labels are only looked up for the inner ids left
+    if (label_black_list_ != nullptr or label_filter_ != nullptr) {
+        const auto* labels = label_table_.GetAllLabels() + start_id;
+        for (int64_t i = 0; i < count; ++i) {
+            if (mask[i] != 0) {
+                mask[i] = static_cast<uint8_t>(check_label(labels[i]));
+            }
+        }
+    }
+    uint32_t valid_count = 0;
+    for (int64_t i = 0; i < count; ++i) {
+        valid_count += mask[i];
+    }
+    return valid_count;
+}
+
+}  // namespace vsag
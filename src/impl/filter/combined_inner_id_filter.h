@@ -0,0 +1,104 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "impl/bitset/computable_bitset.h"
+#include "impl/label_table.h"
+#include "utils/pointer_define.h"
+#include "vsag/bitset.h"
+#include "vsag/filter.h"
+
+namespace vsag {
+
+DEFINE_POINTER(CombinedInnerIdFilter);
+
+/**
+ * @brief The conjunction of the filters of one search, on inner ids.
+ *
+ * The parts are kept apart so that FillMask builds the mask of a range of inner ids from the
+ * bitset on inner ids first, and only looks up the labels of the ids it lets through.
+ */
+class CombinedInnerIdFilter : public Filter {
+public:
+    CombinedInnerIdFilter(const LabelTable& label_table, int64_t total_count)
+        : label_table_(label_table), total_count_(total_count){};
+
+    // a filter on labels
+    void
+    SetLabelFilter(const FilterPtr& filter) {
+        label_filter_ = filter;
+    }
+
+    // a bitset on labels, the labels set are filtered out
+    void
+    SetLabelBlackList(const BitsetPtr& bitset) {
+        label_black_list_ = bitset;
+    }
+
+    // a bitset on inner ids, only the inner ids set are valid
+    void
+    SetInnerIdWhiteList(ComputableBitset* bitset) {
+        inner_id_white_list_ = bitset;
+    }
+
+    // a filter on inner ids that is not a plain bitset
+    void
+    SetInnerIdFilter(const Filter* filter) {
+        inner_id_filter_ = filter;
+    }
+
+    [[nodiscard]] bool
+    Empty() const {
+        return label_filter_ == nullptr and label_black_list_ == nullptr and
+               inner_id_white_list_ == nullptr and inner_id_filter_ == nullptr;
+    }
+
+    [[nodiscard]] bool
+    CheckValid(int64_t inner_id) const override;
+
+    /**
+     * @brief The product of the valid ratios of the parts, as if they were independent.
+     */
+    [[nodiscard]] float
+    ValidRatio() const override;
+
+    /**
+     * @brief Set mask[i] to whether the inner id start_id + i is valid, for i in [0, count).
+     *
+     * @return the number of valid inner ids.
+     */
+    uint32_t
+    FillMask(int64_t start_id, int64_t count, uint8_t* mask) const;
+
+private:
+    [[nodiscard]] bool
+    check_label(LabelType label) const;
+
+private:
+    const LabelTable& label_table_;
+
+    const int64_t total_count_{0};
+
+    FilterPtr label_filter_{nullptr};
+
+    BitsetPtr label_black_list_{nullptr};
+
+    ComputableBitset* inner_id_white_list_{nullptr};
+
+    const Filter* inner_id_filter_{nullptr};
+};
+}  // namespace vsag
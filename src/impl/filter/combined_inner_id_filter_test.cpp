@@ -0,0 +1,68 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "black_list_filter.h"
+#include "combined_inner_id_filter.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <cmath>
+
+#include "impl/allocator/safe_allocator.h"
+#include "impl/bitset/fast_bitset.h"
+#include "white_list_filter.h"
+
+using namespace vsag;
+
+TEST_CASE("CombinedInnerIdFilter Basic Test", "[ut][CombinedInnerIdFilter]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    int64_t max_count = 100;
+    LabelTable label_table(allocator.get());
+    for (int64_t i = 0; i < max_count; i++) {
+        label_table.Insert(i, i * 2);
+    }
+
+    auto label_filter =
+        std::make_shared<WhiteListFilter>([](int64_t label) -> bool { return label % 3 == 0; });
+    auto label_black_list = std::make_shared<FastBitset>(allocator.get());
+    auto inner_id_white_list = std::make_shared<FastBitset>(allocator.get());
+    for (int64_t i = 0; i < max_count; i++) {
+        label_black_list->Set(i * 2, i % 5 == 0);
+        inner_id_white_list->Set(i, i % 2 == 0);
+    }
+    auto expected = [](int64_t inner_id) -> bool {
+        return inner_id % 2 == 0 and (inner_id * 2) % 3 == 0 and inner_id % 5 != 0;
+    };
+
+    CombinedInnerIdFilter filter(label_table, max_count);
+    REQUIRE(filter.Empty());
+    REQUIRE(filter.ValidRatio() == 1.0F);
+    filter.SetInnerIdWhiteList(inner_id_white_list.get());
+    REQUIRE(filter.ValidRatio() == 0.5F);
+    filter.SetLabelFilter(label_filter);
+    filter.SetLabelBlackList(label_black_list);
+    REQUIRE_FALSE(filter.Empty());
+    REQUIRE(std::abs(filter.ValidRatio() - 0.4F) < 1e-6);
+
+    std::vector<uint8_t> mask(max_count);
+    int64_t start_id = 10;
+    auto valid_count = filter.FillMask(start_id, max_count - start_id, mask.data());
+    uint32_t expected_count = 0;
+    for (int64_t i = start_id; i < max_count; i++) {
+        REQUIRE(filter.CheckValid(i) == expected(i));
+        REQUIRE(static_cast<bool>(mask[i - start_id]) == expected(i));
+        expected_count += static_cast<uint32_t>(expected(i));
+    }
+    REQUIRE(valid_count == expected_count);
+}
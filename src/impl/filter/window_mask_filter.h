@@ -0,0 +1,38 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "vsag/filter.h"
+
+namespace vsag {
+
+// accepts the inner ids of one window whose byte in the window-local mask is set
+class WindowMaskFilter : public Filter {
+public:
+    WindowMaskFilter(const uint8_t* window_mask, int64_t window_start_id)
+        : window_mask_(window_mask), window_start_id_(window_start_id){};
+
+    [[nodiscard]] bool
+    CheckValid(int64_t inner_id) const override {
+        return window_mask_[inner_id - window_start_id_] != 0;
+    }
+
+private:
+    const uint8_t* const window_mask_;
+    const int64_t window_start_id_;
+};
+}  // namespace vsag
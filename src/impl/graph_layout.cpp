@@ -0,0 +1,295 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "graph_layout.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "datacell/graph_interface.h"
+#include "inner_string_params.h"
+#include "vsag_exception.h"
+
+namespace vsag {
+
+static constexpr InnerIdType INVALID_LAYOUT_ID = std::numeric_limits<InnerIdType>::max();
+
+// compressed adjacency lists, the neighbors of node i are ids[offsets[i], offsets[i + 1])
+struct LayoutAdjacency {
+    explicit LayoutAdjacency(Allocator* allocator) : offsets(allocator), ids(allocator) {
+    }
+
+    [[nodiscard]] uint64_t
+    Degree(InnerIdType id) const {
+        return offsets[id + 1] - offsets[id];
+    }
+
+    [[nodiscard]] const InnerIdType*
+    Begin(InnerIdType id) const {
+        return ids.data() + offsets[id];
+    }
+
+    [[nodiscard]] const InnerIdType*
+    End(InnerIdType id) const {
+        return ids.data() + offsets[id + 1];
+    }
+
+    Vector<uint64_t> offsets;
+    Vector<InnerIdType> ids;
+};
+
+static void
+load_adjacency(const GraphInterfacePtr& graph,
+               InnerIdType total_count,
+               LayoutAdjacency& out_edges,
+               LayoutAdjacency& in_edges,
+               Allocator* allocator) {
+    Vector<InnerIdType> neighbors(allocator);
+    out_edges.offsets.assign(total_count + 1, 0);
+    in_edges.offsets.assign(total_count + 1, 0);
+    for (InnerIdType id = 0; id < total_count; ++id) {
+        graph->GetNeighbors(id, neighbors);
+        out_edges.offsets[id + 1] = out_edges.offsets[id];
+        for (const auto& nb : neighbors) {
+            if (nb < total_count and nb != id) {
+                out_edges.ids.emplace_back(nb);
+                out_edges.offsets[id + 1]++;
+                in_edges.offsets[nb + 1]++;
+            }
+        }
+    }
+    for (InnerIdType id = 0; id < total_count; ++id) {
+        in_edges.offsets[id + 1] += in_edges.offsets[id];
+    }
+    in_edges.ids.resize(out_edges.ids.size());
+    Vector<uint64_t> cursor(in_edges.offsets.begin(), in_edges.offsets.end() - 1, allocator);
+    for (InnerIdType id = 0; id < total_count; ++id) {
+        for (const auto* nb = out_edges.Begin(id); nb != out_edges.End(id); ++nb) {
+            in_edges.ids[cursor[*nb]++] = id;
+        }
+    }
+}
+
+// the bfs starts from the hubs, so the most visited nodes share the first pages
+static void
+hub_first_bfs(const LayoutAdjacency& out_edges,
+              const LayoutAdjacency& in_edges,
+              InnerIdType total_count,
+              Vector<InnerIdType>& order,
+              Allocator* allocator) {
+    Vector<InnerIdType> seeds(total_count, allocator);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::stable_sort(seeds.begin(), seeds.end(), [&](InnerIdType a, InnerIdType b) {
+        return in_edges.Degree(a) > in_edges.Degree(b);
+    });
+    Vector<bool> visited(total_count, false, allocator);
+    uint64_t head = 0;
+    for (const auto& seed : seeds) {
+        if (visited[seed]) {
+            continue;
+        }
+        visited[seed] = true;
+        order.emplace_back(seed);
+        while (head < order.size()) {
+            auto id = order[head++];
+            for (const auto* nb = out_edges.Begin(id); nb != out_edges.End(id); ++nb) {
+                if (not visited[*nb]) {
+                    visited[*nb] = true;
+                    order.emplace_back(*nb);
+                }
+            }
+        }
+    }
+}
+
+// cuthill-mckee on the symmetrized graph, reversed to lower the profile
+static void
+reverse_cuthill_mckee(const LayoutAdjacency& out_edges,
+                      const LayoutAdjacency& in_edges,
+                      InnerIdType total_count,
+                      Vector<InnerIdType>& order,
+                      Allocator* allocator) {
+    auto degree = [&](InnerIdType id) { return out_edges.Degree(id) + in_edges.Degree(id); };
+    Vector<InnerIdType> seeds(total_count, allocator);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::stable_sort(seeds.begin(), seeds.end(), [&](InnerIdType a, InnerIdType b) {
+        return degree(a) < degree(b);
+    });
+    Vector<bool> visited(total_count, false, allocator);
+    Vector<InnerIdType> next_level(allocator);
+    uint64_t head = 0;
+    for (const auto& seed : seeds) {
+        if (visited[seed]) {
+            continue;
+        }
+        visited[seed] = true;
+        order.emplace_back(seed);
+        while (head < order.size()) {
+            auto id = order[head++];
+            next_level.clear();
+            for (const auto* edges : {&out_edges, &in_edges}) {
+                for (const auto* nb = edges->Begin(id); nb != edges->End(id); ++nb) {
+                    if (not visited[*nb]) {
+                        visited[*nb] = true;
+                        next_level.emplace_back(*nb);
+                    }
+                }
+            }
+            std::stable_sort(next_level.begin(), next_level.end(), [&](auto a, auto b) {
+                return degree(a) < degree(b);
+            });
+            order.insert(order.end(), next_level.begin(), next_level.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+}
+
+/*
+ * gorder places next the node with the highest score against the last `window` placed nodes,
+ * the score counts direct edges and shared in-neighbors, the candidates are kept in buckets
+ * indexed by score so that every score update is O(1)
+ */
+static void
+gorder(const LayoutAdjacency& out_edges,
+       const LayoutAdjacency& in_edges,
+       InnerIdType total_count,
+       uint32_t window,
+       Vector<InnerIdType>& order,
+       Allocator* allocator) {
+    Vector<int64_t> scores(total_count, 0, allocator);
+    Vector<InnerIdType> prev(total_count, INVALID_LAYOUT_ID, allocator);
+    Vector<InnerIdType> next(total_count, INVALID_LAYOUT_ID, allocator);
+    Vector<InnerIdType> heads(1, INVALID_LAYOUT_ID, allocator);
+    Vector<bool> placed(total_count, false, allocator);
+    int64_t top = 0;
+
+    auto unlink = [&](InnerIdType id) {
+        if (prev[id] != INVALID_LAYOUT_ID) {
+            next[prev[id]] = next[id];
+        } else {
+            heads[scores[id]] = next[id];
+        }
+        if (next[id] != INVALID_LAYOUT_ID) {
+            prev[next[id]] = prev[id];
+        }
+    };
+    auto link = [&](InnerIdType id) {
+        auto score = scores[id];
+        if (score >= static_cast<int64_t>(heads.size())) {
+            heads.resize(score + 1, INVALID_LAYOUT_ID);
+        }
+        prev[id] = INVALID_LAYOUT_ID;
+        next[id] = heads[score];
+        if (heads[score] != INVALID_LAYOUT_ID) {
+            prev[heads[score]] = id;
+        }
+        heads[score] = id;
+        top = std::max(top, score);
+    };
+    auto update = [&](InnerIdType id, int64_t delta) {
+        if (placed[id]) {
+            return;
+        }
+        unlink(id);
+        scores[id] += delta;
+        link(id);
+    };
+    auto apply = [&](InnerIdType id, int64_t delta) {
+        for (const auto* nb = out_edges.Begin(id); nb != out_edges.End(id); ++nb) {
+            update(*nb, delta);
+        }
+        for (const auto* in_nb = in_edges.Begin(id); in_nb != in_edges.End(id); ++in_nb) {
+            update(*in_nb, delta);
+            for (const auto* sibling = out_edges.Begin(*in_nb); sibling != out_edges.End(*in_nb);
+                 ++sibling) {
+                if (*sibling != id) {
+                    update(*sibling, delta);
+                }
+            }
+        }
+    };
+
+    // ties at score 0 are broken by in-degree, so each new component starts from a hub
+    Vector<InnerIdType> seeds(total_count, allocator);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    std::stable_sort(seeds.begin(), seeds.end(), [&](InnerIdType a, InnerIdType b) {
+        return in_edges.Degree(a) < in_edges.Degree(b);
+    });
+    for (const auto& id : seeds) {
+        link(id);
+    }
+
+    for (InnerIdType i = 0; i < total_count; ++i) {
+        while (top > 0 and heads[top] == INVALID_LAYOUT_ID) {
+            --top;
+        }
+        auto id = heads[top];
+        unlink(id);
+        placed[id] = true;
+        order.emplace_back(id);
+        apply(id, 1);
+        if (i >= window) {
+            apply(order[i - window], -1);
+        }
+    }
+}
+
+GraphLayoutOrder
+get_graph_layout_order(const std::string& name) {
+    if (name == GRAPH_LAYOUT_ORDER_VALUE_NONE) {
+        return GraphLayoutOrder::NONE;
+    }
+    if (name == GRAPH_LAYOUT_ORDER_VALUE_BFS) {
+        return GraphLayoutOrder::BFS;
+    }
+    if (name == GRAPH_LAYOUT_ORDER_VALUE_RCM) {
+        return GraphLayoutOrder::RCM;
+    }
+    if (name == GRAPH_LAYOUT_ORDER_VALUE_GORDER) {
+        return GraphLayoutOrder::GORDER;
+    }
+    throw VsagException(ErrorType::INVALID_ARGUMENT,
+                        fmt::format("invalid {}: {}", GRAPH_LAYOUT_ORDER_KEY, name));
+}
+
+Vector<InnerIdType>
+compute_graph_layout(const GraphInterfacePtr& graph,
+                     InnerIdType total_count,
+                     GraphLayoutOrder order,
+                     Allocator* allocator,
+                     uint32_t gorder_window) {
+    Vector<InnerIdType> new_to_old(allocator);
+    if (order == GraphLayoutOrder::NONE or total_count == 0) {
+        new_to_old.resize(total_count);
+        std::iota(new_to_old.begin(), new_to_old.end(), 0);
+        return new_to_old;
+    }
+    LayoutAdjacency out_edges(allocator);
+    LayoutAdjacency in_edges(allocator);
+    load_adjacency(graph, total_count, out_edges, in_edges, allocator);
+
+    new_to_old.reserve(total_count);
+    if (order == GraphLayoutOrder::BFS) {
+        hub_first_bfs(out_edges, in_edges, total_count, new_to_old, allocator);
+    } else if (order == GraphLayoutOrder::RCM) {
+        reverse_cuthill_mckee(out_edges, in_edges, total_count, new_to_old, allocator);
+    } else {
+        auto window = std::max(gorder_window, 1U);
+        gorder(out_edges, in_edges, total_count, window, new_to_old, allocator);
+    }
+    return new_to_old;
+}
+
+}  // namespace vsag
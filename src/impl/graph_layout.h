@@ -0,0 +1,48 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "typing.h"
+#include "utils/pointer_define.h"
+
+namespace vsag {
+DEFINE_POINTER(GraphInterface);
+
+enum class GraphLayoutOrder {
+    NONE = 0,
+    BFS = 1,     // hub-first breadth first search
+    RCM = 2,     // reverse Cuthill-McKee
+    GORDER = 3,  // greedy window ordering that packs nodes with shared neighbors
+};
+
+GraphLayoutOrder
+get_graph_layout_order(const std::string& name);
+
+/**
+ * @brief Computes a locality friendly order of the nodes [0, total_count) of graph.
+ *
+ * @return new_to_old, the i-th element is the old id of the node placed at position i.
+ */
+Vector<InnerIdType>
+compute_graph_layout(const GraphInterfacePtr& graph,
+                     InnerIdType total_count,
+                     GraphLayoutOrder order,
+                     Allocator* allocator,
+                     uint32_t gorder_window = 5);
+
+}  // namespace vsag
@@ -0,0 +1,74 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "graph_layout.h"
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+#include <random>
+
+#include "datacell/sparse_graph_datacell.h"
+#include "impl/allocator/safe_allocator.h"
+
+using namespace vsag;
+
+TEST_CASE("Graph Layout Order", "[ut][graph_layout]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto graph_param = std::make_shared<SparseGraphDatacellParameter>();
+    graph_param->max_degree_ = 4;
+    auto graph = std::make_shared<SparseGraphDataCell>(graph_param, allocator.get());
+
+    // a ring whose ids have been shuffled, a good layout puts ring neighbors close together
+    InnerIdType count = 1000;
+    Vector<InnerIdType> ring(count, allocator.get());
+    std::iota(ring.begin(), ring.end(), 0);
+    std::shuffle(ring.begin(), ring.end(), std::mt19937(47));
+    for (InnerIdType i = 0; i < count; ++i) {
+        Vector<InnerIdType> neighbors(allocator.get());
+        neighbors.emplace_back(ring[(i + 1) % count]);
+        neighbors.emplace_back(ring[(i + count - 1) % count]);
+        graph->InsertNeighborsById(ring[i], neighbors);
+    }
+
+    auto bandwidth = [&](const Vector<InnerIdType>& new_to_old) {
+        Vector<InnerIdType> old_to_new(count, allocator.get());
+        for (InnerIdType i = 0; i < count; ++i) {
+            old_to_new[new_to_old[i]] = i;
+        }
+        uint64_t total = 0;
+        for (InnerIdType i = 0; i < count; ++i) {
+            auto a = old_to_new[ring[i]];
+            auto b = old_to_new[ring[(i + 1) % count]];
+            total += a > b ? a - b : b - a;
+        }
+        return total;
+    };
+
+    auto identity = compute_graph_layout(graph, count, GraphLayoutOrder::NONE, allocator.get());
+    auto identity_bandwidth = bandwidth(identity);
+
+    auto name = GENERATE("bfs", "rcm", "gorder");
+    auto new_to_old =
+        compute_graph_layout(graph, count, get_graph_layout_order(name), allocator.get());
+    REQUIRE(new_to_old.size() == count);
+    Vector<InnerIdType> sorted(new_to_old.begin(), new_to_old.end(), allocator.get());
+    std::sort(sorted.begin(), sorted.end());
+    for (InnerIdType i = 0; i < count; ++i) {
+        REQUIRE(sorted[i] == i);
+    }
+    REQUIRE(bandwidth(new_to_old) * 10 < identity_bandwidth);
+
+    REQUIRE_THROWS(get_graph_layout_order("unknown"));
+}
@@ -47,6 +47,7 @@ public:
           label_remap_(0, allocator),
           use_reverse_map_(use_reverse_map),
           deleted_ids_(allocator),
+          released_ids_(allocator),
           compress_duplicate_data_(compress_redundant_data),
           duplicate_records_(0, allocator){};
 
@@ -113,6 +114,45 @@ public:
                 iter->second == std::numeric_limits<InnerIdType>::max());
     }
 
+    /**
+     * @brief Marks a removed id as released once no edge references it anymore.
+     *
+     * A released id stays removed, but its label is dropped from the tombstones so
+     * that it can neither be recovered nor be found by label again.
+     */
+    inline void
+    ReleaseRemovedId(InnerIdType id) {
+        if (not use_reverse_map_ or deleted_ids_.count(id) == 0) {
+            return;
+        }
+        auto iter = label_remap_.find(label_table_[id]);
+        if (iter != label_remap_.end() and
+            iter->second == std::numeric_limits<InnerIdType>::max()) {
+            label_remap_.erase(iter);
+        }
+        released_ids_.insert(id);
+    }
+
+    /**
+     * @brief Hands a released id over to a new label, the id is live again afterwards.
+     *
+     * Unlike Insert, the total count is unchanged because the slot has been counted before.
+     */
+    inline void
+    ReuseReleasedId(InnerIdType id, LabelType label) {
+        released_ids_.erase(id);
+        deleted_ids_.erase(id);
+        if (use_reverse_map_) {
+            label_remap_[label] = id;
+        }
+        label_table_[id] = label;
+    }
+
+    inline bool
+    IsReleased(InnerIdType id) const {
+        return not released_ids_.empty() && released_ids_.count(id) != 0;
+    }
+
     inline bool
     IsRemoved(InnerIdType id) {
         return not deleted_ids_.empty() && deleted_ids_.count(id) != 0;
@@ -131,11 +171,11 @@ public:
                 throw std::runtime_error(fmt::format("label {} is removed", label));
             }
         }
-        auto result = std::find(label_table_.begin(), label_table_.end(), label);
-        if (result == label_table_.end()) {
+        auto id = find_id_by_label(label);
+        if (id == std::numeric_limits<InnerIdType>::max()) {
             throw std::runtime_error(fmt::format("label {} is not exists", label));
         }
-        return result - label_table_.begin();
+        return id;
     }
 
     inline bool
@@ -158,11 +198,10 @@ public:
         }
 
         // 2. update label_table_
-        auto result = std::find(label_table_.begin(), label_table_.end(), old_label);
-        if (result == label_table_.end()) {
+        InnerIdType internal_id = find_id_by_label(old_label);
+        if (internal_id == std::numeric_limits<InnerIdType>::max()) {
             throw std::runtime_error(fmt::format("old label {} is not exists", old_label));
         }
-        InnerIdType internal_id = result - label_table_.begin();
         label_table_[internal_id] = new_label;
 
         // 3. update label_remap_
@@ -211,7 +250,9 @@ public:
         StreamReader::ReadVector(reader, label_table_);
         if (use_reverse_map_) {
             for (InnerIdType id = 0; id < label_table_.size(); ++id) {
-                this->label_remap_[label_table_[id]] = id;
+                if (not IsReleased(id)) {
+                    this->label_remap_[label_table_[id]] = id;
+                }
             }
         }
         if (compress_duplicate_data_) {
@@ -274,10 +315,30 @@ public:
     void
     MergeOther(const LabelTablePtr& other, const IdMapFunction& id_map = nullptr);
 
+private:
+    inline InnerIdType
+    find_id_by_label(LabelType label) const {
+        if (use_reverse_map_) {
+            auto iter = label_remap_.find(label);
+            if (iter != label_remap_.end() and
+                iter->second != std::numeric_limits<InnerIdType>::max()) {
+                return iter->second;
+            }
+        }
+        // released ids keep their stale label, skip them
+        for (InnerIdType id = 0; id < label_table_.size(); ++id) {
+            if (label_table_[id] == label and not IsReleased(id)) {
+                return id;
+            }
+        }
+        return std::numeric_limits<InnerIdType>::max();
+    }
+
 public:
     Vector<LabelType> label_table_;
     STLUnorderedMap<LabelType, InnerIdType> label_remap_;
     UnorderedSet<InnerIdType> deleted_ids_;
+    UnorderedSet<InnerIdType> released_ids_;
 
     bool compress_duplicate_data_{true};
     bool support_tombstone_{false};
@@ -57,8 +57,13 @@ ODescent::Build(const Vector<InnerIdType>& ids_sequence, const GraphInterfacePtr
             repair_no_in_edge();
         }
         if (pruning_) {
+            if (prune_flatten_ != nullptr and prune_flatten_ != flatten_interface_) {
+                pruning_stage_ = true;
+                refine_distances();
+            }
             prune_graph();
             add_reverse_edges();
+            pruning_stage_ = false;
         }
     }
     return true;
@@ -285,6 +290,18 @@ ODescent::repair_no_in_edge() {
     }
 }
 
+void
+ODescent::refine_distances() {
+    auto task = [&, this](int64_t start, int64_t end) {
+        for (int64_t loc = start; loc < end; ++loc) {
+            for (auto& neighbor : graph_[loc].neighbors) {
+                neighbor.distance = get_distance(loc, neighbor.id);
+            }
+        }
+    };
+    parallelize_task(task);
+}
+
 void
 ODescent::prune_graph() {
     Vector<int> in_edges_count(data_num_, 0, allocator_);
@@ -108,13 +108,23 @@ public:
     void
     SaveGraph(GraphInterfacePtr& graph_storage);
 
+    /**
+     * @brief Codes used once the neighbor descent is done, i.e. by the pruning and the reverse
+     * edges, so that the descent itself can run on cheaper codes.
+     */
+    void
+    SetPruneFlatten(const FlattenInterfacePtr& prune_flatten) {
+        prune_flatten_ = prune_flatten;
+    }
+
 private:
     inline float
     get_distance(uint32_t loc1, uint32_t loc2) {
+        const auto& flatten = pruning_stage_ ? prune_flatten_ : flatten_interface_;
         if (valid_ids_ != nullptr) {
-            return flatten_interface_->ComputePairVectors(valid_ids_[loc1], valid_ids_[loc2]);
+            return flatten->ComputePairVectors(valid_ids_[loc1], valid_ids_[loc2]);
         }
-        return flatten_interface_->ComputePairVectors(loc1, loc2);
+        return flatten->ComputePairVectors(loc1, loc2);
     }
 
     void
@@ -145,6 +155,9 @@ private:
     void
     prune_graph();
 
+    void
+    refine_distances();
+
 private:
     void
     parallelize_task(const std::function<void(int64_t i, int64_t end)>& task);
@@ -163,6 +176,9 @@ private:
     const ODescentParameterPtr odescent_param_;
 
     const FlattenInterfacePtr& flatten_interface_;
+
+    FlattenInterfacePtr prune_flatten_{nullptr};
+    bool pruning_stage_{false};
 };
 
 }  // namespace vsag
@@ -222,6 +222,11 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
                 if (not top_candidates->Empty()) {
                     lower_bound = top_candidates->Top().first;
                 }
+                if constexpr (mode == KNN_SEARCH) {
+                    if (top_candidates->Size() >= ef) {
+                        computer->SetDistanceBound(lower_bound);
+                    }
+                }
             }
         }
     }
@@ -367,6 +372,11 @@ BasicSearcher::search_impl(const GraphInterfacePtr& graph,
                 if (not top_candidates->Empty()) {
                     lower_bound = top_candidates->Top().first;
                 }
+                if constexpr (mode == KNN_SEARCH) {
+                    if (top_candidates->Size() >= ef) {
+                        computer->SetDistanceBound(lower_bound);
+                    }
+                }
             }
         }
     }
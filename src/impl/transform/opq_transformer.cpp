@@ -0,0 +1,314 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opq_transformer.h"
+
+#include <cblas.h>
+#include <fmt/format.h>
+#include <lapacke.h>
+
+#include <cmath>
+
+#include "impl/cluster/kmeans_cluster.h"
+#include "impl/logger/logger.h"
+#include "vsag_exception.h"
+
+namespace vsag {
+
+OPQTransformer::OPQTransformer(Allocator* allocator,
+                               int64_t dim,
+                               int64_t pq_dim,
+                               int64_t centroids_count,
+                               uint64_t train_iter)
+    : VectorTransformer(allocator, dim),
+      rotation_matrix_(allocator),
+      pq_dim_(pq_dim),
+      centroids_count_(centroids_count),
+      train_iter_(train_iter) {
+    if (pq_dim_ <= 0 or dim % pq_dim_ != 0) {
+        throw VsagException(
+            ErrorType::INVALID_ARGUMENT,
+            fmt::format("opq: pq_dim({}) does not divide evenly into dim({})", pq_dim, dim));
+    }
+    subspace_dim_ = dim / pq_dim_;
+    this->type_ = VectorTransformerType::OPQ;
+
+    // identity until trained
+    rotation_matrix_.resize(dim * dim, 0.0F);
+    for (int64_t i = 0; i < dim; ++i) {
+        rotation_matrix_[i * dim + i] = 1.0F;
+    }
+}
+
+void
+OPQTransformer::Train(const float* data, uint64_t count) {
+    count = std::min(count, MAX_TRAIN_COUNT);
+    if (count == 0) {
+        return;
+    }
+    auto dim = static_cast<uint64_t>(this->input_dim_);
+    auto centroids_count = std::min(static_cast<uint64_t>(centroids_count_), count);
+
+    if (not init_rotation(data, count)) {
+        logger::warn("opq: failed to init rotation, start from identity");
+    }
+
+    Vector<float> rotated(count * dim, 0.0F, this->allocator_);
+    Vector<float> reconstructed(count * dim, 0.0F, this->allocator_);
+    for (uint64_t iter = 0; iter < train_iter_; ++iter) {
+        // 1. rotate the training data: rotated = data * R^T
+        cblas_sgemm(CblasRowMajor,
+                    CblasNoTrans,
+                    CblasTrans,
+                    static_cast<blasint>(count),
+                    static_cast<blasint>(dim),
+                    static_cast<blasint>(dim),
+                    1.0F,
+                    data,
+                    static_cast<blasint>(dim),
+                    rotation_matrix_.data(),
+                    static_cast<blasint>(dim),
+                    0.0F,
+                    rotated.data(),
+                    static_cast<blasint>(dim));
+
+        // 2. fix R, train sub-codebooks and reconstruct the rotated data
+        quantize_subspaces(
+            rotated.data(), count, static_cast<int64_t>(centroids_count), reconstructed.data());
+
+        // 3. fix codebooks, solve R with orthogonal procrustes
+        if (not update_rotation(data, reconstructed.data(), count)) {
+            logger::warn("opq: failed to update rotation at iter {}, keep the last one", iter);
+            break;
+        }
+    }
+}
+
+bool
+OPQTransformer::init_rotation(const float* data, uint64_t count) {
+    auto dim = static_cast<uint64_t>(this->input_dim_);
+    if (count < 2) {
+        return false;
+    }
+
+    // 1. covariance of the centralized data
+    Vector<float> mean(dim, 0.0F, this->allocator_);
+    for (uint64_t i = 0; i < count; ++i) {
+        for (uint64_t j = 0; j < dim; ++j) {
+            mean[j] += data[i * dim + j];
+        }
+    }
+    for (uint64_t j = 0; j < dim; ++j) {
+        mean[j] /= static_cast<float>(count);
+    }
+    Vector<float> centralized(count * dim, 0.0F, this->allocator_);
+    for (uint64_t i = 0; i < count; ++i) {
+        for (uint64_t j = 0; j < dim; ++j) {
+            centralized[i * dim + j] = data[i * dim + j] - mean[j];
+        }
+    }
+    Vector<float> eigen_vectors(dim * dim, 0.0F, this->allocator_);
+    cblas_sgemm(CblasRowMajor,
+                CblasTrans,
+                CblasNoTrans,
+                static_cast<blasint>(dim),
+                static_cast<blasint>(dim),
+                static_cast<blasint>(count),
+                1.0F / static_cast<float>(count - 1),
+                centralized.data(),
+                static_cast<blasint>(dim),
+                centralized.data(),
+                static_cast<blasint>(dim),
+                0.0F,
+                eigen_vectors.data(),
+                static_cast<blasint>(dim));
+
+    // 2. decomposition, eigen values are in ascending order and eigen vectors are the columns
+    Vector<float> eigen_values(dim, 0.0F, this->allocator_);
+    int ssyev_result = LAPACKE_ssyev(LAPACK_ROW_MAJOR,
+                                     'V',
+                                     'U',
+                                     static_cast<blasint>(dim),
+                                     eigen_vectors.data(),
+                                     static_cast<blasint>(dim),
+                                     eigen_values.data());
+    if (ssyev_result != 0) {
+        logger::error(fmt::format("Error in ssyev: {}", ssyev_result));
+        return false;
+    }
+
+    // 3. eigenvalue allocation: from the largest, each eigen vector goes to the non-full
+    // subspace with the smallest product of eigen values so far
+    Vector<double> log_products(pq_dim_, 0.0, this->allocator_);
+    Vector<int64_t> filled(pq_dim_, 0, this->allocator_);
+    for (int64_t k = static_cast<int64_t>(dim) - 1; k >= 0; --k) {
+        int64_t best = -1;
+        for (int64_t m = 0; m < pq_dim_; ++m) {
+            if (filled[m] < subspace_dim_ and
+                (best == -1 or log_products[m] < log_products[best])) {
+                best = m;
+            }
+        }
+        log_products[best] += std::log(std::max(static_cast<double>(eigen_values[k]), 1e-10));
+        auto row = static_cast<uint64_t>(best * subspace_dim_ + filled[best]);
+        ++filled[best];
+        for (uint64_t j = 0; j < dim; ++j) {
+            rotation_matrix_[row * dim + j] = eigen_vectors[j * dim + k];
+        }
+    }
+    return true;
+}
+
+void
+OPQTransformer::quantize_subspaces(const float* rotated_data,
+                                   uint64_t count,
+                                   int64_t centroids_count,
+                                   float* reconstructed) const {
+    auto dim = static_cast<uint64_t>(this->input_dim_);
+    Vector<float> slice(count * subspace_dim_, 0.0F, this->allocator_);
+    for (int64_t m = 0; m < pq_dim_; ++m) {
+        for (uint64_t i = 0; i < count; ++i) {
+            memcpy(slice.data() + i * subspace_dim_,
+                   rotated_data + i * dim + m * subspace_dim_,
+                   subspace_dim_ * sizeof(float));
+        }
+        KMeansCluster cluster(static_cast<int32_t>(subspace_dim_), this->allocator_);
+        auto labels = cluster.Run(
+            static_cast<uint32_t>(centroids_count), slice.data(), count, KMEANS_ITER);
+        for (uint64_t i = 0; i < count; ++i) {
+            memcpy(reconstructed + i * dim + m * subspace_dim_,
+                   cluster.k_centroids_ + static_cast<uint64_t>(labels[i]) * subspace_dim_,
+                   subspace_dim_ * sizeof(float));
+        }
+    }
+}
+
+bool
+OPQTransformer::update_rotation(const float* data, const float* reconstructed, uint64_t count) {
+    // minimize ||data * R^T - reconstructed||: with data^T * reconstructed = U * S * V^T,
+    // the optimal orthogonal R is V * U^T
+    auto dim = static_cast<blasint>(this->input_dim_);
+    Vector<float> cross(dim * dim, 0.0F, this->allocator_);
+    cblas_sgemm(CblasRowMajor,
+                CblasTrans,
+                CblasNoTrans,
+                dim,
+                dim,
+                static_cast<blasint>(count),
+                1.0F,
+                data,
+                dim,
+                reconstructed,
+                dim,
+                0.0F,
+                cross.data(),
+                dim);
+
+    Vector<float> singular_values(dim, 0.0F, this->allocator_);
+    Vector<float> u(dim * dim, 0.0F, this->allocator_);
+    Vector<float> vt(dim * dim, 0.0F, this->allocator_);
+    Vector<float> superb(dim, 0.0F, this->allocator_);
+    int sgesvd_result = LAPACKE_sgesvd(LAPACK_ROW_MAJOR,
+                                       'A',
+                                       'A',
+                                       dim,
+                                       dim,
+                                       cross.data(),
+                                       dim,
+                                       singular_values.data(),
+                                       u.data(),
+                                       dim,
+                                       vt.data(),
+                                       dim,
+                                       superb.data());
+    if (sgesvd_result != 0) {
+        logger::error(fmt::format("Error in sgesvd: {}", sgesvd_result));
+        return false;
+    }
+
+    // R = V * U^T = (V^T)^T * U^T
+    cblas_sgemm(CblasRowMajor,
+                CblasTrans,
+                CblasTrans,
+                dim,
+                dim,
+                dim,
+                1.0F,
+                vt.data(),
+                dim,
+                u.data(),
+                dim,
+                0.0F,
+                rotation_matrix_.data(),
+                dim);
+    return true;
+}
+
+void
+OPQTransformer::CopyRotationMatrix(float* out_matrix) const {
+    std::copy(rotation_matrix_.data(),
+              rotation_matrix_.data() + this->input_dim_ * this->output_dim_,
+              out_matrix);
+}
+
+TransformerMetaPtr
+OPQTransformer::Transform(const float* original_vec, float* transformed_vec) const {
+    auto meta = std::make_shared<OPQMeta>();
+    // perform matrix-vector multiplication: y = R * x
+    auto dim = static_cast<blasint>(this->input_dim_);
+    cblas_sgemv(CblasRowMajor,
+                CblasNoTrans,
+                dim,
+                dim,
+                1.0F,
+                rotation_matrix_.data(),
+                dim,
+                original_vec,
+                1,
+                0.0F,
+                transformed_vec,
+                1);
+    return meta;
+}
+
+void
+OPQTransformer::InverseTransform(const float* transformed_vec, float* original_vec) const {
+    // perform matrix-vector multiplication: x = R^T * y
+    auto dim = static_cast<blasint>(this->input_dim_);
+    cblas_sgemv(CblasRowMajor,
+                CblasTrans,
+                dim,
+                dim,
+                1.0F,
+                rotation_matrix_.data(),
+                dim,
+                transformed_vec,
+                1,
+                0.0F,
+                original_vec,
+                1);
+}
+
+void
+OPQTransformer::Serialize(StreamWriter& writer) const {
+    StreamWriter::WriteVector(writer, this->rotation_matrix_);
+}
+
+void
+OPQTransformer::Deserialize(StreamReader& reader) {
+    StreamReader::ReadVector(reader, this->rotation_matrix_);
+}
+
+}  // namespace vsag
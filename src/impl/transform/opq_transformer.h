@@ -0,0 +1,91 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "vector_transformer.h"
+
+namespace vsag {
+
+struct OPQMeta : public TransformerMeta {};
+
+/** Implement of OPQ (Optimized Product Quantization) rotation, non-parametric version
+ *
+ *  Learns an orthogonal matrix R that minimizes the PQ distortion of R * x. R starts from the
+ *  parametric solution (PCA eigenvectors allocated to subspaces so that the products of their
+ *  eigenvalues are balanced), then alternates between training sub-codebooks on the rotated data
+ *  and solving the orthogonal Procrustes problem of the rotation against the reconstructed data.
+ *
+ *  Reference:
+ *  [1] Tiezheng Ge, Kaiming He, Qifa Ke, Jian Sun. 2013. Optimized Product Quantization for Approximate Nearest Neighbor Search. CVPR 2013.
+ */
+class OPQTransformer : public VectorTransformer {
+public:
+    explicit OPQTransformer(Allocator* allocator,
+                            int64_t dim,
+                            int64_t pq_dim,
+                            int64_t centroids_count = DEFAULT_CENTROIDS_COUNT,
+                            uint64_t train_iter = DEFAULT_TRAIN_ITER);
+
+    ~OPQTransformer() override = default;
+
+    TransformerMetaPtr
+    Transform(const float* original_vec, float* transformed_vec) const override;
+
+    void
+    InverseTransform(const float* transformed_vec, float* original_vec) const override;
+
+    void
+    Serialize(StreamWriter& writer) const override;
+
+    void
+    Deserialize(StreamReader& reader) override;
+
+    void
+    Train(const float* data, uint64_t count) override;
+
+public:
+    void
+    CopyRotationMatrix(float* out_matrix) const;
+
+public:
+    static constexpr int64_t DEFAULT_CENTROIDS_COUNT = 256;
+    static constexpr uint64_t DEFAULT_TRAIN_ITER = 8;
+    static constexpr uint64_t KMEANS_ITER = 10;
+    static constexpr uint64_t MAX_TRAIN_COUNT = 65536;
+
+private:
+    bool
+    init_rotation(const float* data, uint64_t count);
+
+    void
+    quantize_subspaces(const float* rotated_data,
+                       uint64_t count,
+                       int64_t centroids_count,
+                       float* reconstructed) const;
+
+    bool
+    update_rotation(const float* data, const float* reconstructed, uint64_t count);
+
+private:
+    Vector<float> rotation_matrix_;
+
+    const int64_t pq_dim_{1};
+    int64_t subspace_dim_{0};
+    const int64_t centroids_count_{DEFAULT_CENTROIDS_COUNT};
+    const uint64_t train_iter_{DEFAULT_TRAIN_ITER};
+};
+
+}  // namespace vsag
@@ -0,0 +1,143 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "opq_transformer.h"
+
+#include <cblas.h>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "fixtures.h"
+#include "impl/allocator/safe_allocator.h"
+#include "quantization/product_quantization/product_quantizer.h"
+#include "storage/serialization_template_test.h"
+
+using namespace vsag;
+
+static std::vector<float>
+generate_skewed_vectors(uint64_t count, uint64_t dim) {
+    // most of the variance lies in the first quarter of dims, which plain pq handles badly
+    auto vecs = fixtures::generate_vectors(count, dim, false);
+    for (uint64_t i = 0; i < count; ++i) {
+        for (uint64_t d = 0; d < dim / 4; ++d) {
+            vecs[i * dim + d] *= 10.0F;
+        }
+    }
+    return vecs;
+}
+
+static double
+pq_reconstruct_error(const std::vector<float>& vecs, uint64_t dim, uint64_t count, int64_t pq_dim) {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    ProductQuantizer<MetricType::METRIC_TYPE_L2SQR> pq(dim, pq_dim, allocator.get());
+    pq.Train(vecs.data(), count);
+    std::vector<uint8_t> codes(pq.GetCodeSize());
+    std::vector<float> decoded(dim);
+    double error = 0.0;
+    for (uint64_t i = 0; i < count; ++i) {
+        pq.EncodeOne(vecs.data() + i * dim, codes.data());
+        pq.DecodeOne(codes.data(), decoded.data());
+        for (uint64_t d = 0; d < dim; ++d) {
+            double diff = decoded[d] - vecs[i * dim + d];
+            error += diff * diff;
+        }
+    }
+    return error / static_cast<double>(count);
+}
+
+static void
+TestOrthogonality(const OPQTransformer& opq, uint64_t dim) {
+    std::vector<float> rotation(dim * dim);
+    opq.CopyRotationMatrix(rotation.data());
+
+    std::vector<float> result(dim * dim, 0.0F);
+    cblas_sgemm(CblasRowMajor,
+                CblasNoTrans,
+                CblasTrans,
+                dim,
+                dim,
+                dim,
+                1.0F,
+                rotation.data(),
+                dim,
+                rotation.data(),
+                dim,
+                0.0F,
+                result.data(),
+                dim);
+    for (uint64_t i = 0; i < dim; ++i) {
+        for (uint64_t j = 0; j < dim; ++j) {
+            float expected = (i == j) ? 1.0F : 0.0F;
+            REQUIRE(std::fabs(result[i * dim + j] - expected) < 1e-3);
+        }
+    }
+}
+
+TEST_CASE("OPQ Transformer Basic Test", "[ut][OPQTransformer]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint64_t dim = 64;
+    uint64_t count = 1000;
+    int64_t pq_dim = 8;
+    auto vecs = generate_skewed_vectors(count, dim);
+
+    REQUIRE_THROWS(OPQTransformer(allocator.get(), dim, 7));
+
+    OPQTransformer opq(allocator.get(), dim, pq_dim, 16, 4);
+    REQUIRE(opq.GetType() == VectorTransformerType::OPQ);
+    opq.Train(vecs.data(), count);
+    TestOrthogonality(opq, dim);
+
+    // rotation preserves the length and can be inverted
+    std::vector<float> transformed(dim);
+    std::vector<float> recovered(dim);
+    opq.Transform(vecs.data(), transformed.data());
+    opq.InverseTransform(transformed.data(), recovered.data());
+    float original_length = 0.0F;
+    float transformed_length = 0.0F;
+    for (uint64_t d = 0; d < dim; ++d) {
+        original_length += vecs[d] * vecs[d];
+        transformed_length += transformed[d] * transformed[d];
+        REQUIRE(std::fabs(recovered[d] - vecs[d]) < 1e-3);
+    }
+    REQUIRE(std::fabs(original_length - transformed_length) < 1e-2 * original_length);
+
+    // serialize
+    OPQTransformer opq2(allocator.get(), dim, pq_dim, 16, 4);
+    test_serializion(opq, opq2);
+    std::vector<float> transformed2(dim);
+    opq2.Transform(vecs.data(), transformed2.data());
+    for (uint64_t d = 0; d < dim; ++d) {
+        REQUIRE(std::fabs(transformed[d] - transformed2[d]) < 1e-5);
+    }
+}
+
+TEST_CASE("OPQ Transformer Reduces PQ Error", "[ut][OPQTransformer]") {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    uint64_t dim = 64;
+    uint64_t count = 2000;
+    int64_t pq_dim = 8;
+    auto vecs = generate_skewed_vectors(count, dim);
+
+    OPQTransformer opq(allocator.get(), dim, pq_dim);
+    opq.Train(vecs.data(), count);
+    std::vector<float> rotated(count * dim);
+    for (uint64_t i = 0; i < count; ++i) {
+        opq.Transform(vecs.data() + i * dim, rotated.data() + i * dim);
+    }
+
+    auto raw_error = pq_reconstruct_error(vecs, dim, count, pq_dim);
+    auto opq_error = pq_reconstruct_error(rotated, dim, count, pq_dim);
+    REQUIRE(opq_error < 0.5 * raw_error);
+}
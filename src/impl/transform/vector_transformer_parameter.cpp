@@ -28,6 +28,15 @@ VectorTransformerParameter::FromJson(const JsonType& json) {
     if (json.Contains(PCA_DIM_KEY)) {
         pca_dim_ = json[PCA_DIM_KEY].GetInt();
     }
+
+    // opq learns the rotation for the pq (or pqfs) quantizer at the bottom of the chain
+    if (json.Contains(PRODUCT_QUANTIZATION_DIM_KEY)) {
+        pq_dim_ = json[PRODUCT_QUANTIZATION_DIM_KEY].GetInt();
+    }
+    if (json.Contains(TYPE_KEY) and
+        json[TYPE_KEY].GetString() == QUANTIZATION_TYPE_VALUE_PQFS) {
+        pq_centroids_count_ = 16;
+    }
 }
 
 JsonType
@@ -35,6 +44,7 @@ VectorTransformerParameter::ToJson() const {
     JsonType json;
     json[PCA_DIM_KEY].SetInt(pca_dim_);
     json[INPUT_DIM_KEY].SetInt(input_dim_);
+    json[PRODUCT_QUANTIZATION_DIM_KEY].SetInt(pq_dim_);
     return json;
 }
 
@@ -53,6 +63,9 @@ VectorTransformerParameter::CheckCompatibility(const ParamPtr& other) const {
     if (input_dim_ != param->input_dim_) {
         return false;
     }
+    if (pq_dim_ != param->pq_dim_) {
+        return false;
+    }
     return true;
 }
 
@@ -37,6 +37,8 @@ public:
 public:
     uint32_t input_dim_;
     uint32_t pca_dim_;
+    uint32_t pq_dim_{0};
+    uint32_t pq_centroids_count_{256};
 };
 
 }  // namespace vsag
@@ -41,12 +41,14 @@ TEST_CASE("Transformer Parameter CheckCompatibility", "[ut][VectorTransformerPar
     constexpr static const char* param_template = R"(
         {{
             "input_dim": {},
-            "pca_dim": {}
+            "pca_dim": {},
+            "pq_dim": {}
         }}
     )";
-    auto param_960_480 = fmt::format(param_template, 960, 480);
-    auto param_959_480 = fmt::format(param_template, 959, 480);
-    auto param_960_959 = fmt::format(param_template, 960, 959);
+    auto param_960_480 = fmt::format(param_template, 960, 480, 0);
+    auto param_959_480 = fmt::format(param_template, 959, 480, 0);
+    auto param_960_959 = fmt::format(param_template, 960, 959, 0);
+    auto param_960_480_pq = fmt::format(param_template, 960, 480, 240);
 
     SECTION("wrong parameter type") {
         auto param = std::make_shared<vsag::VectorTransformerParameter>();
@@ -57,6 +59,7 @@ TEST_CASE("Transformer Parameter CheckCompatibility", "[ut][VectorTransformerPar
 
     TEST_COMPATIBILITY_CASE("different pca_dim", param_960_480, param_960_959, false);
     TEST_COMPATIBILITY_CASE("different input_dim", param_960_480, param_959_480, false);
+    TEST_COMPATIBILITY_CASE("different pq_dim", param_960_480, param_960_480_pq, false);
     TEST_COMPATIBILITY_CASE("same", param_960_480, param_960_480, true);
 }
 
@@ -64,12 +67,15 @@ TEST_CASE("Transformer Parameter ToJson Test", "[ut][VectorTransformerParameter]
     std::string param_str = R"(
         {
             "input_dim": 960,
-            "pca_dim": 480
+            "pca_dim": 480,
+            "pq_dim": 240
         }
     )";
     auto param = std::make_shared<VectorTransformerParameter>();
     param->FromJson(JsonType::Parse(param_str));
     REQUIRE(param->input_dim_ == 960);
     REQUIRE(param->pca_dim_ == 480);
+    REQUIRE(param->pq_dim_ == 240);
+    REQUIRE(param->pq_centroids_count_ == 256);
     ParameterTest::TestToJson(param);
 }
\ No newline at end of file
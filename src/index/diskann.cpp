@@ -24,6 +24,7 @@
 #include <new>
 #include <nlohmann/json.hpp>
 #include <stdexcept>
+#include <streambuf>
 #include <utility>
 
 #include "datacell/flatten_datacell.h"
@@ -77,19 +78,21 @@ from_binary(const Binary& binary) {
 
 class LocalMemoryReader : public Reader {
 public:
-    LocalMemoryReader(std::stringstream& file) {
-        file_ << file.rdbuf();
-        file_.seekg(0, std::ios::end);
-        size_ = file_.tellg();
+    explicit LocalMemoryReader(Binary binary) : binary_(std::move(binary)) {
     }
 
     ~LocalMemoryReader() override = default;
 
     void
     Read(uint64_t offset, uint64_t len, void* dest) override {
-        std::lock_guard<std::mutex> lock(mutex_);
-        file_.seekg(static_cast<int64_t>(offset), std::ios::beg);
-        file_.read((char*)dest, static_cast<int64_t>(len));
+        if (offset + len > binary_.size) {
+            throw std::runtime_error(
+                fmt::format("read out of range: offset({}) + len({}) > size({})",
+                            offset,
+                            len,
+                            binary_.size));
+        }
+        std::memcpy(dest, binary_.data.get() + offset, len);
     }
 
     void
@@ -109,13 +112,11 @@ public:
 
     uint64_t
     Size() const override {
-        return size_;
+        return binary_.size;
     }
 
 private:
-    std::stringstream file_;
-    uint64_t size_;
-    std::mutex mutex_;
+    Binary binary_;
     std::shared_ptr<SafeThreadPool> pool_;
 };
 
@@ -152,6 +153,112 @@ private:
     std::mutex mutex_;
 };
 
+// read-only streambuf that pulls bytes from a Reader on demand, so diskann can parse a
+// component straight from its source without staging the whole file in a stringstream
+class ReaderStreamBuf : public std::streambuf {
+public:
+    explicit ReaderStreamBuf(std::shared_ptr<Reader> reader, uint64_t buffer_size = 1024 * 1024)
+        : reader_(std::move(reader)),
+          size_(reader_->Size()),
+          buffer_(std::max<uint64_t>(std::min(buffer_size, size_), 1)) {
+    }
+
+protected:
+    int_type
+    underflow() override {
+        if (gptr() < egptr()) {
+            return traits_type::to_int_type(*gptr());
+        }
+        if (pos_ >= size_) {
+            return traits_type::eof();
+        }
+        auto len = std::min<uint64_t>(buffer_.size(), size_ - pos_);
+        reader_->Read(pos_, len, buffer_.data());
+        pos_ += len;
+        setg(buffer_.data(), buffer_.data(), buffer_.data() + len);
+        return traits_type::to_int_type(*gptr());
+    }
+
+    std::streamsize
+    xsgetn(char* dest, std::streamsize count) override {
+        std::streamsize done = 0;
+        while (done < count) {
+            if (gptr() == egptr()) {
+                auto remain = static_cast<uint64_t>(count - done);
+                if (remain >= buffer_.size()) {
+                    // large reads bypass the buffer and land directly in the destination
+                    auto len = std::min(remain, size_ - pos_);
+                    if (len > 0) {
+                        reader_->Read(pos_, len, dest + done);
+                        pos_ += len;
+                        done += static_cast<std::streamsize>(len);
+                    }
+                    break;
+                }
+                if (traits_type::eq_int_type(underflow(), traits_type::eof())) {
+                    break;
+                }
+            }
+            auto len = std::min<std::streamsize>(egptr() - gptr(), count - done);
+            std::memcpy(dest + done, gptr(), len);
+            gbump(static_cast<int>(len));
+            done += len;
+        }
+        return done;
+    }
+
+    pos_type
+    seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override {
+        off_type base = 0;
+        if (dir == std::ios_base::cur) {
+            base = static_cast<off_type>(pos_) - (egptr() - gptr());
+        } else if (dir == std::ios_base::end) {
+            base = static_cast<off_type>(size_);
+        }
+        return seekpos(pos_type(base + off), which);
+    }
+
+    pos_type
+    seekpos(pos_type pos, std::ios_base::openmode which) override {
+        auto target = static_cast<off_type>(pos);
+        if ((which & std::ios_base::in) == 0 or target < 0 or
+            target > static_cast<off_type>(size_)) {
+            return pos_type(off_type(-1));
+        }
+        setg(nullptr, nullptr, nullptr);
+        pos_ = static_cast<uint64_t>(target);
+        return pos;
+    }
+
+private:
+    std::shared_ptr<Reader> reader_;
+    uint64_t size_{0};
+    uint64_t pos_{0};
+    std::vector<char> buffer_;
+};
+
+void
+load_pq_and_tags(diskann::PQFlashIndex<float, int64_t>& index,
+                 const std::shared_ptr<Reader>& pq_reader,
+                 const std::shared_ptr<Reader>& compressed_vector_reader,
+                 const std::shared_ptr<Reader>& tag_reader) {
+    ReaderStreamBuf pq_buf(pq_reader);
+    ReaderStreamBuf compressed_vector_buf(compressed_vector_reader);
+    ReaderStreamBuf tag_buf(tag_reader);
+    std::istream pq_stream(&pq_buf);
+    std::istream compressed_vector_stream(&compressed_vector_buf);
+    std::istream tag_stream(&tag_buf);
+    index.load_from_separate_paths(pq_stream, compressed_vector_stream, tag_stream);
+}
+
+void
+load_graph_from_reader(diskann::PQFlashIndex<float, int64_t>& index,
+                       const std::shared_ptr<Reader>& reader) {
+    ReaderStreamBuf graph_buf(reader);
+    std::istream graph_stream(&graph_buf);
+    index.load_graph(graph_stream);
+}
+
 uint64_t
 get_stringstream_size(const std::stringstream& stream) {
     std::streambuf* buf = stream.rdbuf();
@@ -174,6 +281,13 @@ convert_stream_to_binary(const std::stringstream& stream) {
     return std::move(binary);
 }
 
+Binary
+release_stream_to_binary(std::stringstream& stream) {
+    auto binary = convert_stream_to_binary(stream);
+    std::stringstream().swap(stream);  // str("") would keep the capacity around
+    return binary;
+}
+
 void
 convert_binary_to_stream(const Binary& binary, std::stringstream& stream) {
     stream.str("");
@@ -182,42 +296,6 @@ convert_binary_to_stream(const Binary& binary, std::stringstream& stream) {
     }
 }
 
-void
-copy_istream_to_stringstream(std::stringstream& to, std::istream& from, uint64_t size) {
-    uint64_t done_size = 0;
-
-    const int32_t buffer_size = 1024;
-    char buffer[buffer_size] = {};
-
-    while (done_size < size) {
-        auto remain = size - done_size;
-        auto copy_size =
-            static_cast<std::streamsize>(remain / buffer_size > 0 ? buffer_size : remain);
-        from.read(buffer, copy_size);
-        to.write(buffer, copy_size);
-
-        done_size += copy_size;
-    }
-}
-
-void
-copy_stringstream_to_ostream(std::ostream& to, std::stringstream& from, uint64_t size) {
-    uint64_t done_size = 0;
-
-    const int32_t buffer_size = 1024;
-    char buffer[buffer_size] = {};
-
-    while (done_size < size) {
-        auto remain = size - done_size;
-        auto copy_size =
-            static_cast<std::streamsize>(remain / buffer_size > 0 ? buffer_size : remain);
-        from.read(buffer, copy_size);
-        to.write(buffer, copy_size);
-
-        done_size += copy_size;
-    }
-}
-
 DiskANN::DiskANN(DiskannParameters& diskann_params, const IndexCommonParam& index_common_param)
     : metric_(diskann_params.metric),
       L_(static_cast<int32_t>(diskann_params.ef_construction)),
@@ -304,6 +382,8 @@ DiskANN::build(const DatasetPtr& base) {
         auto data_num = base->GetNumElements();
 
         std::vector<size_t> failed_locs;
+        std::stringstream graph_stream;
+        std::stringstream tag_stream;
         if (diskann_params_.graph_type == GRAPH_TYPE_ODESCENT) {
             SlowTaskTimer t("odescent build full (graph)");
             FlattenDataCellParamPtr flatten_param =
@@ -324,12 +404,12 @@ DiskANN::build(const DatasetPtr& base) {
                                  common_param_.allocator_.get(),
                                  common_param_.thread_pool_.get());
             graph.Build();
-            graph.SaveGraph(graph_stream_);
+            graph.SaveGraph(graph_stream);
             auto data_num_int32 = static_cast<int32_t>(data_num);
             auto data_dim_int32 = static_cast<int32_t>(data_dim);
-            tag_stream_.write((char*)&data_num_int32, sizeof(data_num_int32));
-            tag_stream_.write((char*)&data_dim_int32, sizeof(data_dim_int32));
-            tag_stream_.write((char*)ids, static_cast<std::streamsize>(data_num * sizeof(ids)));
+            tag_stream.write((char*)&data_num_int32, sizeof(data_num_int32));
+            tag_stream.write((char*)&data_dim_int32, sizeof(data_dim_int32));
+            tag_stream.write((char*)ids, static_cast<std::streamsize>(data_num * sizeof(ids)));
         } else if (diskann_params_.graph_type == DISKANN_GRAPH_TYPE_VAMANA) {
             SlowTaskTimer t("diskann build full (graph)");
             // build graph
@@ -342,33 +422,34 @@ DiskANN::build(const DatasetPtr& base) {
                     .build();
             failed_locs =
                 build_index_->build(vectors, data_num, index_build_params, tags, use_reference_);
-            build_index_->save(graph_stream_, tag_stream_);
+            build_index_->save(graph_stream, tag_stream);
             build_index_.reset();
         }
+        // every component is moved into a Binary as soon as it is complete, so no stream
+        // outlives its build step and the index holds exactly one copy of each file
+        graph_binary_ = release_stream_to_binary(graph_stream);
+        tag_binary_ = release_stream_to_binary(tag_stream);
         {
             SlowTaskTimer t("diskann build full (pq)");
+            std::stringstream pq_pivots_stream;
+            std::stringstream disk_pq_compressed_vectors;
             diskann::generate_disk_quantized_data<float>(vectors,
                                                          data_num,
                                                          data_dim,
                                                          failed_locs,
-                                                         pq_pivots_stream_,
-                                                         disk_pq_compressed_vectors_,
+                                                         pq_pivots_stream,
+                                                         disk_pq_compressed_vectors,
                                                          metric_,
                                                          p_val_,
                                                          disk_pq_dims_,
                                                          use_opq_,
                                                          use_bsa_);
+            pq_pivots_binary_ = release_stream_to_binary(pq_pivots_stream);
+            disk_pq_compressed_vectors_ = release_stream_to_binary(disk_pq_compressed_vectors);
         }
         {
             SlowTaskTimer t("diskann build full (disk layout)");
-            diskann::create_disk_layout<float>(vectors,
-                                               data_num,
-                                               data_dim,
-                                               failed_locs,
-                                               graph_stream_,
-                                               disk_layout_stream_,
-                                               sector_len_,
-                                               metric_);
+            build_disk_layout(vectors, data_num, failed_locs);
         }
 
         std::vector<int64_t> failed_ids;
@@ -377,17 +458,7 @@ DiskANN::build(const DatasetPtr& base) {
                        std::back_inserter(failed_ids),
                        [&ids](const auto& index) { return ids[index]; });
 
-        disk_layout_reader_ = std::make_shared<LocalMemoryReader>(disk_layout_stream_);
-        reader_.reset(new LocalFileReader(batch_read_));
-        index_.reset(new diskann::PQFlashIndex<float, int64_t>(
-            reader_, metric_, sector_len_, dim_, use_bsa_));
-        index_->load_from_separate_paths(
-            pq_pivots_stream_, disk_pq_compressed_vectors_, tag_stream_);
-        if (preload_) {
-            index_->load_graph(graph_stream_);
-        } else {
-            graph_stream_.clear();
-        }
+        load_disk_index();
         status_ = IndexStatus::MEMORY;
         return failed_ids;
     } catch (const std::invalid_argument& e) {
@@ -721,12 +792,12 @@ DiskANN::serialize() const {
         std::shared_lock lock(rw_mutex_);
         BinarySet bs;
 
-        bs.Set(DISKANN_PQ, convert_stream_to_binary(pq_pivots_stream_));
-        bs.Set(DISKANN_COMPRESSED_VECTOR, convert_stream_to_binary(disk_pq_compressed_vectors_));
-        bs.Set(DISKANN_LAYOUT_FILE, convert_stream_to_binary(disk_layout_stream_));
-        bs.Set(DISKANN_TAG_FILE, convert_stream_to_binary(tag_stream_));
+        bs.Set(DISKANN_PQ, pq_pivots_binary_);
+        bs.Set(DISKANN_COMPRESSED_VECTOR, disk_pq_compressed_vectors_);
+        bs.Set(DISKANN_LAYOUT_FILE, disk_layout_binary_);
+        bs.Set(DISKANN_TAG_FILE, tag_binary_);
         if (preload_) {
-            bs.Set(DISKANN_GRAPH, convert_stream_to_binary(graph_stream_));
+            bs.Set(DISKANN_GRAPH, graph_binary_);
             metadata->Set("support_preload", true);
         }
 
@@ -769,7 +840,6 @@ DiskANN::deserialize(const BinarySet& binary_set) {
             return {};
         }
 
-        convert_binary_to_stream(binary_set.Get(DISKANN_LAYOUT_FILE), disk_layout_stream_);
         auto graph = binary_set.Get(DISKANN_GRAPH);
         if (/* trying to use graph-preload mode if parameter sets */ preload_) {
             if (not metadata->Get("support_preload").GetBool()) {
@@ -777,12 +847,14 @@ DiskANN::deserialize(const BinarySet& binary_set) {
                     ErrorType::MISSING_FILE,
                     fmt::format("missing file: {} when deserialize diskann index", DISKANN_GRAPH));
             }
-            convert_binary_to_stream(graph, graph_stream_);
+            graph_binary_ = graph;
         } else if (/* not use graph-preload mode, but contains */ graph.data) {
             logger::warn("serialize without using file: {} ", DISKANN_GRAPH);
         }
 
-        load_disk_index(binary_set);
+        disk_layout_binary_ = binary_set.Get(DISKANN_LAYOUT_FILE);
+        take_binaries(binary_set);
+        load_disk_index();
         status_ = IndexStatus::MEMORY;
 
         return {};
@@ -797,11 +869,10 @@ DiskANN::deserialize(const BinarySet& binary_set) {
         return {};
     }
 
-    convert_binary_to_stream(binary_set.Get(DISKANN_LAYOUT_FILE), disk_layout_stream_);
     auto graph = binary_set.Get(DISKANN_GRAPH);
     if (preload_) {
         if (graph.data) {
-            convert_binary_to_stream(graph, graph_stream_);
+            graph_binary_ = graph;
         } else {
             LOG_ERROR_AND_RETURNS(
                 ErrorType::MISSING_FILE,
@@ -812,7 +883,9 @@ DiskANN::deserialize(const BinarySet& binary_set) {
             logger::warn("serialize without using file: {} ", DISKANN_GRAPH);
         }
     }
-    load_disk_index(binary_set);
+    disk_layout_binary_ = binary_set.Get(DISKANN_LAYOUT_FILE);
+    take_binaries(binary_set);
+    load_disk_index();
     status_ = IndexStatus::MEMORY;
 
     return {};
@@ -840,44 +913,14 @@ DiskANN::deserialize(const ReaderSet& reader_set) {
             return {};
         }
 
-        std::stringstream pq_pivots_stream;
-        std::stringstream disk_pq_compressed_vectors;
-        std::stringstream graph;
-        std::stringstream tag_stream;
-
-        {
-            auto pq_reader = reader_set.Get(DISKANN_PQ);
-            auto pq_pivots_data = std::make_unique<char[]>(pq_reader->Size());
-            pq_reader->Read(0, pq_reader->Size(), pq_pivots_data.get());
-            pq_pivots_stream.write(pq_pivots_data.get(), static_cast<int64_t>(pq_reader->Size()));
-            pq_pivots_stream.seekg(0);
-        }
-
-        {
-            auto compressed_vector_reader = reader_set.Get(DISKANN_COMPRESSED_VECTOR);
-            auto compressed_vector_data =
-                std::make_unique<char[]>(compressed_vector_reader->Size());
-            compressed_vector_reader->Read(
-                0, compressed_vector_reader->Size(), compressed_vector_data.get());
-            disk_pq_compressed_vectors.write(
-                compressed_vector_data.get(),
-                static_cast<int64_t>(compressed_vector_reader->Size()));
-            disk_pq_compressed_vectors.seekg(0);
-        }
-
-        {
-            auto tag_reader = reader_set.Get(DISKANN_TAG_FILE);
-            auto tag_data = std::make_unique<char[]>(tag_reader->Size());
-            tag_reader->Read(0, tag_reader->Size(), tag_data.get());
-            tag_stream.write(tag_data.get(), static_cast<int64_t>(tag_reader->Size()));
-            tag_stream.seekg(0);
-        }
-
         disk_layout_reader_ = reader_set.Get(DISKANN_LAYOUT_FILE);
         reader_.reset(new LocalFileReader(batch_read_));
         index_.reset(new diskann::PQFlashIndex<float, int64_t>(
             reader_, metric_, sector_len_, dim_, use_bsa_));
-        index_->load_from_separate_paths(pq_pivots_stream, disk_pq_compressed_vectors, tag_stream);
+        load_pq_and_tags(*index_,
+                         reader_set.Get(DISKANN_PQ),
+                         reader_set.Get(DISKANN_COMPRESSED_VECTOR),
+                         reader_set.Get(DISKANN_TAG_FILE));
 
         auto graph_reader = reader_set.Get(DISKANN_GRAPH);
         if (/* trying to use graph-preload mode, if parameter sets */ preload_) {
@@ -886,11 +929,7 @@ DiskANN::deserialize(const ReaderSet& reader_set) {
                     ErrorType::MISSING_FILE,
                     fmt::format("miss file: {} when deserialize diskann index", DISKANN_GRAPH));
             }
-            auto graph_data = std::make_unique<char[]>(graph_reader->Size());
-            graph_reader->Read(0, graph_reader->Size(), graph_data.get());
-            graph.write(graph_data.get(), static_cast<int64_t>(graph_reader->Size()));
-            graph.seekg(0);
-            index_->load_graph(graph);
+            load_graph_from_reader(*index_, graph_reader);
         } else if (/* not use graph-preload mode, but contains */ graph_reader) {
             logger::warn("serialize without using file: {} ", DISKANN_GRAPH);
         }
@@ -908,51 +947,19 @@ DiskANN::deserialize(const ReaderSet& reader_set) {
         return {};
     }
 
-    std::stringstream pq_pivots_stream;
-    std::stringstream disk_pq_compressed_vectors;
-    std::stringstream graph;
-    std::stringstream tag_stream;
-
-    {
-        auto pq_reader = reader_set.Get(DISKANN_PQ);
-        auto pq_pivots_data = std::make_unique<char[]>(pq_reader->Size());
-        pq_reader->Read(0, pq_reader->Size(), pq_pivots_data.get());
-        pq_pivots_stream.write(pq_pivots_data.get(), static_cast<int64_t>(pq_reader->Size()));
-        pq_pivots_stream.seekg(0);
-    }
-
-    {
-        auto compressed_vector_reader = reader_set.Get(DISKANN_COMPRESSED_VECTOR);
-        auto compressed_vector_data = std::make_unique<char[]>(compressed_vector_reader->Size());
-        compressed_vector_reader->Read(
-            0, compressed_vector_reader->Size(), compressed_vector_data.get());
-        disk_pq_compressed_vectors.write(compressed_vector_data.get(),
-                                         static_cast<int64_t>(compressed_vector_reader->Size()));
-        disk_pq_compressed_vectors.seekg(0);
-    }
-
-    {
-        auto tag_reader = reader_set.Get(DISKANN_TAG_FILE);
-        auto tag_data = std::make_unique<char[]>(tag_reader->Size());
-        tag_reader->Read(0, tag_reader->Size(), tag_data.get());
-        tag_stream.write(tag_data.get(), static_cast<int64_t>(tag_reader->Size()));
-        tag_stream.seekg(0);
-    }
-
     disk_layout_reader_ = reader_set.Get(DISKANN_LAYOUT_FILE);
     reader_.reset(new LocalFileReader(batch_read_));
     index_.reset(
         new diskann::PQFlashIndex<float, int64_t>(reader_, metric_, sector_len_, dim_, use_bsa_));
-    index_->load_from_separate_paths(pq_pivots_stream, disk_pq_compressed_vectors, tag_stream);
+    load_pq_and_tags(*index_,
+                     reader_set.Get(DISKANN_PQ),
+                     reader_set.Get(DISKANN_COMPRESSED_VECTOR),
+                     reader_set.Get(DISKANN_TAG_FILE));
 
     auto graph_reader = reader_set.Get(DISKANN_GRAPH);
     if (preload_) {
         if (graph_reader) {
-            auto graph_data = std::make_unique<char[]>(graph_reader->Size());
-            graph_reader->Read(0, graph_reader->Size(), graph_data.get());
-            graph.write(graph_data.get(), static_cast<int64_t>(graph_reader->Size()));
-            graph.seekg(0);
-            index_->load_graph(graph);
+            load_graph_from_reader(*index_, graph_reader);
         } else {
             LOG_ERROR_AND_RETURNS(
                 ErrorType::MISSING_FILE,
@@ -976,12 +983,12 @@ DiskANN::deserialize(const ReaderSet& reader_set) {
         return {};                                        \
     }
 
-#define WRITE_DATACELL_WITH_NAME(out_stream, name, datacell_stream)                    \
+#define WRITE_DATACELL_WITH_NAME(out_stream, name, datacell_binary)                    \
     datacell_offsets[(name)].SetInt(offset);                                           \
-    auto datacell_stream##_size = get_stringstream_size((datacell_stream));            \
-    datacell_sizes[(name)].SetInt(datacell_stream##_size);                             \
-    copy_stringstream_to_ostream(out_stream, datacell_stream, datacell_stream##_size); \
-    offset += datacell_stream##_size;
+    datacell_sizes[(name)].SetInt((datacell_binary).size);                             \
+    (out_stream).write(reinterpret_cast<const char*>((datacell_binary).data.get()),    \
+                       static_cast<std::streamsize>((datacell_binary).size));          \
+    offset += (datacell_binary).size;
 
 tl::expected<void, Error>
 DiskANN::serialize(std::ostream& out_stream) {
@@ -1000,13 +1007,13 @@ DiskANN::serialize(std::ostream& out_stream) {
     JsonType datacell_sizes;
     uint64_t offset = 0;
 
-    WRITE_DATACELL_WITH_NAME(out_stream, DISKANN_PQ, pq_pivots_stream_);
+    WRITE_DATACELL_WITH_NAME(out_stream, DISKANN_PQ, pq_pivots_binary_);
     WRITE_DATACELL_WITH_NAME(out_stream, DISKANN_COMPRESSED_VECTOR, disk_pq_compressed_vectors_);
-    WRITE_DATACELL_WITH_NAME(out_stream, DISKANN_LAYOUT_FILE, disk_layout_stream_);
-    WRITE_DATACELL_WITH_NAME(out_stream, DISKANN_TAG_FILE, tag_stream_);
+    WRITE_DATACELL_WITH_NAME(out_stream, DISKANN_LAYOUT_FILE, disk_layout_binary_);
+    WRITE_DATACELL_WITH_NAME(out_stream, DISKANN_TAG_FILE, tag_binary_);
 
     if (preload_) {
-        WRITE_DATACELL_WITH_NAME(out_stream, DISKANN_GRAPH, graph_stream_);
+        WRITE_DATACELL_WITH_NAME(out_stream, DISKANN_GRAPH, graph_binary_);
         metadata->Set("support_preload", true);
     }
 
@@ -1016,9 +1023,10 @@ DiskANN::serialize(std::ostream& out_stream) {
     WRITE_FOOTER_AND_RETURN;
 }
 
-#define READ_DATACELL_WITH_NAME(in_stream, name, datacell_stream) \
-    in_stream.seekg(datacell_offsets[(name)].GetInt());           \
-    copy_istream_to_stringstream((datacell_stream), in_stream, datacell_sizes[(name)].GetInt());
+#define DATACELL_READER_WITH_NAME(in_stream, name)                   \
+    std::make_shared<IStreamReader>((in_stream),                     \
+                                    datacell_offsets[(name)].GetInt(), \
+                                    datacell_sizes[(name)].GetInt())
 
 tl::expected<void, Error>
 DiskANN::deserialize(std::istream& in_stream) {
@@ -1041,24 +1049,15 @@ DiskANN::deserialize(std::istream& in_stream) {
         JsonType datacell_sizes = metadata->Get("datacell_sizes");
         logger::debug("datacell_sizes: {}", datacell_sizes.Dump());
 
-        std::stringstream pq_pivots_stream;
-        std::stringstream disk_pq_compressed_vectors;
-        std::stringstream graph;
-        std::stringstream tag_stream;
-
-        READ_DATACELL_WITH_NAME(in_stream, DISKANN_PQ, pq_pivots_stream);
-        READ_DATACELL_WITH_NAME(in_stream, DISKANN_COMPRESSED_VECTOR, disk_pq_compressed_vectors);
-        READ_DATACELL_WITH_NAME(in_stream, DISKANN_TAG_FILE, tag_stream);
-
-        disk_layout_reader_ =
-            std::make_shared<IStreamReader>(in_stream,
-                                            datacell_offsets[DISKANN_LAYOUT_FILE].GetInt(),
-                                            datacell_sizes[DISKANN_LAYOUT_FILE].GetInt());
+        disk_layout_reader_ = DATACELL_READER_WITH_NAME(in_stream, DISKANN_LAYOUT_FILE);
 
         reader_.reset(new LocalFileReader(batch_read_));
         index_.reset(new diskann::PQFlashIndex<float, int64_t>(
             reader_, metric_, sector_len_, dim_, use_bsa_));
-        index_->load_from_separate_paths(pq_pivots_stream, disk_pq_compressed_vectors, tag_stream);
+        load_pq_and_tags(*index_,
+                         DATACELL_READER_WITH_NAME(in_stream, DISKANN_PQ),
+                         DATACELL_READER_WITH_NAME(in_stream, DISKANN_COMPRESSED_VECTOR),
+                         DATACELL_READER_WITH_NAME(in_stream, DISKANN_TAG_FILE));
 
         if (preload_) {
             if (not metadata->Get("support_preload").GetBool()) {
@@ -1067,8 +1066,7 @@ DiskANN::deserialize(std::istream& in_stream) {
                     fmt::format("miss file: {} when deserialize diskann index", DISKANN_GRAPH));
             }
 
-            READ_DATACELL_WITH_NAME(in_stream, DISKANN_GRAPH, graph);
-            index_->load_graph(graph);
+            load_graph_from_reader(*index_, DATACELL_READER_WITH_NAME(in_stream, DISKANN_GRAPH));
         }
         status_ = IndexStatus::HYBRID;
 
@@ -1248,20 +1246,22 @@ DiskANN::continue_build(const DatasetPtr& base, const BinarySet& binary_set) {
                 SlowTaskTimer t(fmt::format("diskann build (pq)"));
                 auto failed_locs =
                     deserialize_vector_from_binary<size_t>(after_binary_set.Get(BUILD_FAILED_LOC));
+                std::stringstream pq_pivots_stream;
+                std::stringstream disk_pq_compressed_vectors;
                 diskann::generate_disk_quantized_data<float>(base->GetFloat32Vectors(),
                                                              base->GetNumElements(),
                                                              dim_,
                                                              failed_locs,
-                                                             pq_pivots_stream_,
-                                                             disk_pq_compressed_vectors_,
+                                                             pq_pivots_stream,
+                                                             disk_pq_compressed_vectors,
                                                              metric_,
                                                              p_val_,
                                                              disk_pq_dims_,
                                                              use_opq_);
                 after_binary_set = binary_set;
-                after_binary_set.Set(DISKANN_PQ, convert_stream_to_binary(pq_pivots_stream_));
+                after_binary_set.Set(DISKANN_PQ, release_stream_to_binary(pq_pivots_stream));
                 after_binary_set.Set(DISKANN_COMPRESSED_VECTOR,
-                                     convert_stream_to_binary(disk_pq_compressed_vectors_));
+                                     release_stream_to_binary(disk_pq_compressed_vectors));
                 build_status = BuildStatus::DISK_LAYOUT;
                 break;
             }
@@ -1269,16 +1269,11 @@ DiskANN::continue_build(const DatasetPtr& base, const BinarySet& binary_set) {
                 SlowTaskTimer t(fmt::format("diskann build (disk layout)"));
                 auto failed_locs =
                     deserialize_vector_from_binary<size_t>(after_binary_set.Get(BUILD_FAILED_LOC));
-                convert_binary_to_stream(binary_set.Get(DISKANN_GRAPH), graph_stream_);
-                diskann::create_disk_layout<float>(base->GetFloat32Vectors(),
-                                                   base->GetNumElements(),
-                                                   dim_,
-                                                   failed_locs,
-                                                   graph_stream_,
-                                                   disk_layout_stream_,
-                                                   sector_len_,
-                                                   metric_);
-                load_disk_index(binary_set);
+                graph_binary_ = binary_set.Get(DISKANN_GRAPH);
+                build_disk_layout(
+                    base->GetFloat32Vectors(), base->GetNumElements(), failed_locs);
+                take_binaries(binary_set);
+                load_disk_index();
                 build_status = BuildStatus::FINISH;
                 status_ = IndexStatus::MEMORY;
                 break;
@@ -1325,6 +1320,8 @@ DiskANN::build_partial_graph(const DatasetPtr& base,
         auto index_build_params = diskann::IndexWriteParametersBuilder(L_, R_)
                                       .with_num_threads(Options::Instance().num_threads_building())
                                       .build();
+        std::stringstream graph_stream;
+        std::stringstream tag_stream;
         std::vector<size_t> failed_locs =
             build_index_->build(vectors,
                                 dim_,
@@ -1334,33 +1331,58 @@ DiskANN::build_partial_graph(const DatasetPtr& base,
                                 round,
                                 static_cast<int32_t>(build_batch_num_),
                                 &builded_nodes);
-        build_index_->save(graph_stream_, tag_stream_);
+        build_index_->save(graph_stream, tag_stream);
         after_binary_set.Set(BUILD_NODES,
                              serialize_to_binary<std::unordered_set<uint32_t>>(builded_nodes));
         after_binary_set.Set(BUILD_FAILED_LOC, serialize_vector_to_binary<size_t>(failed_locs));
+        after_binary_set.Set(DISKANN_GRAPH, release_stream_to_binary(graph_stream));
+        after_binary_set.Set(DISKANN_TAG_FILE, release_stream_to_binary(tag_stream));
         build_index_.reset();
     }
-    after_binary_set.Set(DISKANN_GRAPH, convert_stream_to_binary(graph_stream_));
-    after_binary_set.Set(DISKANN_TAG_FILE, convert_stream_to_binary(tag_stream_));
     return {};
 }
 
+void
+DiskANN::take_binaries(const BinarySet& binary_set) {
+    // binaries share their buffers, so holding them costs no copy
+    pq_pivots_binary_ = binary_set.Get(DISKANN_PQ);
+    disk_pq_compressed_vectors_ = binary_set.Get(DISKANN_COMPRESSED_VECTOR);
+    tag_binary_ = binary_set.Get(DISKANN_TAG_FILE);
+}
+
+void
+DiskANN::build_disk_layout(const float* vectors,
+                           int64_t data_num,
+                           const std::vector<size_t>& failed_locs) {
+    ReaderStreamBuf graph_buf(std::make_shared<LocalMemoryReader>(graph_binary_));
+    std::istream graph_stream(&graph_buf);
+    std::stringstream disk_layout_stream;
+    diskann::create_disk_layout<float>(vectors,
+                                       data_num,
+                                       dim_,
+                                       failed_locs,
+                                       graph_stream,
+                                       disk_layout_stream,
+                                       sector_len_,
+                                       metric_);
+    disk_layout_binary_ = release_stream_to_binary(disk_layout_stream);
+}
+
 tl::expected<void, Error>
-DiskANN::load_disk_index(const BinarySet& binary_set) {
-    disk_layout_reader_ = std::make_shared<LocalMemoryReader>(disk_layout_stream_);
+DiskANN::load_disk_index() {
+    disk_layout_reader_ = std::make_shared<LocalMemoryReader>(disk_layout_binary_);
     reader_.reset(new LocalFileReader(batch_read_));
     index_.reset(
         new diskann::PQFlashIndex<float, int64_t>(reader_, metric_, sector_len_, dim_, use_bsa_));
 
-    convert_binary_to_stream(binary_set.Get(DISKANN_COMPRESSED_VECTOR),
-                             disk_pq_compressed_vectors_);
-    convert_binary_to_stream(binary_set.Get(DISKANN_PQ), pq_pivots_stream_);
-    convert_binary_to_stream(binary_set.Get(DISKANN_TAG_FILE), tag_stream_);
-    index_->load_from_separate_paths(pq_pivots_stream_, disk_pq_compressed_vectors_, tag_stream_);
+    load_pq_and_tags(*index_,
+                     std::make_shared<LocalMemoryReader>(pq_pivots_binary_),
+                     std::make_shared<LocalMemoryReader>(disk_pq_compressed_vectors_),
+                     std::make_shared<LocalMemoryReader>(tag_binary_));
     if (preload_) {
-        index_->load_graph(graph_stream_);
+        load_graph_from_reader(*index_, std::make_shared<LocalMemoryReader>(graph_binary_));
     } else {
-        graph_stream_.str("");
+        graph_binary_ = Binary();
     }
     return {};
 }
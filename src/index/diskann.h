@@ -162,9 +162,9 @@ public:
     int64_t
     GetMemoryUsage() const override {
         if (status_ == MEMORY) {
-            return index_->get_memory_usage() + disk_pq_compressed_vectors_.str().size() +
-                   pq_pivots_stream_.str().size() + disk_layout_stream_.str().size() +
-                   tag_stream_.str().size() + graph_stream_.str().size();
+            return index_->get_memory_usage() + disk_pq_compressed_vectors_.size +
+                   pq_pivots_binary_.size + disk_layout_binary_.size + tag_binary_.size +
+                   graph_binary_.size;
         } else if (status_ == HYBRID) {
             return index_->get_memory_usage();
         }
@@ -234,8 +234,16 @@ private:
                         BinarySet& after_binary_set,
                         int round);
 
+    void
+    take_binaries(const BinarySet& binary_set);
+
+    void
+    build_disk_layout(const float* vectors,
+                      int64_t data_num,
+                      const std::vector<size_t>& failed_locs);
+
     tl::expected<void, Error>
-    load_disk_index(const BinarySet& binary_set);
+    load_disk_index();
 
     void
     init_feature_list();
@@ -244,11 +252,11 @@ private:
     std::shared_ptr<LocalFileReader> reader_;
     std::shared_ptr<diskann::PQFlashIndex<float, int64_t>> index_;
     std::shared_ptr<diskann::Index<float, int64_t, int64_t>> build_index_;
-    std::stringstream pq_pivots_stream_;
-    std::stringstream disk_pq_compressed_vectors_;
-    std::stringstream disk_layout_stream_;
-    std::stringstream tag_stream_;
-    std::stringstream graph_stream_;
+    Binary pq_pivots_binary_;
+    Binary disk_pq_compressed_vectors_;
+    Binary disk_layout_binary_;
+    Binary tag_binary_;
+    Binary graph_binary_;
 
     const IndexCommonParam index_common_param_;
 
@@ -16,6 +16,7 @@
 #include "diskann.h"
 
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
 #include <fstream>
 #include <nlohmann/json.hpp>
 #include <tuple>
@@ -24,6 +25,7 @@
 #include "distance.h"
 #include "fixtures.h"
 #include "index_common_param.h"
+#include "test_reader.h"
 #include "utils/timer.h"
 #include "vsag/errors.h"
 
@@ -656,3 +658,93 @@ TEST_CASE("diskann serialize in streaming", "[ut][diskann]") {
     REQUIRE(deserialize_result.has_value());
     in_file.close();
 }
+
+TEST_CASE("diskann load from binaryset, readerset and stream", "[ut][diskann]") {
+    vsag::logger::set_level(vsag::logger::level::debug);
+    vsag::IndexCommonParam common_param;
+    common_param.dim_ = 128;
+    common_param.data_type_ = vsag::DataTypes::DATA_TYPE_FLOAT;
+    common_param.metric_ = vsag::MetricType::METRIC_TYPE_L2SQR;
+    vsag::DiskannParameters diskann_obj = parse_diskann_params(common_param);
+    diskann_obj.metric = diskann::Metric::L2;
+    diskann_obj.pq_sample_rate = 1.0F;
+    diskann_obj.pq_dims = 16;
+    diskann_obj.max_degree = 12;
+    diskann_obj.ef_construction = 100;
+    diskann_obj.use_bsa = false;
+    diskann_obj.use_reference = false;
+    diskann_obj.use_preload = GENERATE(false, true);
+
+    int64_t num_elements = 500;
+    auto [ids, vectors] = fixtures::generate_ids_and_vectors(num_elements, common_param.dim_);
+    auto dataset = vsag::Dataset::Make();
+    dataset->Dim(common_param.dim_)
+        ->NumElements(num_elements)
+        ->Ids(ids.data())
+        ->Float32Vectors(vectors.data())
+        ->Owner(false);
+
+    auto index = std::make_shared<vsag::DiskANN>(diskann_obj, common_param);
+    REQUIRE(index->Build(dataset).has_value());
+
+    vsag::JsonType params;
+    params["diskann"]["ef_search"].SetInt(100);
+    params["diskann"]["beam_search"].SetInt(4);
+    params["diskann"]["io_limit"].SetInt(200);
+    auto search_param = params.Dump();
+    int64_t k = 10;
+
+    auto search_all = [&](const std::shared_ptr<vsag::DiskANN>& target) {
+        std::vector<int64_t> results;
+        for (int64_t i = 0; i < num_elements; i += 25) {
+            auto query = vsag::Dataset::Make();
+            query->Dim(common_param.dim_)
+                ->NumElements(1)
+                ->Float32Vectors(vectors.data() + i * common_param.dim_)
+                ->Owner(false);
+            auto result = target->KnnSearch(query, k, search_param);
+            REQUIRE(result.has_value());
+            auto* result_ids = result.value()->GetIds();
+            results.insert(results.end(), result_ids, result_ids + result.value()->GetDim());
+        }
+        return results;
+    };
+    auto expected = search_all(index);
+
+    auto binary_set = index->Serialize();
+    REQUIRE(binary_set.has_value());
+
+    SECTION("binaryset") {
+        auto loaded = std::make_shared<vsag::DiskANN>(diskann_obj, common_param);
+        REQUIRE(loaded->Deserialize(binary_set.value()).has_value());
+        REQUIRE(search_all(loaded) == expected);
+
+        // a deserialized index serializes to the same bytes it was loaded from
+        auto reserialized = loaded->Serialize();
+        REQUIRE(reserialized.has_value());
+        for (const auto& key : binary_set->GetKeys()) {
+            auto origin = binary_set->Get(key);
+            auto again = reserialized->Get(key);
+            REQUIRE(origin.size == again.size);
+            REQUIRE(std::memcmp(origin.data.get(), again.data.get(), origin.size) == 0);
+        }
+    }
+
+    SECTION("readerset") {
+        vsag::ReaderSet reader_set;
+        for (const auto& key : binary_set->GetKeys()) {
+            reader_set.Set(key, std::make_shared<fixtures::TestReader>(binary_set->Get(key)));
+        }
+        auto loaded = std::make_shared<vsag::DiskANN>(diskann_obj, common_param);
+        REQUIRE(loaded->Deserialize(reader_set).has_value());
+        REQUIRE(search_all(loaded) == expected);
+    }
+
+    SECTION("stream") {
+        std::stringstream stream;
+        REQUIRE(index->Serialize(stream).has_value());
+        auto loaded = std::make_shared<vsag::DiskANN>(diskann_obj, common_param);
+        REQUIRE(loaded->Deserialize(stream).has_value());
+        REQUIRE(search_all(loaded) == expected);
+    }
+}
@@ -131,6 +131,18 @@ public:
         return std::make_shared<IndexImpl<T>>(clone_value.value(), common_param);
     }
 
+    tl::expected<uint64_t, Error>
+    Compact() override {
+        CHECK_IMMUTABLE_INDEX("compact");
+        SAFE_CALL(return this->inner_index_->Compact());
+    }
+
+    tl::expected<uint64_t, Error>
+    ConsolidateRemoved() override {
+        CHECK_IMMUTABLE_INDEX("consolidate removed");
+        SAFE_CALL(return this->inner_index_->ConsolidateRemoved());
+    }
+
     tl::expected<Checkpoint, Error>
     ContinueBuild(const DatasetPtr& base, const BinarySet& binary_set) override {
         CHECK_IMMUTABLE_INDEX("continue build");
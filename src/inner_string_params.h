@@ -42,8 +42,11 @@ const char* const ATTR_PARAMS_KEY = "attr_params";
 
 // Parameter key for hgraph
 const char* const HGRAPH_USE_ELP_OPTIMIZER_KEY = "use_elp_optimizer";
+const char* const HGRAPH_FUSE_CODES_WITH_GRAPH_KEY = "fuse_codes_with_graph";
+const char* const HGRAPH_BUILD_PARTITION_COUNT_KEY = "build_partition_count";
 const char* const HGRAPH_IGNORE_REORDER_KEY = "ignore_reorder";
 const char* const HGRAPH_BUILD_BY_BASE_QUANTIZATION_KEY = "build_by_base";
+const char* const HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION_KEY = "build_search_by_base";
 const char* const GRAPH_KEY = "graph";
 const char* const ALPHA_KEY = "alpha";
 
@@ -82,6 +85,7 @@ const char* const QUANTIZATION_TYPE_VALUE_TQ = "tq";
 const char* const TRANSFORMER_TYPE_VALUE_PCA = "pca";
 const char* const TRANSFORMER_TYPE_VALUE_ROM = "rom";
 const char* const TRANSFORMER_TYPE_VALUE_FHT = "fht";
+const char* const TRANSFORMER_TYPE_VALUE_OPQ = "opq";
 const char* const TRANSFORMER_TYPE_VALUE_RESIDUAL = "residual";
 const char* const TRANSFORMER_TYPE_VALUE_NORMALIZE = "normalize";
 
@@ -93,7 +97,9 @@ const char* const USE_FHT_KEY = "use_fht";
 // quantization param
 const char* const TQ_CHAIN_KEY = "tq_chain";
 const char* const RABITQ_QUANTIZATION_BITS_PER_DIM_QUERY_KEY = "rabitq_bits_per_dim_query";
+const char* const RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY = "rabitq_bits_per_dim_base";
 const char* const SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE_KEY = "sq4_uniform_trunc_rate";
+const char* const SQ4_UNIFORM_QUANTIZATION_FASTSCAN_KEY = "sq4_uniform_fastscan";
 const char* const PRODUCT_QUANTIZATION_DIM_KEY = "pq_dim";
 const char* const PRODUCT_QUANTIZATION_BITS_KEY = "pq_bits";
 
@@ -105,6 +111,8 @@ const char* const SPARSE_TERM_PRUNE_RATIO = "term_prune_ratio";
 const char* const SPARSE_TERM_ID_LIMIT = "term_id_limit";
 const char* const SPARSE_WINDOW_SIZE = "window_size";
 const char* const SPARSE_DESERIALIZE_WITHOUT_FOOTER = "deserialize_without_footer";
+const char* const SPARSE_USE_COMPRESSION = "use_compression";
+const char* const SPARSE_DENSE_CODES = "dense_codes";
 
 // graph param value
 const char* const GRAPH_PARAM_MAX_DEGREE_KEY = "max_degree";
@@ -114,6 +122,7 @@ const char* const EF_CONSTRUCTION_KEY = "ef_construction";
 const char* const GRAPH_TYPE_KEY = "graph_type";
 const char* const GRAPH_TYPE_VALUE_ODESCENT = "odescent";
 const char* const GRAPH_TYPE_VALUE_NSW = "nsw";
+const char* const GRAPH_TYPE_VALUE_VAMANA = "vamana";
 
 const char* const GRAPH_STORAGE_TYPE_KEY = "graph_storage_type";
 const char* const GRAPH_STORAGE_TYPE_VALUE_COMPRESSED = "compressed";
@@ -129,27 +138,40 @@ const char* const IVF_TRAIN_TYPE_KEY = "ivf_train_type";
 const char* const IVF_TRAIN_TYPE_RANDOM = "random";
 const char* const IVF_TRAIN_TYPE_KMEANS = "kmeans";
 
+const char* const IVF_TRAIN_BALANCE_FACTOR_KEY = "ivf_train_balance_factor";
+
 const char* const IVF_TRAIN_SAMPLE_COUNT_KEY = "ivf_train_sample_count";
 const char* const IVF_PARTITION_STRATEGY_PARAMS_KEY = "partition_strategy";
 const char* const IVF_PARTITION_STRATEGY_TYPE_KEY = "partition_strategy_type";
 const char* const IVF_PARTITION_STRATEGY_TYPE_NEAREST = "ivf";
 const char* const IVF_PARTITION_STRATEGY_TYPE_GNO_IMI = "gno_imi";
+const char* const IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL = "hierarchical";
 
 const char* const GNO_IMI_FIRST_ORDER_BUCKETS_COUNT_KEY = "first_order_buckets_count";
 const char* const GNO_IMI_SECOND_ORDER_BUCKETS_COUNT_KEY = "second_order_buckets_count";
 
+const char* const HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT_KEY = "first_order_buckets_count";
+const char* const HIERARCHICAL_MAX_BUCKET_SIZE_RATIO_KEY = "max_bucket_size_ratio";
+
 const char* const GNO_IMI_SEARCH_PARAM_FIRST_ORDER_SCAN_RATIO = "first_order_scan_ratio";
 const char* const FLATTEN_DATA_CELL = "flatten_data_cell";
 const char* const SPARSE_VECTOR_DATA_CELL = "sparse_vector_data_cell";
 
 // for pyramid index
 const char* const NO_BUILD_LEVELS = "no_build_levels";
+const char* const INDEX_MIN_SIZE = "index_min_size";
 
 const char* const GRAPH_SUPPORT_REMOVE = "support_remove";
 const char* const REMOVE_FLAG_BIT = "remove_flag_bit";
 const char* const HOLD_MOLDS = "hold_molds";
 const char* const SUPPORT_DUPLICATE = "support_duplicate";
 const char* const SUPPORT_TOMBSTONE = "support_tombstone";
+const char* const CONSOLIDATE_REMOVE_RATIO_KEY = "consolidate_remove_ratio";
+const char* const GRAPH_LAYOUT_ORDER_KEY = "graph_layout_order";
+const char* const GRAPH_LAYOUT_ORDER_VALUE_NONE = "none";
+const char* const GRAPH_LAYOUT_ORDER_VALUE_BFS = "bfs";
+const char* const GRAPH_LAYOUT_ORDER_VALUE_RCM = "rcm";
+const char* const GRAPH_LAYOUT_ORDER_VALUE_GORDER = "gorder";
 
 const char* const DATACELL_OFFSETS = "datacell_offsets";
 const char* const DATACELL_SIZES = "datacell_sizes";
@@ -164,6 +186,9 @@ const char* const SEARCH_PARAM_FACTOR = "factor";
 const char* const SEARCH_PARALLELISM = "parallelism";
 const char* const SEARCH_MAX_TIME_COST_MS = "timeout_ms";
 const char* const SPARSE_N_CANDIDATE = "n_candidate";
+const char* const SPARSE_USE_TERM_PRUNING = "use_term_pruning";
+const char* const SPARSE_DENSE_WEIGHT = "dense_weight";
+const char* const SPARSE_SPARSE_WEIGHT = "sparse_weight";
 
 const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"INDEX_TYPE_HGRAPH", INDEX_TYPE_HGRAPH},
@@ -172,8 +197,11 @@ const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"INDEX_TYPE_PYRAMID", INDEX_TYPE_PYRAMID},
     {"TYPE_KEY", TYPE_KEY},
     {"HGRAPH_USE_ELP_OPTIMIZER_KEY", HGRAPH_USE_ELP_OPTIMIZER_KEY},
+    {"HGRAPH_FUSE_CODES_WITH_GRAPH_KEY", HGRAPH_FUSE_CODES_WITH_GRAPH_KEY},
+    {"HGRAPH_BUILD_PARTITION_COUNT_KEY", HGRAPH_BUILD_PARTITION_COUNT_KEY},
     {"HGRAPH_IGNORE_REORDER_KEY", HGRAPH_IGNORE_REORDER_KEY},
     {"HGRAPH_BUILD_BY_BASE_QUANTIZATION_KEY", HGRAPH_BUILD_BY_BASE_QUANTIZATION_KEY},
+    {"HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION_KEY", HGRAPH_BUILD_SEARCH_BY_BASE_QUANTIZATION_KEY},
     {"GRAPH_KEY", GRAPH_KEY},
     {"BASE_CODES_KEY", BASE_CODES_KEY},
     {"PRECISE_CODES_KEY", PRECISE_CODES_KEY},
@@ -197,6 +225,7 @@ const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"PRODUCT_QUANTIZATION_BITS_KEY", PRODUCT_QUANTIZATION_BITS_KEY},
     {"GRAPH_TYPE_VALUE_NSW", GRAPH_TYPE_VALUE_NSW},
     {"GRAPH_TYPE_VALUE_ODESCENT", GRAPH_TYPE_VALUE_ODESCENT},
+    {"GRAPH_TYPE_VALUE_VAMANA", GRAPH_TYPE_VALUE_VAMANA},
     {"GRAPH_STORAGE_TYPE_KEY", GRAPH_STORAGE_TYPE_KEY},
     {"GRAPH_STORAGE_TYPE_VALUE_FLAT", GRAPH_STORAGE_TYPE_VALUE_FLAT},
     {"GRAPH_STORAGE_TYPE_VALUE_COMPRESSED", GRAPH_STORAGE_TYPE_VALUE_COMPRESSED},
@@ -213,12 +242,17 @@ const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"USE_REORDER_KEY", USE_REORDER_KEY},
     {"USE_ATTRIBUTE_FILTER_KEY", USE_ATTRIBUTE_FILTER_KEY},
     {"SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE_KEY", SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE_KEY},
+    {"SQ4_UNIFORM_QUANTIZATION_FASTSCAN_KEY", SQ4_UNIFORM_QUANTIZATION_FASTSCAN_KEY},
     {"PCA_DIM_KEY", PCA_DIM_KEY},
     {"IVF_SEARCH_PARAM_SCAN_BUCKETS_COUNT", IVF_SEARCH_PARAM_SCAN_BUCKETS_COUNT},
     {"GNO_IMI_FIRST_ORDER_BUCKETS_COUNT_KEY", GNO_IMI_FIRST_ORDER_BUCKETS_COUNT_KEY},
     {"GNO_IMI_SECOND_ORDER_BUCKETS_COUNT_KEY", GNO_IMI_SECOND_ORDER_BUCKETS_COUNT_KEY},
     {"BUCKETS_COUNT_KEY", BUCKETS_COUNT_KEY},
     {"IVF_TRAIN_TYPE_KEY", IVF_TRAIN_TYPE_KEY},
+    {"IVF_TRAIN_BALANCE_FACTOR_KEY", IVF_TRAIN_BALANCE_FACTOR_KEY},
+    {"CONSOLIDATE_REMOVE_RATIO_KEY", CONSOLIDATE_REMOVE_RATIO_KEY},
+    {"GRAPH_LAYOUT_ORDER_KEY", GRAPH_LAYOUT_ORDER_KEY},
+    {"GRAPH_LAYOUT_ORDER_VALUE_NONE", GRAPH_LAYOUT_ORDER_VALUE_NONE},
     {"ODESCENT_PARAMETER_BUILD_BLOCK_SIZE", ODESCENT_PARAMETER_BUILD_BLOCK_SIZE},
     {"ODESCENT_PARAMETER_ALPHA", ODESCENT_PARAMETER_ALPHA},
     {"ODESCENT_PARAMETER_GRAPH_ITER_TURN", ODESCENT_PARAMETER_GRAPH_ITER_TURN},
@@ -238,13 +272,18 @@ const std::unordered_map<std::string, std::string> DEFAULT_MAP = {
     {"REMOVE_FLAG_BIT", REMOVE_FLAG_BIT},
     {"HOLD_MOLDS", HOLD_MOLDS},
     {"IVF_PARTITION_STRATEGY_TYPE_GNO_IMI", IVF_PARTITION_STRATEGY_TYPE_GNO_IMI},
+    {"IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL", IVF_PARTITION_STRATEGY_TYPE_HIERARCHICAL},
+    {"HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT_KEY", HIERARCHICAL_FIRST_ORDER_BUCKETS_COUNT_KEY},
+    {"HIERARCHICAL_MAX_BUCKET_SIZE_RATIO_KEY", HIERARCHICAL_MAX_BUCKET_SIZE_RATIO_KEY},
     {"STORE_RAW_VECTOR_KEY", STORE_RAW_VECTOR_KEY},
     {"RAW_VECTOR_KEY", RAW_VECTOR_KEY},
     {"ATTR_HAS_BUCKETS_KEY", ATTR_HAS_BUCKETS_KEY},
     {"ATTR_PARAMS_KEY", ATTR_PARAMS_KEY},
     {"RABITQ_QUANTIZATION_BITS_PER_DIM_QUERY_KEY", RABITQ_QUANTIZATION_BITS_PER_DIM_QUERY_KEY},
+    {"RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY", RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY},
     {"TQ_CHAIN_KEY", TQ_CHAIN_KEY},
     {"NO_BUILD_LEVELS", NO_BUILD_LEVELS},
+    {"INDEX_MIN_SIZE", INDEX_MIN_SIZE},
     {"GRAPH_TYPE_KEY", GRAPH_TYPE_KEY}};
 
 }  // namespace vsag
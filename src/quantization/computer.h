@@ -16,6 +16,7 @@
 #pragma once
 
 #include <cstdint>
+#include <limits>
 #include <memory>
 
 #include "metric_type.h"
@@ -33,6 +34,18 @@ public:
     ComputerInterface() = default;
 
     virtual ~ComputerInterface() = default;
+
+    /**
+     * @brief Sets the distance a candidate has to beat to be useful for the caller, quantizers
+     * with a refinement stage (e.g. extended rabitq) skip refining candidates that cannot beat it.
+     */
+    virtual void
+    SetDistanceBound(float bound) {
+        dist_bound_ = bound;
+    }
+
+public:
+    float dist_bound_{std::numeric_limits<float>::max()};
 };
 
 template <typename T>
@@ -87,7 +100,7 @@ template <typename QuantImpl, MetricType metric>
 class Computer<TransformQuantizer<QuantImpl, metric>> : public ComputerInterface {
 public:
     explicit Computer(const TransformQuantizer<QuantImpl, metric>* quantizer, Allocator* allocator)
-        : quantizer_(quantizer), allocator_(allocator) {
+        : quantizer_(quantizer), allocator_(allocator), raw_query_(allocator) {
         inner_computer_ = new Computer<QuantImpl>(quantizer_->quantizer_.get(), allocator);
     }
 
@@ -96,6 +109,12 @@ public:
         delete inner_computer_;
     }
 
+    void
+    SetDistanceBound(float bound) override {
+        dist_bound_ = bound;
+        inner_computer_->SetDistanceBound(bound);
+    }
+
     void
     SetQuery(const DataType* query) {
         quantizer_->ProcessQuery(query, *this);
@@ -129,6 +148,7 @@ public:
     const TransformQuantizer<QuantImpl, metric>* quantizer_{nullptr};
     uint8_t* buf_{nullptr};
     Computer<QuantImpl>* inner_computer_{nullptr};
+    Vector<float> raw_query_;
 };
 
 }  // namespace vsag
@@ -80,6 +80,11 @@ public:
         return QUANTIZATION_TYPE_VALUE_PQFS;
     }
 
+    [[nodiscard]] bool
+    UsePackage32() const override {
+        return true;
+    }
+
     void
     Package32(const uint8_t* codes, uint8_t* packaged_codes, int64_t valid_size) const override;
 
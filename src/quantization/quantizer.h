@@ -219,6 +219,15 @@ public:
         return this->hold_molds_;
     }
 
+    /**
+     * @brief Whether codes must be packaged into blocks of 32 (Package32) before
+     * ScanBatchDists, as fastscan layouts require.
+     */
+    [[nodiscard]] virtual bool
+    UsePackage32() const {
+        return false;
+    }
+
     virtual void
     Package32(const uint8_t* codes, uint8_t* packaged_codes, int64_t valid_size) const {};
 
@@ -30,8 +30,14 @@ RaBitQuantizer<metric>::RaBitQuantizer(int dim,
                                        uint64_t num_bits_per_dim_query,
                                        bool use_fht,
                                        bool use_mrq,
-                                       Allocator* allocator)
+                                       Allocator* allocator,
+                                       uint64_t num_bits_per_dim_base)
     : Quantizer<RaBitQuantizer<metric>>(dim, allocator) {
+    if (num_bits_per_dim_base < 1 or num_bits_per_dim_base > 8) {
+        throw VsagException(
+            ErrorType::INVALID_ARGUMENT,
+            fmt::format("rabitq bits per dim base ({}) must be in [1, 8]", num_bits_per_dim_base));
+    }
     // dim
     use_mrq_ = use_mrq;
     pca_dim_ = pca_dim;
@@ -128,6 +134,27 @@ RaBitQuantizer<metric>::RaBitQuantizer(int dim,
         query_offset_raw_norm_ = this->query_code_size_;
         this->query_code_size_ += ((sizeof(norm_type) + align_size - 1) / align_size) * align_size;
     }
+
+    // extended rabitq: the sign plane is the bq-code, the residual planes follow the tail
+    num_bits_per_dim_base_ = num_bits_per_dim_base;
+    if (num_bits_per_dim_base_ > 1) {
+        plane_size_ = ((code_original_size + align_size - 1) / align_size) * align_size;
+        offset_ex_planes_ = this->code_size_;
+        this->code_size_ += plane_size_ * (num_bits_per_dim_base_ - 1);
+
+        offset_ex_factor_ = this->code_size_;
+        this->code_size_ += ((sizeof(float) + align_size - 1) / align_size) * align_size;
+
+        // refinement always uses the fp32 normed query, which sq4 query codes do not keep
+        if (num_bits_per_dim_query_ != 32) {
+            query_offset_ex_query_ = this->query_code_size_;
+            this->query_code_size_ +=
+                ((sizeof(DataType) * this->dim_ + align_size - 1) / align_size) * align_size;
+        }
+
+        query_offset_ex_sum_ = this->query_code_size_;
+        this->query_code_size_ += ((sizeof(sum_type) + align_size - 1) / align_size) * align_size;
+    }
 }
 
 template <MetricType metric>
@@ -138,7 +165,8 @@ RaBitQuantizer<metric>::RaBitQuantizer(const RaBitQuantizerParamPtr& param,
                              param->num_bits_per_dim_query_,
                              param->use_fht_,
                              false,
-                             common_param.allocator_.get()){};
+                             common_param.allocator_.get(),
+                             param->num_bits_per_dim_base_){};
 
 template <MetricType metric>
 RaBitQuantizer<metric>::RaBitQuantizer(const QuantizerParamPtr& param,
@@ -254,9 +282,70 @@ RaBitQuantizer<metric>::EncodeOneImpl(const DataType* data, uint8_t* codes) cons
                   metric == MetricType::METRIC_TYPE_COSINE) {
         *(norm_type*)(codes + offset_raw_norm_) = raw_norm;
     }
+
+    // 7. encode residual planes
+    if (num_bits_per_dim_base_ > 1) {
+        EncodeExtended(normed_data.data(), codes);
+    }
     return true;
 }
 
+template <MetricType metric>
+void
+RaBitQuantizer<metric>::EncodeExtended(const DataType* normed_data, uint8_t* codes) const {
+    // the code of each dim is u = 2^r + m (positive) or 2^r - 1 - m (negative), r = bits - 1,
+    // so the highest bit of u is exactly the sign plane, and u + 0.5 - 2^r = sign * (m + 0.5)
+    // is the reconstructed vector x (up to scale). m = min(floor(|o| * t), 2^r - 1), where the
+    // rescale factor t is chosen to maximize the cosine between x and o, see reference [3]
+    const uint64_t num_bits_residual = num_bits_per_dim_base_ - 1;
+    const auto max_level = static_cast<float>((1 << num_bits_residual) - 1);
+    float max_abs = 0.0F;
+    for (uint64_t d = 0; d < this->dim_; ++d) {
+        max_abs = std::max(max_abs, std::abs(normed_data[d]));
+    }
+    if (is_approx_zero(max_abs)) {
+        max_abs = 1.0F;
+    }
+
+    const float t_min = 1.0F / max_abs;
+    const float t_max = (max_level + 1.0F) / max_abs;
+    const float t_step = (t_max - t_min) / static_cast<float>(EXTENDED_SCALE_CANDIDATES);
+    float best_t = t_min;
+    float best_cos = std::numeric_limits<float>::lowest();
+    for (uint64_t i = 0; i <= EXTENDED_SCALE_CANDIDATES; ++i) {
+        float t = t_min + t_step * static_cast<float>(i);
+        float ip_xo = 0.0F;
+        float norm_x_sqr = 0.0F;
+        for (uint64_t d = 0; d < this->dim_; ++d) {
+            float a = std::abs(normed_data[d]);
+            float x = std::min(std::floor(a * t), max_level) + 0.5F;
+            ip_xo += x * a;
+            norm_x_sqr += x * x;
+        }
+        float cos = ip_xo / std::sqrt(norm_x_sqr);
+        if (cos > best_cos) {
+            best_cos = cos;
+            best_t = t;
+        }
+    }
+
+    auto base_level = static_cast<uint32_t>(1 << num_bits_residual);
+    float ip_xo = 0.0F;
+    uint8_t* planes = codes + offset_ex_planes_;
+    for (uint64_t d = 0; d < this->dim_; ++d) {
+        float a = std::abs(normed_data[d]);
+        auto m = static_cast<uint32_t>(std::min(std::floor(a * best_t), max_level));
+        uint32_t u = normed_data[d] >= 0.0F ? base_level + m : base_level - 1 - m;
+        for (uint64_t p = 0; p < num_bits_residual; ++p) {
+            if (((u >> p) & 1) != 0) {
+                planes[p * plane_size_ + d / 8] |= (1 << (d % 8));
+            }
+        }
+        ip_xo += (static_cast<float>(m) + 0.5F) * a;
+    }
+    *(float*)(codes + offset_ex_factor_) = ip_xo;
+}
+
 template <MetricType metric>
 bool
 RaBitQuantizer<metric>::EncodeBatchImpl(const DataType* data, uint8_t* codes, uint64_t count) {
@@ -278,10 +367,31 @@ RaBitQuantizer<metric>::DecodeOneImpl(const uint8_t* codes, DataType* data) {
     Vector<DataType> normed_data(this->dim_, 0, this->allocator_);
     Vector<DataType> transformed_data(this->dim_, 0, this->allocator_);
 
-    // 2. decode with BQ
-    for (uint64_t d = 0; d < this->dim_; ++d) {
-        bool bit = ((codes[d / 8] >> (d % 8)) & 1) != 0;
-        normed_data[d] = bit ? inv_sqrt_d_ : -inv_sqrt_d_;
+    // 2. decode with BQ (and residual planes)
+    if (num_bits_per_dim_base_ > 1) {
+        const uint64_t num_bits_residual = num_bits_per_dim_base_ - 1;
+        const auto base_level = static_cast<float>(1 << num_bits_residual);
+        float norm_x_sqr = 0.0F;
+        for (uint64_t d = 0; d < this->dim_; ++d) {
+            uint32_t u = 0;
+            for (uint64_t p = 0; p <= num_bits_residual; ++p) {
+                const uint8_t* plane =
+                    p == num_bits_residual ? codes + offset_code_
+                                           : codes + offset_ex_planes_ + p * plane_size_;
+                u |= static_cast<uint32_t>((plane[d / 8] >> (d % 8)) & 1) << p;
+            }
+            normed_data[d] = static_cast<float>(u) + 0.5F - base_level;
+            norm_x_sqr += normed_data[d] * normed_data[d];
+        }
+        float inv_norm_x = 1.0F / std::sqrt(norm_x_sqr);
+        for (uint64_t d = 0; d < this->dim_; ++d) {
+            normed_data[d] *= inv_norm_x;
+        }
+    } else {
+        for (uint64_t d = 0; d < this->dim_; ++d) {
+            bool bit = ((codes[d / 8] >> (d % 8)) & 1) != 0;
+            normed_data[d] = bit ? inv_sqrt_d_ : -inv_sqrt_d_;
+        }
     }
     // 3. inverse normalize
     InverseNormalizeWithCentroid(normed_data.data(),
@@ -337,8 +447,8 @@ recover_dist_between_sq4u_and_fp32(uint32_t ip_bq_1_4,
 
 template <MetricType metric>
 float
-RaBitQuantizer<metric>::ComputeQueryBaseImpl(const uint8_t* query_codes,
-                                             const uint8_t* base_codes) const {
+RaBitQuantizer<metric>::estimate_ip_binary(const uint8_t* query_codes,
+                                           const uint8_t* base_codes) const {
     // codes1 -> query (fp32, sq8, sq4...) + norm
     // codes2 -> base  (binary) + norm + error
     float ip_bq_estimate;
@@ -360,6 +470,63 @@ RaBitQuantizer<metric>::ComputeQueryBaseImpl(const uint8_t* query_codes,
             RaBitQFloatBinaryIP((DataType*)query_codes, base_codes, this->dim_, inv_sqrt_d_);
     }
 
+    error_type base_error = *((error_type*)(base_codes + offset_error_));
+    if (std::abs(base_error) < 1e-5) {
+        base_error = (base_error > 0) ? 1.0F : -1.0F;
+    }
+
+    float ip_bb_1_32 = base_error;
+    return ip_bq_estimate / ip_bb_1_32;
+}
+
+template <MetricType metric>
+float
+RaBitQuantizer<metric>::estimate_ip_extended(const uint8_t* query_codes,
+                                             const uint8_t* base_codes) const {
+    // <q, x> = sum_p 2^p * <q, plane_p> + (0.5 - 2^r) * sum(q), where plane_r is the sign plane,
+    // and <q, plane_p> = (RaBitQFloatBinaryIP(q, plane_p, 1) + sum(q)) / 2
+    const auto* query = (const DataType*)(query_codes + query_offset_ex_query_);
+    const sum_type query_sum = *((sum_type*)(query_codes + query_offset_ex_sum_));
+    const uint64_t num_bits_residual = num_bits_per_dim_base_ - 1;
+
+    float ip_qu = 0.0F;
+    float weight = 1.0F;
+    for (uint64_t p = 0; p <= num_bits_residual; ++p) {
+        const uint8_t* plane = p == num_bits_residual
+                                   ? base_codes + offset_code_
+                                   : base_codes + offset_ex_planes_ + p * plane_size_;
+        float ip_plane = (RaBitQFloatBinaryIP(query, plane, this->dim_, 1.0F) + query_sum) * 0.5F;
+        ip_qu += weight * ip_plane;
+        weight *= 2.0F;
+    }
+    float ip_qx = ip_qu + (0.5F - static_cast<float>(1 << num_bits_residual)) * query_sum;
+
+    float ip_xo = *((float*)(base_codes + offset_ex_factor_));
+    if (std::abs(ip_xo) < 1e-5) {
+        ip_xo = (ip_xo > 0) ? 1.0F : -1.0F;
+    }
+    return ip_qx / ip_xo;
+}
+
+template <MetricType metric>
+float
+RaBitQuantizer<metric>::estimate_error_bound(const uint8_t* base_codes) const {
+    // reference: RaBitQ equation 15, |<o_bar, q> / <o_bar, o> - <o, q>| is bounded by
+    // sqrt((1 - <o_bar, o>^2) / <o_bar, o>^2) * epsilon / sqrt(D - 1) with high probability
+    error_type base_error = std::abs(*((error_type*)(base_codes + offset_error_)));
+    if (base_error < 1e-5) {
+        return std::numeric_limits<float>::max();
+    }
+    float ratio_sqr = (1.0F - base_error * base_error) / (base_error * base_error);
+    return std::sqrt(std::max(ratio_sqr, 0.0F)) * ERROR_BOUND_EPSILON /
+           std::sqrt(std::max(static_cast<float>(this->dim_) - 1.0F, 1.0F));
+}
+
+template <MetricType metric>
+float
+RaBitQuantizer<metric>::recover_dist(const uint8_t* query_codes,
+                                     const uint8_t* base_codes,
+                                     float ip_est) const {
     norm_type query_norm = *((norm_type*)(query_codes + query_offset_norm_));
     norm_type base_norm = *((norm_type*)(base_codes + offset_norm_));
 
@@ -371,14 +538,6 @@ RaBitQuantizer<metric>::ComputeQueryBaseImpl(const uint8_t* query_codes,
         base_raw_norm = *((norm_type*)(base_codes + offset_raw_norm_));
     }
 
-    error_type base_error = *((error_type*)(base_codes + offset_error_));
-    if (std::abs(base_error) < 1e-5) {
-        base_error = (base_error > 0) ? 1.0F : -1.0F;
-    }
-
-    float ip_bb_1_32 = base_error;
-    float ip_est = ip_bq_estimate / ip_bb_1_32;
-
     float result = l2_ube(base_norm, query_norm, ip_est);
 
     if (pca_dim_ != this->original_dim_ and use_mrq_) {
@@ -409,6 +568,17 @@ RaBitQuantizer<metric>::ComputeQueryBaseImpl(const uint8_t* query_codes,
     return result;
 }
 
+template <MetricType metric>
+float
+RaBitQuantizer<metric>::ComputeQueryBaseImpl(const uint8_t* query_codes,
+                                             const uint8_t* base_codes) const {
+    if (num_bits_per_dim_base_ > 1) {
+        return recover_dist(
+            query_codes, base_codes, estimate_ip_extended(query_codes, base_codes));
+    }
+    return recover_dist(query_codes, base_codes, estimate_ip_binary(query_codes, base_codes));
+}
+
 template <MetricType metric>
 float
 RaBitQuantizer<metric>::ComputeImpl(const uint8_t* codes1, const uint8_t* codes2) const {
@@ -612,7 +782,21 @@ RaBitQuantizer<metric>::ProcessQueryImpl(const DataType* query,
             memcpy(computer.buf_, normed_data.data(), normed_data.size() * sizeof(DataType));
         }
 
-        // 5. store norm
+        // 5. store normed query for extended codes
+        if (num_bits_per_dim_base_ > 1) {
+            if (num_bits_per_dim_query_ != 32) {
+                memcpy(computer.buf_ + query_offset_ex_query_,
+                       normed_data.data(),
+                       normed_data.size() * sizeof(DataType));
+            }
+            sum_type query_sum = 0;
+            for (uint64_t d = 0; d < this->dim_; ++d) {
+                query_sum += normed_data[d];
+            }
+            *(sum_type*)(computer.buf_ + query_offset_ex_sum_) = query_sum;
+        }
+
+        // 6. store norm
         *(norm_type*)(computer.buf_ + query_offset_norm_) = query_norm;
         if constexpr (metric == MetricType::METRIC_TYPE_IP or
                       metric == MetricType::METRIC_TYPE_COSINE) {
@@ -629,7 +813,19 @@ void
 RaBitQuantizer<metric>::ComputeDistImpl(Computer<RaBitQuantizer>& computer,
                                         const uint8_t* codes,
                                         float* dists) const {
-    dists[0] = this->ComputeQueryBaseImpl(computer.buf_, codes);
+    if (num_bits_per_dim_base_ == 1) {
+        dists[0] = this->ComputeQueryBaseImpl(computer.buf_, codes);
+        return;
+    }
+    // cascade: the distance increases as the estimated ip decreases, so the lower bound of the
+    // distance comes from the upper bound of the ip. refine only if it may beat the bound
+    float ip_est = estimate_ip_binary(computer.buf_, codes);
+    float lower_bound = recover_dist(computer.buf_, codes, ip_est + estimate_error_bound(codes));
+    if (lower_bound >= computer.dist_bound_) {
+        dists[0] = recover_dist(computer.buf_, codes, ip_est);
+        return;
+    }
+    dists[0] = recover_dist(computer.buf_, codes, estimate_ip_extended(computer.buf_, codes));
 }
 
 template <MetricType metric>
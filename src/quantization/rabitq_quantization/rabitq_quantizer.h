@@ -27,10 +27,15 @@ namespace vsag {
  *
  *  RaBitQ: Supports bit-level quantization
  *  MRQ: Support use residual part of PCA to increase precision
+ *  Extended RaBitQ: Supports 2~8 bits per dimension for base codes, stored as the 1-bit sign
+ *                   plane plus (bits - 1) residual planes. Distances are first estimated with
+ *                   the sign plane, and refined with the residual planes only if the lower
+ *                   bound of the estimate is still below the computer's distance bound.
  *
  *  Reference:
  *  [1] Jianyang Gao and Cheng Long. 2024. RaBitQ: Quantizing High-Dimensional Vectors with a Theoretical Error Bound for Approximate Nearest Neighbor Search. Proc. ACM Manag. Data 2, 3, Article 167 (June 2024), 27 pages. https://doi.org/10.1145/3654970
  *  [2] Mingyu Yang, Wentao Li, Wei Wang. Fast High-dimensional Approximate Nearest Neighbor Search with Efficient Index Time and Space
+ *  [3] Jianyang Gao, Yutong Gou, Yuexuan Xu, Yongyi Yang, Cheng Long, Raymond Chi-Wing Wong. 2025. Practical and Asymptotically Optimal Quantization of High-Dimensional Vectors in Euclidean Space for Approximate Nearest Neighbor Search. Proc. ACM Manag. Data 3, 3, Article 202 (June 2025).
  */
 template <MetricType metric = MetricType::METRIC_TYPE_L2SQR>
 class RaBitQuantizer : public Quantizer<RaBitQuantizer<metric>> {
@@ -44,7 +49,8 @@ public:
                             uint64_t num_bits_per_dim_query,
                             bool use_fht,
                             bool use_mrq,
-                            Allocator* allocator);
+                            Allocator* allocator,
+                            uint64_t num_bits_per_dim_base = 1);
 
     explicit RaBitQuantizer(const RaBitQuantizerParamPtr& param,
                             const IndexCommonParam& common_param);
@@ -124,6 +130,29 @@ public:
     void
     RecoverOrderSQ(const uint8_t* output, uint8_t* input) const;
 
+    void
+    EncodeExtended(const DataType* normed_data, uint8_t* codes) const;
+
+public:
+    // the constant of the error bound in RaBitQ, see equation 15 in reference [1]
+    static constexpr float ERROR_BOUND_EPSILON = 1.9F;
+
+    // number of rescale factors tried when searching the best extended code
+    static constexpr uint64_t EXTENDED_SCALE_CANDIDATES = 32;
+
+private:
+    [[nodiscard]] float
+    estimate_ip_binary(const uint8_t* query_codes, const uint8_t* base_codes) const;
+
+    [[nodiscard]] float
+    estimate_ip_extended(const uint8_t* query_codes, const uint8_t* base_codes) const;
+
+    [[nodiscard]] float
+    estimate_error_bound(const uint8_t* base_codes) const;
+
+    [[nodiscard]] float
+    recover_dist(const uint8_t* query_codes, const uint8_t* base_codes, float ip_est) const;
+
 private:
     // compute related
     float inv_sqrt_d_{0.0F};
@@ -139,8 +168,13 @@ private:
     std::uint64_t pca_dim_{0};
     bool use_mrq_{false};
 
+    // extended rabitq related
+    uint64_t num_bits_per_dim_base_{1};
+    uint64_t plane_size_{0};
+
     /***
      * query layout: sq-code(required) + lower_bound(sq4) + delta(sq4) + sum(sq4) + norm(required) + mrq_norm(required)
+     *               + normed_query(sq4 and extended) + query_sum(extended)
      */
     uint64_t aligned_dim_{0};
     uint64_t num_bits_per_dim_query_{32};
@@ -150,9 +184,12 @@ private:
     uint64_t query_offset_norm_{0};
     uint64_t query_offset_mrq_norm_{0};
     uint64_t query_offset_raw_norm_{0};
+    uint64_t query_offset_ex_query_{0};
+    uint64_t query_offset_ex_sum_{0};
 
     /***
      * code layout: bq-code(required) + norm(required) + error(required) + sum(sq4) + mrq_norm(required)
+     *              + residual-planes(extended) + ex_factor(extended)
      */
     uint64_t offset_code_{0};
     uint64_t offset_norm_{0};
@@ -160,6 +197,8 @@ private:
     uint64_t offset_sum_{0};
     uint64_t offset_mrq_norm_{0};
     uint64_t offset_raw_norm_{0};
+    uint64_t offset_ex_planes_{0};
+    uint64_t offset_ex_factor_{0};
 };
 
 }  // namespace vsag
@@ -32,6 +32,9 @@ RaBitQuantizerParameter::FromJson(const JsonType& json) {
     if (json.Contains(RABITQ_QUANTIZATION_BITS_PER_DIM_QUERY_KEY)) {
         this->num_bits_per_dim_query_ = json[RABITQ_QUANTIZATION_BITS_PER_DIM_QUERY_KEY].GetInt();
     }
+    if (json.Contains(RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY)) {
+        this->num_bits_per_dim_base_ = json[RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY].GetInt();
+    }
     if (json.Contains(USE_FHT_KEY)) {
         this->use_fht_ = json[USE_FHT_KEY].GetBool();
     }
@@ -43,6 +46,7 @@ RaBitQuantizerParameter::ToJson() const {
     json[TYPE_KEY].SetString(QUANTIZATION_TYPE_VALUE_RABITQ);
     json[PCA_DIM_KEY].SetInt(this->pca_dim_);
     json[RABITQ_QUANTIZATION_BITS_PER_DIM_QUERY_KEY].SetInt(this->num_bits_per_dim_query_);
+    json[RABITQ_QUANTIZATION_BITS_PER_DIM_BASE_KEY].SetInt(this->num_bits_per_dim_base_);
     json[USE_FHT_KEY].SetBool(this->use_fht_);
     return json;
 }
@@ -71,6 +75,14 @@ RaBitQuantizerParameter::CheckCompatibility(const ParamPtr& other) const {
             rabitq_param->num_bits_per_dim_query_);
         return false;
     }
+    if (this->num_bits_per_dim_base_ != rabitq_param->num_bits_per_dim_base_) {
+        logger::error(
+            "RaBitQuantizerParameter::CheckCompatibility: Number of bits per dimension base do "
+            "not match: {} vs {}",
+            this->num_bits_per_dim_base_,
+            rabitq_param->num_bits_per_dim_base_);
+        return false;
+    }
     if (this->use_fht_ != rabitq_param->use_fht_) {
         logger::error(
             "RaBitQuantizerParameter::CheckCompatibility: Use FHT flag does not match: {} vs {}",
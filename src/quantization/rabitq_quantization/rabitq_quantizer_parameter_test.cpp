@@ -26,6 +26,7 @@ using namespace vsag;
 struct RaBitQDefaultParam {
     int pca_dim = 256;
     int rabitq_bits_per_dim_query = 4;
+    int rabitq_bits_per_dim_base = 1;
     bool use_fht = false;
 };
 
@@ -35,10 +36,15 @@ generate_rabitq_param(const RaBitQDefaultParam& param) {
         {{
             "pca_dim": {},
             "rabitq_bits_per_dim_query": {},
+            "rabitq_bits_per_dim_base": {},
             "use_fht": {}
         }}
     )";
-    return fmt::format(param_str, param.pca_dim, param.rabitq_bits_per_dim_query, param.use_fht);
+    return fmt::format(param_str,
+                       param.pca_dim,
+                       param.rabitq_bits_per_dim_query,
+                       param.rabitq_bits_per_dim_base,
+                       param.use_fht);
 }
 
 #define TEST_COMPATIBILITY_CASE(section_name, param_member, val1, val2, expect_compatible) \
@@ -72,5 +78,7 @@ TEST_CASE("RaBitQ Quantizer Parameter CheckCompatibility", "[ut][RaBitQuantizerP
     TEST_COMPATIBILITY_CASE("different pac_dim", pca_dim, 256, 512, false)
     TEST_COMPATIBILITY_CASE(
         "different rabitq_bits_per_dim_query", rabitq_bits_per_dim_query, 4, 8, false)
+    TEST_COMPATIBILITY_CASE(
+        "different rabitq_bits_per_dim_base", rabitq_bits_per_dim_base, 1, 4, false)
     TEST_COMPATIBILITY_CASE("different use_fht", use_fht, true, false, false)
 }
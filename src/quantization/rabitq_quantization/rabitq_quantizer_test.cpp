@@ -24,6 +24,7 @@
 #include "impl/logger/logger.h"
 #include "quantization/quantizer_test.h"
 #include "quantization/scalar_quantization/sq4_uniform_quantizer.h"
+#include "simd/fp32_simd.h"
 #include "utils/util_functions.h"
 
 using namespace vsag;
@@ -492,4 +493,95 @@ TEST_CASE("RaBitQ Query SQ Transform With All Same Element", "[ut][RaBitQuantize
     for (int i = 0; i < dim; ++i) {
         REQUIRE(is_approx_zero(original_data[i] - decode_data[i]));
     }
-}
\ No newline at end of file
+}
+template <MetricType metric>
+float
+TestExtendedRaBitQError(uint64_t dim,
+                        uint64_t num_bits_per_dim_query,
+                        uint64_t num_bits_per_dim_base,
+                        const std::vector<float>& vecs,
+                        uint64_t count) {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    RaBitQuantizer<metric> quantizer(dim,
+                                     dim,
+                                     num_bits_per_dim_query,
+                                     false,
+                                     false,
+                                     allocator.get(),
+                                     num_bits_per_dim_base);
+    quantizer.ReTrain(vecs.data(), count);
+    std::vector<uint8_t> codes(quantizer.GetCodeSize() * count);
+    quantizer.EncodeBatch(vecs.data(), codes.data(), count);
+
+    float sum_error = 0.0F;
+    float sum_gt = 0.0F;
+    for (uint64_t i = 0; i < 10; ++i) {
+        const float* query = vecs.data() + i * dim;
+        Computer<RaBitQuantizer<metric>> computer(&quantizer, allocator.get());
+        computer.SetQuery(query);
+        for (uint64_t j = 0; j < count; ++j) {
+            const uint8_t* base_codes = codes.data() + j * quantizer.GetCodeSize();
+            float dist = 0.0F;
+            computer.ComputeDist(base_codes, &dist);
+            // without a distance bound, every candidate is refined
+            REQUIRE(dist == quantizer.ComputeQueryBaseImpl(computer.buf_, base_codes));
+
+            float gt = FP32ComputeL2Sqr(query, vecs.data() + j * dim, dim);
+            sum_error += std::abs(dist - gt);
+            sum_gt += gt;
+        }
+    }
+    return sum_error / sum_gt;
+}
+
+TEST_CASE("RaBitQ Extended Bits Compute", "[ut][RaBitQuantizer]") {
+    auto num_bits_per_dim_query = GENERATE(4, 32);
+    uint64_t count = 100;
+    for (auto dim : dims) {
+        if (dim < 64) {
+            continue;
+        }
+        auto vecs = fixtures::generate_vectors(count, dim);
+        constexpr auto metric = MetricType::METRIC_TYPE_L2SQR;
+        auto error_1 = TestExtendedRaBitQError<metric>(dim, num_bits_per_dim_query, 1, vecs, count);
+        auto error_2 = TestExtendedRaBitQError<metric>(dim, num_bits_per_dim_query, 2, vecs, count);
+        auto error_4 = TestExtendedRaBitQError<metric>(dim, num_bits_per_dim_query, 4, vecs, count);
+        auto error_8 = TestExtendedRaBitQError<metric>(dim, num_bits_per_dim_query, 8, vecs, count);
+        REQUIRE(error_2 < error_1);
+        REQUIRE(error_4 < error_2);
+        REQUIRE(error_8 < error_2);
+        REQUIRE(error_4 < 0.05F);
+    }
+}
+
+TEST_CASE("RaBitQ Extended Bits Cascade", "[ut][RaBitQuantizer]") {
+    uint64_t dim = 128;
+    uint64_t count = 100;
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    auto vecs = fixtures::generate_vectors(count, dim);
+    RaBitQuantizer<MetricType::METRIC_TYPE_L2SQR> quantizer(
+        dim, dim, 32, false, false, allocator.get(), 4);
+    quantizer.ReTrain(vecs.data(), count);
+    std::vector<uint8_t> codes(quantizer.GetCodeSize() * count);
+    quantizer.EncodeBatch(vecs.data(), codes.data(), count);
+
+    Computer<RaBitQuantizer<MetricType::METRIC_TYPE_L2SQR>> computer(&quantizer,
+                                                                     allocator.get());
+    computer.SetQuery(vecs.data());
+    for (uint64_t j = 0; j < count; ++j) {
+        const uint8_t* base_codes = codes.data() + j * quantizer.GetCodeSize();
+        float refined = 0.0F;
+        computer.SetDistanceBound(std::numeric_limits<float>::max());
+        computer.ComputeDist(base_codes, &refined);
+
+        // candidates skipped by the cascade return the 1-bit estimate, which can not beat the bound
+        float bound = refined * 0.5F;
+        float estimated = 0.0F;
+        computer.SetDistanceBound(bound);
+        computer.ComputeDist(base_codes, &estimated);
+        REQUIRE((estimated == refined or estimated >= bound));
+    }
+
+    REQUIRE_THROWS(RaBitQuantizer<MetricType::METRIC_TYPE_L2SQR>(
+        dim, dim, 32, false, false, allocator.get(), 9));
+}
@@ -15,11 +15,13 @@
 
 #include "sq4_uniform_quantizer.h"
 
+#include <cmath>
 #include <cstddef>
 
 #include "index_common_param.h"
 #include "scalar_quantization_trainer.h"
 #include "simd/normalize.h"
+#include "simd/pqfs_simd.h"
 #include "simd/sq4_uniform_simd.h"
 #include "sq4_uniform_quantizer_parameter.h"
 #include "typing.h"
@@ -30,8 +32,13 @@ namespace vsag {
 using norm_type = uint64_t;
 
 template <MetricType metric>
-SQ4UniformQuantizer<metric>::SQ4UniformQuantizer(int dim, Allocator* allocator, float trunc_rate)
-    : Quantizer<SQ4UniformQuantizer<metric>>(dim, allocator), trunc_rate_(trunc_rate) {
+SQ4UniformQuantizer<metric>::SQ4UniformQuantizer(int dim,
+                                                 Allocator* allocator,
+                                                 float trunc_rate,
+                                                 bool use_fastscan)
+    : Quantizer<SQ4UniformQuantizer<metric>>(dim, allocator),
+      trunc_rate_(trunc_rate),
+      use_fastscan_(use_fastscan) {
     lower_bound_ = std::numeric_limits<DataType>::max();
     diff_ = std::numeric_limits<DataType>::lowest();
 
@@ -66,13 +73,21 @@ SQ4UniformQuantizer<metric>::SQ4UniformQuantizer(int dim, Allocator* allocator,
     }
 
     this->query_code_size_ = this->code_size_;
+    if (use_fastscan_) {
+        offset_lut_info_ = this->query_code_size_;
+        this->query_code_size_ += 2 * sizeof(float);
+        offset_lut_ = this->query_code_size_;
+        this->query_code_size_ += this->dim_ * LEVELS_PER_DIM;
+    }
 }
 
 template <MetricType metric>
 SQ4UniformQuantizer<metric>::SQ4UniformQuantizer(const SQ4UniformQuantizerParamPtr& param,
                                                  const IndexCommonParam& common_param)
-    : SQ4UniformQuantizer<metric>(
-          common_param.dim_, common_param.allocator_.get(), param->trunc_rate_){};
+    : SQ4UniformQuantizer<metric>(common_param.dim_,
+                                  common_param.allocator_.get(),
+                                  param->trunc_rate_,
+                                  param->use_fastscan_){};
 
 template <MetricType metric>
 SQ4UniformQuantizer<metric>::SQ4UniformQuantizer(const QuantizerParamPtr& param,
@@ -222,13 +237,76 @@ void
 SQ4UniformQuantizer<metric>::ProcessQueryImpl(const DataType* query,
                                               Computer<SQ4UniformQuantizer>& computer) const {
     try {
-        computer.buf_ = reinterpret_cast<uint8_t*>(this->allocator_->Allocate(this->code_size_));
+        if (computer.buf_ == nullptr) {
+            computer.buf_ =
+                reinterpret_cast<uint8_t*>(this->allocator_->Allocate(this->query_code_size_));
+        }
         this->EncodeOneImpl(query, computer.buf_);
+        if (use_fastscan_) {
+            this->process_query_lookup_table(query, computer.buf_);
+        }
     } catch (const std::bad_alloc& e) {
+        if (computer.buf_ != nullptr) {
+            this->allocator_->Deallocate(computer.buf_);
+        }
+        computer.buf_ = nullptr;
         throw VsagException(ErrorType::NO_ENOUGH_MEMORY, "bad alloc when init computer buf");
     }
 }
 
+template <MetricType metric>
+void
+SQ4UniformQuantizer<metric>::process_query_lookup_table(const DataType* query,
+                                                        uint8_t* buf) const {
+    const DataType* cur_query = query;
+    Vector<DataType> norm_query(this->allocator_);
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        norm_query.resize(this->dim_);
+        Normalize(query, norm_query.data(), this->dim_);
+        cur_query = norm_query.data();
+    }
+
+    // lut[d][c] is the partial distance between query[d] and the c-th uniform level,
+    // each dim is shifted by its own minimum so that the uint8 range is fully used
+    Vector<float> lookup_table(this->dim_ * LEVELS_PER_DIM, this->allocator_);
+    float step = diff_ / 15.0F;
+    float max_range = 0.0F;
+    float bias = 0.0F;
+    for (uint64_t d = 0; d < this->dim_; ++d) {
+        auto* per_dim = lookup_table.data() + d * LEVELS_PER_DIM;
+        float min_value = std::numeric_limits<float>::max();
+        float max_value = std::numeric_limits<float>::lowest();
+        for (int64_t c = 0; c < LEVELS_PER_DIM; ++c) {
+            float level = lower_bound_ + static_cast<float>(c) * step;
+            if constexpr (metric == MetricType::METRIC_TYPE_L2SQR) {
+                per_dim[c] = (cur_query[d] - level) * (cur_query[d] - level);
+            } else {
+                per_dim[c] = -cur_query[d] * level;
+            }
+            min_value = std::min(min_value, per_dim[c]);
+            max_value = std::max(max_value, per_dim[c]);
+        }
+        for (int64_t c = 0; c < LEVELS_PER_DIM; ++c) {
+            per_dim[c] -= min_value;
+        }
+        bias += min_value;
+        max_range = std::max(max_range, max_value - min_value);
+    }
+
+    float scale = max_range > 0.0F ? max_range / 255.0F : 1.0F;
+    auto* lut = buf + offset_lut_;
+    for (uint64_t i = 0; i < this->dim_ * LEVELS_PER_DIM; ++i) {
+        lut[i] = static_cast<uint8_t>(std::lround(lookup_table[i] / scale));
+    }
+    if constexpr (metric == MetricType::METRIC_TYPE_IP or
+                  metric == MetricType::METRIC_TYPE_COSINE) {
+        bias += 1.0F;
+    }
+    auto* lut_info = reinterpret_cast<float*>(buf + offset_lut_info_);
+    lut_info[0] = scale;
+    lut_info[1] = bias;
+}
+
 template <MetricType metric>
 void
 SQ4UniformQuantizer<metric>::ComputeDistImpl(Computer<SQ4UniformQuantizer>& computer,
@@ -243,12 +321,46 @@ SQ4UniformQuantizer<metric>::ScanBatchDistImpl(Computer<SQ4UniformQuantizer<metr
                                                uint64_t count,
                                                const uint8_t* codes,
                                                float* dists) const {
+    if (use_fastscan_) {
+        // codes have been packaged by Package32
+        this->scan_packaged_dists(computer, count, codes, dists);
+        return;
+    }
     // TODO(LHT): Optimize batch for simd
     for (uint64_t i = 0; i < count; ++i) {
         this->ComputeDistImpl(computer, codes + i * this->code_size_, dists + i);
     }
 }
 
+template <MetricType metric>
+void
+SQ4UniformQuantizer<metric>::scan_packaged_dists(Computer<SQ4UniformQuantizer<metric>>& computer,
+                                                 uint64_t count,
+                                                 const uint8_t* codes,
+                                                 float* dists) const {
+    const auto* lut_info = reinterpret_cast<const float*>(computer.buf_ + offset_lut_info_);
+    const auto* lut = computer.buf_ + offset_lut_;
+    auto scale = lut_info[0];
+    auto bias = lut_info[1];
+
+    int32_t tmp_dist[BLOCK_SIZE_PACKAGE];
+    for (uint64_t begin = 0; begin < count; begin += BLOCK_SIZE_PACKAGE) {
+        memset(tmp_dist, 0, BLOCK_SIZE_PACKAGE * sizeof(int32_t));
+        for (uint64_t d = 0; d < this->dim_; d += FASTSCAN_DIM_CHUNK) {
+            auto chunk = std::min(static_cast<uint64_t>(FASTSCAN_DIM_CHUNK), this->dim_ - d);
+            PQFastScanLookUp32(lut + d * LEVELS_PER_DIM,
+                               codes + d * (BLOCK_SIZE_PACKAGE / 2),
+                               chunk,
+                               tmp_dist);
+        }
+        auto valid_size = std::min(static_cast<uint64_t>(BLOCK_SIZE_PACKAGE), count - begin);
+        for (uint64_t j = 0; j < valid_size; ++j) {
+            dists[begin + j] = static_cast<float>(tmp_dist[j]) * scale + bias;
+        }
+        codes += BLOCK_SIZE_PACKAGE * this->code_size_;
+    }
+}
+
 template <MetricType metric>
 void
 SQ4UniformQuantizer<metric>::ReleaseComputerImpl(
@@ -279,6 +391,75 @@ SQ4UniformQuantizer<metric>::DeserializeImpl(StreamReader& reader) {
     this->scalar_rate_ = (diff_ / 15.0) * (diff_ / 15.0);
 }
 
+template <MetricType metric>
+void
+SQ4UniformQuantizer<metric>::Package32(const uint8_t* codes,
+                                       uint8_t* packaged_codes,
+                                       int64_t valid_size) const {
+    /***
+     * packaged layout of 32 vectors:
+     * nibbles of dim d for the 32 vectors are interleaved into 16 bytes at (d * 16) as PQFS does,
+     * the remaining bytes of each code (padding, norm and sum) follow in vector order
+     */
+    constexpr int32_t mapper[32] = {0, 16, 8,  24, 1, 17, 9,  25, 2, 18, 10, 26, 3, 19, 11, 27,
+                                    4, 20, 12, 28, 5, 21, 13, 29, 6, 22, 14, 30, 7, 23, 15, 31};
+    if (valid_size == -1) {
+        valid_size = BLOCK_SIZE_PACKAGE;
+    }
+    uint64_t nibble_bytes = (this->dim_ + 1) / 2;
+    uint64_t extra_bytes = this->code_size_ - nibble_bytes;
+
+    auto get_code = [&](int64_t vector_index, uint64_t dim_index) -> uint8_t {
+        if (vector_index >= valid_size) {
+            return 0;
+        }
+        uint8_t code = codes[vector_index * this->code_size_ + offset_code_ + dim_index / 2];
+        if (dim_index % 2 == 0) {
+            return code & 0x0F;
+        }
+        return code >> 4L;
+    };
+    memset(packaged_codes, 0, this->code_size_ * BLOCK_SIZE_PACKAGE);
+    for (uint64_t i = 0; i < this->dim_; ++i) {
+        for (int64_t j = 0; j < BLOCK_SIZE_PACKAGE; ++j) {
+            auto code = get_code(mapper[j], i);
+            if (j % 2 == 1) {
+                code <<= 4L;
+            }
+            packaged_codes[i * BLOCK_SIZE_PACKAGE / 2 + j / 2] |= code;
+        }
+    }
+    auto* extra = packaged_codes + nibble_bytes * BLOCK_SIZE_PACKAGE;
+    for (int64_t j = 0; j < valid_size; ++j) {
+        memcpy(extra + j * extra_bytes, codes + j * this->code_size_ + nibble_bytes, extra_bytes);
+    }
+}
+
+template <MetricType metric>
+void
+SQ4UniformQuantizer<metric>::Unpack32(const uint8_t* packaged_codes, uint8_t* codes) const {
+    constexpr int32_t mapper[32] = {0, 16, 8,  24, 1, 17, 9,  25, 2, 18, 10, 26, 3, 19, 11, 27,
+                                    4, 20, 12, 28, 5, 21, 13, 29, 6, 22, 14, 30, 7, 23, 15, 31};
+    uint64_t nibble_bytes = (this->dim_ + 1) / 2;
+    uint64_t extra_bytes = this->code_size_ - nibble_bytes;
+
+    const auto* extra = packaged_codes + nibble_bytes * BLOCK_SIZE_PACKAGE;
+    for (int64_t j = 0; j < BLOCK_SIZE_PACKAGE; ++j) {
+        memset(codes + j * this->code_size_ + offset_code_, 0, nibble_bytes);
+        memcpy(codes + j * this->code_size_ + nibble_bytes, extra + j * extra_bytes, extra_bytes);
+    }
+    for (uint64_t i = 0; i < this->dim_; ++i) {
+        for (int64_t j = 0; j < BLOCK_SIZE_PACKAGE; ++j) {
+            uint8_t byte = packaged_codes[i * (BLOCK_SIZE_PACKAGE / 2) + (j / 2)];
+            uint8_t code = (j % 2 == 0) ? (byte & 0x0F) : (byte >> 4);
+            if (i % 2 == 1) {
+                code <<= 4L;
+            }
+            codes[mapper[j] * this->code_size_ + offset_code_ + (i / 2)] |= code;
+        }
+    }
+}
+
 TEMPLATE_QUANTIZER(SQ4UniformQuantizer)
 
 }  // namespace vsag
@@ -31,7 +31,10 @@ using sum_type = float;
 template <MetricType metric = MetricType::METRIC_TYPE_L2SQR>
 class SQ4UniformQuantizer : public Quantizer<SQ4UniformQuantizer<metric>> {
 public:
-    explicit SQ4UniformQuantizer(int dim, Allocator* allocator, float trunc_rate = 0.05F);
+    explicit SQ4UniformQuantizer(int dim,
+                                 Allocator* allocator,
+                                 float trunc_rate = 0.05F,
+                                 bool use_fastscan = false);
 
     explicit SQ4UniformQuantizer(const SQ4UniformQuantizerParamPtr& param,
                                  const IndexCommonParam& common_param);
@@ -85,6 +88,17 @@ public:
         return QUANTIZATION_TYPE_VALUE_SQ4_UNIFORM;
     }
 
+    [[nodiscard]] bool
+    UsePackage32() const override {
+        return this->use_fastscan_;
+    }
+
+    void
+    Package32(const uint8_t* codes, uint8_t* packaged_codes, int64_t valid_size) const override;
+
+    void
+    Unpack32(const uint8_t* packaged_codes, uint8_t* codes) const override;
+
 public:
     [[nodiscard]] std::pair<DataType, DataType>
     GetLBandDiff() const {
@@ -96,6 +110,22 @@ public:
         return *(sum_type*)(codes + offset_codes_sum_);
     }
 
+private:
+    void
+    process_query_lookup_table(const DataType* query, uint8_t* buf) const;
+
+    void
+    scan_packaged_dists(Computer<SQ4UniformQuantizer<metric>>& computer,
+                        uint64_t count,
+                        const uint8_t* codes,
+                        float* dists) const;
+
+public:
+    constexpr static int64_t BLOCK_SIZE_PACKAGE = 32L;
+    constexpr static int64_t LEVELS_PER_DIM = 16L;
+    // the lookup kernel accumulates in uint16 lanes, 256 dims * 255 never overflows
+    constexpr static int64_t FASTSCAN_DIM_CHUNK = 256L;
+
 private:
     DataType lower_bound_{0};
     DataType diff_{0};
@@ -112,6 +142,14 @@ private:
 
     float scalar_rate_{0.0F};
     float trunc_rate_{0.05F};
+
+    /***
+     * fastscan layout: codes are packaged into blocks of 32 vectors (see Package32),
+     * query buffer layout: sq-code(query_code) + lut-info(scale, bias) + lut(dim * 16 bytes)
+     */
+    bool use_fastscan_{false};
+    uint64_t offset_lut_info_{0};
+    uint64_t offset_lut_{0};
 };
 
 }  // namespace vsag
@@ -29,6 +29,9 @@ SQ4UniformQuantizerParameter::FromJson(const JsonType& json) {
         this->trunc_rate_ =
             json[SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE_KEY].GetFloat();  // TODO(LHT): Check value
     }
+    if (json.Contains(SQ4_UNIFORM_QUANTIZATION_FASTSCAN_KEY)) {
+        this->use_fastscan_ = json[SQ4_UNIFORM_QUANTIZATION_FASTSCAN_KEY].GetBool();
+    }
 }
 
 JsonType
@@ -36,6 +39,7 @@ SQ4UniformQuantizerParameter::ToJson() const {
     JsonType json;
     json[TYPE_KEY].SetString(QUANTIZATION_TYPE_VALUE_SQ4_UNIFORM);
     json[SQ4_UNIFORM_QUANTIZATION_TRUNC_RATE_KEY].SetFloat(this->trunc_rate_);
+    json[SQ4_UNIFORM_QUANTIZATION_FASTSCAN_KEY].SetBool(this->use_fastscan_);
     return json;
 }
 bool
@@ -56,6 +60,14 @@ SQ4UniformQuantizerParameter::CheckCompatibility(const ParamPtr& other) const {
             other_sq4_uniform_quantizer_parameter->trunc_rate_);
         return false;
     }
+    if (this->use_fastscan_ != other_sq4_uniform_quantizer_parameter->use_fastscan_) {
+        logger::error(
+            "SQ4UniformQuantizerParameter::CheckCompatibility: "
+            "use_fastscan mismatch: {} vs {}",
+            this->use_fastscan_,
+            other_sq4_uniform_quantizer_parameter->use_fastscan_);
+        return false;
+    }
     return true;
 }
 }  // namespace vsag
@@ -37,5 +37,9 @@ public:
 
 public:
     float trunc_rate_{0.05F};
+
+    // package codes into 32-vector blocks and scan with in-register lookup tables,
+    // only honored by bucket based indexes (e.g. IVF)
+    bool use_fastscan_{false};
 };
 }  // namespace vsag
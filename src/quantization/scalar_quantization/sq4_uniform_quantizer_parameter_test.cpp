@@ -24,12 +24,14 @@ using namespace vsag;
 TEST_CASE("SQ4 Uniform Quantizer Parameter ToJson Test", "[ut][SQ4UniformQuantizerParameter]") {
     std::string param_str = R"(
         {
-            "sq4_uniform_trunc_rate": 0.06
+            "sq4_uniform_trunc_rate": 0.06,
+            "sq4_uniform_fastscan": true
         }
     )";
     auto param = std::make_shared<SQ4UniformQuantizerParameter>();
     param->FromJson(JsonType::Parse(param_str));
     REQUIRE(std::abs(param->trunc_rate_ - 0.06) < 1e-5F);
+    REQUIRE(param->use_fastscan_);
     ParameterTest::TestToJson(param);
 
     TestParamCheckCompatibility<SQ4UniformQuantizerParameter>(param_str);
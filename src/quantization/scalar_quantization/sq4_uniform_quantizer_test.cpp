@@ -21,6 +21,8 @@
 #include "fixtures.h"
 #include "impl/allocator/safe_allocator.h"
 #include "quantization/quantizer_test.h"
+#include "simd/fp32_simd.h"
+#include "simd/normalize.h"
 
 using namespace vsag;
 
@@ -92,3 +94,67 @@ TEST_CASE("SQ4 Uniform Serialize and Deserialize", "[ut][SQ4UniformQuantizer]")
         }
     }
 }
+
+template <MetricType metric>
+void
+TestFastScanMetricSQ4Uniform(uint64_t dim, int count, float error) {
+    auto allocator = SafeAllocator::FactoryDefaultAllocator();
+    SQ4UniformQuantizer<metric> quantizer(dim, allocator.get(), 0.05F, true);
+    REQUIRE(quantizer.UsePackage32());
+    constexpr int64_t block_size = SQ4UniformQuantizer<metric>::BLOCK_SIZE_PACKAGE;
+
+    auto vecs = fixtures::generate_vectors(count, dim);
+    auto query = fixtures::generate_vectors(1, dim, true, 114);
+    quantizer.ReTrain(vecs.data(), count);
+
+    auto code_size = quantizer.GetCodeSize();
+    int64_t new_count = (count + block_size - 1) / block_size * block_size;
+    std::vector<uint8_t> codes(code_size * new_count, 0);
+    std::vector<uint8_t> packaged_codes(code_size * new_count);
+    std::vector<uint8_t> unpacked_codes(code_size * new_count);
+    quantizer.EncodeBatch(vecs.data(), codes.data(), count);
+    for (int64_t i = 0; i < new_count; i += block_size) {
+        auto valid_size = std::min(block_size, count - i);
+        quantizer.Package32(
+            codes.data() + i * code_size, packaged_codes.data() + i * code_size, valid_size);
+        quantizer.Unpack32(packaged_codes.data() + i * code_size,
+                           unpacked_codes.data() + i * code_size);
+    }
+    for (uint64_t i = 0; i < count * code_size; ++i) {
+        REQUIRE(codes[i] == unpacked_codes[i]);
+    }
+
+    auto computer = quantizer.FactoryComputer();
+    computer->SetQuery(query.data());
+    std::vector<float> dists(count);
+    quantizer.ScanBatchDists(*computer, count, packaged_codes.data(), dists.data());
+    // fastscan is asymmetric: the raw query against the decoded base codes
+    std::vector<float> norm_query(query);
+    if constexpr (metric == MetricType::METRIC_TYPE_COSINE) {
+        Normalize(query.data(), norm_query.data(), dim);
+    }
+    std::vector<float> decoded(dim);
+    for (int i = 0; i < count; ++i) {
+        quantizer.DecodeOne(codes.data() + i * code_size, decoded.data());
+        float expect = 0.0F;
+        if constexpr (metric == MetricType::METRIC_TYPE_L2SQR) {
+            expect = FP32ComputeL2Sqr(norm_query.data(), decoded.data(), dim);
+        } else {
+            expect = 1.0F - FP32ComputeIP(norm_query.data(), decoded.data(), dim);
+        }
+        REQUIRE(std::abs(dists[i] - expect) <= error * std::max(1.0F, std::abs(expect)));
+    }
+}
+
+TEST_CASE("SQ4 Uniform FastScan Package and Compute", "[ut][SQ4UniformQuantizer]") {
+    constexpr MetricType metrics[3] = {
+        MetricType::METRIC_TYPE_L2SQR, MetricType::METRIC_TYPE_IP, MetricType::METRIC_TYPE_COSINE};
+    float error = 0.01F;
+    for (auto dim : dims) {
+        for (auto count : counts) {
+            TestFastScanMetricSQ4Uniform<metrics[0]>(dim, count, error);
+            TestFastScanMetricSQ4Uniform<metrics[1]>(dim, count, error);
+            TestFastScanMetricSQ4Uniform<metrics[2]>(dim, count, error);
+        }
+    }
+}
@@ -0,0 +1,112 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace vsag {
+
+/**
+ * @brief Codec of a compressed posting list.
+ *
+ * The window-local ids of a posting list are sorted, so they are stored as 16-bit deltas.
+ * A delta that does not fit is written as DELTA_ESCAPE followed by its low and high halves.
+ * The weights of a posting list are quantized to 8 bits: weight = min + code * scale.
+ */
+class SparsePostingCodec {
+public:
+    static constexpr uint16_t DELTA_ESCAPE = 0xFFFF;
+
+    static uint32_t
+    IdStreamLength(const uint32_t* ids, uint32_t count) {
+        uint32_t length = 0;
+        uint32_t prev = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            length += ids[i] - prev >= DELTA_ESCAPE ? 3 : 1;
+            prev = ids[i];
+        }
+        return length;
+    }
+
+    static void
+    EncodeIds(const uint32_t* ids, uint32_t count, uint16_t* stream) {
+        uint32_t prev = 0;
+        for (uint32_t i = 0; i < count; ++i) {
+            auto delta = ids[i] - prev;
+            if (delta >= DELTA_ESCAPE) {
+                *stream++ = DELTA_ESCAPE;
+                *stream++ = static_cast<uint16_t>(delta & 0xFFFF);
+                *stream++ = static_cast<uint16_t>(delta >> 16);
+            } else {
+                *stream++ = static_cast<uint16_t>(delta);
+            }
+            prev = ids[i];
+        }
+    }
+
+    static void
+    EncodeWeights(const float* weights, uint32_t count, uint8_t* codes, float& min, float& scale) {
+        min = 0.0F;
+        scale = 0.0F;
+        if (count == 0) {
+            return;
+        }
+        auto [min_it, max_it] = std::minmax_element(weights, weights + count);
+        min = *min_it;
+        scale = (*max_it - min) / 255.0F;
+        for (uint32_t i = 0; i < count; ++i) {
+            float code = scale == 0.0F ? 0.0F : std::round((weights[i] - min) / scale);
+            codes[i] = static_cast<uint8_t>(std::clamp(code, 0.0F, 255.0F));
+        }
+    }
+};
+
+/**
+ * @brief Sequential reader of a delta-encoded id stream.
+ *
+ * The reader can start in the middle of a stream: base_id is then the id decoded just
+ * before stream.
+ */
+class SparsePostingIdDecoder {
+public:
+    explicit SparsePostingIdDecoder(const uint16_t* stream, uint32_t base_id = 0)
+        : stream_(stream), id_(base_id) {
+    }
+
+    inline uint32_t
+    Next() {
+        uint32_t delta = *stream_++;
+        if (__builtin_expect(delta == SparsePostingCodec::DELTA_ESCAPE, 0)) {
+            delta = static_cast<uint32_t>(stream_[0]) | (static_cast<uint32_t>(stream_[1]) << 16);
+            stream_ += 2;
+        }
+        id_ += delta;
+        return id_;
+    }
+
+    inline const uint16_t*
+    Position() const {
+        return stream_;
+    }
+
+private:
+    const uint16_t* stream_{nullptr};
+
+    uint32_t id_{0};
+};
+
+}  // namespace vsag
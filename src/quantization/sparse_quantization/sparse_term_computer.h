@@ -20,6 +20,8 @@
 
 #include "algorithm/sindi/sindi_parameter.h"
 #include "metric_type.h"
+#include "simd/sparse_simd.h"
+#include "sparse_posting_codec.h"
 #include "utils/pointer_define.h"
 #include "utils/sparse_vector_transform.h"
 namespace vsag {
@@ -36,7 +38,12 @@ public:
         : sorted_query_(allocator),
           query_retain_ratio_(1.0F - search_param.query_prune_ratio),
           term_retain_ratio_(1.0F - search_param.term_prune_ratio),
-          raw_query_(sparse_query) {
+          use_term_pruning_(search_param.use_term_pruning),
+          raw_query_(sparse_query),
+          prune_order_(allocator),
+          prune_bounds_(allocator),
+          prune_touched_(allocator),
+          prune_candidates_(allocator) {
         sort_sparse_vector(sparse_query, sorted_query_);
 
         pruned_len_ = (uint32_t)(query_retain_ratio_ * sparse_query.len_);
@@ -85,6 +92,30 @@ public:
         }
     }
 
+    inline void
+    ScanForAccumulate(uint32_t term_iterator,
+                      const uint16_t* id_stream,
+                      const uint8_t* codes,
+                      float min,
+                      float scale,
+                      uint32_t term_count,
+                      bool has_escape,
+                      float* global_dists) {
+        // decode on the fly: query * (min + code * scale) = base + step * code
+        float query_val = sorted_query_[term_iterator].second;
+        float base = query_val * min;
+        float step = query_val * scale;
+
+        if (not has_escape) {
+            SparseAccumulateDeltas(id_stream, codes, term_count, base, step, global_dists);
+            return;
+        }
+        SparsePostingIdDecoder decoder(id_stream);
+        for (uint32_t i = 0; i < term_count; i++) {
+            global_dists[decoder.Next()] += base + step * static_cast<float>(codes[i]);
+        }
+    }
+
     inline void
     ScanForCalculateDist(uint32_t term_iterator,
                          const uint32_t* term_ids,
@@ -131,10 +162,23 @@ public:
 
     float term_retain_ratio_{0.0F};
 
+    bool use_term_pruning_{false};
+
     uint32_t pruned_len_{0};
 
     uint32_t term_iterator_{0};
 
+    // scratch of SparseTermDataCell::QueryWithPruning, reused by every window of the query
+    Vector<uint32_t> prune_order_;
+
+    Vector<float> prune_bounds_;
+
+    Vector<uint32_t> prune_touched_;
+
+    uint32_t prune_touched_count_{0};
+
+    Vector<uint32_t> prune_candidates_;
+
     Allocator* const allocator_{nullptr};
 };
 }  // namespace vsag
@@ -186,6 +186,11 @@ TransformQuantizer<QuantTmpl, metric>::MakeTransformerInstance(
         return std::make_shared<RandomOrthogonalMatrix>(this->allocator_, input_dim, output_dim);
     }
 
+    if (transform_str == TRANSFORMER_TYPE_VALUE_OPQ) {
+        return std::make_shared<OPQTransformer>(
+            this->allocator_, input_dim, param.pq_dim_, param.pq_centroids_count_);
+    }
+
     throw VsagException(ErrorType::INVALID_ARGUMENT,
                         fmt::format("invalid transformer name {}", transform_str));
 };
@@ -195,18 +200,25 @@ bool
 TransformQuantizer<QuantTmpl, metric>::TrainImpl(const DataType* data, uint64_t count) {
     count = std::min(count, (uint64_t)TQ_MAX_TRAIN_COUNT);
 
-    // 1. train transformer based on original data
-    for (const auto& vector_transformer : this->transform_chain_) {
-        vector_transformer->Train(data, count);
-    }
-
-    // 2. execute transform on original data
+    // 1. train transformers one by one, each one on the output of the previous ones,
+    //    since learned transformers (e.g., opq) depend on the data they actually receive
     Vector<DataType> transformed_data(this->dim_ * count, 0, this->allocator_);
-    Vector<uint8_t> tmp_codes(this->code_size_, 0, this->allocator_);
+    Vector<DataType> next_data(this->dim_, 0, this->allocator_);
     transformed_data.assign(data, data + count * this->dim_);
-    for (auto i = 0; i < count; i++) {
-        ExecuteChainTransform(
-            transformed_data.data() + i * this->dim_, base_meta_offsets_.data(), tmp_codes.data());
+    uint64_t cur_dim = this->dim_;
+    for (const auto& vector_transformer : this->transform_chain_) {
+        vector_transformer->Train(transformed_data.data(), count);
+
+        // 2. execute transform, the output stays compact if the dim decreases (e.g., pca)
+        auto next_dim = static_cast<uint64_t>(vector_transformer->GetOutputDim());
+        for (uint64_t i = 0; i < count; i++) {
+            vector_transformer->Transform(transformed_data.data() + i * cur_dim,
+                                          next_data.data());
+            memcpy(transformed_data.data() + i * next_dim,
+                   next_data.data(),
+                   next_dim * sizeof(DataType));
+        }
+        cur_dim = next_dim;
     }
 
     // 3. train quantizer based on transformed data
@@ -19,6 +19,7 @@
 #include <immintrin.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 
@@ -1173,4 +1174,107 @@ KacsWalk(float* data, uint64_t len) {
     return avx::KacsWalk(data, len);
 #endif
 }
+float
+SparseComputeIP(const uint32_t* ids1,
+                const float* vals1,
+                uint32_t len1,
+                const uint32_t* ids2,
+                const float* vals2,
+                uint32_t len2) {
+#if defined(ENABLE_AVX2)
+    if (len1 > len2) {
+        std::swap(ids1, ids2);
+        std::swap(vals1, vals2);
+        std::swap(len1, len2);
+    }
+    if (len1 < 8 or static_cast<uint64_t>(len1) * SPARSE_GALLOP_RATIO < len2) {
+        return generic::SparseComputeIP(ids1, vals1, len1, ids2, vals2, len2);
+    }
+    // compares 8 ids of each list against each other through the 8 rotations of one block,
+    // then moves on the block(s) with the smaller last id
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    __m256 sum = _mm256_setzero_ps();
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (i + 8 <= len1 and j + 8 <= len2) {
+        auto max1 = ids1[i + 7];
+        auto max2 = ids2[j + 7];
+        if (max1 >= ids2[j] and max2 >= ids1[i]) {
+            __m256i id1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids1 + i));
+            __m256i id2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids2 + j));
+            __m256 val1 = _mm256_loadu_ps(vals1 + i);
+            __m256 val2 = _mm256_loadu_ps(vals2 + j);
+            for (int r = 0; r < 8; ++r) {
+                __m256 match = _mm256_castsi256_ps(_mm256_cmpeq_epi32(id1, id2));
+                sum = _mm256_add_ps(sum, _mm256_and_ps(match, _mm256_mul_ps(val1, val2)));
+                id2 = _mm256_permutevar8x32_epi32(id2, rotate);
+                val2 = _mm256_permutevar8x32_ps(val2, rotate);
+            }
+        }
+        i += max1 <= max2 ? 8 : 0;
+        j += max2 <= max1 ? 8 : 0;
+    }
+
+    // Horizontal addition
+    __m128 sum_high = _mm256_extractf128_ps(sum, 1);
+    __m128 sum_low = _mm256_castps256_ps128(sum);
+    __m128 sum_final = _mm_add_ps(sum_low, sum_high);
+    sum_final = _mm_hadd_ps(sum_final, sum_final);
+    sum_final = _mm_hadd_ps(sum_final, sum_final);
+    float result;
+    _mm_store_ss(&result, sum_final);
+
+    result +=
+        generic::SparseComputeIP(ids1 + i, vals1 + i, len1 - i, ids2 + j, vals2 + j, len2 - j);
+    return result;
+#else
+    return avx::SparseComputeIP(ids1, vals1, len1, ids2, vals2, len2);
+#endif
+}
+
+void
+SparseAccumulateDeltas(const uint16_t* deltas,
+                       const uint8_t* codes,
+                       uint32_t count,
+                       float base,
+                       float step,
+                       float* dists) {
+#if defined(ENABLE_AVX2)
+    // decodes 8 ids by a prefix sum of their deltas and 8 weights at once, the ids of a
+    // posting list are unique so the 8 updates never collide
+    const __m256 base_vec = _mm256_set1_ps(base);
+    const __m256 step_vec = _mm256_set1_ps(step);
+    const __m256i carry_index = _mm256_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3);
+    alignas(32) uint32_t ids[8];
+    alignas(32) float weights[8];
+    uint32_t id = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i id_vec = _mm256_cvtepu16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas + i)));
+        id_vec = _mm256_add_epi32(id_vec, _mm256_slli_si256(id_vec, 4));
+        id_vec = _mm256_add_epi32(id_vec, _mm256_slli_si256(id_vec, 8));
+        __m256i carry = _mm256_permutevar8x32_epi32(id_vec, carry_index);
+        id_vec = _mm256_add_epi32(id_vec,
+                                  _mm256_blend_epi32(_mm256_setzero_si256(), carry, 0xF0));
+        id_vec = _mm256_add_epi32(id_vec, _mm256_set1_epi32(static_cast<int32_t>(id)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(ids), id_vec);
+
+        __m256 code_vec = _mm256_cvtepi32_ps(
+            _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(codes + i))));
+        _mm256_store_ps(weights, _mm256_add_ps(base_vec, _mm256_mul_ps(step_vec, code_vec)));
+        for (int j = 0; j < 8; ++j) {
+            dists[ids[j]] += weights[j];
+        }
+        id = ids[7];
+    }
+    for (; i < count; ++i) {
+        id += deltas[i];
+        dists[id] += base + step * static_cast<float>(codes[i]);
+    }
+#else
+    avx::SparseAccumulateDeltas(deltas, codes, count, base, step, dists);
+#endif
+}
+
 }  // namespace vsag::avx2
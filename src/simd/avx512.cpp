@@ -17,6 +17,7 @@
 #include <immintrin.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 
 #include "simd.h"
@@ -1254,4 +1255,94 @@ FHTRotate(float* data, uint64_t dim_) {
     return generic::FHTRotate(data, dim_);
 #endif
 }
+float
+SparseComputeIP(const uint32_t* ids1,
+                const float* vals1,
+                uint32_t len1,
+                const uint32_t* ids2,
+                const float* vals2,
+                uint32_t len2) {
+#if defined(ENABLE_AVX512)
+    if (len1 > len2) {
+        std::swap(ids1, ids2);
+        std::swap(vals1, vals2);
+        std::swap(len1, len2);
+    }
+    if (len1 < 16 or static_cast<uint64_t>(len1) * SPARSE_GALLOP_RATIO < len2) {
+        return avx2::SparseComputeIP(ids1, vals1, len1, ids2, vals2, len2);
+    }
+    // compares 16 ids of each list against each other through the 16 rotations of one block,
+    // then moves on the block(s) with the smaller last id
+    const __m512i rotate =
+        _mm512_setr_epi32(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 0);
+    __m512 sum = _mm512_setzero_ps();
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (i + 16 <= len1 and j + 16 <= len2) {
+        auto max1 = ids1[i + 15];
+        auto max2 = ids2[j + 15];
+        if (max1 >= ids2[j] and max2 >= ids1[i]) {
+            __m512i id1 = _mm512_loadu_si512(ids1 + i);
+            __m512i id2 = _mm512_loadu_si512(ids2 + j);
+            __m512 val1 = _mm512_loadu_ps(vals1 + i);
+            __m512 val2 = _mm512_loadu_ps(vals2 + j);
+            for (int r = 0; r < 16; ++r) {
+                __mmask16 match = _mm512_cmpeq_epi32_mask(id1, id2);
+                sum = _mm512_mask3_fmadd_ps(val1, val2, sum, match);
+                id2 = _mm512_permutexvar_epi32(rotate, id2);
+                val2 = _mm512_permutexvar_ps(rotate, val2);
+            }
+        }
+        i += max1 <= max2 ? 16 : 0;
+        j += max2 <= max1 ? 16 : 0;
+    }
+    float result = _mm512_reduce_add_ps(sum);
+    result += avx2::SparseComputeIP(ids1 + i, vals1 + i, len1 - i, ids2 + j, vals2 + j, len2 - j);
+    return result;
+#else
+    return avx2::SparseComputeIP(ids1, vals1, len1, ids2, vals2, len2);
+#endif
+}
+
+void
+SparseAccumulateDeltas(const uint16_t* deltas,
+                       const uint8_t* codes,
+                       uint32_t count,
+                       float base,
+                       float step,
+                       float* dists) {
+#if defined(ENABLE_AVX512)
+    // decodes 16 ids by a prefix sum of their deltas, the ids of a posting list are unique
+    // so the gathered distances are scattered back without conflicts
+    const __m512 base_vec = _mm512_set1_ps(base);
+    const __m512 step_vec = _mm512_set1_ps(step);
+    const __m512i zero = _mm512_setzero_si512();
+    uint32_t id = 0;
+    uint32_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512i id_vec = _mm512_cvtepu16_epi32(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(deltas + i)));
+        id_vec = _mm512_add_epi32(id_vec, _mm512_alignr_epi32(id_vec, zero, 15));
+        id_vec = _mm512_add_epi32(id_vec, _mm512_alignr_epi32(id_vec, zero, 14));
+        id_vec = _mm512_add_epi32(id_vec, _mm512_alignr_epi32(id_vec, zero, 12));
+        id_vec = _mm512_add_epi32(id_vec, _mm512_alignr_epi32(id_vec, zero, 8));
+        id_vec = _mm512_add_epi32(id_vec, _mm512_set1_epi32(static_cast<int32_t>(id)));
+
+        __m512 code_vec = _mm512_cvtepi32_ps(
+            _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + i))));
+        __m512 weight_vec = _mm512_add_ps(base_vec, _mm512_mul_ps(step_vec, code_vec));
+        __m512 dist_vec = _mm512_i32gather_ps(id_vec, dists, 4);
+        _mm512_i32scatter_ps(dists, id_vec, _mm512_add_ps(dist_vec, weight_vec), 4);
+        id = static_cast<uint32_t>(
+            _mm_extract_epi32(_mm512_extracti32x4_epi32(id_vec, 3), 3));
+    }
+    for (; i < count; ++i) {
+        id += deltas[i];
+        dists[id] += base + step * static_cast<float>(codes[i]);
+    }
+#else
+    avx2::SparseAccumulateDeltas(deltas, codes, count, base, step, dists);
+#endif
+}
+
 }  // namespace vsag::avx512
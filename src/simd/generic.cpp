@@ -13,6 +13,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "simd.h"
 #include "simd/int8_simd.h"
 
@@ -710,4 +712,62 @@ FHTRotate(float* data, uint64_t dim_) {
     }
 }
 
+float
+SparseComputeIP(const uint32_t* ids1,
+                const float* vals1,
+                uint32_t len1,
+                const uint32_t* ids2,
+                const float* vals2,
+                uint32_t len2) {
+    if (len1 > len2) {
+        std::swap(ids1, ids2);
+        std::swap(vals1, vals2);
+        std::swap(len1, len2);
+    }
+    float sum = 0.0F;
+    if (static_cast<uint64_t>(len1) * SPARSE_GALLOP_RATIO < len2) {
+        uint32_t j = 0;
+        for (uint32_t i = 0; i < len1 and j < len2; ++i) {
+            auto target = ids1[i];
+            uint32_t bound = 1;
+            while (j + bound < len2 and ids2[j + bound] < target) {
+                bound <<= 1;
+            }
+            auto end = std::min(j + bound + 1, len2);
+            j = std::lower_bound(ids2 + j + bound / 2, ids2 + end, target) - ids2;
+            if (j < len2 and ids2[j] == target) {
+                sum += vals1[i] * vals2[j];
+                ++j;
+            }
+        }
+        return sum;
+    }
+    uint32_t i = 0;
+    uint32_t j = 0;
+    while (i < len1 and j < len2) {
+        auto id1 = ids1[i];
+        auto id2 = ids2[j];
+        if (id1 == id2) {
+            sum += vals1[i] * vals2[j];
+        }
+        i += static_cast<uint32_t>(id1 <= id2);
+        j += static_cast<uint32_t>(id2 <= id1);
+    }
+    return sum;
+}
+
+void
+SparseAccumulateDeltas(const uint16_t* deltas,
+                       const uint8_t* codes,
+                       uint32_t count,
+                       float base,
+                       float step,
+                       float* dists) {
+    uint32_t id = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        id += deltas[i];
+        dists[id] += base + step * static_cast<float>(codes[i]);
+    }
+}
+
 }  // namespace vsag::generic
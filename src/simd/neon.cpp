@@ -2381,4 +2381,24 @@ FHTRotate(float* data, uint64_t dim_) {
     generic::FHTRotate(data, dim_);
 #endif
 }
+float
+SparseComputeIP(const uint32_t* ids1,
+                const float* vals1,
+                uint32_t len1,
+                const uint32_t* ids2,
+                const float* vals2,
+                uint32_t len2) {
+    return generic::SparseComputeIP(ids1, vals1, len1, ids2, vals2, len2);
+}
+
+void
+SparseAccumulateDeltas(const uint16_t* deltas,
+                       const uint8_t* codes,
+                       uint32_t count,
+                       float base,
+                       float step,
+                       float* dists) {
+    generic::SparseAccumulateDeltas(deltas, codes, count, base, step, dists);
+}
+
 }  // namespace vsag::neon
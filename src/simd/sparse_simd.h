@@ -0,0 +1,70 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+namespace vsag {
+
+// the longer list is searched by galloping when it is this many times longer than the other
+constexpr static uint32_t SPARSE_GALLOP_RATIO = 32;
+
+// SparseComputeIP: the inner product of two sparse vectors whose ids are sorted and unique
+// SparseAccumulateDeltas: dists[id_i] += base + step * codes[i], where id_i is the prefix sum of
+//     the 16-bit deltas, i.e. the scan of a compressed posting list without escaped deltas
+#define DECLARE_SPARSE_FUNCTIONS(ns)                      \
+    namespace ns {                                        \
+    float                                                 \
+    SparseComputeIP(const uint32_t* ids1,                 \
+                    const float* vals1,                   \
+                    uint32_t len1,                        \
+                    const uint32_t* ids2,                 \
+                    const float* vals2,                   \
+                    uint32_t len2);                       \
+    void                                                  \
+    SparseAccumulateDeltas(const uint16_t* deltas,        \
+                           const uint8_t* codes,          \
+                           uint32_t count,                \
+                           float base,                    \
+                           float step,                    \
+                           float* dists);                 \
+    }  // namespace ns
+
+DECLARE_SPARSE_FUNCTIONS(generic)
+DECLARE_SPARSE_FUNCTIONS(sse)
+DECLARE_SPARSE_FUNCTIONS(avx)
+DECLARE_SPARSE_FUNCTIONS(avx2)
+DECLARE_SPARSE_FUNCTIONS(avx512)
+DECLARE_SPARSE_FUNCTIONS(neon)
+DECLARE_SPARSE_FUNCTIONS(sve)
+
+#undef DECLARE_SPARSE_FUNCTIONS
+
+using SparseComputeType = float (*)(const uint32_t* ids1,
+                                    const float* vals1,
+                                    uint32_t len1,
+                                    const uint32_t* ids2,
+                                    const float* vals2,
+                                    uint32_t len2);
+extern SparseComputeType SparseComputeIP;
+
+using SparseAccumulateType = void (*)(const uint16_t* deltas,
+                                      const uint8_t* codes,
+                                      uint32_t count,
+                                      float base,
+                                      float step,
+                                      float* dists);
+extern SparseAccumulateType SparseAccumulateDeltas;
+}  // namespace vsag
@@ -0,0 +1,208 @@
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sparse_simd.h"
+
+#include <algorithm>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_all.hpp>
+#include <random>
+#include <set>
+
+#include "fixtures.h"
+#include "simd_status.h"
+
+using namespace vsag;
+
+static std::pair<std::vector<uint32_t>, std::vector<float>>
+generate_sorted_sparse(uint32_t len, uint32_t max_id, std::mt19937& rng) {
+    std::uniform_int_distribution<uint32_t> id_dist(0, max_id);
+    std::uniform_real_distribution<float> val_dist(0.0F, 1.0F);
+    std::set<uint32_t> id_set;
+    while (id_set.size() < len) {
+        id_set.insert(id_dist(rng));
+    }
+    std::vector<uint32_t> ids(id_set.begin(), id_set.end());
+    std::vector<float> vals(len);
+    for (auto& val : vals) {
+        val = val_dist(rng);
+    }
+    return {ids, vals};
+}
+
+static float
+naive_sparse_ip(const std::vector<uint32_t>& ids1,
+                const std::vector<float>& vals1,
+                const std::vector<uint32_t>& ids2,
+                const std::vector<float>& vals2) {
+    float sum = 0.0F;
+    for (uint64_t i = 0; i < ids1.size(); ++i) {
+        auto it = std::lower_bound(ids2.begin(), ids2.end(), ids1[i]);
+        if (it != ids2.end() and *it == ids1[i]) {
+            sum += vals1[i] * vals2[it - ids2.begin()];
+        }
+    }
+    return sum;
+}
+
+#define TEST_SPARSE_ACCURACY(Simd)                                             \
+    {                                                                          \
+        auto result = Simd::SparseComputeIP(                                   \
+            ids1.data(), vals1.data(), len1, ids2.data(), vals2.data(), len2); \
+        REQUIRE(std::abs(result - expected) < 1e-4);                           \
+    }
+
+TEST_CASE("Sparse SIMD Compute", "[ut][simd]") {
+    std::mt19937 rng(47);
+    // short and long lists, dense and sparse overlaps, and skewed lengths for galloping
+    std::vector<std::pair<uint32_t, uint32_t>> lengths = {
+        {0, 10}, {1, 1}, {7, 9}, {8, 8}, {17, 33}, {64, 64}, {100, 300}, {5, 1000}, {200, 200}};
+    for (auto max_id : {100U, 1000U, 100000U}) {
+        for (auto [len1, len2] : lengths) {
+            if (std::max(len1, len2) > max_id) {
+                continue;
+            }
+            auto [ids1, vals1] = generate_sorted_sparse(len1, max_id, rng);
+            auto [ids2, vals2] = generate_sorted_sparse(len2, max_id, rng);
+            auto expected = naive_sparse_ip(ids1, vals1, ids2, vals2);
+
+            // the result does not depend on the order of the two lists
+            REQUIRE(std::abs(SparseComputeIP(ids2.data(),
+                                             vals2.data(),
+                                             len2,
+                                             ids1.data(),
+                                             vals1.data(),
+                                             len1) -
+                             expected) < 1e-4);
+            TEST_SPARSE_ACCURACY(generic);
+            if (SimdStatus::SupportSSE()) {
+                TEST_SPARSE_ACCURACY(sse);
+            }
+            if (SimdStatus::SupportAVX()) {
+                TEST_SPARSE_ACCURACY(avx);
+            }
+            if (SimdStatus::SupportAVX2()) {
+                TEST_SPARSE_ACCURACY(avx2);
+            }
+            if (SimdStatus::SupportAVX512()) {
+                TEST_SPARSE_ACCURACY(avx512);
+            }
+            if (SimdStatus::SupportNEON()) {
+                TEST_SPARSE_ACCURACY(neon);
+            }
+            if (SimdStatus::SupportSVE()) {
+                TEST_SPARSE_ACCURACY(sve);
+            }
+        }
+    }
+}
+
+#define TEST_ACCUMULATE_ACCURACY(Simd)                                                  \
+    {                                                                                   \
+        std::vector<float> dists(max_id + 1, 1.0F);                                     \
+        Simd::SparseAccumulateDeltas(deltas.data(), codes.data(), count, 0.5F, 0.01F,   \
+                                     dists.data());                                     \
+        for (uint32_t id = 0; id <= max_id; ++id) {                                     \
+            REQUIRE(std::abs(dists[id] - expected[id]) < 1e-5);                         \
+        }                                                                               \
+    }
+
+TEST_CASE("Sparse SIMD Accumulate Deltas", "[ut][simd]") {
+    std::mt19937 rng(47);
+    std::uniform_int_distribution<uint32_t> code_dist(0, 255);
+    uint32_t max_id = 100000;
+    // the tails of every vector width, and lists too long for a 16-bit id
+    for (auto count : {0U, 1U, 7U, 8U, 15U, 16U, 17U, 100U, 1000U, 70000U}) {
+        auto ids = generate_sorted_sparse(count, max_id, rng).first;
+        std::vector<uint16_t> deltas(count);
+        std::vector<uint8_t> codes(count);
+        std::vector<float> expected(max_id + 1, 1.0F);
+        for (uint32_t i = 0; i < count; ++i) {
+            deltas[i] = static_cast<uint16_t>(ids[i] - (i == 0 ? 0 : ids[i - 1]));
+            codes[i] = static_cast<uint8_t>(code_dist(rng));
+            expected[ids[i]] += 0.5F + 0.01F * static_cast<float>(codes[i]);
+        }
+
+        TEST_ACCUMULATE_ACCURACY(generic);
+        if (SimdStatus::SupportSSE()) {
+            TEST_ACCUMULATE_ACCURACY(sse);
+        }
+        if (SimdStatus::SupportAVX()) {
+            TEST_ACCUMULATE_ACCURACY(avx);
+        }
+        if (SimdStatus::SupportAVX2()) {
+            TEST_ACCUMULATE_ACCURACY(avx2);
+        }
+        if (SimdStatus::SupportAVX512()) {
+            TEST_ACCUMULATE_ACCURACY(avx512);
+        }
+        if (SimdStatus::SupportNEON()) {
+            TEST_ACCUMULATE_ACCURACY(neon);
+        }
+        if (SimdStatus::SupportSVE()) {
+            TEST_ACCUMULATE_ACCURACY(sve);
+        }
+    }
+}
+
+#define BENCHMARK_SIMD_COMPUTE(Simd, Comp)                                              \
+    BENCHMARK_ADVANCED(#Simd #Comp) {                                                   \
+        for (int i = 0; i < count; ++i) {                                               \
+            Simd::Comp(ids1.data(), vals1.data(), len, ids2.data(), vals2.data(), len); \
+        }                                                                               \
+        return;                                                                         \
+    }
+
+TEST_CASE("Sparse SIMD Benchmark", "[ut][simd][!benchmark]") {
+    std::mt19937 rng(47);
+    int64_t count = 500;
+    uint32_t len = 128;
+    auto sparse1 = generate_sorted_sparse(len, 3000, rng);
+    auto sparse2 = generate_sorted_sparse(len, 3000, rng);
+    const auto& ids1 = sparse1.first;
+    const auto& vals1 = sparse1.second;
+    const auto& ids2 = sparse2.first;
+    const auto& vals2 = sparse2.second;
+    BENCHMARK_SIMD_COMPUTE(generic, SparseComputeIP);
+    if (SimdStatus::SupportAVX2()) {
+        BENCHMARK_SIMD_COMPUTE(avx2, SparseComputeIP);
+    }
+    if (SimdStatus::SupportAVX512()) {
+        BENCHMARK_SIMD_COMPUTE(avx512, SparseComputeIP);
+    }
+}
+
+#define BENCHMARK_SIMD_ACCUMULATE(Simd)                                               \
+    BENCHMARK_ADVANCED(#Simd "SparseAccumulateDeltas") {                              \
+        for (int i = 0; i < count; ++i) {                                             \
+            Simd::SparseAccumulateDeltas(                                             \
+                deltas.data(), codes.data(), len, 0.5F, 0.01F, dists.data());         \
+        }                                                                             \
+        return;                                                                       \
+    }
+
+TEST_CASE("Sparse SIMD Accumulate Benchmark", "[ut][simd][!benchmark]") {
+    int64_t count = 500;
+    uint32_t len = 4096;
+    std::vector<uint16_t> deltas(len, 24);
+    std::vector<uint8_t> codes(len, 100);
+    std::vector<float> dists(len * 24 + 1, 0.0F);
+    BENCHMARK_SIMD_ACCUMULATE(generic);
+    if (SimdStatus::SupportAVX2()) {
+        BENCHMARK_SIMD_ACCUMULATE(avx2);
+    }
+    if (SimdStatus::SupportAVX512()) {
+        BENCHMARK_SIMD_ACCUMULATE(avx512);
+    }
+}
@@ -52,6 +52,10 @@ public:
         bool support_duplicate = false;
         std::string graph_io_type = "block_memory_io";
         std::string graph_file_path = "./graph_storage";
+        std::string graph_layout_order = "none";
+        bool fuse_codes_with_graph = false;
+        int build_partition_count = 0;
+        bool build_search_by_base = false;
         HGraphBuildParam(const std::string& metric_type,
                          int64_t dim,
                          const std::string& quantization_str)
@@ -163,7 +167,11 @@ HGraphTestIndex::GenerateHGraphBuildParametersString(const HGraphBuildParam& par
             "store_raw_vector": {},
             "support_duplicate": {},
             "graph_io_type": "{}",
-            "graph_file_path": "{}"
+            "graph_file_path": "{}",
+            "graph_layout_order": "{}",
+            "fuse_codes_with_graph": {},
+            "build_partition_count": {},
+            "build_search_by_base": {}
         }}
     }}
     )";
@@ -190,7 +198,10 @@ HGraphTestIndex::GenerateHGraphBuildParametersString(const HGraphBuildParam& par
             "store_raw_vector": {},
             "support_duplicate": {},
             "graph_io_type": "{}",
-            "graph_file_path": "{}"
+            "graph_file_path": "{}",
+            "graph_layout_order": "{}",
+            "fuse_codes_with_graph": {},
+            "build_partition_count": {}
         }}
     }}
     )";
@@ -227,7 +238,11 @@ HGraphTestIndex::GenerateHGraphBuildParametersString(const HGraphBuildParam& par
                                            param.store_raw_vector,
                                            param.support_duplicate,
                                            param.graph_io_type,
-                                           param.graph_file_path);
+                                           param.graph_file_path,
+                                           param.graph_layout_order,
+                                           param.fuse_codes_with_graph,
+                                           param.build_partition_count,
+                                           param.build_search_by_base);
     } else {
         build_parameters_str = fmt::format(parameter_temp_origin,
                                            param.data_type,
@@ -244,7 +259,10 @@ HGraphTestIndex::GenerateHGraphBuildParametersString(const HGraphBuildParam& par
                                            param.store_raw_vector,
                                            param.support_duplicate,
                                            param.graph_io_type,
-                                           param.graph_file_path);
+                                           param.graph_file_path,
+                                           param.graph_layout_order,
+                                           param.fuse_codes_with_graph,
+                                           param.build_partition_count);
     }
     return build_parameters_str;
 }
@@ -904,6 +922,24 @@ TestHGraphODescentBuild(const fixtures::HGraphTestIndexPtr& test_index,
                 TestIndex::TestBuildIndex(index, dataset, true);
                 HGraphTestIndex::TestGeneral(index, dataset, search_param, recall);
 
+                // labels repeated inside one batch keep their first occurrence
+                int64_t unique_count = std::min(dataset->base_->GetNumElements() / 2, 500L);
+                std::vector<int64_t> repeated_ids(unique_count * 2);
+                for (int64_t i = 0; i < unique_count * 2; ++i) {
+                    repeated_ids[i] = dataset->base_->GetIds()[i % unique_count];
+                }
+                auto repeated_base = vsag::Dataset::Make();
+                repeated_base->NumElements(unique_count * 2)
+                    ->Dim(dim)
+                    ->Ids(repeated_ids.data())
+                    ->Float32Vectors(dataset->base_->GetFloat32Vectors())
+                    ->Owner(false);
+                auto index2 = TestIndex::TestFactory(test_index->name, param, true);
+                auto failed_ids = index2->Build(repeated_base);
+                REQUIRE(failed_ids.has_value());
+                REQUIRE(failed_ids.value().size() == unique_count);
+                REQUIRE(index2->GetNumElements() == unique_count);
+
                 // Restore original block size limit
                 vsag::Options::Instance().set_block_size_limit(origin_size);
             }
@@ -923,6 +959,55 @@ TEST_CASE("(Daily) HGraph ODescent Build", "[ft][hgraph][daily]") {
     TestHGraphODescentBuild(test_index, resource);
 }
 
+static void
+TestHGraphVamanaBuild(const fixtures::HGraphTestIndexPtr& test_index,
+                      const fixtures::HGraphResourcePtr& resource) {
+    using namespace fixtures;
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto search_param = fmt::format(fixtures::search_param_tmp, 200, false);
+
+    for (auto metric_type : resource->metric_types) {
+        for (auto dim : resource->dims) {
+            for (auto& [base_quantization_str, recall] : resource->test_cases) {
+                INFO(fmt::format("metric_type: {}, dim: {}, base_quantization_str: {}, recall: {}",
+                                 metric_type,
+                                 dim,
+                                 base_quantization_str,
+                                 recall));
+                if (HGraphTestIndex::IsRaBitQ(base_quantization_str) &&
+                    dim < fixtures::RABITQ_MIN_RACALL_DIM) {
+                    continue;  // Skip invalid RaBitQ configurations
+                }
+                vsag::Options::Instance().set_block_size_limit(size);
+                HGraphTestIndex::HGraphBuildParam build_param(
+                    metric_type, dim, base_quantization_str);
+                build_param.graph_type = "vamana";
+                auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+                auto index = TestIndex::TestFactory(test_index->name, param, true);
+                auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(
+                    dim, resource->base_count, metric_type);
+                TestIndex::TestBuildIndex(index, dataset, true);
+                HGraphTestIndex::TestGeneral(index, dataset, search_param, recall);
+
+                // the flat graph also serves from a disk resident graph
+                build_param.graph_io_type = "mmap_io";
+                param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+                auto disk_index = TestIndex::TestFactory(test_index->name, param, true);
+                TestIndex::TestSerializeFile(index, disk_index, dataset, search_param, true);
+                HGraphTestIndex::TestGeneral(disk_index, dataset, search_param, recall);
+                vsag::Options::Instance().set_block_size_limit(origin_size);
+            }
+        }
+    }
+}
+
+TEST_CASE("(PR) HGraph Vamana Build", "[ft][hgraph][pr]") {
+    auto test_index = std::make_shared<fixtures::HGraphTestIndex>();
+    auto resource = test_index->GetResource(true);
+    TestHGraphVamanaBuild(test_index, resource);
+}
+
 static void
 TestHGraphRemove(const fixtures::HGraphTestIndexPtr& test_index,
                  const fixtures::HGraphResourcePtr& resource) {
@@ -977,6 +1062,252 @@ TEST_CASE("(Daily) HGraph Remove", "[ft][hgraph][daily]") {
     TestHGraphRemove(test_index, resource);
 }
 
+static void
+TestHGraphConsolidateRemoved(const fixtures::HGraphTestIndexPtr& test_index,
+                             const fixtures::HGraphResourcePtr& resource) {
+    using namespace fixtures;
+    auto search_param = fmt::format(fixtures::search_param_tmp, 200, false);
+
+    for (auto metric_type : resource->metric_types) {
+        for (auto dim : resource->dims) {
+            for (auto& [base_quantization_str, recall] : resource->test_cases) {
+                INFO(fmt::format("metric_type: {}, dim: {}, base_quantization_str: {}, recall: {}",
+                                 metric_type,
+                                 dim,
+                                 base_quantization_str,
+                                 recall));
+                if (HGraphTestIndex::IsRaBitQ(base_quantization_str) &&
+                    dim < fixtures::RABITQ_MIN_RACALL_DIM) {
+                    continue;  // Skip invalid RaBitQ configurations
+                }
+                HGraphTestIndex::HGraphBuildParam build_param(
+                    metric_type, dim, base_quantization_str);
+                build_param.support_remove = true;
+                auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+                auto index = TestIndex::TestFactory(test_index->name, param, true);
+                auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(
+                    dim, resource->base_count, metric_type);
+                REQUIRE(index->Add(dataset->base_).has_value());
+
+                auto base_num = dataset->base_->GetNumElements();
+                const auto* ids = dataset->base_->GetIds();
+                auto remove_count = base_num / 5;
+                for (int64_t i = 0; i < remove_count; ++i) {
+                    REQUIRE(index->Remove(ids[i]).has_value());
+                }
+                auto consolidate_result = index->ConsolidateRemoved();
+                REQUIRE(consolidate_result.has_value());
+                REQUIRE(consolidate_result.value() == remove_count);
+                REQUIRE(index->ConsolidateRemoved().value() == 0);
+
+                // consolidated labels are not recovered, they are inserted into the released slots
+                auto re_add = vsag::Dataset::Make();
+                re_add->NumElements(remove_count)
+                    ->Dim(dim)
+                    ->Ids(ids)
+                    ->Float32Vectors(dataset->base_->GetFloat32Vectors())
+                    ->Owner(false);
+                auto add_result = index->Add(re_add);
+                REQUIRE(add_result.has_value());
+                REQUIRE(add_result.value().empty());
+                REQUIRE(index->GetNumElements() == base_num);
+                REQUIRE(index->GetNumberRemoved() == 0);
+
+                TestIndex::TestKnnSearch(index, dataset, search_param, recall, true);
+                TestIndex::TestCheckIdExist(index, dataset);
+            }
+        }
+    }
+}
+
+TEST_CASE("(PR) HGraph Consolidate Removed", "[ft][hgraph][pr]") {
+    auto test_index = std::make_shared<fixtures::HGraphTestIndex>();
+    auto resource = test_index->GetResource(true);
+    TestHGraphConsolidateRemoved(test_index, resource);
+}
+
+static void
+TestHGraphCompact(const fixtures::HGraphTestIndexPtr& test_index,
+                  const fixtures::HGraphResourcePtr& resource) {
+    using namespace fixtures;
+    auto search_param = fmt::format(fixtures::search_param_tmp, 200, false);
+
+    for (auto metric_type : resource->metric_types) {
+        for (auto dim : resource->dims) {
+            for (auto& [base_quantization_str, recall] : resource->test_cases) {
+                INFO(fmt::format("metric_type: {}, dim: {}, base_quantization_str: {}, recall: {}",
+                                 metric_type,
+                                 dim,
+                                 base_quantization_str,
+                                 recall));
+                if (HGraphTestIndex::IsRaBitQ(base_quantization_str) &&
+                    dim < fixtures::RABITQ_MIN_RACALL_DIM) {
+                    continue;  // Skip invalid RaBitQ configurations
+                }
+                HGraphTestIndex::HGraphBuildParam build_param(
+                    metric_type, dim, base_quantization_str);
+                build_param.support_remove = true;
+                auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+                auto index = TestIndex::TestFactory(test_index->name, param, true);
+                auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(
+                    dim, resource->base_count, metric_type);
+                REQUIRE(index->Add(dataset->base_).has_value());
+
+                auto base_num = dataset->base_->GetNumElements();
+                const auto* ids = dataset->base_->GetIds();
+                auto remove_count = base_num / 5;
+                for (int64_t i = 0; i < remove_count; ++i) {
+                    REQUIRE(index->Remove(ids[i]).has_value());
+                }
+                auto compact_result = index->Compact();
+                REQUIRE(compact_result.has_value());
+                REQUIRE(compact_result.value() == remove_count);
+                REQUIRE(index->Compact().value() == 0);
+                REQUIRE(index->GetNumberRemoved() == 0);
+                REQUIRE(index->GetNumElements() == base_num - remove_count);
+                for (int64_t i = 0; i < remove_count; ++i) {
+                    REQUIRE_FALSE(index->CheckIdExist(ids[i]));
+                }
+
+                auto re_add = vsag::Dataset::Make();
+                re_add->NumElements(remove_count)
+                    ->Dim(dim)
+                    ->Ids(ids)
+                    ->Float32Vectors(dataset->base_->GetFloat32Vectors())
+                    ->Owner(false);
+                auto add_result = index->Add(re_add);
+                REQUIRE(add_result.has_value());
+                REQUIRE(add_result.value().empty());
+                REQUIRE(index->GetNumElements() == base_num);
+
+                TestIndex::TestKnnSearch(index, dataset, search_param, recall, true);
+                TestIndex::TestCheckIdExist(index, dataset);
+                auto index2 = TestIndex::TestFactory(test_index->name, param, true);
+                TestIndex::TestSerializeFile(index, index2, dataset, search_param, true);
+            }
+        }
+    }
+}
+
+TEST_CASE("(PR) HGraph Compact", "[ft][hgraph][pr]") {
+    auto test_index = std::make_shared<fixtures::HGraphTestIndex>();
+    auto resource = test_index->GetResource(true);
+    TestHGraphCompact(test_index, resource);
+}
+
+static void
+TestHGraphGraphLayout(const fixtures::HGraphTestIndexPtr& test_index,
+                      const fixtures::HGraphResourcePtr& resource) {
+    using namespace fixtures;
+    auto search_param = fmt::format(fixtures::search_param_tmp, 200, false);
+    const std::vector<std::string> layout_orders = {"bfs", "rcm", "gorder"};
+
+    for (auto metric_type : resource->metric_types) {
+        for (auto dim : resource->dims) {
+            for (auto& [base_quantization_str, recall] : resource->test_cases) {
+                INFO(fmt::format("metric_type: {}, dim: {}, base_quantization_str: {}, recall: {}",
+                                 metric_type,
+                                 dim,
+                                 base_quantization_str,
+                                 recall));
+                if (HGraphTestIndex::IsRaBitQ(base_quantization_str) &&
+                    dim < fixtures::RABITQ_MIN_RACALL_DIM) {
+                    continue;  // Skip invalid RaBitQ configurations
+                }
+                HGraphTestIndex::HGraphBuildParam build_param(
+                    metric_type, dim, base_quantization_str);
+                build_param.support_remove = true;
+                build_param.graph_layout_order = layout_orders[dim % layout_orders.size()];
+                auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+                auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(
+                    dim, resource->base_count, metric_type);
+
+                // serialization writes the relabelled layout, the mutable index is untouched
+                auto index = TestIndex::TestFactory(test_index->name, param, true);
+                REQUIRE(index->Build(dataset->base_).has_value());
+                auto index2 = TestIndex::TestFactory(test_index->name, param, true);
+                TestIndex::TestSerializeFile(index, index2, dataset, search_param, true);
+                TestIndex::TestKnnSearch(index2, dataset, search_param, recall, true);
+                TestIndex::TestCheckIdExist(index2, dataset);
+                auto index3 = TestIndex::TestFactory(test_index->name, param, true);
+                TestIndex::TestSerializeBinarySet(index, index3, dataset, search_param, true);
+
+                // SetImmutable relabels in place and drops the removed points
+                auto remove_count = dataset->base_->GetNumElements() / 10;
+                for (int64_t i = 0; i < remove_count; ++i) {
+                    REQUIRE(index->Remove(dataset->base_->GetIds()[i]).has_value());
+                }
+                REQUIRE(index->SetImmutable().has_value());
+                REQUIRE(index->GetNumberRemoved() == 0);
+                REQUIRE(index->GetNumElements() ==
+                        dataset->base_->GetNumElements() - remove_count);
+                REQUIRE_FALSE(index->CheckIdExist(dataset->base_->GetIds()[0]));
+                TestIndex::TestKnnSearch(index, dataset, search_param, recall * 0.8F, true);
+            }
+        }
+    }
+}
+
+TEST_CASE("(PR) HGraph Graph Layout", "[ft][hgraph][pr]") {
+    auto test_index = std::make_shared<fixtures::HGraphTestIndex>();
+    auto resource = test_index->GetResource(true);
+    TestHGraphGraphLayout(test_index, resource);
+}
+
+static void
+TestHGraphFusedCodesWithGraph(const fixtures::HGraphTestIndexPtr& test_index,
+                              const fixtures::HGraphResourcePtr& resource) {
+    using namespace fixtures;
+    auto search_param = fmt::format(fixtures::search_param_tmp, 200, false);
+
+    for (auto metric_type : resource->metric_types) {
+        for (auto dim : resource->dims) {
+            for (auto& [base_quantization_str, recall] : resource->test_cases) {
+                INFO(fmt::format("metric_type: {}, dim: {}, base_quantization_str: {}, recall: {}",
+                                 metric_type,
+                                 dim,
+                                 base_quantization_str,
+                                 recall));
+                if (HGraphTestIndex::IsRaBitQ(base_quantization_str) &&
+                    dim < fixtures::RABITQ_MIN_RACALL_DIM) {
+                    continue;  // Skip invalid RaBitQ configurations
+                }
+                HGraphTestIndex::HGraphBuildParam build_param(
+                    metric_type, dim, base_quantization_str);
+                build_param.support_remove = true;
+                build_param.fuse_codes_with_graph = true;
+                auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+                auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(
+                    dim, resource->base_count, metric_type);
+
+                auto index = TestIndex::TestFactory(test_index->name, param, true);
+                TestIndex::TestBuildIndex(index, dataset, true);
+                TestIndex::TestKnnSearch(index, dataset, search_param, recall, true);
+                TestIndex::TestRangeSearch(index, dataset, search_param, recall, 10, true);
+                auto index2 = TestIndex::TestFactory(test_index->name, param, true);
+                TestIndex::TestSerializeFile(index, index2, dataset, search_param, true);
+                TestIndex::TestKnnSearch(index2, dataset, search_param, recall, true);
+
+                // removed slots are reused and compaction relabels the shared records
+                auto remove_count = dataset->base_->GetNumElements() / 10;
+                for (int64_t i = 0; i < remove_count; ++i) {
+                    REQUIRE(index->Remove(dataset->base_->GetIds()[i]).has_value());
+                }
+                REQUIRE(index->Compact().has_value());
+                REQUIRE(index->GetNumElements() ==
+                        dataset->base_->GetNumElements() - remove_count);
+                TestIndex::TestKnnSearch(index, dataset, search_param, recall * 0.8F, true);
+            }
+        }
+    }
+}
+
+TEST_CASE("(PR) HGraph Fused Codes With Graph", "[ft][hgraph][pr]") {
+    auto test_index = std::make_shared<fixtures::HGraphTestIndex>();
+    auto resource = test_index->GetResource(true);
+    TestHGraphFusedCodesWithGraph(test_index, resource);
+}
+
 static void
 TestHGraphCompressedBuild(const fixtures::HGraphTestIndexPtr& test_index,
                           const fixtures::HGraphResourcePtr& resource) {
@@ -1025,6 +1356,99 @@ TEST_CASE("(Daily) HGraph Compressed Graph Build", "[ft][hgraph][daily]") {
     TestHGraphCompressedBuild(test_index, resource);
 }
 
+static void
+TestHGraphPartitionedBuild(const fixtures::HGraphTestIndexPtr& test_index,
+                           const fixtures::HGraphResourcePtr& resource) {
+    using namespace fixtures;
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto graph_type = GENERATE("nsw", "odescent");
+    auto search_param = fmt::format(fixtures::search_param_tmp, 200, false);
+
+    for (auto metric_type : resource->metric_types) {
+        for (auto dim : resource->dims) {
+            for (auto& [base_quantization_str, recall] : resource->test_cases) {
+                INFO(fmt::format("metric_type: {}, dim: {}, base_quantization_str: {}, recall: {}",
+                                 metric_type,
+                                 dim,
+                                 base_quantization_str,
+                                 recall));
+                if (HGraphTestIndex::IsRaBitQ(base_quantization_str) &&
+                    dim < fixtures::RABITQ_MIN_RACALL_DIM) {
+                    continue;  // Skip invalid RaBitQ configurations
+                }
+                vsag::Options::Instance().set_block_size_limit(size);
+                HGraphTestIndex::HGraphBuildParam build_param(
+                    metric_type, dim, base_quantization_str);
+                build_param.graph_type = graph_type;
+                build_param.build_partition_count = 4;
+                auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+                auto index = TestIndex::TestFactory(test_index->name, param, true);
+                auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(
+                    dim, resource->base_count, metric_type);
+                TestIndex::TestBuildIndex(index, dataset, true);
+                REQUIRE(index->GetNumElements() == dataset->base_->GetNumElements());
+                HGraphTestIndex::TestGeneral(index, dataset, search_param, recall);
+                vsag::Options::Instance().set_block_size_limit(origin_size);
+            }
+        }
+    }
+}
+
+TEST_CASE("(PR) HGraph Partitioned Build", "[ft][hgraph][pr]") {
+    auto test_index = std::make_shared<fixtures::HGraphTestIndex>();
+    auto resource = test_index->GetResource(true);
+    TestHGraphPartitionedBuild(test_index, resource);
+}
+
+static void
+TestHGraphBuildSearchByBase(const fixtures::HGraphTestIndexPtr& test_index,
+                            const fixtures::HGraphResourcePtr& resource) {
+    using namespace fixtures;
+    auto origin_size = vsag::Options::Instance().block_size_limit();
+    auto size = GENERATE(1024 * 1024 * 2);
+    auto graph_type = GENERATE("nsw", "odescent", "vamana");
+    auto search_param = fmt::format(fixtures::search_param_tmp, 200, false);
+
+    for (auto metric_type : resource->metric_types) {
+        for (auto dim : resource->dims) {
+            for (auto& [base_quantization_str, recall] : resource->test_cases) {
+                INFO(fmt::format("metric_type: {}, dim: {}, base_quantization_str: {}, recall: {}",
+                                 metric_type,
+                                 dim,
+                                 base_quantization_str,
+                                 recall));
+                // only meaningful with precise codes to prune with
+                if (base_quantization_str.find(',') == std::string::npos) {
+                    continue;
+                }
+                if (HGraphTestIndex::IsRaBitQ(base_quantization_str) &&
+                    dim < fixtures::RABITQ_MIN_RACALL_DIM) {
+                    continue;  // Skip invalid RaBitQ configurations
+                }
+                vsag::Options::Instance().set_block_size_limit(size);
+                HGraphTestIndex::HGraphBuildParam build_param(
+                    metric_type, dim, base_quantization_str);
+                build_param.graph_type = graph_type;
+                build_param.build_search_by_base = true;
+                auto param = HGraphTestIndex::GenerateHGraphBuildParametersString(build_param);
+                auto index = TestIndex::TestFactory(test_index->name, param, true);
+                auto dataset = HGraphTestIndex::pool.GetDatasetAndCreate(
+                    dim, resource->base_count, metric_type);
+                TestIndex::TestBuildIndex(index, dataset, true);
+                HGraphTestIndex::TestGeneral(index, dataset, search_param, recall);
+                vsag::Options::Instance().set_block_size_limit(origin_size);
+            }
+        }
+    }
+}
+
+TEST_CASE("(PR) HGraph Build Search By Base", "[ft][hgraph][pr]") {
+    auto test_index = std::make_shared<fixtures::HGraphTestIndex>();
+    auto resource = test_index->GetResource(true);
+    TestHGraphBuildSearchByBase(test_index, resource);
+}
+
 static void
 TestHGraphMerge(const fixtures::HGraphTestIndexPtr& test_index,
                 const fixtures::HGraphResourcePtr& resource) {
@@ -1056,6 +1480,29 @@ TestHGraphMerge(const fixtures::HGraphTestIndexPtr& test_index,
                 REQUIRE(ret.has_value() == true);
                 auto merge_index = TestIndex::TestMergeIndexWithSameModel(model, dataset, 5, true);
                 HGraphTestIndex::TestGeneral(merge_index, dataset, search_param, recall);
+
+                // merge into an index that already holds the first half of the data
+                auto half = dataset->base_->GetNumElements() / 2;
+                auto make_part = [&](int64_t begin, int64_t count) {
+                    auto part = vsag::Dataset::Make();
+                    part->Float32Vectors(dataset->base_->GetFloat32Vectors() + begin * dim)
+                        ->Ids(dataset->base_->GetIds() + begin)
+                        ->NumElements(count)
+                        ->Dim(dim)
+                        ->Owner(false);
+                    return part;
+                };
+                auto target = model->Clone().value();
+                REQUIRE(target->Add(make_part(0, half)).has_value());
+                auto other = model->Clone().value();
+                REQUIRE(other->Add(make_part(half, dataset->base_->GetNumElements() - half))
+                            .has_value());
+                vsag::IdMapFunction id_map = [](int64_t id) -> std::tuple<bool, int64_t> {
+                    return std::make_tuple(true, id);
+                };
+                REQUIRE(target->Merge({{other, id_map}}).has_value());
+                REQUIRE(target->GetNumElements() == dataset->base_->GetNumElements());
+                HGraphTestIndex::TestGeneral(target, dataset, search_param, recall);
                 vsag::Options::Instance().set_block_size_limit(origin_size);
             }
         }
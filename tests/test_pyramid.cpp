@@ -27,6 +27,7 @@ struct PyramidParam {
     std::string precise_quantization_type = "fp32";
     std::string graph_type = "nsw";
     bool use_reorder = false;
+    uint64_t index_min_size = 0;
 };
 
 namespace fixtures {
@@ -38,7 +39,9 @@ public:
                                          const PyramidParam& param);
 
     static std::string
-    GeneratePyramidSearchParametersString(int64_t ef_search, double timeout_ms = 100);
+    GeneratePyramidSearchParametersString(int64_t ef_search,
+                                          double timeout_ms = 100,
+                                          int64_t parallelism = 1);
 
     static TestDatasetPool pool;
 
@@ -52,7 +55,8 @@ public:
         {{
             "pyramid": {{
                 "ef_search": {},
-                "timeout_ms": {}
+                "timeout_ms": {},
+                "parallelism": {}
             }}
         }})";
 };
@@ -78,7 +82,8 @@ PyramidTestIndex::GeneratePyramidBuildParametersString(const std::string& metric
             "graph_type": "{}",
             "base_quantization_type": "{}",
             "precise_quantization_type": "{}",
-            "use_reorder": {}
+            "use_reorder": {},
+            "index_min_size": {}
         }}
     }}
     )";
@@ -89,13 +94,16 @@ PyramidTestIndex::GeneratePyramidBuildParametersString(const std::string& metric
                                             param.graph_type,
                                             param.base_quantization_type,
                                             param.precise_quantization_type,
-                                            param.use_reorder);
+                                            param.use_reorder,
+                                            param.index_min_size);
     return build_parameters_str;
 }
 
 std::string
-PyramidTestIndex::GeneratePyramidSearchParametersString(int64_t ef_search, double timeout_ms) {
-    return fmt::format(search_param_tmp, ef_search, timeout_ms);
+PyramidTestIndex::GeneratePyramidSearchParametersString(int64_t ef_search,
+                                                        double timeout_ms,
+                                                        int64_t parallelism) {
+    return fmt::format(search_param_tmp, ef_search, timeout_ms, parallelism);
 }
 
 }  // namespace fixtures
@@ -169,12 +177,64 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
     }
 }
 
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
+                             "Pyramid Parallel Search Test",
+                             "[ft][pyramid]") {
+    auto metric_type = GENERATE("l2", "ip");
+    auto parallelism = GENERATE(2, 4);
+    const std::string name = "pyramid";
+    auto search_param = GeneratePyramidSearchParametersString(100, 100, parallelism);
+    PyramidParam pyramid_param;
+    for (auto& dim : dims) {
+        for (const auto& level : levels) {
+            pyramid_param.no_build_levels = level;
+            auto param = GeneratePyramidBuildParametersString(metric_type, dim, pyramid_param);
+            auto index = TestFactory(name, param, true);
+            auto dataset =
+                pool.GetDatasetAndCreate(dim, base_count, metric_type, /*with_path=*/true);
+            TestBuildIndex(index, dataset, true);
+            TestKnnSearch(index, dataset, search_param, 0.99, true);
+            TestFilterSearch(index, dataset, search_param, 0.99, true);
+            TestRangeSearch(index, dataset, search_param, 0.99, 10, true);
+            TestConcurrentKnnSearch(index, dataset, search_param, 0.99, true);
+        }
+    }
+}
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex,
+                             "Pyramid Flat Node Test",
+                             "[ft][pyramid]") {
+    auto metric_type = GENERATE("l2", "ip");
+    auto index_min_size = GENERATE(10, 200);
+    const std::string name = "pyramid";
+    auto search_param = GeneratePyramidSearchParametersString(100, 100, 2);
+    PyramidParam pyramid_param;
+    pyramid_param.index_min_size = index_min_size;
+    for (auto& dim : dims) {
+        for (const auto& level : levels) {
+            pyramid_param.no_build_levels = level;
+            auto param = GeneratePyramidBuildParametersString(metric_type, dim, pyramid_param);
+            auto index = TestFactory(name, param, true);
+            auto dataset =
+                pool.GetDatasetAndCreate(dim, base_count, metric_type, /*with_path=*/true);
+            TestContinueAdd(index, dataset, true);
+            TestKnnSearch(index, dataset, search_param, 0.99, true);
+            TestFilterSearch(index, dataset, search_param, 0.99, true);
+            TestRangeSearch(index, dataset, search_param, 0.99, 10, true);
+            auto index2 = TestFactory(name, param, true);
+            TestSerializeBinarySet(index, index2, dataset, search_param, true);
+        }
+    }
+}
+
 TEST_CASE_PERSISTENT_FIXTURE(fixtures::PyramidTestIndex, "Pyramid No Path Test", "[ft][pyramid]") {
     auto metric_type = GENERATE("l2");
     std::string base_quantization_str = GENERATE("fp32");
     const std::string name = "pyramid";
     auto search_param = GeneratePyramidSearchParametersString(100);
     PyramidParam pyramid_param;
+    // with an index_min_size above base_count the root stays a flat list
+    pyramid_param.index_min_size = GENERATE(0, 2 * base_count);
     std::vector<std::vector<int>> tmp_levels = {{1, 2}, {0, 1, 2}};
     for (auto& dim : dims) {
         for (const auto& level : tmp_levels) {
@@ -39,6 +39,12 @@ public:
             "sparse_index": {
             }
         })";
+    constexpr static const char* parallel_search_param = R"(
+        {
+            "sparse_index": {
+                "parallelism": 4
+            }
+        })";
 };
 TestDatasetPool SparseTestIndex::pool{};
 
@@ -92,3 +98,14 @@ TEST_CASE_PERSISTENT_FIXTURE(fixtures::SparseTestIndex,
     }
     vsag::Options::Instance().set_block_size_limit(origin_size);
 }
+
+TEST_CASE_PERSISTENT_FIXTURE(fixtures::SparseTestIndex,
+                             "SparseIndex Parallel Search",
+                             "[ft][sparse_index]") {
+    auto index = TestFactory("sparse_index", build_param, true);
+    auto dataset = pool.GetSparseDatasetAndCreate(base_count * 5, 128, 0.8);
+    TestBuildIndex(index, dataset, true);
+    TestKnnSearch(index, dataset, parallel_search_param, 0.99, true);
+    TestRangeSearch(index, dataset, parallel_search_param, 0.99, 10, true);
+    TestFilterSearch(index, dataset, parallel_search_param, 0.99, true);
+}
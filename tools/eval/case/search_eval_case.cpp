@@ -22,6 +22,7 @@
 #include <iostream>
 #include <stdexcept>
 
+#include "../monitor/cache_miss_monitor.h"
 #include "../monitor/latency_monitor.h"
 #include "../monitor/memory_peak_monitor.h"
 #include "../monitor/recall_monitor.h"
@@ -76,6 +77,7 @@ SearchEvalCase::init_monitor() {
     this->init_latency_monitor();
     this->init_recall_monitor();
     this->init_memory_monitor();
+    this->init_cache_miss_monitor();
 }
 
 void
@@ -119,6 +121,14 @@ SearchEvalCase::init_memory_monitor() {
     }
 }
 
+void
+SearchEvalCase::init_cache_miss_monitor() {
+    if (config_.enable_cache_miss) {
+        auto cache_miss_monitor = std::make_shared<CacheMissMonitor>();
+        this->monitors_.emplace_back(std::move(cache_miss_monitor));
+    }
+}
+
 JsonType
 SearchEvalCase::Run() {
     std::ifstream infile(this->index_path_, std::ios::binary);
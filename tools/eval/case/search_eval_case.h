@@ -52,6 +52,9 @@ private:
     void
     init_memory_monitor();
 
+    void
+    init_cache_miss_monitor();
+
     void
     deserialize(std::ifstream& infile);
 
@@ -65,6 +65,9 @@ EvalConfig::Load(argparse::ArgumentParser& parser) {
     if (parser.get<bool>("--disable_percent_latency")) {
         config.enable_percent_latency = false;
     }
+    if (parser.get<bool>("--enable_cache_miss")) {
+        config.enable_cache_miss = true;
+    }
 
     return config;
 }
@@ -140,6 +143,7 @@ EvalConfig::Load(YAML::Node& yaml_node, const eval_job& global_options) {
         config.enable_percent_latency = false;
         disable = false;
     }
+    check_and_get_value<bool>(yaml_node, "enable_cache_miss", config.enable_cache_miss);
 
     return config;
 }
@@ -164,6 +168,7 @@ EvalConfig::CheckKeyAndType(YAML::Node& yaml_node) {
     check_and_get_value<bool>(yaml_node, "disable_memory");
     check_and_get_value<bool>(yaml_node, "disable_latency");
     check_and_get_value<bool>(yaml_node, "disable_percent_latency");
+    check_and_get_value<bool>(yaml_node, "enable_cache_miss");
 }
 
 }  // namespace vsag::eval
@@ -55,6 +55,7 @@ public:
     bool enable_memory{true};
     bool enable_latency{true};
     bool enable_percent_latency{true};
+    bool enable_cache_miss{false};
 
     EvalConfig() = default;
 };
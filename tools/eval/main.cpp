@@ -100,6 +100,9 @@ parse_args(argparse::ArgumentParser& parser, int argc, char** argv) {
     parser.add_argument("--disable_percent_latency")
         .default_value(false)
         .help("Disable percent latency eval, include p50, p80, p90, p95, p99");
+    parser.add_argument("--enable_cache_miss")
+        .default_value(false)
+        .help("Enable l1d, llc and dtlb miss per query eval with perf events");
 
     try {
         parser.parse_args(argc, argv);
@@ -0,0 +1,126 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cache_miss_monitor.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <mutex>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+namespace vsag::eval {
+
+#if defined(__linux__)
+static int
+open_perf_event(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+static uint64_t
+hw_cache_config(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+#endif
+
+CacheMissMonitor::CacheMissMonitor() : Monitor("cache_miss_monitor") {
+#if defined(__linux__)
+    counters_.push_back(
+        {"l1d_miss",
+         open_perf_event(PERF_TYPE_HW_CACHE,
+                         hw_cache_config(PERF_COUNT_HW_CACHE_L1D,
+                                         PERF_COUNT_HW_CACHE_OP_READ,
+                                         PERF_COUNT_HW_CACHE_RESULT_MISS))});
+    counters_.push_back(
+        {"llc_miss", open_perf_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES)});
+    counters_.push_back(
+        {"dtlb_miss",
+         open_perf_event(PERF_TYPE_HW_CACHE,
+                         hw_cache_config(PERF_COUNT_HW_CACHE_DTLB,
+                                         PERF_COUNT_HW_CACHE_OP_READ,
+                                         PERF_COUNT_HW_CACHE_RESULT_MISS))});
+#endif
+}
+
+CacheMissMonitor::~CacheMissMonitor() {
+    for (auto& counter : counters_) {
+        if (counter.fd >= 0) {
+            close(counter.fd);
+        }
+    }
+}
+
+void
+CacheMissMonitor::Start() {
+#if defined(__linux__)
+    for (auto& counter : counters_) {
+        if (counter.fd >= 0) {
+            ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void
+CacheMissMonitor::Stop() {
+#if defined(__linux__)
+    for (auto& counter : counters_) {
+        if (counter.fd >= 0) {
+            ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(counter.fd, &counter.value, sizeof(counter.value)) != sizeof(counter.value)) {
+                counter.value = 0;
+            }
+        }
+    }
+#endif
+}
+
+Monitor::JsonType
+CacheMissMonitor::GetResult() {
+    JsonType result;
+    if (query_count_ == 0) {
+        return result;
+    }
+    for (const auto& counter : counters_) {
+        if (counter.fd >= 0) {
+            result["cache_miss_per_query"][counter.name] =
+                static_cast<double>(counter.value) / static_cast<double>(query_count_);
+        }
+    }
+    return result;
+}
+
+void
+CacheMissMonitor::Record(void* input) {
+    std::lock_guard<std::mutex> lock(record_mutex_);
+    ++query_count_;
+}
+
+}  // namespace vsag::eval
@@ -0,0 +1,61 @@
+
+// Copyright 2024-present the vsag project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "monitor.h"
+
+namespace vsag::eval {
+
+/**
+ * @brief Counts L1d, LLC and dTLB misses per query with linux perf events.
+ *
+ * The counters are inherited by the threads created after Start(), the result is empty when
+ * perf events are not permitted (see /proc/sys/kernel/perf_event_paranoid).
+ */
+class CacheMissMonitor : public Monitor {
+public:
+    CacheMissMonitor();
+
+    ~CacheMissMonitor() override;
+
+    void
+    Start() override;
+
+    void
+    Stop() override;
+
+    JsonType
+    GetResult() override;
+
+    void
+    Record(void* input) override;
+
+private:
+    struct Counter {
+        std::string name;
+        int fd{-1};
+        uint64_t value{0};
+    };
+
+    std::vector<Counter> counters_;
+
+    uint64_t query_count_{0};
+};
+
+}  // namespace vsag::eval